@@ -98,45 +98,67 @@ Real min_fixable_quality(Mesh* mesh, AdaptOpts const& opts) {
 
 AdaptOpts::AdaptOpts(Mesh* mesh) : AdaptOpts(mesh->dim()) {}
 
-static void adapt_summary(Mesh* mesh, AdaptOpts const& opts,
-    MinMax<Real> qualstats, MinMax<Real> lenstats) {
-  print_goal_stats(mesh, "quality", mesh->dim(),
-      get_fixable_qualities(mesh, opts),
-      {opts.min_quality_allowed, opts.min_quality_desired}, qualstats);
-  print_goal_stats(mesh, "length", EDGE, mesh->ask_lengths(),
-      {opts.min_length_desired, opts.max_length_desired}, lenstats);
+/* quality stats first, then length stats, with histograms only
+   when they are going to be printed. the arrays are cached since
+   the next operations need them too */
+static std::vector<FieldStats> get_adapt_stats(
+    Mesh* mesh, AdaptOpts const& opts, bool with_histograms) {
+  StatsQuery quality{mesh->dim(), get_fixable_qualities(mesh, opts),
+      {opts.min_quality_allowed, opts.min_quality_desired}, 0, 0.0, 1.0,
+      STATS_VALUES};
+  StatsQuery length{EDGE, mesh->ask_lengths(),
+      {opts.min_length_desired, opts.max_length_desired}, 0,
+      opts.length_histogram_min, opts.length_histogram_max, STATS_VALUES};
+  if (with_histograms) {
+    quality.nbins = opts.nquality_histogram_bins;
+    length.nbins = opts.nlength_histogram_bins;
+  }
+  return get_field_stats(mesh, {quality, length});
 }
 
-bool print_adapt_status(Mesh* mesh, AdaptOpts const& opts) {
-  OMEGA_H_TIME_FUNCTION;
-  auto qualstats = get_minmax(mesh->comm(), get_fixable_qualities(mesh, opts));
-  auto lenstats = get_minmax(mesh->comm(), mesh->ask_lengths());
+std::vector<FieldStats> get_trial_stats(Mesh* mesh, AdaptOpts const& opts) {
+  StatsQuery quality{mesh->dim(), Reals(),
+      {opts.min_quality_allowed, opts.min_quality_desired}, 0, 0.0, 1.0,
+      STATS_QUALITY};
+  StatsQuery length{EDGE, Reals(),
+      {opts.min_length_desired, opts.max_length_desired}, 0, 0.0, 0.0,
+      STATS_LENGTH};
+  return get_field_stats(mesh, {quality, length});
+}
+
+static bool print_adapt_status(Mesh* mesh, AdaptOpts const& opts,
+    std::vector<FieldStats> const& stats) {
+  auto const& qualstats = stats[0];
+  auto const& lenstats = stats[1];
   if (opts.verbosity > SILENT) {
-    adapt_summary(mesh, opts, qualstats, lenstats);
+    print_goal_stats(mesh, "quality", mesh->dim(), qualstats,
+        {opts.min_quality_allowed, opts.min_quality_desired});
+    print_goal_stats(mesh, "length", EDGE, lenstats,
+        {opts.min_length_desired, opts.max_length_desired});
   }
-  return (qualstats.min >= opts.min_quality_desired &&
-          lenstats.min >= opts.min_length_desired &&
-          lenstats.max <= opts.max_length_desired);
+  return (qualstats.actual.min >= opts.min_quality_desired &&
+          lenstats.actual.min >= opts.min_length_desired &&
+          lenstats.actual.max <= opts.max_length_desired);
 }
 
-void print_adapt_histograms(Mesh* mesh, AdaptOpts const& opts) {
-  auto qh = get_histogram(mesh, mesh->dim(), opts.nquality_histogram_bins, 0.0,
-      1.0, mesh->ask_qualities());
-  auto lh = get_histogram(mesh, EDGE, opts.nlength_histogram_bins,
-      opts.length_histogram_min, opts.length_histogram_max,
-      mesh->ask_lengths());
-  auto owned_qualities =
-      mesh->owned_array(mesh->dim(), mesh->ask_qualities(), 1);
-  auto qual_sum = get_sum(mesh->comm(), owned_qualities);
-  auto global_nelems = mesh->nglobal_ents(mesh->dim());
-  auto avg_qual = qual_sum / global_nelems;
+static void print_adapt_histograms(
+    Mesh* mesh, std::vector<FieldStats> const& stats) {
   if (can_print(mesh)) {
-    print_histogram(qh, "quality");
-    print_histogram(lh, "length");
-    std::cout << "average quality: " << avg_qual << '\n';
+    print_histogram(stats[0].histogram, "quality");
+    print_histogram(stats[1].histogram, "length");
+    std::cout << "average quality: " << stats[0].mean << '\n';
   }
 }
 
+bool print_adapt_status(Mesh* mesh, AdaptOpts const& opts) {
+  OMEGA_H_TIME_FUNCTION;
+  return print_adapt_status(mesh, opts, get_adapt_stats(mesh, opts, false));
+}
+
+void print_adapt_histograms(Mesh* mesh, AdaptOpts const& opts) {
+  print_adapt_histograms(mesh, get_adapt_stats(mesh, opts, true));
+}
+
 static void validate(Mesh* mesh, AdaptOpts const& opts) {
   OMEGA_H_CHECK(0.0 <= opts.min_quality_allowed);
   OMEGA_H_CHECK(opts.min_quality_allowed <= opts.min_quality_desired);
@@ -156,10 +178,10 @@ static bool pre_adapt(Mesh* mesh, AdaptOpts const& opts) {
   if (opts.verbosity >= EACH_ADAPT && !mesh->comm()->rank()) {
     std::cout << "before adapting:\n";
   }
-  if (print_adapt_status(mesh, opts)) return false;
-  if (opts.verbosity >= EXTRA_STATS) {
-    print_adapt_histograms(mesh, opts);
-  }
+  auto const extra_stats = opts.verbosity >= EXTRA_STATS;
+  auto const stats = get_adapt_stats(mesh, opts, extra_stats);
+  if (print_adapt_status(mesh, opts, stats)) return false;
+  if (extra_stats) print_adapt_histograms(mesh, stats);
   if ((opts.verbosity >= EACH_REBUILD) && !mesh->comm()->rank()) {
     std::cout << "addressing edge lengths\n";
   }
@@ -243,11 +265,15 @@ static void snap_and_satisfy_quality(Mesh* mesh, AdaptOpts const& opts) {
 
 static void post_adapt(
     Mesh* mesh, AdaptOpts const& opts, Now t0, Now t1, Now t2, Now t3, Now t4) {
-  if (opts.verbosity == EACH_ADAPT) {
-    if (!mesh->comm()->rank()) std::cout << "after adapting:\n";
-    print_adapt_status(mesh, opts);
+  if (opts.verbosity == EACH_ADAPT || opts.verbosity >= EXTRA_STATS) {
+    auto const extra_stats = opts.verbosity >= EXTRA_STATS;
+    auto const stats = get_adapt_stats(mesh, opts, extra_stats);
+    if (opts.verbosity == EACH_ADAPT) {
+      if (!mesh->comm()->rank()) std::cout << "after adapting:\n";
+      print_adapt_status(mesh, opts, stats);
+    }
+    if (extra_stats) print_adapt_histograms(mesh, stats);
   }
-  if (opts.verbosity >= EXTRA_STATS) print_adapt_histograms(mesh, opts);
   if (opts.verbosity > SILENT && !mesh->comm()->rank()) {
     std::cout << "addressing edge lengths took " << (t2 - t1) << " seconds\n";
   }
@@ -6,6 +6,7 @@
 #include <Omega_h_config.h>
 #include <Omega_h_compare.hpp>
 #include <Omega_h_defines.hpp>
+#include <Omega_h_histogram.hpp>
 #include <Omega_h_mark.hpp>
 
 namespace Omega_h {
@@ -78,6 +79,12 @@ struct AdaptOpts {
 
 Real min_fixable_quality(Mesh* mesh, AdaptOpts const& opts);
 
+/* fixable quality stats first, then length stats, in one pass over
+   each and a single collective. qualities and lengths that are not
+   cached are measured during the pass and not stored, so this can
+   check trial states cheaply */
+std::vector<FieldStats> get_trial_stats(Mesh* mesh, AdaptOpts const& opts);
+
 /* returns false if the mesh was not modified. */
 bool adapt(Mesh* mesh, AdaptOpts const& opts);
 
@@ -87,6 +94,8 @@ void print_adapt_histograms(Mesh* mesh, AdaptOpts const& opts);
 void fix_momentum_velocity_verts(
     Mesh* mesh, std::vector<ClassPair> const& class_pairs, Int comp);
 
+/* the warp stalls once the uniform step has been halved (max_niters)
+   times without passing */
 bool warp_to_limit(Mesh* mesh, AdaptOpts const& opts,
     bool exit_on_stall = false, Int max_niters = 40);
 bool approach_metric(Mesh* mesh, AdaptOpts const& opts, Real min_step = 1e-4);
@@ -123,6 +123,7 @@ static void refine_elem_based(Mesh* mesh, TransferOpts xfer_opts) {
   Few<LOs, 4> same_ents2new_ents;
   Few<LOs, 4> old_ents2new_ents;
   LOs old_lows2new_lows;
+  ModifiedEnts modified;
   for (Int prod_dim = 0; prod_dim <= mesh->dim(); ++prod_dim) {
     LOs prods2verts;
     if (prod_dim != VERT) {
@@ -146,7 +147,7 @@ static void refine_elem_based(Mesh* mesh, TransferOpts xfer_opts) {
         prods2verts, old_lows2new_lows, /*keep_mods*/ true,
         /*mods_can_be_shared*/ true, &(prods2new_ents[prod_dim]),
         &(same_ents2old_ents[prod_dim]), &(same_ents2new_ents[prod_dim]),
-        &(old_ents2new_ents[prod_dim]));
+        &(old_ents2new_ents[prod_dim]), &modified);
     if (prod_dim == VERT) {
       mods2midverts[VERT] =
           unmap(mods2mds[VERT], old_ents2new_ents[prod_dim], 1);
@@ -172,6 +173,7 @@ static void refine_elem_based(Mesh* mesh, TransferOpts xfer_opts) {
         same_ents2new_ents[prod_dim], old_ents2new_ents[prod_dim]);
     old_lows2new_lows = old_ents2new_ents[prod_dim];
   }
+  modify_owners_and_globals(mesh, &new_mesh, modified);
   amr::transfer_parents(mesh, &new_mesh, mods2mds, prods2new_ents,
       same_ents2old_ents, same_ents2new_ents, old_ents2new_ents);
   amr::transfer_inherit(mesh, &new_mesh, prods2new_ents, same_ents2old_ents,
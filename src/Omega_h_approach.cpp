@@ -1,7 +1,9 @@
 #include "Omega_h_adapt.hpp"
 
 #include "Omega_h_array_ops.hpp"
+#include "Omega_h_for.hpp"
 #include "Omega_h_metric.hpp"
+#include "Omega_h_quality.hpp"
 #include "Omega_h_shape.hpp"
 
 #include <iostream>
@@ -9,73 +11,271 @@
 namespace Omega_h {
 
 static void check_okay(Mesh* mesh, AdaptOpts const& opts) {
-  auto minq = min_fixable_quality(mesh, opts);
+  auto stats = get_trial_stats(mesh, opts);
+  auto minq = stats[0].actual.min;
   if (minq < opts.min_quality_allowed) {
     Omega_h_fail("minimum element quality %f < minimum allowed quality %f\n",
         minq, opts.min_quality_allowed);
   }
-  auto maxl = mesh->max_length();
+  auto maxl = stats[1].actual.max;
   if (maxl > opts.max_length_allowed) {
     Omega_h_fail("maximum edge length %f > maximum allowed length %f\n", maxl,
         opts.max_length_allowed);
   }
 }
 
-static bool okay(Mesh* mesh, AdaptOpts const& opts) {
-  auto minq = min_fixable_quality(mesh, opts);
-  if (minq < opts.min_quality_allowed) {
-    return false;
+/* adaptive step control. after the full step fails, vertices
+   around violations are first held back on their own, as long as
+   there are few of them, by a secant through the quality or length
+   of each violating entity. otherwise the uniform step is halved
+   until it passes and then pushed toward the largest passing step
+   by regula falsi on the margin of the worst constraint */
+
+namespace {
+
+struct StepResponse {
+  /* how far the worst constraint is from its limit, negative
+     if violated: quality minus the minimum allowed quality, or
+     the relative distance of the longest edge to the maximum */
+  Real margin;
+  Reals quals;
+  Reals lens;
+};
+
+struct StepResult {
+  Reals steps;  // per vertex
+  Real factor;  // uniform factor, or one if limited per vertex
+  LO nlimited;  // number of vertices limited per vertex
+  Int ntrials;
+  bool stalled;
+};
+
+constexpr Real max_limited_fraction = 0.01;
+constexpr Int max_local_trials = 3;
+constexpr Int max_refine_trials = 2;
+constexpr Real refine_safety = 0.9;
+constexpr Real refine_tolerance = 0.05;
+
+}  // end anonymous namespace
+
+/* the margin alone is measured without storing qualities or lengths */
+static Real measure_margin(Mesh* mesh, AdaptOpts const& opts) {
+  auto stats = get_trial_stats(mesh, opts);
+  return min2(stats[0].actual.min - opts.min_quality_allowed,
+      (opts.max_length_allowed - stats[1].actual.max) /
+          opts.max_length_allowed);
+}
+
+/* the values of each entity are only needed at step zero and while
+   a step fails, and are measured without storing them as tags */
+static StepResponse measure_step(
+    Mesh* mesh, AdaptOpts const& opts, bool is_start = false) {
+  StepResponse response;
+  response.margin = measure_margin(mesh, opts);
+  if (is_start || response.margin < 0.0) {
+    response.quals = measure_qualities(mesh);
+    response.lens = measure_edges_metric(mesh);
   }
-  auto maxl = mesh->max_length();
-  if (maxl > opts.max_length_allowed) {
-    return false;
+  return response;
+}
+
+/* the factor by which the steps of each entity should shrink:
+   one if it satisfies the limit, otherwise the root of a line through
+   its value at step zero (start) and at the trial. (sign) is 1 for
+   lower limits and -1 for upper limits */
+static Reals get_entity_ratios(
+    Reals start, Reals trial, Real limit, Real sign) {
+  constexpr Real safety = 0.9;
+  constexpr Real min_ratio = 1.0 / 16.0;
+  auto n = trial.size();
+  Write<Real> out(n);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto g0 = sign * start[i];
+    auto g = sign * trial[i];
+    auto gl = sign * limit;
+    if (g >= gl) {
+      out[i] = 1.0;
+    } else {
+      auto ratio = safety * max2(g0 - gl, 0.0) / (g0 - g);
+      out[i] = max2(min_ratio, min2(safety, ratio));
+    }
+  };
+  parallel_for(n, f, "get_entity_ratios");
+  return out;
+}
+
+/* the smallest ratio among the entities of dimension (dim) around
+   each vertex, consistent across ranks */
+static Reals get_vert_ratios(Mesh* mesh, Int dim, Reals ent_ratios) {
+  auto v2e = mesh->ask_up(VERT, dim);
+  auto nverts = mesh->nverts();
+  Write<Real> out(nverts);
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    Real ratio = 1.0;
+    for (auto ve = v2e.a2ab[v]; ve < v2e.a2ab[v + 1]; ++ve) {
+      ratio = min2(ratio, ent_ratios[v2e.ab2b[ve]]);
+    }
+    out[v] = ratio;
+  };
+  parallel_for(nverts, f, "get_vert_ratios");
+  Reals ratios = out;
+  if (!mesh->owners_have_all_upward(VERT)) {
+    ratios = mesh->reduce_array(VERT, ratios, 1, OMEGA_H_MIN);
   }
-  return true;
+  return mesh->sync_array(VERT, ratios, 1);
+}
+
+static Reals get_vert_ratios(Mesh* mesh, AdaptOpts const& opts,
+    StepResponse const& start, StepResponse const& trial) {
+  auto elem_ratios = get_entity_ratios(
+      start.quals, trial.quals, opts.min_quality_allowed, 1.0);
+  auto edge_ratios = get_entity_ratios(
+      start.lens, trial.lens, opts.max_length_allowed, -1.0);
+  return min_each(get_vert_ratios(mesh, mesh->dim(), elem_ratios),
+      get_vert_ratios(mesh, EDGE, edge_ratios));
+}
+
+/* (apply) sets the mesh to per-vertex steps from zero (the state
+   measured in (start)) to one, where (full) was measured. the local
+   and refinement trials have their own fixed budgets, so that
+   (max_halvings) bounds the halvings alone, as it always has */
+template <typename Apply>
+static StepResult find_steps(Mesh* mesh, AdaptOpts const& opts,
+    StepResponse const& start, StepResponse const& full, Apply const& apply,
+    Real min_step, Int max_halvings) {
+  auto nverts = mesh->nverts();
+  auto comm = mesh->comm();
+  StepResult result;
+  result.factor = 1.0;
+  result.nlimited = 0;
+  result.ntrials = 0;
+  result.stalled = false;
+  auto trial = full;
+  auto steps = Reals(nverts, 1.0);
+  for (Int i = 0; i < max_local_trials; ++i) {
+    auto ratios = get_vert_ratios(mesh, opts, start, trial);
+    auto are_limited = land_each(mesh->owned(VERT), each_lt(ratios, 1.0));
+    auto nlimited = get_sum(comm, are_limited);
+    auto max_nlimited = max_limited_fraction * Real(mesh->nglobal_ents(VERT));
+    if (Real(nlimited) > max_nlimited) break;
+    steps = multiply_each(steps, ratios);
+    apply(steps);
+    ++result.ntrials;
+    trial = measure_step(mesh, opts);
+    if (trial.margin >= 0.0) {
+      result.steps = steps;
+      result.nlimited = LO(nlimited);
+      return result;
+    }
+  }
+  /* halve until a step passes, as without the controller. the margin
+     at step zero says little about larger steps, so it is not used */
+  Real hi = 1.0;
+  Real hi_margin = full.margin;
+  Real lo = 0.5;
+  Real lo_margin;
+  for (Int nhalvings = 1;; ++nhalvings) {
+    if (lo < min_step || nhalvings > max_halvings) {
+      result.factor = lo;
+      result.stalled = true;
+      return result;
+    }
+    apply(Reals(nverts, lo));
+    ++result.ntrials;
+    lo_margin = measure_margin(mesh, opts);
+    if (lo_margin >= 0.0) break;
+    hi = lo;
+    hi_margin = lo_margin;
+    lo /= 2.0;
+  }
+  /* then move toward the largest passing step by regula falsi
+     between the measured passing and failing steps */
+  auto best = lo;
+  auto applied = lo;
+  for (Int i = 0; i < max_refine_trials; ++i) {
+    auto root = lo + (hi - lo) * lo_margin / (lo_margin - hi_margin);
+    auto t = lo + refine_safety * (root - lo);
+    if (t - lo < refine_tolerance * hi) break;
+    apply(Reals(nverts, t));
+    applied = t;
+    ++result.ntrials;
+    auto margin = measure_margin(mesh, opts);
+    if (margin >= 0.0) {
+      best = lo = t;
+      lo_margin = margin;
+    } else {
+      hi = t;
+      hi_margin = margin;
+    }
+  }
+  if (applied != best) apply(Reals(nverts, best));
+  result.steps = Reals(nverts, best);
+  result.factor = best;
+  return result;
+}
+
+static void print_steps(Mesh* mesh, AdaptOpts const& opts, char const* what,
+    StepResult const& result) {
+  if (opts.verbosity >= EACH_REBUILD && can_print(mesh)) {
+    std::cout << what;
+    if (result.nlimited) {
+      std::cout << " held back " << result.nlimited << " vertices";
+    } else {
+      std::cout << " moved by factor " << result.factor;
+    }
+    std::cout << " after " << result.ntrials << " trials\n";
+  }
+}
+
+/* a + steps * b, with one step per vertex */
+static Reals add_scaled(Reals a, Reals steps, Reals b) {
+  auto width = divide_no_remainder(a.size(), steps.size());
+  Write<Real> out(a.size());
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    out[i] = a[i] + steps[i / width] * b[i];
+  };
+  parallel_for(a.size(), f, "add_scaled");
+  return out;
 }
 
 bool warp_to_limit(
     Mesh* mesh, AdaptOpts const& opts, bool exit_on_stall, Int max_niters) {
   if (!mesh->has_tag(VERT, "warp")) return false;
-  check_okay(mesh, opts);
+  auto start = measure_step(mesh, opts, true);
+  if (start.margin < 0.0) check_okay(mesh, opts);
   auto coords = mesh->coords();
   auto warp = mesh->get_array<Real>(VERT, "warp");
   mesh->set_coords(add_each(coords, warp));
-  if (okay(mesh, opts)) {
+  auto full = measure_step(mesh, opts);
+  if (full.margin >= 0.0) {
     if (opts.verbosity >= EACH_REBUILD && can_print(mesh)) {
       std::cout << "warp_to_limit completed in one step\n";
     }
     mesh->remove_tag(VERT, "warp");
     return true;
   }
-  auto remainder = Reals(warp.size(), 0.0);
-  Int i = 0;
-  Real factor = 1.0;
-  do {
-    ++i;
-    if (i > max_niters) {
-      if (exit_on_stall) {
-        if (can_print(mesh)) {
-          std::cout << "warp_to_limit stalled, dropping warp field and "
-                       "continuing anyway\n";
-        }
-        mesh->remove_tag(VERT, "warp");
-        return true;
+  auto apply = [&](Reals steps) {
+    mesh->set_coords(add_scaled(coords, steps, warp));
+  };
+  auto result = find_steps(mesh, opts, start, full, apply, 0.0, max_niters);
+  if (result.stalled) {
+    if (exit_on_stall) {
+      if (can_print(mesh)) {
+        std::cout << "warp_to_limit stalled, dropping warp field and "
+                     "continuing anyway\n";
       }
-      Omega_h_fail(
-          "warp step %d : Omega_h is probably unable to satisfy"
-          " this warp under this size field\n"
-          "min quality %.2e max length %.2e\n",
-          i, min_fixable_quality(mesh, opts), mesh->max_length());
+      mesh->remove_tag(VERT, "warp");
+      return true;
     }
-    auto half_warp = divide_each_by(warp, 2.0);
-    factor /= 2.0;
-    warp = half_warp;
-    remainder = add_each(remainder, half_warp);
-    mesh->set_coords(add_each(coords, warp));
-  } while (!okay(mesh, opts));
-  if (opts.verbosity >= EACH_REBUILD && can_print(mesh)) {
-    std::cout << "warp_to_limit moved by factor " << factor << '\n';
+    auto stats = get_trial_stats(mesh, opts);
+    Omega_h_fail(
+        "warp step %d : Omega_h is probably unable to satisfy"
+        " this warp under this size field\n"
+        "min quality %.2e max length %.2e\n",
+        result.ntrials, stats[0].actual.min, stats[1].actual.max);
   }
+  print_steps(mesh, opts, "warp_to_limit", result);
+  auto remainder = add_scaled(warp, result.steps, multiply_each_by(warp, -1.0));
   mesh->set_tag(VERT, "warp", remainder);
   return true;
 }
@@ -84,44 +284,49 @@ bool approach_metric(Mesh* mesh, AdaptOpts const& opts, Real min_step) {
   auto name = "metric";
   auto target_name = "target_metric";
   if (!mesh->has_tag(VERT, target_name)) return false;
-  check_okay(mesh, opts);
+  auto start = measure_step(mesh, opts, true);
+  if (start.margin < 0.0) check_okay(mesh, opts);
   auto orig = mesh->get_array<Real>(VERT, name);
   auto target = mesh->get_array<Real>(VERT, target_name);
   mesh->set_tag(VERT, name, target);
-  if (okay(mesh, opts)) {
+  auto full = measure_step(mesh, opts);
+  if (full.margin >= 0.0) {
     mesh->remove_tag(VERT, target_name);
     return true;
   }
-  Real factor = 1.0;
-  do {
-    factor /= 2.0;
-    if (factor < min_step) {
-      auto minq = min_fixable_quality(mesh, opts);
-      auto maxl = mesh->max_length();
-      if (can_print(mesh)) {
-        if (minq < opts.min_quality_allowed) {
-          std::cerr << "Metric approach has stalled with minimum quality "
-                    << minq << " < " << opts.min_quality_allowed << "\n";
-          std::cerr << "Decreasing \"Min Quality Allowed\" may help, but "
-                       "otherwise the metric is likely not satisfiable\n";
-        }
-        if (maxl > opts.max_length_allowed) {
-          std::cerr << "Metric approach has stalled with maximum length "
-                    << maxl << " > " << opts.max_length_allowed << "\n";
-          std::cerr << "Increasing \"Max Length Allowed\" will probably fix "
-                       "this, otherwise the metric is likely not satisfiable\n";
-        }
-      }
-      Omega_h_fail("Metric approach has stalled at step size = %f < %f.\n",
-          factor, min_step);
-    }
+  /* steps are taken between the linearized metrics */
+  auto nverts = mesh->nverts();
+  auto log_orig = linearize_metrics(nverts, orig);
+  auto log_diff = subtract_each(linearize_metrics(nverts, target), log_orig);
+  auto apply = [&](Reals steps) {
     auto current =
-        interpolate_between_metrics(mesh->nverts(), orig, target, factor);
+        delinearize_metrics(nverts, add_scaled(log_orig, steps, log_diff));
     mesh->set_tag(VERT, name, current);
-  } while (!okay(mesh, opts));
-  if (opts.verbosity >= EACH_REBUILD && can_print(mesh)) {
-    std::cout << "approach_metric moved by factor " << factor << '\n';
+  };
+  auto result = find_steps(mesh, opts, start, full, apply, min_step,
+      ArithTraits<Int>::max());
+  if (result.stalled) {
+    auto stats = get_trial_stats(mesh, opts);
+    auto minq = stats[0].actual.min;
+    auto maxl = stats[1].actual.max;
+    if (can_print(mesh)) {
+      if (minq < opts.min_quality_allowed) {
+        std::cerr << "Metric approach has stalled with minimum quality "
+                  << minq << " < " << opts.min_quality_allowed << "\n";
+        std::cerr << "Decreasing \"Min Quality Allowed\" may help, but "
+                     "otherwise the metric is likely not satisfiable\n";
+      }
+      if (maxl > opts.max_length_allowed) {
+        std::cerr << "Metric approach has stalled with maximum length "
+                  << maxl << " > " << opts.max_length_allowed << "\n";
+        std::cerr << "Increasing \"Max Length Allowed\" will probably fix "
+                     "this, otherwise the metric is likely not satisfiable\n";
+      }
+    }
+    Omega_h_fail("Metric approach has stalled at step size = %f < %f.\n",
+        result.factor, min_step);
   }
+  print_steps(mesh, opts, "approach_metric", result);
   return true;
 }
 
@@ -28,11 +28,16 @@ T* nonnull(T* p) {
 #ifdef OMEGA_H_USE_KOKKOS
 template <typename T>
 Write<T>::Write(Kokkos::View<T*> view_in) : view_(view_in) {}
+#else
+template <typename T>
+Write<T>::Write(SharedAlloc shared_alloc_in)
+    : shared_alloc_(std::move(shared_alloc_in)) {}
 #endif
 
 template <typename T>
 Write<T>::Write(LO size_in, std::string const& name_in) {
-  begin_code("Write allocation");
+  static auto const region = profile::intern("Write allocation");
+  begin_code(region);
 #ifdef OMEGA_H_USE_KOKKOS
   view_ = decltype(view_)(Kokkos::ViewAllocateWithoutInitializing(name_in),
       static_cast<std::size_t>(size_in));
@@ -90,7 +95,7 @@ std::string const& Write<T>::name() const {
 
 template <typename T>
 void Write<T>::set(LO i, T value) const {
-  ScopedTimer timer("single host to device");
+  OMEGA_H_TIME_REGION("single host to device");
 #ifdef OMEGA_H_USE_CUDA
   cudaMemcpy(data() + i, &value, sizeof(T), cudaMemcpyHostToDevice);
 #else
@@ -100,7 +105,7 @@ void Write<T>::set(LO i, T value) const {
 
 template <typename T>
 T Write<T>::get(LO i) const {
-  ScopedTimer timer("single device to host");
+  OMEGA_H_TIME_REGION("single device to host");
 #ifdef OMEGA_H_USE_CUDA
   T value;
   cudaMemcpy(&value, data() + i, sizeof(T), cudaMemcpyDeviceToHost);
@@ -268,7 +273,7 @@ HostWrite<T>::HostWrite(std::initializer_list<T> l, std::string const& name_in)
 
 template <typename T>
 Write<T> HostWrite<T>::write() const {
-  ScopedTimer timer("array host to device");
+  OMEGA_H_TIME_REGION("array host to device");
 #ifdef OMEGA_H_USE_KOKKOS
   Kokkos::deep_copy(write_.view(), mirror_);
 #elif defined(OMEGA_H_USE_CUDA)
@@ -319,7 +324,7 @@ T HostWrite<T>::get(LO i) const {
 
 template <typename T>
 HostRead<T>::HostRead(Read<T> read) : read_(read) {
-  ScopedTimer timer("array device to host");
+  OMEGA_H_TIME_REGION("array device to host");
 #ifdef OMEGA_H_USE_KOKKOS
   Kokkos::View<const T*> dev_view = read.view();
   Kokkos::View<const T*, Kokkos::HostSpace> h_view =
@@ -376,6 +381,20 @@ Write<T> deep_copy(Read<T> a, std::string const& name) {
   return b;
 }
 
+template <class T>
+Write<T> adopt_host_data(T* data, LO size, std::function<void()> release,
+    std::string const& name) {
+#if defined(OMEGA_H_USE_KOKKOS) || defined(OMEGA_H_USE_CUDA)
+  HostWrite<T> h_out(size, name);
+  for (LO i = 0; i < size; ++i) h_out[i] = data[i];
+  if (release) release();
+  return h_out.write();
+#else
+  return Write<T>(SharedAlloc::adopt(data,
+      sizeof(T) * static_cast<std::size_t>(size), name, std::move(release)));
+#endif
+}
+
 #define INST(T)                                                                \
   template T* nonnull(T*);                                                     \
   template T const* nonnull(T const*);                                         \
@@ -387,7 +406,9 @@ Write<T> deep_copy(Read<T> a, std::string const& name) {
   template void fill(Write<T> a, T val);                                       \
   template void fill_linear(Write<T> a, T, T);                                 \
   template void copy_into(Read<T> a, Write<T> b);                              \
-  template Write<T> deep_copy(Read<T> a, std::string const&);
+  template Write<T> deep_copy(Read<T> a, std::string const&);                  \
+  template Write<T> adopt_host_data(                                           \
+      T*, LO, std::function<void()>, std::string const&);
 
 INST(I8)
 INST(I32)
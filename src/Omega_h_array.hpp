@@ -3,6 +3,7 @@
 
 #include <Omega_h_defines.hpp>
 #include <Omega_h_fail.hpp>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #ifdef OMEGA_H_USE_KOKKOS
@@ -40,6 +41,8 @@ class Write {
   }
 #ifdef OMEGA_H_USE_KOKKOS
   Write(Kokkos::View<T*> view_in);
+#else
+  Write(SharedAlloc shared_alloc_in);
 #endif
   Write(LO size_in, std::string const& name = "");
   Write(LO size_in, T value, std::string const& name = "");
@@ -267,6 +270,14 @@ template <class T>
 void copy_into(Read<T> a, Write<T> b);
 template <class T>
 Write<T> deep_copy(Read<T> a, std::string const& name = "");
+/* Wraps host memory owned by the caller as an array.
+   When device memory is host memory this does not copy, and (release)
+   is called when the last reference to the array goes away.
+   Otherwise the data is copied to the device and (release) is called
+   before returning. */
+template <class T>
+Write<T> adopt_host_data(T* data, LO size, std::function<void()> release,
+    std::string const& name = "");
 
 /* begin explicit instantiation declarations */
 #define OMEGA_H_EXPL_INST_DECL(T)                                              \
@@ -279,7 +290,9 @@ Write<T> deep_copy(Read<T> a, std::string const& name = "");
   extern template void fill(Write<T> a, T val);                                \
   extern template void fill_linear(Write<T> a, T, T);                          \
   extern template void copy_into(Read<T> a, Write<T> b);                       \
-  extern template Write<T> deep_copy(Read<T> a, std::string const&);
+  extern template Write<T> deep_copy(Read<T> a, std::string const&);           \
+  extern template Write<T> adopt_host_data(                                    \
+      T*, LO, std::function<void()>, std::string const&);
 OMEGA_H_EXPL_INST_DECL(I8)
 OMEGA_H_EXPL_INST_DECL(I32)
 OMEGA_H_EXPL_INST_DECL(I64)
@@ -1,6 +1,8 @@
 #include "Omega_h_base64.hpp"
 
 #include "Omega_h_fail.hpp"
+#include "Omega_h_for.hpp"
+#include "Omega_h_scalar.hpp"
 
 namespace Omega_h {
 
@@ -89,6 +91,15 @@ void decode_4(char const* in, unsigned char* out, std::size_t nout = 3) {
       UC(((U(val[2]) << U(6)) & U(0xC0)) | ((U(val[3]) >> U(0)) & U(0x3F)));
 }
 
+OMEGA_H_INLINE unsigned char_to_value_arith(I8 c) {
+  if ('A' <= c && c <= 'Z') return unsigned(c - 'A');
+  if ('a' <= c && c <= 'z') return unsigned(c - 'a' + 26);
+  if ('0' <= c && c <= '9') return unsigned(c - '0' + 52);
+  if (c == '+') return 62;
+  if (c == '/') return 63;
+  return 0;
+}
+
 }  // end anonymous namespace
 
 std::size_t encoded_size(std::size_t size) {
@@ -128,10 +139,36 @@ void decode(std::string const& text, void* data, std::size_t size) {
   if (rem) decode_4(&text[quot * 4], &out[quot * 3], rem);
 }
 
+Read<I8> decode(Read<I8> text, std::size_t size) {
+  OMEGA_H_CHECK(size <= std::size_t(ArithTraits<LO>::max()));
+  OMEGA_H_CHECK(std::size_t(text.size()) >= encoded_size(size));
+  auto n = LO(size);
+  Write<I8> out(n);
+  auto f = OMEGA_H_LAMBDA(LO group) {
+    unsigned bits = 0;
+    for (Int i = 0; i < 4; ++i) {
+      bits = (bits << 6) | char_to_value_arith(text[group * 4 + i]);
+    }
+    for (Int i = 0; i < 3; ++i) {
+      auto j = group * 3 + i;
+      if (j < n) out[j] = static_cast<I8>((bits >> (16 - 8 * i)) & 0xFF);
+    }
+  };
+  parallel_for((n + 2) / 3, f, "base64::decode");
+  return out;
+}
+
+/* reads through the stream buffer directly, since get() is
+   much slower per character */
 std::string read_encoded(std::istream& f) {
   std::string out;
+  auto buf = f.rdbuf();
   while (true) {
-    int c = f.get();
+    int c = buf->sbumpc();
+    if (c == std::char_traits<char>::eof()) {
+      f.setstate(std::ios::eofbit);
+      break;
+    }
     if (c < 0 || c > 127) break;
     unsigned char val = char_to_value[c];
     if (val > 63) break;
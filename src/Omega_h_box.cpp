@@ -1,10 +1,19 @@
 #include "Omega_h_box.hpp"
 
+#include "Omega_h_align.hpp"
+#include "Omega_h_element.hpp"
+#include "Omega_h_fail.hpp"
 #include "Omega_h_few.hpp"
 #include "Omega_h_for.hpp"
 #include "Omega_h_mesh.hpp"
+#include "Omega_h_profile.hpp"
+#include "Omega_h_remotes.hpp"
+#include "Omega_h_simplify.hpp"
 #include "Omega_h_vector.hpp"
 
+#include <algorithm>
+#include <vector>
+
 namespace Omega_h {
 
 void make_1d_box(Real x, LO nx, LOs* ev2v_out, Reals* coords_out) {
@@ -101,6 +110,498 @@ void make_3d_box(Real x, Real y, Real z, LO nx, LO ny, LO nz, LOs* hv2v_out,
   *coords_out = coords;
 }
 
+void make_box_block(Int dim, Vector<3> l, Few<LO, 3> nel, Few<LO, 3> begin,
+    Few<LO, 3> end, LOs* cv2v_out, Reals* coords_out, GOs* vert_globals_out,
+    GOs* cell_globals_out) {
+  OMEGA_H_TIME_FUNCTION;
+  Few<LO, 3> ncl;  // local cells along each axis
+  Few<LO, 3> nvl;  // local vertices along each axis
+  Few<GO, 3> nvg;  // global vertices along each axis
+  Vector<3> dx;
+  bool is_empty = false;
+  for (Int a = 0; a < 3; ++a) {
+    if (a < dim) {
+      ncl[a] = end[a] - begin[a];
+      if (ncl[a] <= 0) is_empty = true;
+      nvl[a] = ncl[a] + 1;
+      nvg[a] = GO(nel[a]) + 1;
+      dx[a] = l[a] / nel[a];
+    } else {
+      ncl[a] = nvl[a] = 1;
+      nvg[a] = 1;
+      dx[a] = 0.0;
+    }
+  }
+  LO nc = is_empty ? 0 : ncl[0] * ncl[1] * ncl[2];
+  LO nv = is_empty ? 0 : nvl[0] * nvl[1] * nvl[2];
+  Int nverts_per_cell = 1 << dim;
+  Write<Real> coords(nv * dim);
+  Write<GO> vert_globals(nv);
+  auto fill_verts = OMEGA_H_LAMBDA(LO v) {
+    LO i = v % nvl[0];
+    LO j = (v / nvl[0]) % nvl[1];
+    LO k = v / (nvl[0] * nvl[1]);
+    GO gi = begin[0] + i;
+    GO gj = begin[1] + j;
+    GO gk = begin[2] + k;
+    coords[v * dim + 0] = Real(gi) * dx[0];
+    if (dim > 1) coords[v * dim + 1] = Real(gj) * dx[1];
+    if (dim > 2) coords[v * dim + 2] = Real(gk) * dx[2];
+    vert_globals[v] = gi + nvg[0] * (gj + nvg[1] * gk);
+  };
+  parallel_for(nv, fill_verts, "make_box_block(verts)");
+  /* corners are ordered as in make_3d_box, truncated to the dimension.
+     lexicographic local vertex numbering makes the local order of the
+     corners of a cell agree with the global order, so any splitting
+     of cells into simplices matches across blocks */
+  Write<LO> cv2v(nc * nverts_per_cell);
+  Write<GO> cell_globals(nc);
+  auto fill_cells = OMEGA_H_LAMBDA(LO c) {
+    LO i = c % ncl[0];
+    LO j = (c / ncl[0]) % ncl[1];
+    LO k = c / (ncl[0] * ncl[1]);
+    for (Int n = 0; n < nverts_per_cell; ++n) {
+      LO di = (n & 1) ^ ((n >> 1) & 1);
+      LO dj = (n >> 1) & 1;
+      LO dk = (n >> 2) & 1;
+      cv2v[c * nverts_per_cell + n] =
+          (i + di) + nvl[0] * ((j + dj) + nvl[1] * (k + dk));
+    }
+    GO gi = begin[0] + i;
+    GO gj = begin[1] + j;
+    GO gk = begin[2] + k;
+    cell_globals[c] = gi + GO(nel[0]) * (gj + GO(nel[1]) * gk);
+  };
+  parallel_for(nc, fill_cells, "make_box_block(cells)");
+  *cv2v_out = cv2v;
+  *coords_out = coords;
+  *vert_globals_out = vert_globals;
+  *cell_globals_out = cell_globals;
+}
+
+Few<I32, 3> suggest_box_parts(I32 nparts, Int dim, Few<LO, 3> nel) {
+  OMEGA_H_CHECK(nparts >= 1);
+  Few<I32, 3> parts({1, 1, 1});
+  std::vector<I32> factors;
+  auto rest = nparts;
+  for (I32 f = 2; f * f <= rest; ++f) {
+    while (rest % f == 0) {
+      factors.push_back(f);
+      rest /= f;
+    }
+  }
+  if (rest > 1) factors.push_back(rest);
+  /* give the largest factors to the axes with the most cells per part,
+     keeping blocks close to cubic */
+  for (auto it = factors.rbegin(); it != factors.rend(); ++it) {
+    Int best = 0;
+    for (Int a = 1; a < dim; ++a) {
+      if (Real(nel[a]) / parts[a] > Real(nel[best]) / parts[best]) best = a;
+    }
+    parts[best] *= *it;
+  }
+  return parts;
+}
+
+/* every entity of a box grid is a translate of an entity of a single
+   cell. the entities of one dimension therefore fall into a few
+   "types", each given by the keys (di + 2 * dj + 4 * dk) of its
+   corners relative to its lowest corner. an entity is then identified
+   by its type and the grid position of its lowest corner, and its
+   connectivity, owner, global number and classification all follow
+   from that position, so nothing has to be matched or communicated.
+   the entities of a block are numbered by type, then lexicographically
+   by position, and global numbers follow the same rule over the whole
+   grid, which for vertices is the numbering of make_box_block. */
+
+typedef std::vector<Int> BoxKeys;
+
+/* the corners of one cell have local vertex numbers equal to their keys,
+   and every cell is split into simplices the same way as this one */
+static std::vector<BoxKeys> get_box_elem_shapes(
+    Omega_h_Family family, Int dim) {
+  LOs cv2v;
+  Reals coords;
+  GOs vert_globals;
+  GOs cell_globals;
+  Few<LO, 3> zeros({0, 0, 0});
+  Few<LO, 3> ones({1, 1, 1});
+  make_box_block(dim, Vector<3>({1.0, 1.0, 1.0}), ones, zeros, ones, &cv2v,
+      &coords, &vert_globals, &cell_globals);
+  if (family == OMEGA_H_SIMPLEX && dim > 1) {
+    cv2v = (dim == 2) ? tris_from_quads(cv2v) : tets_from_hexes(cv2v);
+  }
+  auto deg = element_degree(family, dim, VERT);
+  auto h_cv2v = HostRead<LO>(cv2v);
+  std::vector<BoxKeys> shapes(std::size_t(h_cv2v.size() / deg));
+  for (LO i = 0; i < h_cv2v.size(); ++i) {
+    shapes[std::size_t(i / deg)].push_back(h_cv2v[i]);
+  }
+  return shapes;
+}
+
+/* moves (keys) to its lowest corner, returned in (base), and into the
+   vertex order of its type: the lowest key first and, if the entity is
+   a face, its second key below its last */
+static BoxKeys canonicalize_box_keys(BoxKeys keys, Int* base) {
+  *base = keys[0];
+  for (auto key : keys) *base &= key;
+  for (auto& key : keys) key ^= *base;
+  std::rotate(
+      keys.begin(), std::min_element(keys.begin(), keys.end()), keys.end());
+  if (keys.size() > 2 && keys[1] > keys.back()) {
+    std::reverse(keys.begin() + 1, keys.end());
+  }
+  return keys;
+}
+
+static Int find_box_type(std::vector<BoxKeys> const& types, BoxKeys keys) {
+  for (std::size_t t = 0; t < types.size(); ++t) {
+    if (types[t] == keys) return Int(t);
+  }
+  Omega_h_fail("box entity type not found\n");
+}
+
+/* the alignment code of a use (a) of an entity (b), by the same rules
+   reflect_down uses to match them */
+static I8 get_box_code(BoxKeys const& a, BoxKeys const& b) {
+  auto deg = Int(b.size());
+  Int which_down = 0;
+  while (b[std::size_t(which_down)] != a[0]) ++which_down;
+  if (deg == 2) return make_code(false, which_down, 0);
+  auto at = [&](Int i) { return b[std::size_t((which_down + i) % deg)]; };
+  OMEGA_H_CHECK(deg == 3 || a[2] == at(2));
+  bool is_flipped = (a[1] != at(1));
+  OMEGA_H_CHECK(a[1] == at(is_flipped ? deg - 1 : 1));
+  return make_code(is_flipped, rotation_to_first(deg, which_down), 0);
+}
+
+/* the (low_dim) sides of entities given by keys, as the type of each
+   side, the key of its lowest corner and its alignment code */
+struct BoxDown {
+  LOs types;
+  LOs bases;
+  Read<I8> codes;
+};
+
+static BoxDown get_box_down(Omega_h_Family family, Int high_dim,
+    std::vector<BoxKeys> const& highs, std::vector<BoxKeys> const& lows) {
+  auto nsides = element_degree(family, high_dim, high_dim - 1);
+  auto deg = element_degree(family, high_dim - 1, VERT);
+  auto n = LO(highs.size()) * nsides;
+  HostWrite<LO> types(n);
+  HostWrite<LO> bases(n);
+  HostWrite<I8> codes(n);
+  for (std::size_t h = 0; h < highs.size(); ++h) {
+    for (Int u = 0; u < nsides; ++u) {
+      BoxKeys use;
+      for (Int uv = 0; uv < deg; ++uv) {
+        use.push_back(highs[h][std::size_t(element_down_template(
+            family, high_dim, high_dim - 1, u, uv))]);
+      }
+      Int base;
+      auto keys = canonicalize_box_keys(use, &base);
+      auto t = find_box_type(lows, keys);
+      auto i = LO(h) * nsides + u;
+      types[i] = t;
+      bases[i] = base;
+      for (auto& key : use) key ^= base;
+      codes[i] = get_box_code(use, keys);
+    }
+  }
+  return {LOs(types.write()), LOs(bases.write()), Read<I8>(codes.write())};
+}
+
+/* the number of positions of entities with extents (ext) along each axis,
+   given (n) cells along each axis, with unused axes having zero cells */
+template <typename T>
+OMEGA_H_INLINE T get_box_npositions(Few<T, 3> n, Int ext) {
+  T count = 1;
+  for (Int a = 0; a < 3; ++a) count *= n[a] + 1 - ((ext >> a) & 1);
+  return count;
+}
+
+template <typename T>
+OMEGA_H_INLINE T get_box_position_index(Few<T, 3> p, Few<T, 3> n, Int ext) {
+  T i = 0;
+  for (Int a = 2; a >= 0; --a) i = i * (n[a] + 1 - ((ext >> a) & 1)) + p[a];
+  return i;
+}
+
+OMEGA_H_INLINE Few<LO, 3> get_box_position(LO i, Few<LO, 3> n, Int ext) {
+  Few<LO, 3> p;
+  for (Int a = 0; a < 3; ++a) {
+    auto m = n[a] + 1 - ((ext >> a) & 1);
+    p[a] = i % m;
+    i /= m;
+  }
+  return p;
+}
+
+/* inverse of suggest_slices */
+OMEGA_H_INLINE LO get_box_slice_begin(LO total, I32 nparts, I32 part) {
+  auto quot = total / nparts;
+  auto rem = total % nparts;
+  return quot * part + ((part < rem) ? part : rem);
+}
+
+OMEGA_H_INLINE I32 get_box_slice(LO total, I32 nparts, LO i) {
+  auto quot = total / nparts;
+  auto rem = total % nparts;
+  if (i < rem * (quot + 1)) return I32(i / (quot + 1));
+  return I32(rem + (i - rem * (quot + 1)) / quot);
+}
+
+static LOs get_box_exts(std::vector<BoxKeys> const& types) {
+  HostWrite<LO> exts(LO(types.size()));
+  for (std::size_t t = 0; t < types.size(); ++t) {
+    exts[LO(t)] = 0;
+    for (auto key : types[t]) exts[LO(t)] |= key;
+  }
+  return exts.write();
+}
+
+static void set_box_ents_info(Mesh* mesh, Int ent_dim, Remotes owners,
+    GOs globals, Read<ClassId> class_ids, Read<Byte> class_dims) {
+  if (mesh->comm()->size() > 1) mesh->set_owners(ent_dim, owners);
+  mesh->add_tag(ent_dim, "global", 1, globals);
+  mesh->add_tag<ClassId>(ent_dim, "class_id", 1, class_ids);
+  mesh->add_tag<Byte>(ent_dim, "class_dim", 1, class_dims);
+}
+
+void build_box_block(
+    Mesh* mesh, Vector<3> l, Few<LO, 3> nel, Few<I32, 3> nparts) {
+  OMEGA_H_TIME_FUNCTION;
+  auto comm = mesh->comm();
+  auto family = mesh->family();
+  auto dim = mesh->dim();
+  OMEGA_H_CHECK(nparts[0] * nparts[1] * nparts[2] == comm->size());
+  auto rank = comm->rank();
+  Few<I32, 3> part;
+  part[0] = rank % nparts[0];
+  part[1] = (rank / nparts[0]) % nparts[1];
+  part[2] = rank / (nparts[0] * nparts[1]);
+  Few<LO, 3> begin({0, 0, 0});
+  Few<LO, 3> end({0, 0, 0});
+  Few<GO, 3> nelg({0, 0, 0});
+  bool is_empty = false;
+  for (Int a = 0; a < dim; ++a) {
+    OMEGA_H_CHECK(nel[a] > 0);
+    begin[a] = get_box_slice_begin(nel[a], nparts[a], part[a]);
+    end[a] = get_box_slice_begin(nel[a], nparts[a], part[a] + 1);
+    if (end[a] == begin[a]) is_empty = true;
+    nelg[a] = nel[a];
+  }
+  for (Int a = dim; a < 3; ++a) {
+    OMEGA_H_CHECK(nparts[a] == 1);
+    nel[a] = 0;
+  }
+  Few<LO, 3> ncl;
+  for (Int a = 0; a < 3; ++a) ncl[a] = end[a] - begin[a];
+  LOs cv2v;
+  Reals coords;
+  GOs vert_globals;
+  GOs cell_globals;
+  make_box_block(
+      dim, l, nel, begin, end, &cv2v, &coords, &vert_globals, &cell_globals);
+  auto shapes = get_box_elem_shapes(family, dim);
+  std::vector<BoxKeys> types[3];
+  types[VERT].push_back(BoxKeys({0}));
+  for (Int ent_dim = 1; ent_dim < dim; ++ent_dim) {
+    auto nsides = element_degree(family, dim, ent_dim);
+    auto deg = element_degree(family, ent_dim, VERT);
+    for (auto& shape : shapes) {
+      for (Int u = 0; u < nsides; ++u) {
+        BoxKeys keys;
+        for (Int uv = 0; uv < deg; ++uv) {
+          keys.push_back(shape[std::size_t(
+              element_down_template(family, dim, ent_dim, u, uv))]);
+        }
+        Int base;
+        keys = canonicalize_box_keys(keys, &base);
+        auto& dim_types = types[ent_dim];
+        if (std::find(dim_types.begin(), dim_types.end(), keys) ==
+            dim_types.end()) {
+          dim_types.push_back(keys);
+        }
+      }
+    }
+    std::sort(types[ent_dim].begin(), types[ent_dim].end());
+  }
+  LOs exts[3];
+  for (Int ent_dim = 0; ent_dim < dim; ++ent_dim) {
+    exts[ent_dim] = get_box_exts(types[ent_dim]);
+  }
+  for (Int ent_dim = 0; ent_dim < dim; ++ent_dim) {
+    auto ntypes = Int(types[ent_dim].size());
+    auto h_exts = HostRead<LO>(exts[ent_dim]);
+    LO nents = 0;
+    if (!is_empty) {
+      for (Int t = 0; t < ntypes; ++t) {
+        nents += get_box_npositions(ncl, h_exts[t]);
+      }
+    }
+    auto type_exts = exts[ent_dim];
+    Write<LO> ev2v((ent_dim == EDGE) ? nents * 2 : 0);
+    HostWrite<LO> h_edge_keys((ent_dim == EDGE) ? ntypes * 2 : 0);
+    if (ent_dim == EDGE) {
+      for (Int t = 0; t < ntypes; ++t) {
+        for (Int k = 0; k < 2; ++k) {
+          h_edge_keys[t * 2 + k] = types[EDGE][std::size_t(t)][std::size_t(k)];
+        }
+      }
+    }
+    LOs edge_keys(h_edge_keys.write());
+    BoxDown down;
+    auto nsides =
+        (ent_dim > EDGE) ? element_degree(family, ent_dim, ent_dim - 1) : 0;
+    if (ent_dim > EDGE) {
+      down = get_box_down(family, ent_dim, types[ent_dim], types[ent_dim - 1]);
+    }
+    auto low_exts = (ent_dim > VERT) ? exts[ent_dim - 1] : LOs();
+    Write<LO> hl2l((ent_dim > EDGE) ? nents * nsides : 0);
+    Write<I8> codes((ent_dim > EDGE) ? nents * nsides : 0);
+    Write<I32> owner_ranks(nents);
+    Write<LO> owner_idxs(nents);
+    Write<GO> globals(nents);
+    Write<ClassId> class_ids(nents);
+    Write<Byte> class_dims(nents);
+    auto f = OMEGA_H_LAMBDA(LO e) {
+      Int t = 0;
+      LO i = e;
+      while (i >= get_box_npositions(ncl, type_exts[t])) {
+        i -= get_box_npositions(ncl, type_exts[t]);
+        ++t;
+      }
+      auto ext = type_exts[t];
+      auto p = get_box_position(i, ncl, ext);
+      if (ent_dim == EDGE) {
+        for (Int k = 0; k < 2; ++k) {
+          auto key = edge_keys[t * 2 + k];
+          Few<LO, 3> q;
+          for (Int a = 0; a < 3; ++a) q[a] = p[a] + ((key >> a) & 1);
+          ev2v[e * 2 + k] = get_box_position_index(q, ncl, 0);
+        }
+      } else if (ent_dim > EDGE) {
+        for (Int u = 0; u < nsides; ++u) {
+          auto lt = down.types[t * nsides + u];
+          auto base = down.bases[t * nsides + u];
+          LO l_idx = 0;
+          for (Int t2 = 0; t2 < lt; ++t2) {
+            l_idx += get_box_npositions(ncl, low_exts[t2]);
+          }
+          Few<LO, 3> q;
+          for (Int a = 0; a < 3; ++a) q[a] = p[a] + ((base >> a) & 1);
+          hl2l[e * nsides + u] =
+              l_idx + get_box_position_index(q, ncl, low_exts[lt]);
+          codes[e * nsides + u] = down.codes[t * nsides + u];
+        }
+      }
+      /* the entity is owned by the block holding the cell at or, on the
+         upper boundary, below its lowest corner */
+      Few<GO, 3> gp;
+      Few<I32, 3> owner_part;
+      Few<LO, 3> owner_begin;
+      Few<LO, 3> owner_ncl;
+      Int class_id = 0;
+      Int class_dim = 0;
+      for (Int a = 2; a >= 0; --a) {
+        gp[a] = begin[a] + p[a];
+        owner_part[a] = 0;
+        owner_begin[a] = owner_ncl[a] = 0;
+        if (a >= dim) continue;
+        auto cell = (gp[a] < nel[a]) ? LO(gp[a]) : nel[a] - 1;
+        owner_part[a] = get_box_slice(nel[a], nparts[a], cell);
+        owner_begin[a] = get_box_slice_begin(nel[a], nparts[a], owner_part[a]);
+        owner_ncl[a] =
+            get_box_slice_begin(nel[a], nparts[a], owner_part[a] + 1) -
+            owner_begin[a];
+        Int digit = 1;
+        if (!((ext >> a) & 1)) {
+          if (gp[a] == 0) digit = 0;
+          if (gp[a] == nel[a]) digit = 2;
+        }
+        class_id = class_id * 3 + digit;
+        if (digit == 1) ++class_dim;
+      }
+      GO global = 0;
+      LO owner_idx = 0;
+      for (Int t2 = 0; t2 < t; ++t2) {
+        global += get_box_npositions(nelg, type_exts[t2]);
+        owner_idx += get_box_npositions(owner_ncl, type_exts[t2]);
+      }
+      Few<LO, 3> owner_p;
+      for (Int a = 0; a < 3; ++a) owner_p[a] = LO(gp[a]) - owner_begin[a];
+      globals[e] = global + get_box_position_index(gp, nelg, ext);
+      owner_ranks[e] = owner_part[0] +
+                       nparts[0] * (owner_part[1] + nparts[1] * owner_part[2]);
+      owner_idxs[e] =
+          owner_idx + get_box_position_index(owner_p, owner_ncl, ext);
+      class_ids[e] = class_id;
+      class_dims[e] = Byte(class_dim);
+    };
+    parallel_for(nents, f, "build_box_block(ents)");
+    if (ent_dim == VERT) {
+      mesh->set_verts(nents);
+    } else if (ent_dim == EDGE) {
+      mesh->set_ents(ent_dim, Adj(LOs(ev2v)));
+    } else {
+      mesh->set_ents(ent_dim, Adj(LOs(hl2l), Read<I8>(codes)));
+    }
+    set_box_ents_info(mesh, ent_dim, Remotes(owner_ranks, owner_idxs), globals,
+        class_ids, class_dims);
+  }
+  /* elements are numbered by cell, then by their shape within the cell */
+  auto nshapes = LO(shapes.size());
+  auto ncells = cell_globals.size();
+  auto nelems = ncells * nshapes;
+  GOs elem_globals;
+  if (nshapes == 1) {
+    elem_globals = cell_globals;
+  } else {
+    auto elem_globals_w = Write<GO>(nelems);
+    auto f = OMEGA_H_LAMBDA(LO e) {
+      elem_globals_w[e] = cell_globals[e / nshapes] * nshapes + e % nshapes;
+    };
+    parallel_for(nelems, f, "build_box_block(elem globals)");
+    elem_globals = elem_globals_w;
+  }
+  if (dim == EDGE) {
+    mesh->set_ents(dim, Adj(cv2v));
+  } else {
+    auto down = get_box_down(family, dim, shapes, types[dim - 1]);
+    auto nsides = element_degree(family, dim, dim - 1);
+    auto low_exts = exts[dim - 1];
+    auto cell_ext = (1 << dim) - 1;
+    Write<LO> hl2l(nelems * nsides);
+    Write<I8> codes(nelems * nsides);
+    auto f = OMEGA_H_LAMBDA(LO e) {
+      auto s = e % nshapes;
+      auto p = get_box_position(e / nshapes, ncl, cell_ext);
+      for (Int u = 0; u < nsides; ++u) {
+        auto lt = down.types[s * nsides + u];
+        auto base = down.bases[s * nsides + u];
+        LO l_idx = 0;
+        for (Int t2 = 0; t2 < lt; ++t2) {
+          l_idx += get_box_npositions(ncl, low_exts[t2]);
+        }
+        Few<LO, 3> q;
+        for (Int a = 0; a < 3; ++a) q[a] = p[a] + ((base >> a) & 1);
+        hl2l[e * nsides + u] =
+            l_idx + get_box_position_index(q, ncl, low_exts[lt]);
+        codes[e * nsides + u] = down.codes[s * nsides + u];
+      }
+    };
+    parallel_for(nelems, f, "build_box_block(elems)");
+    mesh->set_ents(dim, Adj(LOs(hl2l), Read<I8>(codes)));
+  }
+  Int interior_id = 0;
+  for (Int a = 0; a < dim; ++a) interior_id = interior_id * 3 + 1;
+  set_box_ents_info(mesh, dim, identity_remotes(comm, nelems), elem_globals,
+      Read<ClassId>(nelems, interior_id), Read<Byte>(nelems, Byte(dim)));
+  mesh->add_coords(coords);
+}
+
 template <Int dim>
 void classify_box_dim(Mesh* mesh, Int ent_dim, Reals centroids,
     Few<LO, 3> nel, Vector<3> const l) {
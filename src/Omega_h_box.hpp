@@ -3,7 +3,9 @@
 
 #include <Omega_h_array.hpp>
 #include <Omega_h_defines.hpp>
+#include <Omega_h_few.hpp>
 #include <Omega_h_mesh.hpp>
+#include <Omega_h_vector.hpp>
 
 namespace Omega_h {
 
@@ -12,6 +14,22 @@ void make_2d_box(
     Real x, Real y, LO nx, LO ny, LOs* qv2v_out, Reals* coords_out);
 void make_3d_box(Real x, Real y, Real z, LO nx, LO ny, LO nz, LOs* hv2v_out,
     Reals* coords_out);
+/* builds the cells [begin, end) of a structured (nel[0] x nel[1] x nel[2])
+   grid of hypercubes spanning the box (l), with vertex and cell global
+   numbers derived from their grid position. Only the first (dim) axes
+   are used. */
+void make_box_block(Int dim, Vector<3> l, Few<LO, 3> nel, Few<LO, 3> begin,
+    Few<LO, 3> end, LOs* cv2v_out, Reals* coords_out, GOs* vert_globals_out,
+    GOs* cell_globals_out);
+/* gives (mesh), whose comm, family and dim are set, its block of a
+   (nparts[0] x nparts[1] x nparts[2]) grid of blocks of the box (l)
+   with (nel) cells along each axis. edges and faces, alignment codes,
+   owners, global numbers and classification are all computed from grid
+   positions rather than derived by matching. */
+void build_box_block(
+    Mesh* mesh, Vector<3> l, Few<LO, 3> nel, Few<I32, 3> nparts);
+/* factors (nparts) into a grid of blocks over the first (dim) axes */
+Few<I32, 3> suggest_box_parts(I32 nparts, Int dim, Few<LO, 3> nel);
 void classify_box(Mesh* mesh, Real x, Real y, Real z, Int nx, Int ny, Int nz);
 ClassSets get_box_class_sets(Int dim);
 
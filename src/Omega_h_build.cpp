@@ -148,6 +148,31 @@ Mesh build_box(CommPtr comm, Omega_h_Family family, Real x, Real y, Real z,
   return mesh;
 }
 
+Mesh build_box_distributed(CommPtr comm, Omega_h_Family family, Real x,
+    Real y, Real z, LO nx, LO ny, LO nz, Few<I32, 3> nparts) {
+  OMEGA_H_TIME_FUNCTION;
+  OMEGA_H_CHECK(nx > 0);
+  OMEGA_H_CHECK(ny >= 0);
+  OMEGA_H_CHECK(nz >= 0);
+  Int dim = (ny == 0) ? 1 : ((nz == 0) ? 2 : 3);
+  auto mesh = Mesh(comm->library());
+  mesh.set_comm(comm);
+  mesh.set_parting(OMEGA_H_ELEM_BASED);
+  mesh.set_family(family);
+  mesh.set_dim(dim);
+  build_box_block(
+      &mesh, Vector<3>({x, y, z}), Few<LO, 3>({nx, ny, nz}), nparts);
+  mesh.class_sets = get_box_class_sets(dim);
+  return mesh;
+}
+
+Mesh build_box_distributed(CommPtr comm, Omega_h_Family family, Real x,
+    Real y, Real z, LO nx, LO ny, LO nz) {
+  Int dim = (ny == 0) ? 1 : ((nz == 0) ? 2 : 3);
+  auto nparts = suggest_box_parts(comm->size(), dim, Few<LO, 3>({nx, ny, nz}));
+  return build_box_distributed(comm, family, x, y, z, nx, ny, nz, nparts);
+}
+
 /* When we try to build a mesh from _partitioned_
    element-to-vertex connectivity only, we have to derive
    consistent edges and faces in parallel.
@@ -3,6 +3,7 @@
 
 #include <Omega_h_array.hpp>
 #include <Omega_h_comm.hpp>
+#include <Omega_h_few.hpp>
 #include <Omega_h_mesh.hpp>
 
 namespace Omega_h {
@@ -25,6 +26,15 @@ Mesh build_box(CommPtr comm, Omega_h_Family family, Real x, Real y, Real z,
     LO nx, LO ny, LO nz, bool symmetric = false);
 void build_box_internal(Mesh* mesh, Omega_h_Family family, Real x, Real y,
     Real z, LO nx, LO ny, LO nz, bool symmetric = false);
+/* builds the same box as build_box, but each rank directly generates
+   one block of a (nparts[0] x nparts[1] x nparts[2]) grid of blocks,
+   e.g. {1, 1, comm->size()} for slabs along Z.
+   nothing is built on one rank and migrated. */
+Mesh build_box_distributed(CommPtr comm, Omega_h_Family family, Real x,
+    Real y, Real z, LO nx, LO ny, LO nz, Few<I32, 3> nparts);
+/* as above, with the blocks chosen by suggest_box_parts */
+Mesh build_box_distributed(CommPtr comm, Omega_h_Family family, Real x,
+    Real y, Real z, LO nx, LO ny, LO nz);
 
 void add_ents2verts(
     Mesh* mesh, Int edim, LOs ev2v, GOs vert_globals, GOs elem_globals = GOs());
@@ -125,6 +125,7 @@ static void coarsen_element_based2(Mesh* mesh, AdaptOpts const& opts) {
   auto new_mesh = mesh->copy_meta();
   auto old_verts2new_verts = LOs();
   auto old_lows2new_lows = LOs();
+  ModifiedEnts modified;
   for (Int ent_dim = 0; ent_dim <= mesh->dim(); ++ent_dim) {
     auto keys2prods = LOs();
     auto prod_verts2verts = LOs();
@@ -144,7 +145,8 @@ static void coarsen_element_based2(Mesh* mesh, AdaptOpts const& opts) {
     auto old_ents2new_ents = LOs();
     modify_ents_adapt(mesh, &new_mesh, ent_dim, VERT, keys2verts, keys2prods,
         prod_verts2verts, old_lows2new_lows, &prods2new_ents,
-        &same_ents2old_ents, &same_ents2new_ents, &old_ents2new_ents);
+        &same_ents2old_ents, &same_ents2new_ents, &old_ents2new_ents,
+        &modified);
     if (ent_dim == VERT) {
       old_verts2new_verts = old_ents2new_ents;
     }
@@ -152,6 +154,7 @@ static void coarsen_element_based2(Mesh* mesh, AdaptOpts const& opts) {
         ent_dim, prods2new_ents, same_ents2old_ents, same_ents2new_ents);
     old_lows2new_lows = old_ents2new_ents;
   }
+  modify_owners_and_globals(mesh, &new_mesh, modified);
   *mesh = new_mesh;
 }
 
@@ -0,0 +1,74 @@
+#include "Omega_h_coloring.hpp"
+
+#include "Omega_h_array_ops.hpp"
+#include "Omega_h_for.hpp"
+#include "Omega_h_mesh.hpp"
+#include "Omega_h_random.hpp"
+
+namespace Omega_h {
+
+namespace {
+
+enum : I32 { UNCOLORED = -1 };
+
+Read<I32> color_locally(LOs xadj, LOs adj, GOs priorities, GOs globals,
+    Read<I32> old_colors) {
+  auto n = xadj.size() - 1;
+  Write<I32> new_colors = deep_copy(old_colors);
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    if (old_colors[v] != UNCOLORED) return;
+    auto begin = xadj[v];
+    auto end = xadj[v + 1];
+    // wait for uncolored neighbors that come first in the random order
+    for (auto j = begin; j < end; ++j) {
+      auto u = adj[j];
+      if (old_colors[u] != UNCOLORED) continue;
+      if (priorities[u] > priorities[v]) return;
+      if (priorities[u] == priorities[v] && globals[u] > globals[v]) return;
+    }
+    // all neighbors that come first are colored, take the smallest free color
+    I32 color = 0;
+    for (auto j = begin; j < end; ++j) {
+      if (old_colors[adj[j]] == color) {
+        ++color;
+        j = begin - 1;
+      }
+    }
+    new_colors[v] = color;
+  };
+  parallel_for(n, std::move(f), "color_locally");
+  return new_colors;
+}
+
+}  // end anonymous namespace
+
+Read<I32> color_graph(
+    Mesh* mesh, Int ent_dim, Graph graph, I64 seed, I64 iteration) {
+  OMEGA_H_TIME_FUNCTION;
+  auto xadj = graph.a2ab;
+  auto adj = graph.ab2b;
+  auto globals = mesh->globals(ent_dim);
+  auto priorities = random_priorities_from_globals(globals, seed, iteration);
+  auto comm = mesh->comm();
+  Read<I32> colors(xadj.size() - 1, UNCOLORED);
+  while (get_min(comm, colors) == UNCOLORED) {
+    colors = color_locally(xadj, adj, priorities, globals, colors);
+    colors = mesh->sync_array(ent_dim, colors, 1);
+  }
+  return colors;
+}
+
+Read<I32> color_ents(Mesh* mesh, Int ent_dim, I64 seed, I64 iteration) {
+  Graph graph;
+  if (ent_dim == mesh->dim()) {
+    OMEGA_H_CHECK(
+        mesh->comm()->size() == 1 || mesh->parting() == OMEGA_H_GHOSTED);
+    graph = mesh->ask_dual();
+  } else {
+    OMEGA_H_CHECK(mesh->owners_have_all_upward(ent_dim));
+    graph = mesh->ask_star(ent_dim);
+  }
+  return color_graph(mesh, ent_dim, graph, seed, iteration);
+}
+
+}  // end namespace Omega_h
@@ -0,0 +1,26 @@
+#ifndef OMEGA_H_COLORING_HPP
+#define OMEGA_H_COLORING_HPP
+
+#include <Omega_h_array.hpp>
+#include <Omega_h_graph.hpp>
+
+namespace Omega_h {
+
+class Mesh;
+
+/* colors the entities so that no two adjacent in (graph) share a color.
+   rounds proceed as in Jones and Plassmann: every uncolored entity whose
+   random_priority() keyed by (seed, global, iteration) beats that of all
+   its uncolored neighbors takes the smallest color none of its neighbors
+   has. the result is the sequential greedy coloring in random order, so
+   it is the same on any number of ranks and uses at most one color more
+   than the largest degree. colors start at zero */
+Read<I32> color_graph(
+    Mesh* mesh, Int ent_dim, Graph graph, I64 seed, I64 iteration = 0);
+/* uses the star of (ent_dim) for lower dimensions and the dual graph
+   for elements, which needs ghosted elements in parallel */
+Read<I32> color_ents(Mesh* mesh, Int ent_dim, I64 seed, I64 iteration = 0);
+
+}  // end namespace Omega_h
+
+#endif
@@ -1,13 +1,28 @@
 #include "Omega_h_comm.hpp"
 
 #include <algorithm>
+#include <cstring>
 #include <string>
 
+#ifndef OMEGA_H_USE_MPI
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#endif
+
 #include "Omega_h_array_ops.hpp"
 #include "Omega_h_int_scan.hpp"
 #include "Omega_h_map.hpp"
 #include "Omega_h_profile.hpp"
 
+#ifndef OMEGA_H_USE_MPI
+#include "Omega_h_malloc.hpp"
+#include "Omega_h_shared_alloc.hpp"
+#endif
+
 #if defined(OMEGA_H_USE_CUDA) && !defined(OMEGA_H_USE_CUDA_AWARE_MPI)
 #include "Omega_h_for.hpp"
 #include "Omega_h_library.hpp"
@@ -19,9 +34,239 @@ namespace Omega_h {
 #define CALL(f) OMEGA_H_CHECK(MPI_SUCCESS == (f))
 #endif
 
+#ifndef OMEGA_H_USE_MPI
+
+/* one rank's buffers in one neighbor exchange. each part moves
+   once both ends are posted, copied by whichever end gets to it */
+struct ThreadMessage {
+  char const* sendbuf;
+  LO const* sdispls;
+  I32 const* dsts;
+  I32 ndsts;
+  char* recvbuf;
+  LO const* rdispls;
+  I32 const* srcs;
+  I32 nsrcs;
+  std::vector<bool> is_sent;  // per destination, set when a copy starts
+  I32 nunsent;                // parts of sendbuf still being copied
+  I32 nunreceived;            // parts of recvbuf not yet filled
+};
+
+/* the shared state of the ranks of one thread communicator */
+struct ThreadGroup {
+  ThreadGroup(std::shared_ptr<std::vector<ThreadTraffic>> traffic_in,
+      std::vector<I32> world_ranks_in);
+  I32 size() const { return I32(world_ranks.size()); }
+  void barrier();
+  /* every rank shows (mine) to the others, which read it in (f)
+     before any rank returns */
+  template <typename F>
+  void share(I32 rank, void const* mine, F const& f);
+  std::shared_ptr<ThreadGroup> split(
+      I32 rank, I32 color, I32 key, I32* new_rank);
+  std::shared_ptr<std::vector<ThreadTraffic>> traffic;
+  std::vector<I32> world_ranks;
+  std::vector<void const*> slots;
+  std::mutex mutex;
+  std::condition_variable changed;
+  I32 nwaiting;
+  I64 generation;
+  /* keyed by rank and exchange number */
+  std::map<std::pair<I32, I64>, ThreadMessage> messages;
+};
+
+ThreadGroup::ThreadGroup(
+    std::shared_ptr<std::vector<ThreadTraffic>> traffic_in,
+    std::vector<I32> world_ranks_in)
+    : traffic(traffic_in),
+      world_ranks(world_ranks_in),
+      slots(world_ranks_in.size(), nullptr),
+      nwaiting(0),
+      generation(0) {}
+
+void ThreadGroup::barrier() {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto my_generation = generation;
+  if (++nwaiting == size()) {
+    nwaiting = 0;
+    ++generation;
+    changed.notify_all();
+  } else {
+    changed.wait(lock, [&]() { return generation != my_generation; });
+  }
+}
+
+template <typename F>
+void ThreadGroup::share(I32 rank, void const* mine, F const& f) {
+  slots[std::size_t(rank)] = mine;
+  barrier();
+  f(slots);
+  barrier();
+}
+
+std::shared_ptr<ThreadGroup> ThreadGroup::split(
+    I32 rank, I32 color, I32 key, I32* new_rank) {
+  I32 const mine[2] = {color, key};
+  std::vector<std::pair<I32, I32>> members;
+  share(rank, mine, [&](std::vector<void const*> const& all) {
+    for (I32 other = 0; other < size(); ++other) {
+      auto theirs = static_cast<I32 const*>(all[std::size_t(other)]);
+      if (theirs[0] == color) members.push_back({theirs[1], other});
+    }
+  });
+  std::sort(members.begin(), members.end());
+  std::vector<I32> member_world_ranks;
+  for (std::size_t i = 0; i < members.size(); ++i) {
+    if (members[i].second == rank) *new_rank = I32(i);
+    member_world_ranks.push_back(
+        world_ranks[std::size_t(members[i].second)]);
+  }
+  auto leader = members[0].second;
+  std::shared_ptr<ThreadGroup> made;
+  if (rank == leader) {
+    made = std::make_shared<ThreadGroup>(traffic, member_world_ranks);
+  }
+  std::shared_ptr<ThreadGroup> out;
+  share(rank, &made, [&](std::vector<void const*> const& all) {
+    out = *static_cast<std::shared_ptr<ThreadGroup> const*>(
+        all[std::size_t(leader)]);
+  });
+  return out;
+}
+
+/* one rank's part in one neighbor exchange. it posts its buffers
+   on construction and copies parts each time it makes progress, so no
+   rank waits on another to call progress, just to post. the other
+   ranks may still be copying to and from the posted buffers, so the
+   exchange completes before it is destroyed */
+class ThreadExchange {
+ public:
+  ThreadExchange(std::shared_ptr<ThreadGroup> group, I32 rank, I64 tag,
+      HostRead<I32> srcs, HostRead<I32> dsts, HostRead<LO> sdispls,
+      HostRead<LO> rdispls, char const* sendbuf, char* recvbuf,
+      std::size_t item_bytes);
+  ~ThreadExchange();
+  bool progress(bool wait);
+
+ private:
+  typedef std::map<std::pair<I32, I64>, ThreadMessage>::iterator Posted;
+  Posted find(I32 rank);
+  void copy(Posted from, I32 j, Posted to, std::unique_lock<std::mutex>& lock);
+  std::shared_ptr<ThreadGroup> group_;
+  I32 rank_;
+  I64 tag_;
+  HostRead<I32> srcs_;
+  HostRead<I32> dsts_;
+  HostRead<LO> sdispls_;
+  HostRead<LO> rdispls_;
+  std::size_t item_bytes_;
+  bool is_done_;
+};
+
+ThreadExchange::ThreadExchange(std::shared_ptr<ThreadGroup> group, I32 rank,
+    I64 tag, HostRead<I32> srcs, HostRead<I32> dsts, HostRead<LO> sdispls,
+    HostRead<LO> rdispls, char const* sendbuf, char* recvbuf,
+    std::size_t item_bytes)
+    : group_(group),
+      rank_(rank),
+      tag_(tag),
+      srcs_(srcs),
+      dsts_(dsts),
+      sdispls_(sdispls),
+      rdispls_(rdispls),
+      item_bytes_(item_bytes),
+      is_done_(false) {
+  auto& traffic =
+      (*group_->traffic)[std::size_t(group_->world_ranks[std::size_t(rank_)])];
+  for (LO i = 0; i < dsts_.size(); ++i) {
+    if (dsts_[i] == rank_) continue;
+    ++traffic.messages;
+    traffic.bytes += I64(sdispls_[i + 1] - sdispls_[i]) * I64(item_bytes_);
+  }
+  ThreadMessage message;
+  message.sendbuf = sendbuf;
+  message.sdispls = sdispls_.data();
+  message.dsts = dsts_.data();
+  message.ndsts = dsts_.size();
+  message.recvbuf = recvbuf;
+  message.rdispls = rdispls_.data();
+  message.srcs = srcs_.data();
+  message.nsrcs = srcs_.size();
+  message.is_sent.assign(std::size_t(dsts_.size()), false);
+  message.nunsent = dsts_.size();
+  message.nunreceived = srcs_.size();
+  std::lock_guard<std::mutex> lock(group_->mutex);
+  auto inserted = group_->messages.insert({{rank_, tag_}, message});
+  OMEGA_H_CHECK(inserted.second);
+  group_->changed.notify_all();
+}
+
+ThreadExchange::~ThreadExchange() { progress(true); }
+
+ThreadExchange::Posted ThreadExchange::find(I32 rank) {
+  return group_->messages.find({rank, tag_});
+}
+
+/* copies the part of (from) bound for its destination j into (to),
+   without holding the lock. neither message can be retired while
+   the part is counted as unsent and unreceived */
+void ThreadExchange::copy(
+    Posted from, I32 j, Posted to, std::unique_lock<std::mutex>& lock) {
+  auto& sender = from->second;
+  auto& receiver = to->second;
+  auto i = I32(std::find(receiver.srcs, receiver.srcs + receiver.nsrcs,
+                   from->first.first) -
+               receiver.srcs);
+  OMEGA_H_CHECK(i < receiver.nsrcs);
+  auto nitems = sender.sdispls[j + 1] - sender.sdispls[j];
+  OMEGA_H_CHECK(nitems == receiver.rdispls[i + 1] - receiver.rdispls[i]);
+  sender.is_sent[std::size_t(j)] = true;
+  auto src = sender.sendbuf + std::size_t(sender.sdispls[j]) * item_bytes_;
+  auto dst = receiver.recvbuf + std::size_t(receiver.rdispls[i]) * item_bytes_;
+  lock.unlock();
+  if (nitems) std::memcpy(dst, src, std::size_t(nitems) * item_bytes_);
+  lock.lock();
+  --sender.nunsent;
+  --receiver.nunreceived;
+  group_->changed.notify_all();
+}
+
+bool ThreadExchange::progress(bool wait) {
+  if (is_done_) return true;
+  std::unique_lock<std::mutex> lock(group_->mutex);
+  auto mine = find(rank_);
+  while (true) {
+    for (LO j = 0; j < dsts_.size(); ++j) {
+      if (mine->second.is_sent[std::size_t(j)]) continue;
+      auto to = find(dsts_[j]);
+      if (to != group_->messages.end()) copy(mine, j, to, lock);
+    }
+    for (LO i = 0; i < srcs_.size(); ++i) {
+      auto from = find(srcs_[i]);
+      if (from == group_->messages.end()) continue;
+      auto& sender = from->second;
+      auto j = I32(std::find(sender.dsts, sender.dsts + sender.ndsts, rank_) -
+                   sender.dsts);
+      OMEGA_H_CHECK(j < sender.ndsts);
+      if (!sender.is_sent[std::size_t(j)]) copy(from, j, mine, lock);
+    }
+    if (mine->second.nunsent == 0 && mine->second.nunreceived == 0) break;
+    if (!wait) return false;
+    group_->changed.wait(lock);
+  }
+  group_->messages.erase(mine);
+  is_done_ = true;
+  return true;
+}
+
+#endif
+
 Comm::Comm() {
 #ifdef OMEGA_H_USE_MPI
   impl_ = MPI_COMM_NULL;
+#else
+  rank_ = 0;
+  nexchanges_ = 0;
 #endif
   library_ = nullptr;
 }
@@ -43,7 +288,7 @@ Comm::Comm(
 #else
 
 Comm::Comm(Library* library_in, bool is_graph, bool sends_to_self)
-    : library_(library_in) {
+    : rank_(0), nexchanges_(0), library_(library_in) {
   if (is_graph) {
     if (sends_to_self) {
       srcs_ = Read<LO>({0});
@@ -59,6 +304,21 @@ Comm::Comm(Library* library_in, bool is_graph, bool sends_to_self)
     OMEGA_H_CHECK(!sends_to_self);
   }
 }
+
+Comm::Comm(
+    Library* library_in, std::shared_ptr<ThreadGroup> group, I32 rank_in)
+    : group_(group), rank_(rank_in), nexchanges_(0), library_(library_in) {}
+
+Comm::Comm(Library* library_in, std::shared_ptr<ThreadGroup> group,
+    I32 rank_in, Read<I32> srcs, Read<I32> dsts)
+    : Comm(library_in, group, rank_in) {
+  srcs_ = srcs;
+  dsts_ = dsts;
+  self_src_ = find_last(srcs_, rank());
+  self_dst_ = find_last(dsts_, rank());
+  host_srcs_ = HostRead<I32>(srcs_);
+  host_dsts_ = HostRead<I32>(dsts_);
+}
 #endif
 
 Comm::~Comm() {
@@ -75,7 +335,7 @@ I32 Comm::rank() const {
   CALL(MPI_Comm_rank(impl_, &r));
   return r;
 #else
-  return 0;
+  return group_ ? rank_ : 0;
 #endif
 }
 
@@ -85,7 +345,7 @@ I32 Comm::size() const {
   CALL(MPI_Comm_size(impl_, &s));
   return s;
 #else
-  return 1;
+  return group_ ? group_->size() : 1;
 #endif
 }
 
@@ -95,6 +355,7 @@ CommPtr Comm::dup() const {
   CALL(MPI_Comm_dup(impl_, &impl2));
   return CommPtr(new Comm(library_, impl2));
 #else
+  if (group_) return split(0, rank_);
   return CommPtr(
       new Comm(library_, srcs_.exists(), srcs_.exists() && srcs_.size() == 1));
 #endif
@@ -106,6 +367,11 @@ CommPtr Comm::split(I32 color, I32 key) const {
   CALL(MPI_Comm_split(impl_, color, key, &impl2));
   return CommPtr(new Comm(library_, impl2));
 #else
+  if (group_) {
+    I32 new_rank;
+    auto group = group_->split(rank_, color, key, &new_rank);
+    return CommPtr(new Comm(library_, group, new_rank));
+  }
   (void)color;
   (void)key;
   return CommPtr(new Comm(library_, false, false));
@@ -171,6 +437,24 @@ CommPtr Comm::graph(Read<I32> dsts) const {
   CALL(MPI_Comm_dup(impl_, &impl2));
   return CommPtr(new Comm(library_, impl2, h_sources.write(), dsts));
 #else
+  if (group_) {
+    HostRead<I32> h_destinations(dsts);
+    std::vector<I32> v_sources;
+    group_->share(rank_, &h_destinations,
+        [&](std::vector<void const*> const& all) {
+          for (I32 other = 0; other < size(); ++other) {
+            auto& theirs = *static_cast<HostRead<I32> const*>(
+                all[std::size_t(other)]);
+            for (LO i = 0; i < theirs.size(); ++i) {
+              if (theirs[i] == rank_) v_sources.push_back(other);
+            }
+          }
+        });
+    HostWrite<I32> h_sources(int(v_sources.size()));
+    for (int i = 0; i < h_sources.size(); ++i)
+      h_sources[i] = v_sources[std::size_t(i)];
+    return graph_adjacent(h_sources.write(), dsts);
+  }
   return CommPtr(new Comm(library_, true, dsts.size() == 1));
 #endif
 }
@@ -181,6 +465,11 @@ CommPtr Comm::graph_adjacent(Read<I32> srcs, Read<I32> dsts) const {
   CALL(MPI_Comm_dup(impl_, &impl2));
   return CommPtr(new Comm(library_, impl2, srcs, dsts));
 #else
+  if (group_) {
+    I32 new_rank;
+    auto group = group_->split(rank_, 0, rank_, &new_rank);
+    return CommPtr(new Comm(library_, group, new_rank, srcs, dsts));
+  }
   OMEGA_H_CHECK(srcs == dsts);
   return CommPtr(new Comm(library_, true, dsts.size() == 1));
 #endif
@@ -194,12 +483,46 @@ Read<I32> Comm::sources() const { return srcs_; }
 
 Read<I32> Comm::destinations() const { return dsts_; }
 
+#ifndef OMEGA_H_USE_MPI
+template <typename T>
+static T apply_op(T a, T b, Omega_h_Op op) {
+  switch (op) {
+    case OMEGA_H_MIN:
+      return min2(a, b);
+    case OMEGA_H_MAX:
+      return max2(a, b);
+    case OMEGA_H_SUM:
+      return a + b;
+  }
+  OMEGA_H_NORETURN(a);
+}
+
+/* reduces entry i of the first (nranks) shared arrays, in rank order
+   so that every rank gets the same result */
+template <typename T>
+static T reduce_shared(std::vector<void const*> const& all, I32 nranks,
+    std::size_t i, Omega_h_Op op) {
+  auto x = static_cast<T const*>(all[0])[i];
+  for (I32 r = 1; r < nranks; ++r) {
+    x = apply_op(x, static_cast<T const*>(all[std::size_t(r)])[i], op);
+  }
+  return x;
+}
+#endif
+
 template <typename T>
 T Comm::allreduce(T x, Omega_h_Op op) const {
 #ifdef OMEGA_H_USE_MPI
   CALL(MPI_Allreduce(
       MPI_IN_PLACE, &x, 1, MpiTraits<T>::datatype(), mpi_op(op), impl_));
 #else
+  if (group_) {
+    T y = x;
+    group_->share(rank_, &x, [&](std::vector<void const*> const& all) {
+      y = reduce_shared<T>(all, size(), 0, op);
+    });
+    return y;
+  }
   (void)op;
 #endif
   return x;
@@ -232,10 +555,69 @@ Int128 Comm::add_int128(Int128 x) const {
   CALL(MPI_Op_create(mpi_add_int128, commute, &op));
   CALL(MPI_Allreduce(MPI_IN_PLACE, &x, sizeof(Int128), MPI_PACKED, op, impl_));
   CALL(MPI_Op_free(&op));
+#else
+  if (group_) {
+    Int128 y = x;
+    group_->share(rank_, &x, [&](std::vector<void const*> const& all) {
+      y = *static_cast<Int128 const*>(all[0]);
+      for (I32 r = 1; r < size(); ++r) {
+        y = y + *static_cast<Int128 const*>(all[std::size_t(r)]);
+      }
+    });
+    return y;
+  }
 #endif
   return x;
 }
 
+#ifdef OMEGA_H_USE_MPI
+/* the buffer is one element of a contiguous type, so MPI never splits
+   it. its first entry holds the number of entries (after itself) that
+   are summed; the rest are maximized */
+static void mpi_sum_max(void* a, void* b, int* len, MPI_Datatype* type) {
+  int type_size;
+  MPI_Type_size(*type, &type_size);
+  auto n = type_size / int(sizeof(Real));
+  for (int e = 0; e < *len; ++e) {
+    Real* a2 = static_cast<Real*>(a) + e * n;
+    Real* b2 = static_cast<Real*>(b) + e * n;
+    auto nsums = static_cast<int>(a2[0]);
+    for (int i = 1; i <= nsums; ++i) b2[i] += a2[i];
+    for (int i = nsums + 1; i < n; ++i) b2[i] = max2(a2[i], b2[i]);
+  }
+}
+#endif
+
+void Comm::allreduce_sum_max(std::vector<Real>& x, Int nsums) const {
+  OMEGA_H_CHECK(0 <= nsums && std::size_t(nsums) <= x.size());
+#ifdef OMEGA_H_USE_MPI
+  std::vector<Real> buf(x.size() + 1);
+  buf[0] = Real(nsums);
+  std::copy(x.begin(), x.end(), buf.begin() + 1);
+  MPI_Datatype type;
+  CALL(MPI_Type_contiguous(int(buf.size()), MPI_DOUBLE, &type));
+  CALL(MPI_Type_commit(&type));
+  MPI_Op op;
+  int commute = true;
+  CALL(MPI_Op_create(mpi_sum_max, commute, &op));
+  CALL(MPI_Allreduce(MPI_IN_PLACE, buf.data(), 1, type, op, impl_));
+  CALL(MPI_Op_free(&op));
+  CALL(MPI_Type_free(&type));
+  std::copy(buf.begin() + 1, buf.end(), x.begin());
+#else
+  if (group_) {
+    auto y = x;
+    group_->share(rank_, x.data(), [&](std::vector<void const*> const& all) {
+      for (std::size_t i = 0; i < x.size(); ++i) {
+        auto op = (Int(i) < nsums) ? OMEGA_H_SUM : OMEGA_H_MAX;
+        y[i] = reduce_shared<Real>(all, size(), i, op);
+      }
+    });
+    x = y;
+  }
+#endif
+}
+
 template <typename T>
 T Comm::exscan(T x, Omega_h_Op op) const {
 #ifdef OMEGA_H_USE_MPI
@@ -244,18 +626,74 @@ T Comm::exscan(T x, Omega_h_Op op) const {
   if (rank() == 0) x = 0;
   return x;
 #else
+  if (group_) {
+    T y = 0;
+    group_->share(rank_, &x, [&](std::vector<void const*> const& all) {
+      if (rank_ > 0) y = reduce_shared<T>(all, rank_, 0, op);
+    });
+    return y;
+  }
   (void)op;
   (void)x;
   return 0;
 #endif
 }
 
+template <typename T>
+std::vector<T> Comm::allreduce(std::vector<T> x, Omega_h_Op op) const {
+#ifdef OMEGA_H_USE_MPI
+  CALL(MPI_Allreduce(MPI_IN_PLACE, x.data(), int(x.size()),
+      MpiTraits<T>::datatype(), mpi_op(op), impl_));
+#else
+  if (group_) {
+    auto y = x;
+    group_->share(rank_, x.data(), [&](std::vector<void const*> const& all) {
+      for (std::size_t i = 0; i < x.size(); ++i) {
+        y[i] = reduce_shared<T>(all, size(), i, op);
+      }
+    });
+    return y;
+  }
+  (void)op;
+#endif
+  return x;
+}
+
+template <typename T>
+std::vector<T> Comm::exscan(std::vector<T> x, Omega_h_Op op) const {
+#ifdef OMEGA_H_USE_MPI
+  CALL(MPI_Exscan(MPI_IN_PLACE, x.data(), int(x.size()),
+      MpiTraits<T>::datatype(), mpi_op(op), impl_));
+  if (rank() == 0) std::fill(x.begin(), x.end(), T(0));
+#else
+  if (group_) {
+    auto y = std::vector<T>(x.size(), T(0));
+    group_->share(rank_, x.data(), [&](std::vector<void const*> const& all) {
+      if (rank_ == 0) return;
+      for (std::size_t i = 0; i < x.size(); ++i) {
+        y[i] = reduce_shared<T>(all, rank_, i, op);
+      }
+    });
+    return y;
+  }
+  (void)op;
+  std::fill(x.begin(), x.end(), T(0));
+#endif
+  return x;
+}
+
 template <typename T>
 void Comm::bcast(T& x) const {
 #ifdef OMEGA_H_USE_MPI
   CALL(MPI_Bcast(&x, 1, MpiTraits<T>::datatype(), 0, impl_));
 #else
-  (void)x;
+  if (group_) {
+    T y = x;
+    group_->share(rank_, &x, [&](std::vector<void const*> const& all) {
+      y = *static_cast<T const*>(all[0]);
+    });
+    x = y;
+  }
 #endif
 }
 
@@ -266,7 +704,13 @@ void Comm::bcast_string(std::string& s) const {
   s.resize(static_cast<std::size_t>(len));
   CALL(MPI_Bcast(&s[0], len, MPI_CHAR, 0, impl_));
 #else
-  (void)s;
+  if (group_) {
+    auto t = s;
+    group_->share(rank_, &s, [&](std::vector<void const*> const& all) {
+      t = *static_cast<std::string const*>(all[0]);
+    });
+    s = t;
+  }
 #endif
 }
 
@@ -372,6 +816,7 @@ Read<T> Comm::allgather(T x) const {
       MpiTraits<T>::datatype(), impl_));
   return recvbuf.write();
 #else
+  if (group_) return alltoall(Read<T>(dsts_.size(), x));
   if (srcs_.size() == 1) return Read<T>({x});
   return Read<T>({});
 #endif
@@ -387,6 +832,11 @@ Read<T> Comm::alltoall(Read<T> x) const {
       MpiTraits<T>::datatype(), impl_));
   return recvbuf.write();
 #else
+  if (group_) {
+    auto sdispls = LOs(dsts_.size() + 1, 0, 1);
+    auto rdispls = LOs(srcs_.size() + 1, 0, 1);
+    return alltoallv(x, sdispls, rdispls, 1);
+  }
   return x;
 #endif
 }
@@ -474,7 +924,7 @@ void self_send_part2(Read<T> self_data, LO self_src, Read<T>* p_recvbuf,
 template <typename T>
 Future<T> Comm::ialltoallv(Read<T> sendbuf_dev, Read<LO> sdispls_dev,
     Read<LO> rdispls_dev, Int width) const {
-  ScopedTimer timer("Comm::ialltoallv");
+  OMEGA_H_TIME_REGION("Comm::ialltoallv");
 #ifdef OMEGA_H_USE_MPI
 #if defined(OMEGA_H_USE_CUDA) && !defined(OMEGA_H_USE_CUDA_AWARE_MPI)
   auto self_data = self_send_part1(self_dst_, self_src_, &sendbuf_dev,
@@ -509,6 +959,32 @@ Future<T> Comm::ialltoallv(Read<T> sendbuf_dev, Read<LO> sdispls_dev,
   return {sendbuf_dev, recvbuf_dev_w, std::move(reqs)};
 #endif  // !defined(OMEGA_H_USE_CUDA) || defined(OMEGA_H_USE_CUDA_AWARE_MPI)
 #else   // !defined(OMEGA_H_USE_MPI)
+  if (group_) {
+    HostRead<LO> sdispls(sdispls_dev);
+    HostRead<LO> rdispls(rdispls_dev);
+    OMEGA_H_CHECK(sendbuf_dev.size() == sdispls.last() * width);
+    /* the request keeps both buffers alive until the exchange is
+       done, which is destroyed first since it is declared last */
+    struct Posted {
+      HostRead<T> sendbuf;
+      HostWrite<T> recvbuf;
+      std::unique_ptr<ThreadExchange> exchange;
+    };
+    auto posted = std::make_shared<Posted>();
+    posted->sendbuf = HostRead<T>(sendbuf_dev);
+    posted->recvbuf = HostWrite<T>(rdispls.last() * width);
+    posted->exchange.reset(new ThreadExchange(group_, rank_, nexchanges_++,
+        host_srcs_, host_dsts_, sdispls, rdispls,
+        reinterpret_cast<char const*>(nonnull(posted->sendbuf.data())),
+        reinterpret_cast<char*>(nonnull(posted->recvbuf.data())),
+        sizeof(T) * std::size_t(width)));
+    auto request = [posted](bool wait) {
+      return posted->exchange->progress(wait);
+    };
+    auto recvbuf = posted->recvbuf;
+    auto callback = [recvbuf](Write<T>) -> Read<T> { return recvbuf.write(); };
+    return {sendbuf_dev, Write<T>(), {request}, callback};
+  }
   (void)sdispls_dev;
   (void)rdispls_dev;
   (void)width;
@@ -519,7 +995,7 @@ Future<T> Comm::ialltoallv(Read<T> sendbuf_dev, Read<LO> sdispls_dev,
 template <typename T>
 Read<T> Comm::alltoallv(Read<T> sendbuf_dev, Read<LO> sdispls_dev,
     Read<LO> rdispls_dev, Int width) const {
-  ScopedTimer timer("Comm::alltoallv");
+  OMEGA_H_TIME_REGION("Comm::alltoallv");
 #ifdef OMEGA_H_USE_MPI
 #if defined(OMEGA_H_USE_CUDA) && !defined(OMEGA_H_USE_CUDA_AWARE_MPI)
   auto self_data = self_send_part1(self_dst_, self_src_, &sendbuf_dev,
@@ -552,6 +1028,9 @@ Read<T> Comm::alltoallv(Read<T> sendbuf_dev, Read<LO> sdispls_dev,
   Read<T> recvbuf_dev = recvbuf_dev_w;
 #endif  // !defined(OMEGA_H_USE_CUDA) || defined(OMEGA_H_USE_CUDA_AWARE_MPI)
 #else   // !defined(OMEGA_H_USE_MPI)
+  if (group_) {
+    return ialltoallv(sendbuf_dev, sdispls_dev, rdispls_dev, width).get();
+  }
   (void)sdispls_dev;
   (void)rdispls_dev;
   (void)width;
@@ -563,14 +1042,57 @@ Read<T> Comm::alltoallv(Read<T> sendbuf_dev, Read<LO> sdispls_dev,
 void Comm::barrier() const {
 #ifdef OMEGA_H_USE_MPI
   CALL(MPI_Barrier(impl_));
+#else
+  if (group_) group_->barrier();
+#endif
+}
+
+#ifndef OMEGA_H_USE_MPI
+static void run_thread_rank(
+    CommPtr world, std::function<void(CommPtr)> const& f, bool is_timing) {
+  profile::History history;
+  if (is_timing) profile::global_singleton_history = &history;
+  f(world);
+  if (is_timing) {
+    profile::global_singleton_history = nullptr;
+    auto reduced = profile::reduce_history(history, world);
+    if (world->rank() == 0) profile::print_time_sorted(reduced);
+  }
+}
+
+std::vector<ThreadTraffic> run_thread_ranks(
+    Library* library, I32 nranks, std::function<void(CommPtr)> const& f) {
+#ifdef _MSC_VER
+  Omega_h_fail("run_thread_ranks needs thread-local globals\n");
 #endif
+  OMEGA_H_CHECK(nranks >= 1);
+  OMEGA_H_CHECK(global_allocs == nullptr);
+  OMEGA_H_CHECK(!is_pooling_enabled());
+  auto traffic = std::make_shared<std::vector<ThreadTraffic>>(
+      std::size_t(nranks), ThreadTraffic{0, 0});
+  std::vector<I32> world_ranks(static_cast<std::size_t>(nranks));
+  std::iota(world_ranks.begin(), world_ranks.end(), 0);
+  auto group = std::make_shared<ThreadGroup>(traffic, world_ranks);
+  auto caller_history = profile::global_singleton_history;
+  auto is_timing = caller_history && !caller_history->is_sampling;
+  std::vector<std::thread> threads;
+  for (I32 rank = 0; rank < nranks; ++rank) {
+    auto world = CommPtr(new Comm(library, group, rank));
+    threads.emplace_back(run_thread_rank, world, std::cref(f), is_timing);
+  }
+  for (auto& thread : threads) thread.join();
+  return *traffic;
 }
+#endif
 
 #undef CALL
 
 #define INST(T)                                                                \
   template T Comm::allreduce(T x, Omega_h_Op op) const;                        \
   template T Comm::exscan(T x, Omega_h_Op op) const;                           \
+  template std::vector<T> Comm::allreduce(std::vector<T> x, Omega_h_Op op)     \
+      const;                                                                   \
+  template std::vector<T> Comm::exscan(std::vector<T> x, Omega_h_Op op) const; \
   template void Comm::bcast(T& x) const;                                       \
   template Read<T> Comm::allgather(T x) const;                                 \
   template Read<T> Comm::alltoall(Read<T> x) const;                            \
@@ -1,7 +1,9 @@
 #ifndef OMEGA_H_COMM_HPP
 #define OMEGA_H_COMM_HPP
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include <Omega_h_mpi.h>
 #include <Omega_h_array.hpp>
@@ -25,9 +27,19 @@ class Comm;
 
 typedef std::shared_ptr<Comm> CommPtr;
 
+#ifndef OMEGA_H_USE_MPI
+struct ThreadGroup;
+#endif
+
 class Comm {
 #ifdef OMEGA_H_USE_MPI
   MPI_Comm impl_;
+#else
+  /* only set for the ranks run as threads by run_thread_ranks */
+  std::shared_ptr<ThreadGroup> group_;
+  I32 rank_;
+  /* numbers the neighbor exchanges, which all ranks make in order */
+  mutable I64 nexchanges_;
 #endif
   Library* library_;
   Read<I32> srcs_;
@@ -45,6 +57,9 @@ class Comm {
   MPI_Comm get_impl() const { return impl_; }
 #else
   Comm(Library* library, bool is_graph, bool sends_to_self);
+  Comm(Library* library, std::shared_ptr<ThreadGroup> group, I32 rank);
+  Comm(Library* library, std::shared_ptr<ThreadGroup> group, I32 rank,
+      Read<I32> srcs, Read<I32> dsts);
 #endif
   Comm(Comm const&) = delete;
   Comm(Comm&&) = delete;
@@ -66,8 +81,16 @@ class Comm {
   bool reduce_or(bool x) const;
   bool reduce_and(bool x) const;
   Int128 add_int128(Int128 x) const;
+  /* sums the first nsums entries of x and takes the maximum of the
+     remaining ones, in a single collective */
+  void allreduce_sum_max(std::vector<Real>& x, Int nsums) const;
   template <typename T>
   T exscan(T x, Omega_h_Op op) const;
+  /* elementwise versions: one collective for the whole vector */
+  template <typename T>
+  std::vector<T> allreduce(std::vector<T> x, Omega_h_Op op) const;
+  template <typename T>
+  std::vector<T> exscan(std::vector<T> x, Omega_h_Op op) const;
   template <typename T>
   void bcast(T& x) const;
   void bcast_string(std::string& s) const;
@@ -84,6 +107,24 @@ class Comm {
   void barrier() const;
 };
 
+#ifndef OMEGA_H_USE_MPI
+/* what one rank sent to the other ranks in neighbor exchanges */
+struct ThreadTraffic {
+  I64 messages;
+  I64 bytes;
+};
+
+/* runs f on (nranks) threads of this process, each given the world
+   communicator of one virtual rank, so that the distributed code paths
+   can be tested and profiled without MPI. neighbor exchanges copy once,
+   straight from the sender's buffer into the receiver's.
+   memory pooling and allocation tracking must be off; if the calling
+   thread is timing, each rank times itself and rank 0 prints the
+   reduced profile. returns the traffic of each rank */
+std::vector<ThreadTraffic> run_thread_ranks(
+    Library* library, I32 nranks, std::function<void(CommPtr)> const& f);
+#endif
+
 #ifdef OMEGA_H_USE_MPI
 
 #ifdef OMPI_MPI_H
@@ -150,6 +191,10 @@ inline MPI_Op mpi_op(Omega_h_Op op) {
 #define OMEGA_H_EXPL_INST_DECL(T)                                              \
   extern template T Comm::allreduce(T x, Omega_h_Op op) const;                 \
   extern template T Comm::exscan(T x, Omega_h_Op op) const;                    \
+  extern template std::vector<T> Comm::allreduce(                              \
+      std::vector<T> x, Omega_h_Op op) const;                                  \
+  extern template std::vector<T> Comm::exscan(std::vector<T> x, Omega_h_Op op) \
+      const;                                                                   \
   extern template void Comm::bcast(T& x) const;                                \
   extern template Read<T> Comm::allgather(T x) const;                          \
   extern template Read<T> Comm::alltoall(Read<T> x) const;                     \
@@ -107,7 +107,7 @@ Dist Dist::invert() const {
 
 template <typename T>
 Read<T> Dist::exch(Read<T> data, Int width) const {
-  ScopedTimer exch_timer("Dist::exch");
+  OMEGA_H_TIME_REGION("Dist::exch");
   if (roots2items_[F].exists()) {
     data = expand(data, roots2items_[F], width);
   }
@@ -123,7 +123,7 @@ Read<T> Dist::exch(Read<T> data, Int width) const {
 
 template <typename T>
 Future<T> Dist::iexch(Read<T> data, Int width) const {
-  ScopedTimer exch_timer("Dist::iexch");
+  OMEGA_H_TIME_REGION("Dist::iexch");
   if (roots2items_[F].exists()) {
     data = expand(data, roots2items_[F], width);
   }
@@ -131,9 +131,11 @@ Future<T> Dist::iexch(Read<T> data, Int width) const {
     data = permute(data, items2content_[F], width);
   }
   auto future = comm_[F]->ialltoallv(data, msgs2content_[F], msgs2content_[R], width);
-  auto callback = [this,width](Read<T> buf) {
-    if (this->items2content_[R].exists()) {
-      buf = unmap(this->items2content_[R], buf, width);
+  // capture by value: the Dist may be a temporary that dies before completion
+  auto rcontent = items2content_[R];
+  auto callback = [rcontent, width](Read<T> buf) {
+    if (rcontent.exists()) {
+      buf = unmap(rcontent, buf, width);
     }
     return buf;
   };
@@ -1,5 +1,8 @@
 #include <Omega_h_dolfin.hpp>
 
+#include <algorithm>
+#include <map>
+#include <set>
 #include <vector>
 
 #include <Omega_h_adj.hpp>
@@ -7,78 +10,95 @@
 #include <Omega_h_for.hpp>
 #include <Omega_h_map.hpp>
 #include <Omega_h_mesh.hpp>
+#include <Omega_h_owners.hpp>
 #include <Omega_h_scan.hpp>
 #include <Omega_h_shape.hpp>
 
 namespace Omega_h {
 
-static void form_sharing(Mesh* mesh_osh, Int ent_dim,
-    std::map<std::int32_t, std::set<unsigned int>>* shared_ents) {
-  auto n = mesh_osh->nents(ent_dim);
-  if (!mesh_osh->could_be_shared(ent_dim)) {
-    return;
-  }
-  auto dist = mesh_osh->ask_dist(ent_dim).invert();
-  auto d_owners2copies = dist.roots2items();
-  auto d_copies2rank = dist.items2ranks();
-  auto d_copies2indices = dist.items2dest_idxs();
-  auto h_owners2copies = HostRead<LO>(d_owners2copies);
-  auto h_copies2rank = HostRead<I32>(d_copies2rank);
-  auto h_copies2indices = HostRead<LO>(d_copies2indices);
-  std::vector<I32> full_src_ranks;
-  std::vector<I32> full_dest_ranks;
-  std::vector<LO> full_dest_indices;
-  auto my_rank = mesh_osh->comm()->rank();
-  for (LO i_osh = 0; i_osh < n; ++i_osh) {
-    auto begin = h_owners2copies[i_osh];
-    auto end = h_owners2copies[i_osh + 1];
-    if (end - begin <= 1) continue;
-    for (LO copy = begin; copy < end; ++copy) {
-      auto dest_rank = h_copies2rank[copy];
-      auto dest_index = h_copies2indices[copy];
-      for (LO copy2 = begin; copy2 < end; ++copy2) {
-        auto src_rank = h_copies2rank[copy2];
-        full_src_ranks.push_back(src_rank);
-        full_dest_ranks.push_back(dest_rank);
-        full_dest_indices.push_back(dest_index);
-      }
+/* the ranks sharing each vertex come straight from the owners,
+   entities are keyed in increasing order so the map fills in one pass */
+static std::map<std::int32_t, std::set<unsigned int>> form_sharing(
+    Mesh* mesh_osh, Int ent_dim) {
+  std::map<std::int32_t, std::set<unsigned int>> shared_ents;
+  if (!mesh_osh->could_be_shared(ent_dim)) return shared_ents;
+  auto sharers = get_sharers(mesh_osh, ent_dim);
+  auto h_ents2sharers = HostRead<LO>(sharers.a2ab);
+  auto h_sharers = HostRead<I32>(sharers.ab2b);
+  for (LO i = 0; i < mesh_osh->nents(ent_dim); ++i) {
+    auto begin = h_ents2sharers[i];
+    auto end = h_ents2sharers[i + 1];
+    if (begin == end) continue;
+    auto& ranks = shared_ents.emplace_hint(shared_ents.end(), i,
+                                  std::set<unsigned int>())
+                      ->second;
+    for (auto j = begin; j < end; ++j) {
+      ranks.insert(ranks.end(), unsigned(h_sharers[j]));
     }
   }
-  auto h_full_src_ranks = HostWrite<I32>(LO(full_src_ranks.size()));
-  auto h_full_dest_ranks = HostWrite<I32>(LO(full_src_ranks.size()));
-  auto h_full_dest_indices = HostWrite<I32>(LO(full_dest_indices.size()));
-  for (LO i = 0; i < h_full_src_ranks.size(); ++i) {
-    h_full_src_ranks[i] = full_src_ranks[size_t(i)];
-    h_full_dest_ranks[i] = full_dest_ranks[size_t(i)];
-    h_full_dest_indices[i] = full_dest_indices[size_t(i)];
-  }
-  auto d_full_src_ranks = Read<I32>(h_full_src_ranks.write());
-  auto d_full_dest_ranks = Read<I32>(h_full_dest_ranks.write());
-  auto d_full_dest_indices = Read<I32>(h_full_dest_indices.write());
-  auto dist2 = Dist();
-  dist2.set_parent_comm(mesh_osh->comm());
-  dist2.set_dest_ranks(d_full_dest_ranks);
-  dist2.set_dest_idxs(d_full_dest_indices, n);
-  auto d_exchd_full_src_ranks = dist2.exch(d_full_src_ranks, 1);
-  auto d_shared2ranks = dist2.invert().roots2items();
-  auto h_exchd_full_src_ranks = HostRead<I32>(d_exchd_full_src_ranks);
-  auto h_shared2ranks = HostRead<LO>(d_shared2ranks);
-  auto ents_are_shared_w = HostWrite<Byte>(n);
-  for (LO i_osh = 0; i_osh < n; ++i_osh) {
-    auto begin = h_shared2ranks[i_osh];
-    auto end = h_shared2ranks[i_osh + 1];
-    ents_are_shared_w[i_osh] = ((end - begin) > 0);
+  return shared_ents;
+}
+
+/* number of cells across all ranks adjacent to each side.
+   without element ghosts, a side on a partition boundary has one
+   cell on each of two ranks */
+static HostRead<I32> get_global_side_cells(Mesh* mesh_osh) {
+  auto dim = mesh_osh->dim();
+  auto sides2cells = mesh_osh->ask_up(dim - 1, dim).a2ab;
+  auto counts = get_degrees(sides2cells);
+  if (mesh_osh->could_be_shared(dim - 1)) {
+    counts = mesh_osh->reduce_array(dim - 1, counts, 1, OMEGA_H_SUM);
+    counts = mesh_osh->sync_array(dim - 1, counts, 1);
   }
-  for (LO i_osh = 0; i_osh < n; ++i_osh) {
-    auto begin = h_shared2ranks[i_osh];
-    auto end = h_shared2ranks[i_osh + 1];
-    for (auto j = begin; j < end; ++j) {
-      auto rank = h_exchd_full_src_ranks[j];
-      if (rank != my_rank) {
-        (*shared_ents)[i_osh].insert(unsigned(rank));
+  return HostRead<I32>(counts);
+}
+
+/* DOLFIN numbers facets on its own, but its vertices are ours,
+   so a facet is found as the side of its first vertex having
+   all the same vertices */
+static void init_facet_cell_connections(
+    dolfin::Mesh& mesh_dolfin, Mesh* mesh_osh) {
+  auto dim = mesh_osh->dim();
+  mesh_dolfin.init(std::size_t(dim - 1), std::size_t(dim));
+  auto& topology = mesh_dolfin.topology();
+  auto nfacets = LO(topology.size(std::size_t(dim - 1)));
+  auto h_side_cells = get_global_side_cells(mesh_osh);
+  std::vector<unsigned int> facet_cells(std::size_t(nfacets), 0);
+  if (dim == 1) {
+    for (LO f = 0; f < nfacets; ++f) facet_cells[f] = unsigned(h_side_cells[f]);
+  } else {
+    auto& facet_verts = topology(std::size_t(dim - 1), VERT);
+    auto verts2sides = mesh_osh->ask_up(VERT, dim - 1);
+    auto h_verts2sides = HostRead<LO>(verts2sides.a2ab);
+    auto h_vert_sides = HostRead<LO>(verts2sides.ab2b);
+    auto h_side_verts = HostRead<LO>(mesh_osh->ask_verts_of(dim - 1));
+    for (LO f = 0; f < nfacets; ++f) {
+      auto fv = facet_verts(std::size_t(f));
+      auto v = LO(fv[0]);
+      bool found = false;
+      for (auto vs = h_verts2sides[v]; vs < h_verts2sides[v + 1]; ++vs) {
+        auto s = h_vert_sides[vs];
+        bool is_same = true;
+        for (Int i = 0; i < dim; ++i) {
+          bool has_vert = false;
+          for (Int j = 0; j < dim; ++j) {
+            has_vert = has_vert || (h_side_verts[s * dim + j] == LO(fv[i]));
+          }
+          is_same = is_same && has_vert;
+        }
+        if (is_same) {
+          facet_cells[f] = unsigned(h_side_cells[s]);
+          found = true;
+          break;
+        }
+      }
+      if (!found) {
+        Omega_h_fail("DOLFIN facet %d matches no Omega_h side\n", f);
       }
     }
   }
+  topology(std::size_t(dim - 1), std::size_t(dim))
+      .set_global_size(facet_cells);
 }
 
 void to_dolfin(dolfin::Mesh& mesh_dolfin, Mesh* mesh_osh) {
@@ -87,38 +107,32 @@ void to_dolfin(dolfin::Mesh& mesh_dolfin, Mesh* mesh_osh) {
       "point", "interval", "triangle", "tetrahedron"};
   auto dim = mesh_osh->dim();
   OMEGA_H_CHECK(mesh_osh->parting() == OMEGA_H_ELEM_BASED);
-  std::map<std::int32_t, std::set<unsigned int>> shared_verts;
-  form_sharing(mesh_osh, VERT, &shared_verts);
   editor.open(mesh_dolfin, cell_type_names[dim], dim, dim);
   auto nverts = mesh_osh->nverts();
   auto nverts_global = mesh_osh->nglobal_ents(VERT);
   editor.init_vertices_global(nverts, nverts_global);
-  auto d_vert_globals = mesh_osh->globals(VERT);
-  auto h_vert_globals = HostRead<GO>(d_vert_globals);
-  auto d_coords = mesh_osh->coords();
-  auto h_coords = HostRead<Real>(d_coords);
-  for (LO i_osh = 0; i_osh < nverts; ++i_osh) {
-    editor.add_vertex_global(i_osh, h_vert_globals[i_osh],
-        dolfin::Point(dim, &h_coords[i_osh * dim]));
+  /* each array comes to the host once; the entities then go through
+     the editor, which keeps its own bookkeeping consistent */
+  auto h_vert_globals = HostRead<GO>(mesh_osh->globals(VERT));
+  auto h_coords = HostRead<Real>(mesh_osh->coords());
+  for (LO i = 0; i < nverts; ++i) {
+    editor.add_vertex_global(std::size_t(i), h_vert_globals[i],
+        dolfin::Point(std::size_t(dim), h_coords.data() + i * dim));
   }
   auto ncells = mesh_osh->nelems();
   auto ncells_global = mesh_osh->nglobal_ents(dim);
   editor.init_cells_global(ncells, ncells_global);
-  auto d_cell_globals = mesh_osh->globals(dim);
-  auto h_cell_globals = HostRead<GO>(d_cell_globals);
-  auto d_conn = mesh_osh->ask_elem_verts();
-  auto h_conn = HostRead<LO>(d_conn);
+  auto h_cell_globals = HostRead<GO>(mesh_osh->globals(dim));
+  auto h_conn = HostRead<LO>(mesh_osh->ask_elem_verts());
   auto nverts_per_cell = dim + 1;
-  /* this type needs to have .size(), .begin(), and .end().
-     could have templated on dimension, but there is no threading
-     here so its okay to just allocate it once. */
-  std::vector<LO> cell_verts(nverts_per_cell);
+  std::vector<std::size_t> cell_verts(
+      static_cast<std::size_t>(nverts_per_cell));
   for (LO i = 0; i < ncells; ++i) {
-    for (LO j = 0; j < (nverts_per_cell); ++j) {
-      auto vert_osh = h_conn[i * (nverts_per_cell) + j];
-      cell_verts[j] = vert_osh;
+    for (Int j = 0; j < nverts_per_cell; ++j) {
+      cell_verts[std::size_t(j)] =
+          std::size_t(h_conn[i * nverts_per_cell + j]);
     }
-    editor.add_cell(i, h_cell_globals[i], cell_verts);
+    editor.add_cell(std::size_t(i), h_cell_globals[i], cell_verts);
   }
   /* the reordering in question is local to each cell,
      and among other things it requires the vertices of
@@ -127,20 +141,22 @@ void to_dolfin(dolfin::Mesh& mesh_dolfin, Mesh* mesh_osh) {
   bool should_reorder = true;
   editor.close(should_reorder);
 
+  auto& topology = mesh_dolfin.topology();
+
   // Set the ghost cell offset
-  mesh_dolfin.topology().init_ghost(dim, size_t(ncells));
+  topology.init_ghost(dim, size_t(ncells));
 
   // Set the ghost vertex offset
-  mesh_dolfin.topology().init_ghost(0, size_t(nverts));
+  topology.init_ghost(0, size_t(nverts));
 
   // Assign map of shared cells and vertices
-  mesh_dolfin.topology().shared_entities(0) = shared_verts;
+  topology.shared_entities(0) = form_sharing(mesh_osh, VERT);
 
   // Initialise number of globally connected cells to each facet. This
   // is necessary to distinguish between facets on an exterior
   // boundary and facets on a partition boundary (see
   // https://bugs.launchpad.net/dolfin/+bug/733834).
-  dolfin::DistributedMeshTools::init_facet_cell_connections(mesh_dolfin);
+  init_facet_cell_connections(mesh_dolfin, mesh_osh);
 }
 
 /* due to their "UFC order" which requires vertices of a cell
@@ -181,26 +197,24 @@ void from_dolfin(Mesh* mesh_osh, dolfin::Mesh const& mesh_dolfin) {
   auto nelems = LO(topology.size(dim));
   auto& coords_dolfin = geometry.x();
   auto h_coords = HostWrite<Real>(nverts * dim);
-  for (LO i = 0; i < nverts * dim; ++i) {
-    h_coords[i] = coords_dolfin[i];
-  }
+  std::copy(coords_dolfin.begin(), coords_dolfin.begin() + nverts * dim,
+      h_coords.data());
   auto d_coords = Reals(h_coords.write());
   auto& vert_globals_dolfin = topology.global_indices(VERT);
   auto h_vert_globals = HostWrite<GO>(nverts);
-  for (LO i = 0; i < nverts; ++i) {
-    h_vert_globals[i] = vert_globals_dolfin[i];
-  }
+  std::copy(vert_globals_dolfin.begin(), vert_globals_dolfin.begin() + nverts,
+      h_vert_globals.data());
   auto d_vert_globals = GOs(h_vert_globals.write());
   auto& elem_verts_dolfin = topology(dim, VERT);
   auto nverts_per_cell = dim + 1;
   if (nelems)
     OMEGA_H_CHECK(Int(elem_verts_dolfin.size(0)) == (nverts_per_cell));
   auto h_elem_verts = HostWrite<LO>(nelems * (nverts_per_cell));
-  for (LO i = 0; i < nelems; ++i) {
-    auto ptr_dolfin = elem_verts_dolfin(i);
-    for (Int j = 0; j < (nverts_per_cell); ++j) {
-      h_elem_verts[i * (nverts_per_cell) + j] = ptr_dolfin[j];
-    }
+  /* DOLFIN keeps cell connectivity in one contiguous array */
+  if (nelems) {
+    auto ptr_dolfin = elem_verts_dolfin();
+    std::copy(ptr_dolfin, ptr_dolfin + nelems * nverts_per_cell,
+        h_elem_verts.data());
   }
   auto d_elem_verts = h_elem_verts.write();
   fix_inverted_elements(dim, d_elem_verts, d_coords);
@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <map>
 #include <set>
 #include <sstream>
 
@@ -24,6 +25,7 @@
 #include "Omega_h_map.hpp"
 #include "Omega_h_mark.hpp"
 #include "Omega_h_mesh.hpp"
+#include "Omega_h_owners.hpp"
 
 namespace Omega_h {
 
@@ -545,22 +547,18 @@ Mesh read_sliced(filesystem::path const&, CommPtr, bool, int, int) {
 }
 #endif
 
-void write(
-    filesystem::path const& path, Mesh* mesh, bool verbose, int classify_with) {
-  begin_code("exodus::write");
-  auto comp_ws = int(sizeof(Real));
-  auto io_ws = comp_ws;
-  auto mode = EX_CLOBBER | EX_MAPS_INT64_API;
-  auto file = ex_create(path.c_str(), mode, &comp_ws, &io_ws);
-  if (file < 0) Omega_h_fail("can't create Exodus file %s\n", path.c_str());
-  auto title = "Omega_h " OMEGA_H_SEMVER " Exodus Output";
+static std::set<LO> get_region_set(Mesh* mesh) {
   std::set<LO> region_set;
-  auto dim = mesh->dim();
-  auto elem_class_ids = mesh->get_array<ClassId>(dim, "class_id");
+  auto elem_class_ids = mesh->get_array<ClassId>(mesh->dim(), "class_id");
   auto h_elem_class_ids = HostRead<LO>(elem_class_ids);
   for (LO i = 0; i < h_elem_class_ids.size(); ++i) {
     region_set.insert(h_elem_class_ids[i]);
   }
+  return region_set;
+}
+
+static std::set<LO> get_surface_set(Mesh* mesh) {
+  auto dim = mesh->dim();
   auto side_class_ids = mesh->get_array<ClassId>(dim - 1, "class_id");
   auto side_class_dims = mesh->get_array<I8>(dim - 1, "class_dim");
   auto h_side_class_ids = HostRead<LO>(side_class_ids);
@@ -571,6 +569,23 @@ void write(
       surface_set.insert(h_side_class_ids[i]);
     }
   }
+  return surface_set;
+}
+
+/* writes everything but the parallel metadata into an open file.
+   every block and set in (region_set) and (surface_set) is written,
+   even if it is empty here. returns the position of each element
+   in the file */
+static LOs write_mesh(int file, filesystem::path const& path, Mesh* mesh,
+    bool verbose, int classify_with, std::set<LO> const& region_set,
+    std::set<LO> const& surface_set) {
+  auto comp_ws = int(sizeof(Real));
+  auto io_ws = comp_ws;
+  auto title = "Omega_h " OMEGA_H_SEMVER " Exodus Output";
+  auto dim = mesh->dim();
+  auto elem_class_ids = mesh->get_array<ClassId>(dim, "class_id");
+  auto side_class_ids = mesh->get_array<ClassId>(dim - 1, "class_id");
+  auto side_class_dims = mesh->get_array<I8>(dim - 1, "class_dim");
   auto nelem_blocks = int(region_set.size());
   auto nside_sets =
       (classify_with | exodus::SIDE_SETS) ? int(surface_set.size()) : 0;
@@ -713,6 +728,171 @@ void write(
       CALL(ex_put_names(file, EX_SIDE_SET, set_name_ptrs.data()));
     }
   }
+  return elems2file_idx;
+}
+
+void write(
+    filesystem::path const& path, Mesh* mesh, bool verbose, int classify_with) {
+  begin_code("exodus::write");
+  auto comp_ws = int(sizeof(Real));
+  auto io_ws = comp_ws;
+  auto mode = EX_CLOBBER | EX_MAPS_INT64_API;
+  auto file = ex_create(path.c_str(), mode, &comp_ws, &io_ws);
+  if (file < 0) Omega_h_fail("can't create Exodus file %s\n", path.c_str());
+  write_mesh(file, path, mesh, verbose, classify_with, get_region_set(mesh),
+      get_surface_set(mesh));
+  CALL(ex_close(file));
+  end_code();
+}
+
+/* the union over all ranks of the class ids in (local) */
+static std::set<LO> unite(CommPtr comm, std::set<LO> const& local) {
+  auto max_id = local.empty() ? LO(-1) : *local.rbegin();
+  max_id = comm->allreduce(max_id, OMEGA_H_MAX);
+  std::vector<I32> have(std::size_t(max_id + 1), 0);
+  for (auto id : local) have[std::size_t(id)] = 1;
+  have = comm->allreduce(have, OMEGA_H_MAX);
+  std::set<LO> global;
+  for (std::size_t id = 0; id < have.size(); ++id) {
+    if (have[id]) global.insert(LO(id));
+  }
+  return global;
+}
+
+static std::string get_spread_file_name(
+    filesystem::path const& path, I32 nparts, I32 part) {
+  auto nparts_str = std::to_string(nparts);
+  auto part_str = std::to_string(part);
+  part_str.insert(0, nparts_str.size() - part_str.size(), '0');
+  return path.string() + "." + nparts_str + "." + part_str;
+}
+
+void write_parallel(
+    filesystem::path const& path, Mesh* mesh, bool verbose, int classify_with) {
+  if (mesh->parting() != OMEGA_H_ELEM_BASED) {
+    /* the caller's mesh keeps its parting. the copy shares its arrays,
+       and repartitioning builds new ones rather than changing those */
+    Mesh elem_based = *mesh;
+    elem_based.set_parting(OMEGA_H_ELEM_BASED);
+    write_parallel(path, &elem_based, verbose, classify_with);
+    return;
+  }
+  begin_code("exodus::write_parallel");
+  auto comm = mesh->comm();
+  auto nparts = comm->size();
+  auto part = comm->rank();
+  auto dim = mesh->dim();
+  auto region_set = unite(comm, get_region_set(mesh));
+  auto surface_set = unite(comm, get_surface_set(mesh));
+  auto sharers = get_sharers(mesh, VERT);
+  auto file_path = get_spread_file_name(path, nparts, part);
+  auto comp_ws = int(sizeof(Real));
+  auto io_ws = comp_ws;
+  auto mode = EX_CLOBBER | EX_MAPS_INT64_API;
+  auto file = ex_create(file_path.c_str(), mode, &comp_ws, &io_ws);
+  if (file < 0) {
+    Omega_h_fail("can't create Exodus file %s\n", file_path.c_str());
+  }
+  auto elems2file_idx = write_mesh(file, file_path, mesh,
+      verbose && (part == 0), classify_with, region_set, surface_set);
+  /* the rest is written through 64-bit integers only */
+  CALL(ex_set_int64_status(file, EX_ALL_INT64_API));
+  /* node and element number maps from the global numbers */
+  auto vert_globals = HostRead<GO>(add_to_each(mesh->globals(VERT), GO(1)));
+  CALL(ex_put_id_map(file, EX_NODE_MAP, vert_globals.data()));
+  auto file_elems2elems = invert_permutation(elems2file_idx);
+  auto file_elem_globals =
+      unmap(file_elems2elems, add_to_each(mesh->globals(dim), GO(1)), 1);
+  auto h_file_elem_globals = HostRead<GO>(file_elem_globals);
+  CALL(ex_put_id_map(file, EX_ELEM_MAP, h_file_elem_globals.data()));
+  /* Nemesis load balance information. without element ghosts all
+     elements are internal and neighbors are linked by shared nodes */
+  auto h_verts2sharers = HostRead<LO>(sharers.a2ab);
+  auto h_sharers = HostRead<I32>(sharers.ab2b);
+  std::vector<I64> internal_nodes, border_nodes;
+  std::map<I32, std::vector<LO>> neighbor_nodes;
+  for (LO v = 0; v < mesh->nverts(); ++v) {
+    if (h_verts2sharers[v] == h_verts2sharers[v + 1]) {
+      internal_nodes.push_back(v + 1);
+      continue;
+    }
+    border_nodes.push_back(v + 1);
+    for (auto s = h_verts2sharers[v]; s < h_verts2sharers[v + 1]; ++s) {
+      neighbor_nodes[h_sharers[s]].push_back(v);
+    }
+  }
+  std::vector<I64> internal_elems(std::size_t(mesh->nelems()));
+  for (std::size_t i = 0; i < internal_elems.size(); ++i) {
+    internal_elems[i] = I64(i + 1);
+  }
+  CALL(ex_put_init_info(file, nparts, 1, const_cast<char*>("p")));
+  CALL(ex_put_init_global(file, mesh->nglobal_ents(VERT),
+      mesh->nglobal_ents(dim), I64(region_set.size()),
+      (classify_with & exodus::NODE_SETS) ? I64(surface_set.size()) : 0,
+      (classify_with & exodus::SIDE_SETS) ? I64(surface_set.size()) : 0));
+  CALL(ex_put_loadbal_param(file, I64(internal_nodes.size()),
+      I64(border_nodes.size()), 0, I64(internal_elems.size()), 0,
+      I64(neighbor_nodes.size()), 0, part));
+  CALL(ex_put_processor_node_maps(
+      file, internal_nodes.data(), border_nodes.data(), nullptr, part));
+  CALL(ex_put_processor_elem_maps(file, internal_elems.data(), nullptr, part));
+  std::vector<I64> cmap_ids, cmap_counts;
+  for (auto& pair : neighbor_nodes) {
+    cmap_ids.push_back(pair.first);
+    cmap_counts.push_back(I64(pair.second.size()));
+  }
+  CALL(ex_put_cmap_params(
+      file, cmap_ids.data(), cmap_counts.data(), nullptr, nullptr, part));
+  /* both sides of each map list the shared nodes by global number */
+  for (auto& pair : neighbor_nodes) {
+    auto& nodes = pair.second;
+    std::sort(nodes.begin(), nodes.end(), [&](LO a, LO b) {
+      return vert_globals[a] < vert_globals[b];
+    });
+    std::vector<I64> node_ids(nodes.begin(), nodes.end());
+    for (auto& node_id : node_ids) ++node_id;
+    std::vector<I64> proc_ids(nodes.size(), I64(pair.first));
+    CALL(ex_put_node_cmap(
+        file, pair.first, node_ids.data(), proc_ids.data(), part));
+  }
+  /* global sizes of blocks and sets, counting each entity at its owner */
+  std::vector<I64> block_ids(region_set.begin(), region_set.end());
+  std::vector<I64> block_counts;
+  auto elem_class_ids = mesh->get_array<ClassId>(dim, "class_id");
+  for (auto block_id : region_set) {
+    auto nblock_elems = get_sum(each_eq_to(elem_class_ids, block_id));
+    block_counts.push_back(comm->allreduce(I64(nblock_elems), OMEGA_H_SUM));
+  }
+  CALL(ex_put_eb_info_global(file, block_ids.data(), block_counts.data()));
+  if (classify_with) {
+    std::vector<I64> set_ids(surface_set.begin(), surface_set.end());
+    std::vector<I64> nset_sides, nset_nodes;
+    auto side_class_ids = mesh->get_array<ClassId>(dim - 1, "class_id");
+    auto side_class_dims = mesh->get_array<I8>(dim - 1, "class_dim");
+    auto sides_are_owned = mesh->owned(dim - 1);
+    for (auto set_id : surface_set) {
+      auto sides_in_set = land_each(each_eq_to(side_class_ids, set_id),
+          each_eq_to(side_class_dims, I8(dim - 1)));
+      auto owned_sides = land_each(sides_in_set, sides_are_owned);
+      nset_sides.push_back(
+          comm->allreduce(I64(get_sum(owned_sides)), OMEGA_H_SUM));
+      /* a node may be in the set only through sides of other ranks */
+      auto nodes_in_set = mesh->reduce_array(
+          VERT, mark_down(mesh, dim - 1, VERT, sides_in_set), 1, OMEGA_H_MAX);
+      auto owned_nodes = land_each(nodes_in_set, mesh->owned(VERT));
+      nset_nodes.push_back(
+          comm->allreduce(I64(get_sum(owned_nodes)), OMEGA_H_SUM));
+    }
+    std::vector<I64> ndist_factors(surface_set.size(), 0);
+    if (classify_with & exodus::NODE_SETS) {
+      CALL(ex_put_ns_param_global(
+          file, set_ids.data(), nset_nodes.data(), ndist_factors.data()));
+    }
+    if (classify_with & exodus::SIDE_SETS) {
+      CALL(ex_put_ss_param_global(
+          file, set_ids.data(), nset_sides.data(), ndist_factors.data()));
+    }
+  }
   CALL(ex_close(file));
   end_code();
 }
@@ -3,10 +3,14 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <cerrno>
+#include <clocale>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <locale>
+#include <sstream>
 
 #ifdef OMEGA_H_USE_ZLIB
 #include <zlib.h>
@@ -15,6 +19,7 @@
 #include "Omega_h_array_ops.hpp"
 #include "Omega_h_for.hpp"
 #include "Omega_h_inertia.hpp"
+#include "Omega_h_map.hpp"
 #include "Omega_h_mesh.hpp"
 
 namespace Omega_h {
@@ -627,18 +632,298 @@ void write_reals_txt(std::ostream& stream, Reals a, Int ncomps) {
 }
 
 Reals read_reals_txt(filesystem::path const& filename, LO n, Int ncomps) {
-  std::ifstream stream(filename.c_str());
+  std::ifstream stream(filename.c_str(), std::ios::binary);
+  if (!stream.is_open()) {
+    Omega_h_fail("couldn't open \"%s\"\n", filename.c_str());
+  }
   return read_reals_txt(stream, n, ncomps);
 }
 
 Reals read_reals_txt(std::istream& stream, LO n, Int ncomps) {
-  auto h_a = HostWrite<Real>(n * ncomps);
-  for (LO i = 0; i < n; ++i) {
-    for (Int j = 0; j < ncomps; ++j) {
-      stream >> h_a[i * ncomps + j];
+  return read_reals(stream, n * ncomps);
+}
+
+namespace {
+
+OMEGA_H_INLINE bool is_text_space(I8 c) {
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+         c == '\f';
+}
+
+OMEGA_H_INLINE bool is_text_digit(I8 c) { return '0' <= c && c <= '9'; }
+
+/* parses the number at text[i] using only exact operations:
+   up to 19 significant digits which, after dropping trailing zeros,
+   are at most 2^53, scaled by a power of ten of at most 22. both are
+   exact doubles, so one rounding gives the correctly rounded result.
+   returns false for anything else, including numbers that need more
+   care */
+OMEGA_H_DEVICE bool parse_real_exactly(
+    Read<I8> const& text, LO i, LO end, Real* out) {
+  bool is_negative = false;
+  if (text[i] == '-' || text[i] == '+') is_negative = (text[i++] == '-');
+  std::uint64_t mantissa = 0;
+  Int nsig = 0;
+  Int exponent = 0;
+  bool has_digits = false;
+  bool is_inexact = false;
+  bool is_fraction = false;
+  for (; i < end; ++i) {
+    auto c = text[i];
+    if (c == '.' && !is_fraction) {
+      is_fraction = true;
+      continue;
     }
+    if (!is_text_digit(c)) break;
+    has_digits = true;
+    auto digit = std::uint64_t(c - '0');
+    if (mantissa == 0 && digit == 0) {
+      if (is_fraction) --exponent;
+    } else if (nsig < 19) {
+      mantissa = mantissa * 10 + digit;
+      ++nsig;
+      if (is_fraction) --exponent;
+    } else {
+      if (digit) is_inexact = true;
+      if (!is_fraction) ++exponent;
+    }
+  }
+  if (!has_digits || is_inexact) return false;
+  if (i < end && (text[i] == 'e' || text[i] == 'E')) {
+    ++i;
+    bool is_negative_exponent = false;
+    if (i < end && (text[i] == '-' || text[i] == '+')) {
+      is_negative_exponent = (text[i++] == '-');
+    }
+    if (!(i < end && is_text_digit(text[i]))) return false;
+    Int e = 0;
+    for (; i < end && is_text_digit(text[i]); ++i) {
+      if (e < 100000) e = e * 10 + (text[i] - '0');
+    }
+    exponent += is_negative_exponent ? -e : e;
+  }
+  if (i < end && !is_text_space(text[i])) return false;
+  if (mantissa == 0) {
+    *out = is_negative ? -0.0 : 0.0;
+    return true;
   }
-  return h_a.write();
+  while (mantissa % 10 == 0) {
+    mantissa /= 10;
+    ++exponent;
+  }
+  if (mantissa > (std::uint64_t(1) << 53)) return false;
+  if (exponent > 22 || exponent < -22) return false;
+  Real scale = 1.0;
+  auto nscales = (exponent < 0) ? -exponent : exponent;
+  for (Int k = 0; k < nscales; ++k) scale *= 10.0;
+  auto value = Real(mantissa);
+  value = (exponent < 0) ? (value / scale) : (value * scale);
+  *out = is_negative ? -value : value;
+  return true;
+}
+
+OMEGA_H_DEVICE bool parse_integer(
+    Read<I8> const& text, LO i, LO end, I64* out) {
+  bool is_negative = false;
+  if (text[i] == '-' || text[i] == '+') is_negative = (text[i++] == '-');
+  if (!(i < end && is_text_digit(text[i]))) return false;
+  I64 value = 0;
+  for (; i < end && is_text_digit(text[i]); ++i) {
+    if (value > (ArithTraits<I64>::max() - 9) / 10) return false;
+    value = value * 10 + (text[i] - '0');
+  }
+  if (i < end && !is_text_space(text[i])) return false;
+  *out = is_negative ? -value : value;
+  return true;
+}
+
+LOs get_token_starts(Read<I8> text, LO begin, LO end) {
+  OMEGA_H_CHECK(0 <= begin && begin <= end && end <= text.size());
+  Write<I8> is_start(end - begin);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto c = text[begin + i];
+    auto follows_space = (i == 0) || is_text_space(text[begin + i - 1]);
+    is_start[i] = !is_text_space(c) && follows_space;
+  };
+  parallel_for(end - begin, f, "get_token_starts");
+  return add_to_each(collect_marked(is_start), begin);
+}
+
+std::string get_token(HostRead<I8> const& h_text, LO i, LO end) {
+  std::string token;
+  for (; i < end && !is_text_space(h_text[i]); ++i) token.push_back(h_text[i]);
+  return token;
+}
+
+void check_token_count(LO ntokens, LO n) {
+  if (ntokens != n) {
+    Omega_h_fail("expected %d numbers but found %d\n", n, ntokens);
+  }
+}
+
+}  // end anonymous namespace
+
+/* the fallback for what parse_real_exactly declines is strtod, which is
+   correctly rounded. it is only trusted while the C locale uses a
+   period, and otherwise a stream with the classic locale is used */
+Reals parse_reals(Read<I8> text, LO begin, LO end, LO n) {
+  OMEGA_H_TIME_FUNCTION;
+  auto starts = get_token_starts(text, begin, end);
+  check_token_count(starts.size(), n);
+  Write<Real> values(n);
+  Write<I8> are_exact(n);
+  auto f = OMEGA_H_LAMBDA(LO t) {
+    Real value = 0.0;
+    are_exact[t] = parse_real_exactly(text, starts[t], end, &value);
+    values[t] = value;
+  };
+  parallel_for(n, f, "parse_reals");
+  auto others = collect_marked(each_eq_to(Read<I8>(are_exact), I8(0)));
+  if (others.size() == 0) return values;
+  auto h_text = HostRead<I8>(text);
+  auto h_starts = HostRead<LO>(starts);
+  auto h_others = HostRead<LO>(others);
+  auto h_values = HostWrite<Real>(values);
+  auto const has_period = (std::localeconv()->decimal_point[0] == '.');
+  auto nothers = h_others.size();
+  std::vector<I8> are_ok(std::size_t(nothers), 1);
+#ifdef OMEGA_H_USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (LO o = 0; o < nothers; ++o) {
+    auto t = h_others[o];
+    auto token = get_token(h_text, h_starts[t], end);
+    Real value = 0.0;
+    bool ok;
+    if (has_period) {
+      char* token_end;
+      value = std::strtod(token.c_str(), &token_end);
+      ok = !token.empty() && (*token_end == '\0');
+    } else {
+      std::istringstream token_stream(token);
+      token_stream.imbue(std::locale::classic());
+      ok = bool(token_stream >> value) && token_stream.eof();
+    }
+    h_values[t] = value;
+    are_ok[std::size_t(o)] = ok;
+  }
+  for (LO o = 0; o < nothers; ++o) {
+    if (!are_ok[std::size_t(o)]) {
+      Omega_h_fail("\"%s\" is not a number\n",
+          get_token(h_text, h_starts[h_others[o]], end).c_str());
+    }
+  }
+  return h_values.write();
+}
+
+LOs parse_los(Read<I8> text, LO begin, LO end, LO n) {
+  OMEGA_H_TIME_FUNCTION;
+  auto starts = get_token_starts(text, begin, end);
+  check_token_count(starts.size(), n);
+  Write<LO> values(n);
+  Write<I8> are_valid(n);
+  auto f = OMEGA_H_LAMBDA(LO t) {
+    I64 value = 0;
+    auto ok = parse_integer(text, starts[t], end, &value);
+    ok = ok && ArithTraits<LO>::min() <= value &&
+         value <= ArithTraits<LO>::max();
+    are_valid[t] = ok;
+    values[t] = ok ? LO(value) : LO(0);
+  };
+  parallel_for(n, f, "parse_los");
+  auto invalid = collect_marked(each_eq_to(Read<I8>(are_valid), I8(0)));
+  if (invalid.size()) {
+    auto t = invalid.get(0);
+    Omega_h_fail("\"%s\" is not a local integer\n",
+        get_token(HostRead<I8>(text), starts.get(t), end).c_str());
+  }
+  return values;
+}
+
+namespace {
+
+/* appends the characters of (stream) to (buffer) up to the end of
+   its (ntokens)th token, counting the one (buffer) may end inside,
+   and leaves the whitespace after it unread */
+void read_tokens(
+    std::istream& stream, std::size_t ntokens, std::string& buffer) {
+  auto in_token = !buffer.empty() && !is_text_space(I8(buffer.back()));
+  std::size_t nstarted = in_token ? 1 : 0;
+  while (true) {
+    auto const c = stream.peek();
+    if (c == std::char_traits<char>::eof()) return;
+    auto const is_space = is_text_space(I8(c));
+    if (is_space && in_token && nstarted == ntokens) return;
+    if (!is_space && !in_token) ++nstarted;
+    in_token = !is_space;
+    buffer.push_back(char(stream.get()));
+  }
+}
+
+/* reads (stream) in chunks of at most (chunk_bytes), each cut after its
+   last whitespace so no number is split, and parses them with (parse)
+   until (n) numbers are found. (r) numbers still to be read span at
+   least 2r - 1 bytes, so a chunk of at most 2(r - 1) bytes never goes
+   past the last one, and the last one is read up to the whitespace
+   after it. nothing is given back, so the stream need not seek */
+template <typename T, typename Parse>
+Read<T> read_numbers(
+    std::istream& stream, LO n, std::size_t chunk_bytes, Parse parse) {
+  OMEGA_H_CHECK(n >= 0 && chunk_bytes > 0);
+  Write<T> values(n);
+  std::string buffer;
+  LO nread = 0;
+  bool is_last = false;
+  while (nread < n) {
+    if (is_last) {
+      Omega_h_fail("expected %d numbers but found %d\n", n, nread);
+    }
+    /* the start of a number cut off by the previous chunk is kept */
+    auto const nleft = std::size_t(n - nread);
+    auto const nbytes = std::min(chunk_bytes, 2 * (nleft - 1));
+    if (nbytes) {
+      auto const nkept = buffer.size();
+      buffer.resize(nkept + nbytes);
+      stream.read(&buffer[nkept], std::streamsize(nbytes));
+      auto const ngot = std::size_t(stream.gcount());
+      buffer.resize(nkept + ngot);
+      is_last = (ngot < nbytes);
+    } else {
+      read_tokens(stream, nleft, buffer);
+      is_last = true;
+    }
+    auto cut = buffer.size();
+    if (!is_last) {
+      while (cut && !is_text_space(I8(buffer[cut - 1]))) --cut;
+    }
+    OMEGA_H_CHECK(cut <= std::size_t(ArithTraits<LO>::max()));
+    auto const ntext = static_cast<LO>(cut);
+    HostWrite<I8> h_text(ntext);
+    if (cut) std::memcpy(h_text.data(), buffer.data(), cut);
+    Read<I8> text(h_text.write());
+    auto starts = get_token_starts(text, 0, text.size());
+    auto ntokens = starts.size();
+    OMEGA_H_CHECK(ntokens <= n - nread);
+    map_into_range(parse(text, 0, text.size(), ntokens), nread,
+        nread + ntokens, values, 1);
+    nread += ntokens;
+    buffer.erase(0, cut);
+  }
+  /* a stream that ends right after the last number is not an error */
+  if (stream.eof() && !stream.bad()) stream.clear();
+  return values;
+}
+
+}  // end anonymous namespace
+
+Reals read_reals(std::istream& stream, LO n, std::size_t chunk_bytes) {
+  OMEGA_H_TIME_FUNCTION;
+  return read_numbers<Real>(stream, n, chunk_bytes, parse_reals);
+}
+
+LOs read_los(std::istream& stream, LO n, std::size_t chunk_bytes) {
+  OMEGA_H_TIME_FUNCTION;
+  return read_numbers<LO>(stream, n, chunk_bytes, parse_los);
 }
 
 OMEGA_H_DLL Mesh read_mesh_file(filesystem::path const& path, CommPtr comm) {
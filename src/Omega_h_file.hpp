@@ -21,7 +21,13 @@ bool is_little_endian_cpu();
 #ifdef OMEGA_H_USE_LIBMESHB
 namespace meshb {
 void read(Mesh* mesh, std::string const& filepath);
+/* each rank of (comm) reads one slice of the vertices and elements.
+   lower dimensional sections are not read, sides are classified
+   by exposure instead */
+void read_sliced(Mesh* mesh, std::string const& filepath, CommPtr comm);
 void write(Mesh* mesh, std::string const& filepath, int version = 2);
+/* on several ranks, (mesh) must number its vertices as the file does,
+   as meshes from read() or read_sliced() do */
 void read_sol(
     Mesh* mesh, std::string const& filepath, std::string const& sol_name);
 void write_sol(Mesh* mesh, std::string const& filepath,
@@ -45,6 +51,13 @@ void read_nodal_fields(int exodus_file, Mesh* mesh, int time_step,
     bool verbose = false);
 void write(filesystem::path const& path, Mesh* mesh, bool verbose = false,
     int classify_with = NODE_SETS | SIDE_SETS);
+/* every rank writes its elements and their nodes to its own file
+   (path).(nranks).(rank), with node and element maps from the globals
+   and the Nemesis metadata that joins the files (as read by epu and
+   other Nemesis-aware tools). only the serial ExodusII API is used,
+   and nothing is gathered to one rank */
+void write_parallel(filesystem::path const& path, Mesh* mesh,
+    bool verbose = false, int classify_with = NODE_SETS | SIDE_SETS);
 Mesh read_sliced(filesystem::path const& path, CommPtr comm,
     bool verbose = false, int classify_with = NODE_SETS | SIDE_SETS,
     int time_step = -1);
@@ -103,6 +116,11 @@ void write_parallel(std::string const& path, Mesh* mesh, Int cell_dim,
     bool compress = OMEGA_H_DEFAULT_COMPRESS);
 void write_parallel(std::string const& path, Mesh* mesh,
     bool compress = OMEGA_H_DEFAULT_COMPRESS);
+/* converts a .osh directory to parallel VTK without loading it as a Mesh.
+   every chunk of at most (max_chunk_ents) cells becomes one piece */
+void write_parallel_streamed(filesystem::path const& osh_path,
+    filesystem::path const& path, CommPtr comm, Int cell_dim = -1,
+    LO max_chunk_ents = LO(1) << 20, bool compress = OMEGA_H_DEFAULT_COMPRESS);
 
 void read_parallel(filesystem::path const& pvtupath, CommPtr comm, Mesh* mesh);
 void read_vtu(std::istream& stream, CommPtr comm, Mesh* mesh);
@@ -201,6 +219,19 @@ void write_reals_txt(std::ostream& stream, Reals a, Int ncomps);
 Reals read_reals_txt(filesystem::path const& filename, LO n, Int ncomps);
 Reals read_reals_txt(std::istream& stream, LO n, Int ncomps);
 
+/* the whitespace-separated numbers in [begin, end) of (text), each
+   parsed in parallel and independently of the locale.
+   fails unless there are exactly (n) of them */
+Reals parse_reals(Read<I8> text, LO begin, LO end, LO n);
+LOs parse_los(Read<I8> text, LO begin, LO end, LO n);
+/* the next (n) whitespace-separated numbers of (stream), read and
+   parsed as above a chunk of about (chunk_bytes) at a time, so the
+   text may be of any size. the stream is left right after the last
+   number and need not be seekable; fails if it ends sooner */
+Reals read_reals(
+    std::istream& stream, LO n, std::size_t chunk_bytes = (1 << 26));
+LOs read_los(std::istream& stream, LO n, std::size_t chunk_bytes = (1 << 26));
+
 }  // namespace Omega_h
 
 #endif
@@ -54,6 +54,13 @@ bool Future<T>::completed() {
   }
   return flag == 0;
 #else   // !OMEGA_H_USE_MPI
+  if (status_ != Status::waiting) {
+    return true;
+  }
+  for (auto& request : requests_) {
+    if (!request(false)) return false;
+  }
+  status_ = Status::completed;
   return true;
 #endif  // OMEGA_H_USE_MPI
 }
@@ -69,7 +76,12 @@ Read<T> Future<T>::get() {
                                      requests_.data(), MPI_STATUS_IGNORE));
     status_ = Status::consumed;
     return callback_(recvbuf_);
-#endif  // !OMEGA_H_USE_MPI
+#else
+  } else if (status_ == Status::waiting) {
+    for (auto& request : requests_) request(true);
+    status_ = Status::consumed;
+    return callback_(recvbuf_);
+#endif  // OMEGA_H_USE_MPI
   } else {
     fail("Can not ask the result more than once.");
   }
@@ -35,7 +35,9 @@ class Future {
 #ifdef OMEGA_H_USE_MPI
   using requests_type = std::vector<MPI_Request>;
 #else
-  using requests_type = std::vector<int>;
+  /* exchanges between thread ranks: each one tests for completion,
+     or waits for it when given true */
+  using requests_type = std::vector<std::function<bool(bool)>>;
 #endif  // OMEGA_H_USE_MPI
 
 #if defined(OMEGA_H_USE_MPI) && defined(OMEGA_H_USE_CUDA) &&                   \
@@ -6,35 +6,297 @@
 #include <iostream>
 
 #include "Omega_h_array_ops.hpp"
+#include "Omega_h_atomics.hpp"
 #include "Omega_h_element.hpp"
-#include "Omega_h_mark.hpp"
+#include "Omega_h_for.hpp"
+#include "Omega_h_int_iterator.hpp"
 #include "Omega_h_mesh.hpp"
+#include "Omega_h_profile.hpp"
+#include "Omega_h_quality.hpp"
+#include "Omega_h_reduce.hpp"
 
 namespace Omega_h {
 
+namespace {
+
+struct StatsAccum {
+  Real min;
+  Real max;
+  Real sum;
+  LO n;
+  LO nlow;
+  LO nhigh;
+};
+
+OMEGA_H_INLINE StatsAccum empty_stats() {
+  StatsAccum a;
+  a.min = ArithTraits<Real>::max();
+  a.max = ArithTraits<Real>::min();
+  a.sum = 0.0;
+  a.n = a.nlow = a.nhigh = 0;
+  return a;
+}
+
+struct join_stats {
+  OMEGA_H_INLINE StatsAccum operator()(
+      StatsAccum const& a, StatsAccum const& b) const {
+    StatsAccum c;
+    c.min = min2(a.min, b.min);
+    c.max = max2(a.max, b.max);
+    c.sum = a.sum + b.sum;
+    c.n = a.n + b.n;
+    c.nlow = a.nlow + b.nlow;
+    c.nhigh = a.nhigh + b.nhigh;
+    return c;
+  }
+};
+
+/* the summary of a field, and its histogram counts followed by the
+   counts under and over the histogram range */
+struct LocalStats {
+  StatsAccum accum;
+  std::vector<LO> bins;
+};
+
+template <typename Value>
+LocalStats get_local_stats(
+    Mesh* mesh, StatsQuery const& query, Value const value) {
+  auto const owned = mesh->owned(query.ent_dim);
+  auto const desired = query.desired;
+  auto transform = OMEGA_H_LAMBDA(LO i)->StatsAccum {
+    auto a = empty_stats();
+    if (!owned[i]) return a;
+    auto const v = value(i);
+    a.min = a.max = a.sum = v;
+    a.n = 1;
+    if (v < desired.min) a.nlow = 1;
+    if (v > desired.max) a.nhigh = 1;
+    return a;
+  };
+  auto const first = IntIterator(0);
+  auto const last = IntIterator(owned.size());
+  LocalStats result;
+  result.accum = transform_reduce(
+      first, last, empty_stats(), join_stats(), std::move(transform));
+  auto const nbins = query.nbins;
+  if (nbins == 0) return result;
+  /* the histogram takes its own pass, so the reduction above carries
+     no bins however many are asked for */
+  auto const hmin = query.histogram_min;
+  auto const hmax = query.histogram_max;
+  auto const interval = (hmax - hmin) / Real(nbins);
+  Write<LO> counts(nbins + 2, 0);
+  auto fill = OMEGA_H_LAMBDA(LO i) {
+    if (!owned[i]) return;
+    auto const v = value(i);
+    Int b;
+    if (v < hmin) {
+      b = nbins;
+    } else if (v > hmax) {
+      b = nbins + 1;
+    } else {
+      /* bin i holds [floor_i, ceil_i), the last bin also holds hmax;
+         correct the division's rounding against those bounds */
+      b = min2(Int((v - hmin) / interval), nbins - 1);
+      if (b > 0 && v < interval * b + hmin) --b;
+      if (b < nbins - 1 && v >= interval * (b + 1) + hmin) ++b;
+    }
+    atomic_increment(&counts[b]);
+  };
+  parallel_for(owned.size(), std::move(fill), "get_local_stats(histogram)");
+  auto const h_counts = HostRead<LO>(counts);
+  for (LO i = 0; i < h_counts.size(); ++i) result.bins.push_back(h_counts[i]);
+  return result;
+}
+
+struct ArrayValue {
+  Reals values;
+  OMEGA_H_DEVICE Real operator()(LO i) const { return values[i]; }
+};
+
+struct UnitValue {
+  OMEGA_H_DEVICE Real operator()(LO) const { return 1.0; }
+};
+
+template <Int mesh_dim, Int metric_dim>
+struct QualityValue {
+  MetricElementQualities<mesh_dim, metric_dim> measurer;
+  LOs ev2v;
+  QualityValue(Mesh* mesh)
+      : measurer(mesh), ev2v(mesh->ask_verts_of(mesh_dim)) {}
+  OMEGA_H_DEVICE Real operator()(LO e) const {
+    return measurer.measure(gather_verts<mesh_dim + 1>(ev2v, e));
+  }
+};
+
+template <Int space_dim, Int metric_dim>
+struct LengthValue {
+  MetricEdgeLengths<space_dim, metric_dim> measurer;
+  LOs ev2v;
+  LengthValue(Mesh* mesh) : measurer(mesh), ev2v(mesh->ask_verts_of(EDGE)) {}
+  OMEGA_H_DEVICE Real operator()(LO e) const {
+    return measurer.measure(gather_verts<2>(ev2v, e));
+  }
+};
+
+LocalStats get_quality_stats(
+    Mesh* mesh, StatsQuery const& query) {
+  auto const dim = mesh->dim();
+  OMEGA_H_CHECK(query.ent_dim == dim);
+  if (mesh->has_tag(dim, "quality")) {
+    auto const values = mesh->ask_qualities();
+    return get_local_stats(mesh, query, ArrayValue{values});
+  }
+  if (dim == 1) return get_local_stats(mesh, query, UnitValue());
+  auto metric_dim =
+      get_metrics_dim(mesh->nverts(), mesh->get_array<Real>(VERT, "metric"));
+  if (dim == 3 && metric_dim == 3) {
+    return get_local_stats(mesh, query, QualityValue<3, 3>(mesh));
+  }
+  if (dim == 2 && metric_dim == 2) {
+    return get_local_stats(mesh, query, QualityValue<2, 2>(mesh));
+  }
+  if (dim == 3 && metric_dim == 1) {
+    return get_local_stats(mesh, query, QualityValue<3, 1>(mesh));
+  }
+  if (dim == 2 && metric_dim == 1) {
+    return get_local_stats(mesh, query, QualityValue<2, 1>(mesh));
+  }
+  OMEGA_H_NORETURN(LocalStats());
+}
+
+LocalStats get_length_stats(
+    Mesh* mesh, StatsQuery const& query) {
+  auto const dim = mesh->dim();
+  OMEGA_H_CHECK(query.ent_dim == EDGE);
+  if (mesh->has_tag(EDGE, "length")) {
+    auto const values = mesh->ask_lengths();
+    return get_local_stats(mesh, query, ArrayValue{values});
+  }
+  auto metric_dim =
+      get_metrics_dim(mesh->nverts(), mesh->get_array<Real>(VERT, "metric"));
+  if (dim == 3 && metric_dim == 3) {
+    return get_local_stats(mesh, query, LengthValue<3, 3>(mesh));
+  }
+  if (dim == 2 && metric_dim == 2) {
+    return get_local_stats(mesh, query, LengthValue<2, 2>(mesh));
+  }
+  if (dim == 3 && metric_dim == 1) {
+    return get_local_stats(mesh, query, LengthValue<3, 1>(mesh));
+  }
+  if (dim == 2 && metric_dim == 1) {
+    return get_local_stats(mesh, query, LengthValue<2, 1>(mesh));
+  }
+  if (dim == 1 && metric_dim == 1) {
+    return get_local_stats(mesh, query, LengthValue<1, 1>(mesh));
+  }
+  OMEGA_H_NORETURN(LocalStats());
+}
+
+LocalStats get_local_stats(Mesh* mesh, StatsQuery const& query) {
+  OMEGA_H_CHECK(0 <= query.nbins);
+  if (query.source == STATS_VALUES) {
+    OMEGA_H_CHECK(query.values.size() == mesh->nents(query.ent_dim));
+    return get_local_stats(mesh, query, ArrayValue{query.values});
+  }
+  if (mesh->nents(query.ent_dim) == 0) {
+    LocalStats result;
+    result.accum = empty_stats();
+    if (query.nbins) result.bins.assign(std::size_t(query.nbins + 2), 0);
+    return result;
+  }
+  if (query.source == STATS_QUALITY) {
+    return get_quality_stats(mesh, query);
+  }
+  return get_length_stats(mesh, query);
+}
+
+}  // end anonymous namespace
+
+std::vector<FieldStats> get_field_stats(
+    Mesh* mesh, std::vector<StatsQuery> const& queries) {
+  OMEGA_H_TIME_FUNCTION;
+  std::vector<LocalStats> locals;
+  for (auto& query : queries) locals.push_back(get_local_stats(mesh, query));
+  /* pack every sum first and every extremum last so that one
+     allreduce_sum_max call serves all fields; minima travel negated */
+  std::vector<Real> packed;
+  for (auto& local : locals) {
+    auto& a = local.accum;
+    packed.push_back(a.sum);
+    packed.push_back(Real(a.n));
+    packed.push_back(Real(a.nlow));
+    packed.push_back(Real(a.nhigh));
+    for (auto bin : local.bins) packed.push_back(Real(bin));
+  }
+  auto const nsums = Int(packed.size());
+  for (auto& local : locals) {
+    packed.push_back(-local.accum.min);
+    packed.push_back(local.accum.max);
+  }
+  mesh->comm()->allreduce_sum_max(packed, nsums);
+  std::vector<FieldStats> result(queries.size());
+  std::size_t pos = 0;
+  for (std::size_t q = 0; q < queries.size(); ++q) {
+    auto& stats = result[q];
+    auto sum = packed[pos++];
+    stats.ntotal = GO(packed[pos++]);
+    stats.nlow = GO(packed[pos++]);
+    stats.nhigh = GO(packed[pos++]);
+    stats.mean = stats.ntotal ? sum / Real(stats.ntotal) : 0.0;
+    stats.histogram.min = queries[q].histogram_min;
+    stats.histogram.max = queries[q].histogram_max;
+    stats.nunder = stats.nover = 0;
+    if (queries[q].nbins) {
+      for (Int i = 0; i < queries[q].nbins; ++i) {
+        stats.histogram.bins.push_back(GO(packed[pos++]));
+      }
+      stats.nunder = GO(packed[pos++]);
+      stats.nover = GO(packed[pos++]);
+    }
+  }
+  for (auto& stats : result) {
+    stats.actual.min = -packed[pos++];
+    stats.actual.max = packed[pos++];
+  }
+  return result;
+}
+
+Real get_quantile(FieldStats const& stats, Real fraction) {
+  auto const& h = stats.histogram;
+  auto nbins = Int(h.bins.size());
+  if (stats.ntotal == 0) return 0.0;
+  if (nbins == 0) {
+    return stats.actual.min + fraction * (stats.actual.max - stats.actual.min);
+  }
+  auto target = fraction * Real(stats.ntotal);
+  auto interpolate = [&](Real lo, Real hi, GO before, GO count) {
+    auto t = count ? (target - Real(before)) / Real(count) : 0.0;
+    auto v = lo + max2(0.0, min2(t, 1.0)) * (hi - lo);
+    return max2(stats.actual.min, min2(v, stats.actual.max));
+  };
+  GO before = 0;
+  if (target <= Real(stats.nunder)) {
+    return interpolate(stats.actual.min, h.min, before, stats.nunder);
+  }
+  before += stats.nunder;
+  auto interval = (h.max - h.min) / Real(nbins);
+  for (Int i = 0; i < nbins; ++i) {
+    auto count = h.bins[std::size_t(i)];
+    if (target <= Real(before + count)) {
+      auto floor = interval * i + h.min;
+      return interpolate(floor, floor + interval, before, count);
+    }
+    before += count;
+  }
+  return interpolate(h.max, stats.actual.max, before, stats.nover);
+}
+
 Histogram get_histogram(Mesh* mesh, Int dim, Int nbins, Real min_value,
     Real max_value, Reals values) {
-  OMEGA_H_CHECK(values.size() == mesh->nents(dim));
-  auto owned_values = mesh->owned_array(dim, values, 1);
-  auto interval = (max_value - min_value) / Real(nbins);
-  Histogram histogram;
-  histogram.min = min_value;
-  histogram.max = max_value;
-  histogram.bins.resize(std::size_t(nbins));
-  for (Int i = 0; i < nbins; ++i) {
-    auto floor = interval * i + min_value;
-    auto ceil = interval * (i + 1) + min_value;
-    if (i == nbins - 1) ceil = max_value;
-    auto floor_marks = each_geq_to(owned_values, floor);
-    Read<I8> ceil_marks;
-    if (i == nbins - 1)
-      ceil_marks = each_leq_to(owned_values, ceil);
-    else
-      ceil_marks = each_lt(owned_values, ceil);
-    auto marked = land_each(floor_marks, ceil_marks);
-    histogram.bins[std::size_t(i)] = get_sum(mesh->comm(), marked);
-  }
-  return histogram;
+  StatsQuery query{dim, values, {min_value, max_value}, nbins, min_value,
+      max_value, STATS_VALUES};
+  return get_field_stats(mesh, {query})[0].histogram;
 }
 
 void print_histogram(Histogram const& histogram, std::string const& name) {
@@ -53,14 +315,13 @@ void print_histogram(Histogram const& histogram, std::string const& name) {
   std::cout.copyfmt(saved_state);
 }
 
-void print_goal_stats(Mesh* mesh, char const* name, Int ent_dim, Reals values,
-    MinMax<Real> desired, MinMax<Real> actual) {
-  auto low_marks = each_lt(values, desired.min);
-  auto high_marks = each_gt(values, desired.max);
-  auto nlow = count_owned_marks(mesh, ent_dim, low_marks);
-  auto nhigh = count_owned_marks(mesh, ent_dim, high_marks);
-  auto ntotal = mesh->nglobal_ents(ent_dim);
+void print_goal_stats(Mesh* mesh, char const* name, Int ent_dim,
+    FieldStats const& stats, MinMax<Real> desired) {
+  auto nlow = stats.nlow;
+  auto nhigh = stats.nhigh;
+  auto ntotal = stats.ntotal;
   auto nmid = ntotal - nlow - nhigh;
+  auto actual = stats.actual;
   if (mesh->comm()->rank() == 0) {
     auto precision_before = std::cout.precision();
     std::ios::fmtflags stream_state(std::cout.flags());
@@ -84,6 +345,14 @@ void print_goal_stats(Mesh* mesh, char const* name, Int ent_dim, Reals values,
   }
 }
 
+void print_goal_stats(Mesh* mesh, char const* name, Int ent_dim, Reals values,
+    MinMax<Real> desired, MinMax<Real> actual) {
+  StatsQuery query{ent_dim, values, desired, 0, 0.0, 0.0, STATS_VALUES};
+  auto stats = get_field_stats(mesh, {query})[0];
+  stats.actual = actual;
+  print_goal_stats(mesh, name, ent_dim, stats, desired);
+}
+
 void render_histogram_matplotlib(
     Histogram const& histogram, std::string const& filepath) {
   std::ofstream script("Omega_h_histogram.py");
@@ -21,6 +21,56 @@ Histogram get_histogram(Mesh* mesh, Int dim, Int nbins, Real min_value,
 
 void print_histogram(Histogram const& histogram, std::string const& name);
 
+/* where the values of a query come from. the measured sources
+   leave (values) empty and use the cached "quality" or "length"
+   tag if there is one, otherwise they measure each entity from the
+   current coordinates and metric during the pass, storing nothing */
+enum StatsSource {
+  STATS_VALUES,
+  STATS_QUALITY,  // element qualities
+  STATS_LENGTH,   // edge lengths
+};
+
+/* describes one per-entity field to summarize: values outside
+   [desired.min, desired.max] are counted as low or high, and if
+   nbins > 0 the range [histogram_min, histogram_max] is binned */
+struct StatsQuery {
+  Int ent_dim;
+  Reals values;
+  MinMax<Real> desired;
+  Int nbins;
+  Real histogram_min;
+  Real histogram_max;
+  StatsSource source;
+};
+
+/* global statistics over the owned entries of one field.
+   nunder and nover count the values left of and right of
+   the histogram range, which lets get_quantile estimate
+   quantiles from the bins */
+struct FieldStats {
+  MinMax<Real> actual;
+  Real mean;
+  GO ntotal;
+  GO nlow;
+  GO nhigh;
+  GO nunder;
+  GO nover;
+  Histogram histogram;
+};
+
+/* makes one pass over each field and combines all the
+   results with a single collective call */
+std::vector<FieldStats> get_field_stats(
+    Mesh* mesh, std::vector<StatsQuery> const& queries);
+
+/* approximates the value below which the given fraction
+   of entries lie, interpolating linearly within histogram bins */
+Real get_quantile(FieldStats const& stats, Real fraction);
+
+void print_goal_stats(Mesh* mesh, char const* name, Int ent_dim,
+    FieldStats const& stats, MinMax<Real> desired);
+
 void print_goal_stats(Mesh* mesh, char const* name, Int ent_dim, Reals values,
     MinMax<Real> desired, MinMax<Real> actual);
 
@@ -1,5 +1,9 @@
 #include "Omega_h_indset_inline.hpp"
 
+#ifndef _MSC_VER
+#include "Omega_h_random.hpp"
+#endif
+
 namespace Omega_h {
 
 struct QualityCompare {
@@ -14,6 +18,23 @@ struct QualityCompare {
   }
 };
 
+#ifndef _MSC_VER
+struct RandomQualityCompare {
+  Reals quality;
+  GOs priority;
+  GOs global;
+  OMEGA_H_DEVICE bool operator()(LO u, LO v) const {
+    auto const v_qual = quality[v];
+    auto const u_qual = quality[u];
+    if (u_qual != v_qual) return u_qual < v_qual;
+    auto const v_prio = priority[v];
+    auto const u_prio = priority[u];
+    if (u_prio != v_prio) return u_prio < v_prio;
+    return global[u] < global[v];
+  }
+};
+#endif
+
 Read<I8> find_indset(
     Mesh* mesh, Int ent_dim, Graph graph, Reals quality, Read<I8> candidates) {
   auto xadj = graph.a2ab;
@@ -33,4 +54,27 @@ Read<I8> find_indset(
   return find_indset(mesh, ent_dim, graph, quality, candidates);
 }
 
+#ifndef _MSC_VER
+Read<I8> find_random_indset(Mesh* mesh, Int ent_dim, Graph graph,
+    Reals quality, Read<I8> candidates, I64 seed, I64 iteration) {
+  auto xadj = graph.a2ab;
+  auto adj = graph.ab2b;
+  RandomQualityCompare compare;
+  compare.quality = quality;
+  compare.global = mesh->globals(ent_dim);
+  compare.priority =
+      random_priorities_from_globals(compare.global, seed, iteration);
+  return indset::find(mesh, ent_dim, xadj, adj, candidates, compare);
+}
+
+Read<I8> find_random_indset(Mesh* mesh, Int ent_dim, Reals quality,
+    Read<I8> candidates, I64 seed, I64 iteration) {
+  if (ent_dim == mesh->dim()) return candidates;
+  OMEGA_H_CHECK(mesh->owners_have_all_upward(ent_dim));
+  auto graph = mesh->ask_star(ent_dim);
+  return find_random_indset(
+      mesh, ent_dim, graph, quality, candidates, seed, iteration);
+}
+#endif
+
 }  // end namespace Omega_h
@@ -13,6 +13,18 @@ Read<I8> find_indset(
 Read<I8> find_indset(
     Mesh* mesh, Int ent_dim, Reals quality, Read<I8> candidates);
 
+#ifndef _MSC_VER
+/* the same, but ties in quality are broken by random_priority() keyed by
+   (seed, global, iteration) rather than by global number. on structured
+   meshes ordering by global number chains ties across the whole mesh,
+   while a random order resolves them in a logarithmic number of rounds.
+   with equal qualities everywhere this is Luby's independent set */
+Read<I8> find_random_indset(Mesh* mesh, Int ent_dim, Graph graph,
+    Reals quality, Read<I8> candidates, I64 seed, I64 iteration = 0);
+Read<I8> find_random_indset(Mesh* mesh, Int ent_dim, Reals quality,
+    Read<I8> candidates, I64 seed, I64 iteration = 0);
+#endif
+
 }  // end namespace Omega_h
 
 #endif
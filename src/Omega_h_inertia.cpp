@@ -1,11 +1,17 @@
 #include "Omega_h_inertia.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include "Omega_h_array_ops.hpp"
 #include "Omega_h_bipart.hpp"
 #include "Omega_h_eigen.hpp"
 #include "Omega_h_for.hpp"
+#include "Omega_h_map.hpp"
+#ifndef _MSC_VER
+#include "Omega_h_random.hpp"
+#endif
 
 namespace Omega_h {
 
@@ -87,13 +93,8 @@ Read<I8> mark_half(Reals distances, Real distance) {
 }
 
 bool mark_axis_bisection(CommPtr comm, Reals distances, Reals masses,
-    Real total_mass, Real tolerance, Read<I8>& marked) {
-  auto n = distances.size();
-  OMEGA_H_CHECK(n == masses.size());
-  auto minmax_dist = get_minmax(comm, distances);
-  auto range = max2(std::abs(minmax_dist.min), std::abs(minmax_dist.max));
-  auto step = range / 2.;
-  Real distance = 0.;
+    Real total_mass, Real tolerance, Real distance, Real step,
+    Read<I8>& marked) {
   for (Int i = 0; i < MANTISSA_BITS; ++i) {
     marked = mark_half(distances, distance);
     auto half_weight = get_half_weight(comm, masses, marked);
@@ -110,11 +111,140 @@ bool mark_axis_bisection(CommPtr comm, Reals distances, Reals masses,
   return false;
 }
 
+bool mark_axis_bisection(CommPtr comm, Reals distances, Reals masses,
+    Real total_mass, Real tolerance, Read<I8>& marked) {
+  auto n = distances.size();
+  OMEGA_H_CHECK(n == masses.size());
+  auto minmax_dist = get_minmax(comm, distances);
+  auto range = max2(std::abs(minmax_dist.min), std::abs(minmax_dist.max));
+  return mark_axis_bisection(
+      comm, distances, masses, total_mass, tolerance, 0., range / 2., marked);
+}
+
+#ifndef _MSC_VER
+
+constexpr LO nsample_slots = 256;
+
+/* a sample of (distances) drawn with probability proportional to mass.
+   points are dealt into slots by their random priority and each slot
+   keeps the point with the largest key log(u) / mass (Efraimidis and
+   Spirakis). the result depends only on the keys of the points.
+   only one value per slot leaves the device */
+std::vector<Real> sample_distances(
+    CommPtr comm, Reals distances, Reals masses, GOs keys) {
+  auto const n = masses.size();
+  auto const priorities =
+      random_priorities_from_globals(keys, 0, I64(comm->size()));
+  auto const nbuckets = Real(ArithTraits<I64>::max() / nsample_slots) + 1.;
+  Write<LO> slots(n);
+  Write<Real> point_keys(n);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    /* massless points go to an extra slot that is never sampled */
+    if (!(masses[i] > 0.)) {
+      slots[i] = nsample_slots;
+      point_keys[i] = 0.;
+      return;
+    }
+    slots[i] = LO(priorities[i] % nsample_slots);
+    auto u = (Real(priorities[i] / nsample_slots) + 0.5) / nbuckets;
+    point_keys[i] = std::log(u) / masses[i];
+  };
+  parallel_for(n, f, "sample_keys");
+  auto const slots2points = invert_map_by_atomics(slots, nsample_slots + 1);
+  auto const a2ab = slots2points.a2ab;
+  auto const ab2b = slots2points.ab2b;
+  auto const none = ArithTraits<Real>::min();
+  Write<Real> slot_keys(nsample_slots);
+  Write<Real> slot_distances(nsample_slots);
+  auto g = OMEGA_H_LAMBDA(LO slot) {
+    auto best_key = none;
+    auto best_distance = none;
+    for (auto ab = a2ab[slot]; ab < a2ab[slot + 1]; ++ab) {
+      auto i = ab2b[ab];
+      if (point_keys[i] > best_key ||
+          (point_keys[i] == best_key && distances[i] > best_distance)) {
+        best_key = point_keys[i];
+        best_distance = distances[i];
+      }
+    }
+    slot_keys[slot] = best_key;
+    slot_distances[slot] = best_distance;
+  };
+  parallel_for(nsample_slots, g, "sample_slots");
+  auto const h_keys = HostRead<Real>(slot_keys);
+  auto const h_distances = HostRead<Real>(slot_distances);
+  std::vector<Real> best_keys(h_keys.data(), h_keys.data() + nsample_slots);
+  auto global_keys = comm->allreduce(best_keys, OMEGA_H_MAX);
+  std::vector<Real> sample(nsample_slots, none);
+  for (std::size_t slot = 0; slot < sample.size(); ++slot) {
+    if (best_keys[slot] != none && best_keys[slot] == global_keys[slot]) {
+      sample[slot] = h_distances[LO(slot)];
+    }
+  }
+  sample = comm->allreduce(sample, OMEGA_H_MAX);
+  sample.erase(std::remove(sample.begin(), sample.end(), none), sample.end());
+  std::sort(sample.begin(), sample.end());
+  return sample;
+}
+
+/* tries to bracket the cut between two quantiles of a random sample,
+   which usually saves most of the bisection rounds over the whole range */
+bool mark_sampled_axis_bisection(CommPtr comm, Reals distances, Reals masses,
+    GOs keys, Real total_mass, Real tolerance, Read<I8>& marked) {
+  auto sample = sample_distances(comm, distances, masses, keys);
+  // with few points most slots stay empty and the full range is cheap anyway
+  if (sample.size() < std::size_t(nsample_slots / 2)) return false;
+  auto nsamples = sample.size();
+  auto lo = sample[nsamples * 2 / 5];
+  auto hi = sample[nsamples * 3 / 5];
+  auto n = distances.size();
+  Write<Real> weighted(n * 2);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    weighted[i * 2 + 0] = (distances[i] > lo) ? masses[i] : 0.;
+    weighted[i * 2 + 1] = (distances[i] > hi) ? masses[i] : 0.;
+  };
+  parallel_for(n, f, "bracket_weights");
+  Real bracket_weights[2];
+  repro_sum(comm, Reals(weighted), 2, bracket_weights);
+  auto half_mass = total_mass / 2.;
+  if (std::abs(bracket_weights[0] - half_mass) <= tolerance) {
+    marked = mark_half(distances, lo);
+    return true;
+  }
+  if (std::abs(bracket_weights[1] - half_mass) <= tolerance) {
+    marked = mark_half(distances, hi);
+    return true;
+  }
+  if (!(bracket_weights[0] > half_mass && half_mass > bracket_weights[1])) {
+    return false;
+  }
+  return mark_axis_bisection(comm, distances, masses, total_mass, tolerance,
+      (lo + hi) / 2., (hi - lo) / 4., marked);
+}
+
+#endif
+
+bool mark_axis_bisection(CommPtr comm, Reals distances, Reals masses,
+    GOs keys, Real total_mass, Real tolerance, Read<I8>& marked) {
+#ifndef _MSC_VER
+  if (keys.exists() && mark_sampled_axis_bisection(comm, distances, masses,
+                           keys, total_mass, tolerance, marked)) {
+    return true;
+  }
+#else
+  (void)keys;
+#endif
+  return mark_axis_bisection(
+      comm, distances, masses, total_mass, tolerance, marked);
+}
+
 Read<I8> mark_bisection_internal(CommPtr comm, Reals coords, Reals masses,
-    Real tolerance, Vector<3> axis, Vector<3> center, Real total_mass) {
+    GOs keys, Real tolerance, Vector<3> axis, Vector<3> center,
+    Real total_mass) {
   auto dists = get_distances(coords, center, axis);
   Read<I8> marked;
-  if (mark_axis_bisection(comm, dists, masses, total_mass, tolerance, marked)) {
+  if (mark_axis_bisection(
+          comm, dists, masses, keys, total_mass, tolerance, marked)) {
     return marked;
   }
   // if we couldn't find a decent cutting plane, this may be a highly
@@ -125,7 +255,7 @@ Read<I8> mark_bisection_internal(CommPtr comm, Reals coords, Reals masses,
     axis2[i / 2] += (i % 2) ? 1e-3 : -1e-3;
     dists = get_distances(coords, center, axis2);
     if (mark_axis_bisection(
-            comm, dists, masses, total_mass, tolerance, marked)) {
+            comm, dists, masses, keys, total_mass, tolerance, marked)) {
       return marked;
     }
   }
@@ -142,25 +272,36 @@ Read<I8> mark_bisection_internal(CommPtr comm, Reals coords, Reals masses,
 
 Read<I8> mark_bisection(
     CommPtr comm, Reals coords, Reals masses, Real tolerance, Vector<3>& axis) {
+  return mark_bisection(comm, coords, masses, tolerance, axis, GOs());
+}
+
+Read<I8> mark_bisection_given_axis(
+    CommPtr comm, Reals coords, Reals masses, Real tolerance, Vector<3> axis) {
+  return mark_bisection_given_axis(
+      comm, coords, masses, tolerance, axis, GOs());
+}
+
+Read<I8> mark_bisection(CommPtr comm, Reals coords, Reals masses,
+    Real tolerance, Vector<3>& axis, GOs keys) {
   OMEGA_H_CHECK(coords.size() == masses.size() * 3);
   auto total_mass = repro_sum(comm, masses);
   auto center = get_center(comm, coords, masses, total_mass);
   axis = get_axis(comm, coords, masses, center);
   return mark_bisection_internal(
-      comm, coords, masses, tolerance, axis, center, total_mass);
+      comm, coords, masses, keys, tolerance, axis, center, total_mass);
 }
 
-Read<I8> mark_bisection_given_axis(
-    CommPtr comm, Reals coords, Reals masses, Real tolerance, Vector<3> axis) {
+Read<I8> mark_bisection_given_axis(CommPtr comm, Reals coords, Reals masses,
+    Real tolerance, Vector<3> axis, GOs keys) {
   OMEGA_H_CHECK(coords.size() == masses.size() * 3);
   auto total_mass = repro_sum(comm, masses);
   auto center = get_center(comm, coords, masses, total_mass);
   return mark_bisection_internal(
-      comm, coords, masses, tolerance, axis, center, total_mass);
+      comm, coords, masses, keys, tolerance, axis, center, total_mass);
 }
 
 void recursively_bisect(CommPtr comm, Real tolerance, Reals* p_coords,
-    Reals* p_masses, Remotes* p_owners, Rib* p_hints) {
+    Reals* p_masses, Remotes* p_owners, Rib* p_hints, GOs* p_keys) {
   auto& coords = *p_coords;
   auto& masses = *p_masses;
   auto& owners = *p_owners;
@@ -170,21 +311,26 @@ void recursively_bisect(CommPtr comm, Real tolerance, Reals* p_coords,
   }
   Vector<3> axis;
   Read<I8> marks;
+  GOs keys;
+  if (p_keys && hints.sample_cuts) keys = *p_keys;
   if (hints.axes.empty()) {
-    marks = inertia::mark_bisection(comm, coords, masses, tolerance, axis);
+    marks =
+        inertia::mark_bisection(comm, coords, masses, tolerance, axis, keys);
   } else {
     axis = hints.axes.front();
     hints.axes.erase(hints.axes.begin());
     marks = inertia::mark_bisection_given_axis(
-        comm, coords, masses, tolerance, axis);
+        comm, coords, masses, tolerance, axis, keys);
   }
   auto dist = bi_partition(comm, marks);
   coords = dist.exch(coords, 3);
   masses = dist.exch(masses, 1);
   owners = dist.exch(owners, 1);
+  if (p_keys) *p_keys = dist.exch(*p_keys, 1);
   auto halfsize = divide_no_remainder(comm->size(), 2);
   comm = comm->split(comm->rank() / halfsize, comm->rank() % halfsize);
-  recursively_bisect(comm, tolerance, p_coords, p_masses, p_owners, p_hints);
+  recursively_bisect(
+      comm, tolerance, p_coords, p_masses, p_owners, p_hints, p_keys);
   hints.axes.insert(hints.axes.begin(), axis);
 }
 
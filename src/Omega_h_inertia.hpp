@@ -12,14 +12,27 @@ namespace inertia {
 
 struct Rib {
   std::vector<Vector<3>> axes;
+  /* bracket each cut by a random sample keyed by global numbers before
+     bisecting. off by default, which keeps the original partitions */
+  bool sample_cuts = false;
 };
 
 Read<I8> mark_bisection(
     CommPtr comm, Reals coords, Reals masses, Real tolerance, Vector<3>& axis);
 Read<I8> mark_bisection_given_axis(
     CommPtr comm, Reals coords, Reals masses, Real tolerance, Vector<3> axis);
+/* the same, given a global key per point. the cut is first bracketed by
+   quantiles of a mass-weighted random sample keyed by (keys), which
+   depends only on the keys and not on how the points are spread over
+   ranks, and then refined inside that bracket */
+Read<I8> mark_bisection(CommPtr comm, Reals coords, Reals masses,
+    Real tolerance, Vector<3>& axis, GOs keys);
+Read<I8> mark_bisection_given_axis(CommPtr comm, Reals coords, Reals masses,
+    Real tolerance, Vector<3> axis, GOs keys);
+/* (p_keys), if given, are global numbers of the points, which travel
+   with them and key the samples when (p_hints->sample_cuts) is set */
 void recursively_bisect(CommPtr comm, Real tolerance, Reals* p_coords,
-    Reals* p_masses, Remotes* p_owners, Rib* p_hints);
+    Reals* p_masses, Remotes* p_owners, Rib* p_hints, GOs* p_keys = nullptr);
 }  // namespace inertia
 
 }  // end namespace Omega_h
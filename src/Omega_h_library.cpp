@@ -5,6 +5,7 @@
 #include <Omega_h_profile.hpp>
 
 #include <csignal>
+#include <fstream>
 #include <cstdarg>
 #include <cstdlib>
 #include <iostream>
@@ -82,6 +83,12 @@ void Library::initialize(char const* head_desc, int* argc, char*** argv
       "--osh-memory", "print amount and stacktrace of max memory use");
   cmdline.add_flag(
       "--osh-time", "print amount of time spend in certain functions");
+  auto& time_json_flag = cmdline.add_flag("--osh-time-json",
+      "write the --osh-time profile reduced over all ranks as JSON");
+  time_json_flag.add_arg<std::string>("path");
+  auto& time_sample_flag = cmdline.add_flag("--osh-time-sample",
+      "like --osh-time, but sample regions instead of timing every call");
+  time_sample_flag.add_arg<double>("hertz");
   cmdline.add_flag("--osh-signal", "catch signals and print a stacktrace");
   cmdline.add_flag("--osh-fpe", "enable floating-point exceptions");
   cmdline.add_flag("--osh-silent", "suppress all output");
@@ -99,6 +106,22 @@ void Library::initialize(char const* head_desc, int* argc, char*** argv
     Omega_h::profile::global_singleton_history =
         new Omega_h::profile::History();
   }
+  if (cmdline.parsed("--osh-time-sample")) {
+    if (!Omega_h::profile::global_singleton_history) {
+      Omega_h::profile::global_singleton_history =
+          new Omega_h::profile::History();
+    }
+    auto hertz = cmdline.get<double>("--osh-time-sample", "hertz");
+    Omega_h::profile::start_sampling(
+        Omega_h::profile::global_singleton_history, 1.0 / hertz);
+  }
+  if (cmdline.parsed("--osh-time-json")) {
+    time_json_path_ = cmdline.get<std::string>("--osh-time-json", "path");
+    if (!Omega_h::profile::global_singleton_history) {
+      Omega_h::profile::global_singleton_history =
+          new Omega_h::profile::History();
+    }
+  }
   if (cmdline.parsed("--osh-fpe")) {
     enable_floating_point_exceptions();
   }
@@ -157,9 +180,21 @@ Library::Library(Library const& other)
 
 Library::~Library() {
   if (Omega_h::profile::global_singleton_history) {
+    auto& history = *Omega_h::profile::global_singleton_history;
+    Omega_h::profile::stop_sampling(&history);
     if (world_->rank() == 0) {
-      Omega_h::profile::print_top_down_and_bottom_up(
-          *Omega_h::profile::global_singleton_history);
+      Omega_h::profile::print_top_down_and_bottom_up(history);
+    }
+    if (world_->size() > 1 || !time_json_path_.empty()) {
+      auto reduced = Omega_h::profile::reduce_history(history, world_);
+      if (world_->rank() == 0 && world_->size() > 1) {
+        Omega_h::profile::print_time_sorted(reduced);
+      }
+      if (world_->rank() == 0 && !time_json_path_.empty()) {
+        std::ofstream file(time_json_path_.c_str());
+        OMEGA_H_CHECK(file.is_open());
+        Omega_h::profile::write_json(file, reduced);
+      }
     }
     delete Omega_h::profile::global_singleton_history;
     Omega_h::profile::global_singleton_history = nullptr;
@@ -2,6 +2,7 @@
 #define OMEGA_H_LIBRARY_HPP
 
 #include <map>
+#include <string>
 
 #include <Omega_h_comm.hpp>
 
@@ -54,6 +55,7 @@ class Library {
   bool we_called_kokkos_init;
 #endif
   std::map<std::string, double> timers;
+  std::string time_json_path_;
 };
 
 extern char* max_memory_stacktrace;
@@ -36,6 +36,14 @@ LO linear_partition_size(GO total, I32 comm_size, I32 comm_rank) {
     return static_cast<LO>(quot);
 }
 
+GO linear_partition_begin(GO total, I32 comm_size, I32 comm_rank) {
+  auto const comm_size_gt = GO(comm_size);
+  auto const quot = total / comm_size_gt;
+  auto const rem = total % comm_size_gt;
+  auto const rank_gt = GO(comm_rank);
+  return rank_gt * quot + min2(rank_gt, rem);
+}
+
 Remotes globals_to_linear_owners(CommPtr comm, Read<GO> globals, GO total) {
   return globals_to_linear_owners(globals, total, comm->size());
 }
@@ -44,6 +52,10 @@ LO linear_partition_size(CommPtr comm, GO total) {
   return linear_partition_size(total, comm->size(), comm->rank());
 }
 
+GO linear_partition_begin(CommPtr comm, GO total) {
+  return linear_partition_begin(total, comm->size(), comm->rank());
+}
+
 GO find_total_globals(CommPtr comm, Read<GO> globals) {
   auto const a = get_max(comm, globals);
   if (a < 0) return 0;
@@ -72,4 +72,12 @@
 #define OMEGA_H_DLL
 #endif
 
+/* for the globals that each thread rank of run_thread_ranks needs its
+   own copy of. DLL interfaces can not export thread-local data */
+#ifdef _MSC_VER
+#define OMEGA_H_THREAD_LOCAL
+#else
+#define OMEGA_H_THREAD_LOCAL thread_local
+#endif
+
 #endif
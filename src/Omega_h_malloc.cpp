@@ -71,6 +71,8 @@ void disable_pooling() {
   host_pool = nullptr;
 }
 
+bool is_pooling_enabled() { return device_pool != nullptr; }
+
 void* maybe_pooled_device_malloc(std::size_t size) {
   if (device_pool) return allocate(*device_pool, size);
   return device_malloc(size);
@@ -12,6 +12,7 @@ void host_free(void* ptr, std::size_t size);
 
 void enable_pooling();
 void disable_pooling();
+bool is_pooling_enabled();
 
 void* maybe_pooled_device_malloc(std::size_t size);
 void maybe_pooled_device_free(void* ptr, std::size_t size);
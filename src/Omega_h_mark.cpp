@@ -5,7 +5,10 @@
 #include "Omega_h_array_ops.hpp"
 #include "Omega_h_element.hpp"
 #include "Omega_h_for.hpp"
+#include "Omega_h_map.hpp"
 #include "Omega_h_mesh.hpp"
+#include "Omega_h_profile.hpp"
+#include "Omega_h_sort.hpp"
 
 namespace Omega_h {
 
@@ -99,42 +102,113 @@ Read<I8> mark_by_class(Mesh* mesh, Int ent_dim, Int class_dim, I32 class_id) {
   return land_each(id_marks, mark_by_class_dim(mesh, ent_dim, class_dim));
 }
 
-Read<I8> mark_class_closure(
-    Mesh* mesh, Int ent_dim, Int class_dim, ClassId class_id) {
-  OMEGA_H_CHECK(ent_dim <= class_dim);
-  auto eq_marks = mark_by_class(mesh, class_dim, class_dim, class_id);
-  if (ent_dim == class_dim) return eq_marks;
-  return mark_down(mesh, class_dim, ent_dim, eq_marks);
-}
-
-Read<I8> get_eq_marks(
-    Mesh* mesh, Int class_dim, std::vector<ClassId> const& class_ids) {
-  auto sorted_class_ids = class_ids;
-  std::sort(begin(sorted_class_ids), end(sorted_class_ids));
-  HostWrite<LO> h_sorted_class_ids(LO(sorted_class_ids.size()));
-  for (size_t i = 0; i < sorted_class_ids.size(); ++i) {
-    h_sorted_class_ids[LO(i)] = sorted_class_ids[i];
+ClassIndex get_class_index(Mesh* mesh, Int class_dim) {
+  OMEGA_H_TIME_FUNCTION;
+  auto eqs = collect_marked(mark_by_class_dim(mesh, class_dim, class_dim));
+  auto eq_ids = unmap(eqs, mesh->get_array<ClassId>(class_dim, "class_id"), 1);
+  auto perm = sort_by_keys(read(eq_ids));
+  auto sorted_ids = unmap(perm, read(eq_ids), 1);
+  auto sorted_eqs = unmap(perm, eqs, 1);
+  auto neq = eqs.size();
+  Write<I8> is_first_w(neq);
+  auto mark_first = OMEGA_H_LAMBDA(LO i) {
+    is_first_w[i] = I8((i == 0) || (sorted_ids[i] != sorted_ids[i - 1]));
+  };
+  parallel_for(neq, mark_first, "get_class_index(first)");
+  auto firsts = collect_marked(read(is_first_w));
+  auto nids = firsts.size();
+  Write<LO> id_offsets(nids + 1);
+  auto copy_firsts = OMEGA_H_LAMBDA(LO i) { id_offsets[i] = firsts[i]; };
+  parallel_for(nids, copy_firsts, "get_class_index(offsets)");
+  id_offsets.set(nids, neq);
+  ClassIndex index;
+  index.ids = unmap(firsts, read(sorted_ids), 1);
+  index.closures[class_dim] = Graph(id_offsets, sorted_eqs);
+  return index;
+}
+
+Graph get_class_closures(Mesh* mesh, Int class_dim, Int ent_dim,
+    Read<ClassId> ids, Graph ids2eqs) {
+  OMEGA_H_TIME_FUNCTION;
+  OMEGA_H_CHECK(ent_dim < class_dim);
+  auto eqs = ids2eqs.ab2b;
+  auto eq2id = invert_fan(ids2eqs.a2ab);
+  auto eqe2e = mesh->ask_down(class_dim, ent_dim).ab2b;
+  auto deg = element_degree(mesh->family(), class_dim, ent_dim);
+  auto npairs = eqs.size() * deg;
+  /* (model entity, mesh entity) pairs, sorted and made unique */
+  Write<LO> pairs(npairs * 2);
+  auto fill = OMEGA_H_LAMBDA(LO p) {
+    auto i = p / deg;
+    pairs[p * 2 + 0] = eq2id[i];
+    pairs[p * 2 + 1] = eqe2e[eqs[i] * deg + p % deg];
+  };
+  parallel_for(npairs, fill, "get_class_closures(pairs)");
+  auto perm = sort_by_keys(read(pairs), 2);
+  auto sorted = unmap(perm, read(pairs), 2);
+  Write<I8> is_first_w(npairs);
+  auto mark_first = OMEGA_H_LAMBDA(LO p) {
+    is_first_w[p] = I8((p == 0) || (sorted[p * 2 + 0] != sorted[p * 2 - 2]) ||
+                       (sorted[p * 2 + 1] != sorted[p * 2 - 1]));
+  };
+  parallel_for(npairs, mark_first, "get_class_closures(unique)");
+  auto firsts = collect_marked(read(is_first_w));
+  auto uniq = unmap(firsts, read(sorted), 2);
+  auto closure2id = get_component(read(uniq), 2, 0);
+  auto closure2ent = get_component(read(uniq), 2, 1);
+  return Graph(invert_funnel(closure2id, ids.size()), closure2ent);
+}
+
+/* marks the closures of the given model entities using the cached
+   class index: only the entities in those closures are visited */
+static void scatter_class_closures(Mesh* mesh, Int ent_dim, Int class_dim,
+    std::vector<ClassId> const& class_ids, Write<I8> marks) {
+  OMEGA_H_CHECK(class_dim >= ent_dim);
+  auto& index = mesh->ask_class_index(class_dim, ent_dim);
+  auto closures = index.closures[ent_dim];
+  auto h_ids = HostRead<ClassId>(index.ids);
+  auto h_offsets = HostRead<LO>(closures.a2ab);
+  std::vector<LO> selected;
+  HostWrite<LO> h_sel2items_w(LO(class_ids.size() + 1));
+  LO nitems = 0;
+  h_sel2items_w[0] = 0;
+  for (auto class_id : class_ids) {
+    auto first = std::lower_bound(h_ids.data(), h_ids.data() + h_ids.size(),
+        class_id);
+    auto i = LO(first - h_ids.data());
+    if (i == h_ids.size() || h_ids[i] != class_id) continue;
+    nitems += h_offsets[i + 1] - h_offsets[i];
+    selected.push_back(i);
+    h_sel2items_w[LO(selected.size())] = nitems;
   }
-  auto d_sorted_class_ids = Read<ClassId>(h_sorted_class_ids.write());
-  auto nclass_ids = d_sorted_class_ids.size();
-  auto eq_class_dims = mesh->get_array<I8>(class_dim, "class_dim");
-  auto eq_class_ids = mesh->get_array<LO>(class_dim, "class_id");
-  auto neq = mesh->nents(class_dim);
-  Write<I8> eq_marks_w(neq);
-  auto f = OMEGA_H_LAMBDA(LO eq) {
-    eq_marks_w[eq] = I8((eq_class_dims[eq] == I8(class_dim)) &&
-                        (-1 != binary_search(d_sorted_class_ids,
-                                   eq_class_ids[eq], nclass_ids)));
+  if (nitems == 0) return;
+  auto nsel = LO(selected.size());
+  HostWrite<LO> h_sel2ids_w(nsel);
+  for (LO i = 0; i < nsel; ++i) h_sel2ids_w[i] = selected[std::size_t(i)];
+  auto sel2ids = LOs(h_sel2ids_w.write());
+  auto sel2items = LOs(h_sel2items_w.write());
+  auto item2sel = invert_fan(sel2items);
+  auto ids2closure = closures.a2ab;
+  auto closure2ents = closures.ab2b;
+  auto f = OMEGA_H_LAMBDA(LO item) {
+    auto sel = item2sel[item];
+    auto id = sel2ids[sel];
+    auto closure = ids2closure[id] + (item - sel2items[sel]);
+    marks[closure2ents[closure]] = 1;
   };
-  parallel_for(neq, f, "mark_class_closures");
-  return eq_marks_w;
+  parallel_for(nitems, f, "scatter_class_closures");
+}
+
+Read<I8> mark_class_closure(
+    Mesh* mesh, Int ent_dim, Int class_dim, ClassId class_id) {
+  return mark_class_closures(mesh, ent_dim, class_dim, {class_id});
 }
 
 Read<I8> mark_class_closures(Mesh* mesh, Int ent_dim, Int class_dim,
     std::vector<ClassId> const& class_ids) {
   OMEGA_H_CHECK(class_dim >= ent_dim);
-  auto eq_marks = get_eq_marks(mesh, class_dim, class_ids);
-  auto marks = mark_down(mesh, class_dim, ent_dim, eq_marks);
+  Write<I8> marks(mesh->nents(ent_dim), I8(0));
+  scatter_class_closures(mesh, ent_dim, class_dim, class_ids, marks);
   return marks;
 }
 
@@ -142,7 +216,7 @@ Read<I8> mark_class_closures(Mesh* mesh, Int class_dim,
     std::vector<ClassId> const& class_ids, Graph nodes2ents) {
   OMEGA_H_CHECK(nodes2ents.a2ab.exists());
   OMEGA_H_CHECK(nodes2ents.ab2b.exists());
-  auto eq_marks = get_eq_marks(mesh, class_dim, class_ids);
+  auto eq_marks = mark_class_closures(mesh, class_dim, class_dim, class_ids);
   auto marks = mark_down(nodes2ents, eq_marks);
   return marks;
 }
@@ -160,13 +234,11 @@ static std::vector<LO> get_dim_class_ids(
 
 Read<I8> mark_class_closures(
     Mesh* mesh, Int ent_dim, std::vector<ClassPair> const& class_pairs) {
-  auto marks = Read<I8>(mesh->nents(ent_dim), I8(0));
+  Write<I8> marks(mesh->nents(ent_dim), I8(0));
   for (Int class_dim = ent_dim; class_dim <= mesh->dim(); ++class_dim) {
     auto dim_class_ids = get_dim_class_ids(class_dim, class_pairs);
     if (dim_class_ids.empty()) continue;
-    auto class_dim_marks =
-        mark_class_closures(mesh, ent_dim, class_dim, dim_class_ids);
-    marks = lor_each(marks, class_dim_marks);
+    scatter_class_closures(mesh, ent_dim, class_dim, dim_class_ids, marks);
   }
   return marks;
 }
@@ -22,6 +22,14 @@ Read<I8> mark_dual_layers(Mesh* mesh, Read<I8> marks, Int nlayers);
 GO count_owned_marks(Mesh* mesh, Int ent_dim, Read<I8> marks);
 Read<I8> mark_sliver_layers(Mesh* mesh, Real qual_ceil, Int nlayers);
 Read<I8> mark_exposed_sides(Mesh* mesh);
+/* builds the ids and equal-order closures of a ClassIndex */
+ClassIndex get_class_index(Mesh* mesh, Int class_dim);
+/* builds the closures of dimension (ent_dim) of a ClassIndex */
+Graph get_class_closures(Mesh* mesh, Int class_dim, Int ent_dim,
+    Read<ClassId> ids, Graph ids2eqs);
+
+/* these use the cached Mesh::ask_class_index, so they only visit the
+   entities in the requested closures */
 Read<I8> mark_class_closure(
     Mesh* mesh, Int ent_dim, Int class_dim, LO class_id);
 
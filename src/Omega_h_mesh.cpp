@@ -16,6 +16,7 @@
 #include "Omega_h_migrate.hpp"
 #include "Omega_h_quality.hpp"
 #include "Omega_h_shape.hpp"
+#include "Omega_h_surface.hpp"
 #include "Omega_h_timer.hpp"
 
 namespace Omega_h {
@@ -60,7 +61,8 @@ void Mesh::set_comm(CommPtr const& new_comm) {
   /* if some ranks already have mesh data, their
      parallel info needs updating, we'll do this
      by using the old Dist to set new owners */
-  if (0 < nnew_had_comm && library_->world()->size() > 1) {
+  if (0 < nnew_had_comm &&
+      (library_->world()->size() > 1 || new_comm->size() > 1)) {
     for (Int d = 0; d <= dim(); ++d) {
       auto dist = ask_dist(d);
       dist.change_comm(new_comm);
@@ -153,6 +155,7 @@ void Mesh::add_tag(Int ent_dim, std::string const& name, Int ncomps,
     tags_[ent_dim].push_back(std::move(ptr));
   }
   OMEGA_H_CHECK(array.size() == nents_[ent_dim] * ncomps);
+  react_to_cached_tag(ent_dim, name);
   /* internal typically indicates migration/adaptation/file reading,
      when we do not want any invalidation to take place.
      the invalidation is there to prevent users changing coordinates
@@ -170,6 +173,7 @@ void Mesh::set_tag(
   }
   Tag<T>* tag = as<T>(tag_iter(ent_dim, name)->get());
   OMEGA_H_CHECK(array.size() == nents(ent_dim) * tag->ncomps());
+  react_to_cached_tag(ent_dim, name);
   /* internal typically indicates migration/adaptation/file reading,
      when we do not want any invalidation to take place.
      the invalidation is there to prevent users changing coordinates
@@ -190,6 +194,16 @@ void Mesh::react_to_set_tag(Int ent_dim, std::string const& name) {
   }
 }
 
+void Mesh::react_to_cached_tag(Int ent_dim, std::string const& name) {
+  /* unlike the invalidations above, these also apply to internal
+     changes, since neither cache is ever carried over to a new mesh */
+  bool is_class = (name == "class_id" || name == "class_dim");
+  if (is_class) class_indices_[ent_dim] = ClassIndexPtr();
+  if (is_class || (ent_dim == VERT && name == "coordinates")) {
+    surface_info_ = SurfaceInfoPtr();
+  }
+}
+
 TagBase const* Mesh::get_tagbase(Int ent_dim, std::string const& name) const {
   check_dim2(ent_dim);
   auto it = tag_iter(ent_dim, name);
@@ -214,6 +228,7 @@ void Mesh::remove_tag(Int ent_dim, std::string const& name) {
   if (!has_tag(ent_dim, name)) return;
   check_dim2(ent_dim);
   OMEGA_H_CHECK(has_tag(ent_dim, name));
+  react_to_cached_tag(ent_dim, name);
   tags_[ent_dim].erase(tag_iter(ent_dim, name));
 }
 
@@ -410,6 +425,28 @@ Reals Mesh::ask_sizes() {
   return get_array<Real>(dim(), "size");
 }
 
+ClassIndex const& Mesh::ask_class_index(Int class_dim, Int ent_dim) {
+  check_dim2(class_dim);
+  OMEGA_H_CHECK(0 <= ent_dim && ent_dim <= class_dim);
+  if (!class_indices_[class_dim]) {
+    class_indices_[class_dim] =
+        std::make_shared<ClassIndex>(get_class_index(this, class_dim));
+  }
+  auto& index = *(class_indices_[class_dim]);
+  if (!index.closures[ent_dim].a2ab.exists()) {
+    index.closures[ent_dim] = get_class_closures(this, class_dim, ent_dim,
+        index.ids, index.closures[class_dim]);
+  }
+  return index;
+}
+
+SurfaceInfo const& Mesh::ask_surface_info() {
+  if (!surface_info_) {
+    surface_info_ = std::make_shared<SurfaceInfo>(get_surface_info(this));
+  }
+  return *surface_info_;
+}
+
 Bytes Mesh::ask_levels(Int ent_dim) {
   check_dim2(ent_dim);
   if (!has_tag(ent_dim, "level")) {
@@ -572,7 +609,11 @@ void Mesh::balance(bool predictive) {
   }
   abs_tol *= 2.0;  // fudge factor ?
   auto owners = ask_owners(dim());
-  recursively_bisect(comm(), abs_tol, &ecoords, &masses, &owners, &hints);
+  /* global numbers key the sampled cuts, and only travel when used */
+  GOs keys;
+  if (hints.sample_cuts) keys = globals(dim());
+  recursively_bisect(comm(), abs_tol, &ecoords, &masses, &owners, &hints,
+      hints.sample_cuts ? &keys : nullptr);
   rib_hints_ = std::make_shared<inertia::Rib>(hints);
   auto unsorted_new2owners = Dist(comm_, owners, nelems());
   auto owners2new = unsorted_new2owners.invert();
@@ -624,6 +665,31 @@ Read<T> Mesh::reduce_array(Int ent_dim, Read<T> a, Int width, Omega_h_Op op) {
   return ask_dist(ent_dim).exch_reduce(a, width, op);
 }
 
+std::vector<MixedArray> Mesh::sync_arrays(
+    Int ent_dim, std::vector<MixedArray> const& arrays) {
+  if (!could_be_shared(ent_dim)) return arrays;
+  return exch_arrays(ask_dist(ent_dim).invert(), arrays);
+}
+
+MixedFuture Mesh::isync_arrays(
+    Int ent_dim, std::vector<MixedArray> const& arrays) {
+  if (!could_be_shared(ent_dim)) return MixedFuture(arrays);
+  return iexch_arrays(ask_dist(ent_dim).invert(), arrays);
+}
+
+std::vector<MixedArray> Mesh::reduce_arrays(
+    Int ent_dim, std::vector<MixedArray> const& arrays, Omega_h_Op op) {
+  if (!could_be_shared(ent_dim)) return arrays;
+  return exch_reduce_arrays(ask_dist(ent_dim), arrays, op);
+}
+
+std::vector<MixedArray> Mesh::reduce_arrays(Int ent_dim,
+    std::vector<MixedArray> const& arrays, std::vector<Omega_h_Op> const& ops,
+    bool ordered) {
+  if (!could_be_shared(ent_dim)) return arrays;
+  return exch_reduce_arrays(ask_dist(ent_dim), arrays, ops, ordered);
+}
+
 template <typename T>
 Read<T> Mesh::owned_array(Int ent_dim, Read<T> a, Int width) {
   OMEGA_H_CHECK(a.size() == width * nents(ent_dim));
@@ -11,6 +11,7 @@
 #include <Omega_h_comm.hpp>
 #include <Omega_h_dist.hpp>
 #include <Omega_h_library.hpp>
+#include <Omega_h_mixed.hpp>
 #include <Omega_h_tag.hpp>
 
 namespace Omega_h {
@@ -19,6 +20,8 @@ namespace inertia {
 struct Rib;
 }
 
+struct SurfaceInfo;
+
 struct ClassPair {
   inline ClassPair() = default;
   inline ClassPair(Int t_dim, LO t_id) : dim(t_dim), id(t_id) {}
@@ -33,6 +36,19 @@ struct ClassPair {
 
 using ClassSets = std::map<std::string, std::vector<ClassPair>>;
 
+/* index from the model entities of one dimension to the
+   mesh entities in their closure, built once from the
+   "class_dim" and "class_id" tags */
+struct ClassIndex {
+  /* sorted IDs of the model entities that have
+     equal-order mesh entities */
+  Read<ClassId> ids;
+  /* from each model entity (position in ids) to
+     the sorted mesh entities of each dimension in its closure.
+     built on demand. */
+  Graph closures[DIMS];
+};
+
 class Mesh {
  public:
   Mesh();
@@ -93,6 +109,8 @@ class Mesh {
   typedef std::shared_ptr<inertia::Rib> RibPtr;
   typedef std::shared_ptr<Parents> ParentPtr;
   typedef std::shared_ptr<Children> ChildrenPtr;
+  typedef std::shared_ptr<ClassIndex> ClassIndexPtr;
+  typedef std::shared_ptr<SurfaceInfo> SurfaceInfoPtr;
 
  private:
   typedef std::vector<TagPtr> TagVector;
@@ -106,6 +124,7 @@ class Mesh {
   Adj derive_adj(Int from, Int to);
   Adj ask_adj(Int from, Int to);
   void react_to_set_tag(Int dim, std::string const& name);
+  void react_to_cached_tag(Int dim, std::string const& name);
   Omega_h_Family family_;
   Int dim_;
   CommPtr comm_;
@@ -119,6 +138,8 @@ class Mesh {
   RibPtr rib_hints_;
   ParentPtr parents_[DIMS];
   ChildrenPtr children_[DIMS][DIMS];
+  ClassIndexPtr class_indices_[DIMS];
+  SurfaceInfoPtr surface_info_;
   Library* library_;
 
  public:
@@ -133,6 +154,8 @@ class Mesh {
   Bytes ask_leaves(Int dim);
   Parents ask_parents(Int child_dim);
   Children ask_children(Int parent_dim, Int child_dim);
+  ClassIndex const& ask_class_index(Int class_dim, Int ent_dim);
+  SurfaceInfo const& ask_surface_info();
   bool has_any_parents() const;
   void set_owners(Int dim, Remotes owners);
   Remotes ask_owners(Int dim);
@@ -152,6 +175,17 @@ class Mesh {
       Int ent_dim, Read<T> a_data, LOs a2e, T default_val, Int width);
   template <typename T>
   Read<T> reduce_array(Int ent_dim, Read<T> a, Int width, Omega_h_Op op);
+  /* like sync_array and reduce_array for several arrays of
+     any types and widths, all moved in one exchange */
+  std::vector<MixedArray> sync_arrays(
+      Int ent_dim, std::vector<MixedArray> const& arrays);
+  MixedFuture isync_arrays(
+      Int ent_dim, std::vector<MixedArray> const& arrays);
+  std::vector<MixedArray> reduce_arrays(
+      Int ent_dim, std::vector<MixedArray> const& arrays, Omega_h_Op op);
+  std::vector<MixedArray> reduce_arrays(Int ent_dim,
+      std::vector<MixedArray> const& arrays,
+      std::vector<Omega_h_Op> const& ops, bool ordered = false);
   template <typename T>
   Read<T> owned_array(Int ent_dim, Read<T> a, Int width);
   void sync_tag(Int dim, std::string const& name);
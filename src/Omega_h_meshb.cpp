@@ -5,127 +5,206 @@
 #include "Omega_h_class.hpp"
 #include "Omega_h_file.hpp"
 #include "Omega_h_for.hpp"
+#include "Omega_h_linpart.hpp"
 #include "Omega_h_map.hpp"
+#include "Omega_h_mark.hpp"
+#include "Omega_h_mesh.hpp"
+#include "Omega_h_profile.hpp"
 
 namespace Omega_h {
 
 namespace meshb {
 
-template <int version>
-struct VersionTypes;
-
 using GmfFile = std::int64_t;
 /* contrary to the documentation, GmfSetKwd
  * and GmfStatKwd always operate on 64-bit values.
  */
 using GmfLine = std::int64_t;
 
-template <>
-struct VersionTypes<1> {
-  using Index = std::int32_t;
-  using RealIn = float;
-  // contrary to the documentation, GmfSetLin expects doubles
-  using RealOut = double;
-};
+/* all sections are moved with GmfGetBlock and GmfSetBlock, which convert
+   between the numbers in the file (32 or 64 bits, depending on the
+   version) and doubles and 64-bit integers in memory. whole sections,
+   or the slice of one rank, move in one call straight into arrays that
+   are then decoded in parallel, instead of one library call per line */
 
-template <>
-struct VersionTypes<2> {
-  using Index = std::int32_t;
-  using RealIn = double;
-  using RealOut = double;
-};
+static void check_version(int version, char const* what) {
+  if (version < 1 || version > 4) {
+    Omega_h_fail("unknown libMeshb version %d when %s\n", version, what);
+  }
+}
 
-template <>
-struct VersionTypes<3> {
-  using Index = std::int32_t;
-  using RealIn = double;
-  using RealOut = double;
-};
+static GmfKwdCod const simplex_kwds[4] = {
+    GmfVertices, GmfEdges, GmfTriangles, GmfTetrahedra};
 
-template <>
-struct VersionTypes<4> {
-  using Index = std::int64_t;
-  using RealIn = double;
-  using RealOut = double;
-};
+/* coordinates of vertices [begin, end), the references are dropped */
+static Reals read_vertices(GmfFile file, Int dim, GO begin, GO end) {
+  auto n = LO(end - begin);
+  HostWrite<Real> coords(n * dim);
+  HostWrite<GO> refs(n);
+  if (n == 0) return coords.write();
+  auto ok = GmfGetBlock(file, GmfVertices, begin + 1, end, 0, nullptr,
+      nullptr, GmfDoubleVec, int(dim), coords.data(),
+      coords.data() + (n - 1) * dim, GmfLong, refs.data(),
+      refs.data() + (n - 1));
+  if (!ok) Omega_h_fail("could not read Meshb vertices\n");
+  return coords.write();
+}
 
-static void safe_goto(GmfFile file, GmfKwdCod key) {
-  auto ret = GmfGotoKwd(file, key);
-  OMEGA_H_CHECK(ret);
+/* one-based vertices and references of simplices [begin, end) */
+static void read_simplices(GmfFile file, Int ent_dim, GO begin, GO end,
+    GOs* p_verts, GOs* p_refs) {
+  auto n = LO(end - begin);
+  auto deg = ent_dim + 1;
+  HostWrite<GO> verts(n * deg);
+  HostWrite<GO> refs(n);
+  if (n > 0) {
+    auto ok = GmfGetBlock(file, simplex_kwds[ent_dim], begin + 1, end, 0,
+        nullptr, nullptr, GmfLongVec, int(deg), verts.data(),
+        verts.data() + (n - 1) * deg, GmfLong, refs.data(),
+        refs.data() + (n - 1));
+    if (!ok) Omega_h_fail("could not read Meshb simplices\n");
+  }
+  *p_verts = verts.write();
+  *p_refs = refs.write();
 }
 
-static GmfKwdCod const simplex_kwds[4] = {
-    GmfVertices, GmfEdges, GmfTriangles, GmfTetrahedra};
+template <typename T>
+static Read<T> narrow(GOs a, GO shift) {
+  auto n = a.size();
+  Write<T> out(n);
+  auto f = OMEGA_H_LAMBDA(LO i) { out[i] = static_cast<T>(a[i] - shift); };
+  parallel_for(n, f, "meshb_narrow");
+  return out;
+}
 
-template <int version>
-static void read_meshb_version(Mesh* mesh, GmfFile file, int dim) {
-  using GmfIndex = typename VersionTypes<version>::Index;
-  using GmfReal = typename VersionTypes<version>::RealIn;
-  LO nverts = LO(GmfStatKwd(file, GmfVertices));
-  safe_goto(file, GmfVertices);
-  auto coords = HostWrite<Real>(LO(nverts) * dim);
-  for (LO i = 0; i < nverts; ++i) {
-    GmfIndex ref;
-    Few<GmfReal, 3> tmp;
-    if (dim == 2)
-      GmfGetLin(file, GmfVertices, &tmp[0], &tmp[1], &ref);
-    else
-      GmfGetLin(file, GmfVertices, &tmp[0], &tmp[1], &tmp[2], &ref);
-    for (int j = 0; j < dim; ++j) coords[i * dim + j] = Real(tmp[j]);
+template <typename T>
+static GOs widen(Read<T> a, GO shift) {
+  auto n = a.size();
+  Write<GO> out(n);
+  auto f = OMEGA_H_LAMBDA(LO i) { out[i] = GO(a[i]) + shift; };
+  parallel_for(n, f, "meshb_widen");
+  return out;
+}
+
+/* old files number their simplices in the reference field,
+   which then carries no classification */
+static bool is_old_convention(Read<ClassId> refs, GO begin) {
+  return refs == Read<ClassId>(refs.size(), ClassId(begin + 1), 1);
+}
+
+/* without element ghosts a side on a partition boundary has its two
+   cells on two ranks, so the cell counts are summed over all copies */
+static Read<I8> mark_globally_exposed_sides(Mesh* mesh) {
+  auto dim = mesh->dim();
+  auto counts = get_degrees(mesh->ask_up(dim - 1, dim).a2ab);
+  if (mesh->could_be_shared(dim - 1)) {
+    counts = mesh->reduce_array(dim - 1, counts, 1, OMEGA_H_SUM);
+    counts = mesh->sync_array(dim - 1, counts, 1);
+  }
+  return each_lt(counts, 2);
+}
+
+void read(Mesh* mesh, std::string const& filepath) {
+  ScopedTimer timer("meshb::read");
+  int version, dim;
+  auto file = GmfOpenMesh(filepath.c_str(), GmfRead, &version, &dim);
+  if (!file) {
+    Omega_h_fail(
+        "could not open Meshb file %s for reading\n", filepath.c_str());
   }
-  HostWrite<LO> eqs2verts[4];
-  HostWrite<ClassId> eqs2class_id[4];
-  LO neqs[4];
+  check_version(version, "reading");
+  OMEGA_H_CHECK(dim == 2 || dim == 3);
+  auto nverts = GO(GmfStatKwd(file, GmfVertices));
+  auto coords = read_vertices(file, dim, 0, nverts);
+  LOs eqs2verts[4];
+  Read<ClassId> eqs2class_id[4];
   for (Int ent_dim = 1; ent_dim <= dim; ++ent_dim) {
-    auto ent_kwd = simplex_kwds[ent_dim];
-    neqs[ent_dim] = LO(GmfStatKwd(file, ent_kwd));
-    if (ent_dim < dim && neqs[ent_dim] < 1) continue;
-    eqs2verts[ent_dim] = HostWrite<LO>(LO(neqs[ent_dim]) * (ent_dim + 1));
-    eqs2class_id[ent_dim] = HostWrite<ClassId>(LO(neqs[ent_dim]));
-    safe_goto(file, ent_kwd);
-    bool is_old_convention = true;
-    for (LO i = 0; i < neqs[ent_dim]; ++i) {
-      GmfIndex class_id;
-      Few<GmfIndex, 4> tmp;
-      if (ent_dim == 1) {
-        GmfGetLin(file, ent_kwd, &tmp[0], &tmp[1], &class_id);
-      } else if (ent_dim == 2) {
-        GmfGetLin(file, ent_kwd, &tmp[0], &tmp[1], &tmp[2], &class_id);
-      } else {
-        GmfGetLin(file, ent_kwd, &tmp[0], &tmp[1], &tmp[2], &tmp[3], &class_id);
-      }
-      for (Int j = 0; j < (ent_dim + 1); ++j) {
-        eqs2verts[ent_dim][i * (ent_dim + 1) + j] = LO(tmp[j]) - 1;
-      }
-      eqs2class_id[ent_dim][i] = ClassId(class_id);
-      if (LO(class_id) != i + 1) is_old_convention = false;
-    }
-    if (is_old_convention) {
-      eqs2class_id[ent_dim] = HostWrite<ClassId>();
-    }
+    auto neqs = GO(GmfStatKwd(file, simplex_kwds[ent_dim]));
+    if (ent_dim < dim && neqs < 1) continue;
+    GOs file_verts, file_refs;
+    read_simplices(file, ent_dim, 0, neqs, &file_verts, &file_refs);
+    eqs2verts[ent_dim] = narrow<LO>(file_verts, 1);
+    auto class_ids = narrow<ClassId>(file_refs, 0);
+    if (!is_old_convention(class_ids, 0)) eqs2class_id[ent_dim] = class_ids;
   }
   GmfCloseMesh(file);
   build_from_elems2verts(
-      mesh, OMEGA_H_SIMPLEX, dim, LOs(eqs2verts[dim].write()), LO(nverts));
-  mesh->add_tag(VERT, "coordinates", dim, Reals(coords.write()));
+      mesh, OMEGA_H_SIMPLEX, dim, eqs2verts[dim], LO(nverts));
+  mesh->add_tag(VERT, "coordinates", dim, coords);
   if (eqs2class_id[dim].exists()) {
-    mesh->add_tag(dim, "class_id", 1, Read<ClassId>(ClassId(neqs[dim]), 1));
+    mesh->add_tag(dim, "class_id", 1, eqs2class_id[dim]);
   } else {
-    mesh->add_tag(dim, "class_id", 1, Read<ClassId>(eqs2class_id[dim].write()));
+    mesh->add_tag(dim, "class_id", 1, Read<ClassId>(mesh->nelems(), 1));
   }
   for (Int ent_dim = 1; ent_dim < dim; ++ent_dim) {
     if (eqs2class_id[ent_dim].exists()) {
-      classify_equal_order(mesh, ent_dim, eqs2verts[ent_dim].write(),
-          eqs2class_id[ent_dim].write());
+      classify_equal_order(
+          mesh, ent_dim, eqs2verts[ent_dim], eqs2class_id[ent_dim]);
     }
   }
   finalize_classification(mesh);
 }
 
-template <int version>
-static void write_meshb_version(Mesh* mesh, GmfFile file, int dim) {
-  using GmfIndex = typename VersionTypes<version>::Index;
-  using GmfReal = typename VersionTypes<version>::RealOut;
+void read_sliced(Mesh* mesh, std::string const& filepath, CommPtr comm) {
+  ScopedTimer timer("meshb::read_sliced");
+  int version, dim;
+  auto file = GmfOpenMesh(filepath.c_str(), GmfRead, &version, &dim);
+  if (!file) {
+    Omega_h_fail(
+        "could not open Meshb file %s for reading\n", filepath.c_str());
+  }
+  check_version(version, "reading");
+  OMEGA_H_CHECK(dim == 2 || dim == 3);
+  auto nverts = GO(GmfStatKwd(file, GmfVertices));
+  GO verts_begin, verts_end;
+  suggest_slices(
+      nverts, comm->size(), comm->rank(), &verts_begin, &verts_end);
+  auto slice_coords = read_vertices(file, dim, verts_begin, verts_end);
+  auto nelems = GO(GmfStatKwd(file, simplex_kwds[dim]));
+  GO elems_begin, elems_end;
+  suggest_slices(
+      nelems, comm->size(), comm->rank(), &elems_begin, &elems_end);
+  GOs file_verts, file_refs;
+  read_simplices(file, dim, elems_begin, elems_end, &file_verts, &file_refs);
+  GmfCloseMesh(file);
+  auto slice_conn = subtract_from_each(file_verts, GO(1));
+  auto slice_class_ids = narrow<ClassId>(file_refs, 0);
+  Dist slice_elems2elems;
+  Dist slice_verts2verts;
+  LOs conn;
+  assemble_slices(comm, OMEGA_H_SIMPLEX, dim, nelems, elems_begin,
+      slice_conn, nverts, verts_begin, slice_coords, &slice_elems2elems,
+      &conn, &slice_verts2verts);
+  auto nslice_verts = LO(verts_end - verts_begin);
+  auto slice_vert_globals = GOs(nslice_verts, verts_begin, 1);
+  auto vert_globals = slice_verts2verts.exch(slice_vert_globals, 1);
+  build_from_elems2verts(mesh, comm, OMEGA_H_SIMPLEX, dim, conn, vert_globals);
+  auto coords = slice_verts2verts.exch(slice_coords, dim);
+  mesh->add_tag(VERT, "coordinates", dim, coords);
+  /* lower dimensional sections would have to be matched across ranks,
+     so here only elements are classified from the file */
+  classify_elements(mesh);
+  if (comm->reduce_and(is_old_convention(slice_class_ids, elems_begin))) {
+    mesh->add_tag(dim, "class_id", 1, Read<ClassId>(mesh->nelems(), 1));
+  } else {
+    mesh->add_tag(
+        dim, "class_id", 1, slice_elems2elems.exch(slice_class_ids, 1));
+  }
+  classify_sides_by_exposure(mesh, mark_globally_exposed_sides(mesh));
+  mesh->set_parting(OMEGA_H_GHOSTED);
+  finalize_classification(mesh);
+  mesh->set_parting(OMEGA_H_ELEM_BASED);
+}
+
+void write(Mesh* mesh, std::string const& filepath, int version) {
+  ScopedTimer timer("meshb::write");
+  auto dim = int(mesh->dim());
+  auto file = GmfOpenMesh(filepath.c_str(), GmfWrite, version, dim);
+  if (!file) {
+    Omega_h_fail(
+        "could not open Meshb file %s for writing\n", filepath.c_str());
+  }
+  check_version(version, "writing");
   auto nverts = mesh->nverts();
   GmfSetKwd(file, GmfVertices, GmfLine(nverts));
   auto coords = HostRead<Real>(mesh->coords());
@@ -135,15 +214,13 @@ static void write_meshb_version(Mesh* mesh, GmfFile file, int dim) {
   } else {
     vert_refs = LOs(mesh->nverts(), 1);
   }
-  auto h_vert_refs = HostRead<LO>(vert_refs);
-  for (LO i = 0; i < nverts; ++i) {
-    Few<GmfReal, 3> tmp = {0.0, 0.0, 0.0};
-    for (int j = 0; j < dim; ++j) tmp[j] = GmfReal(coords[i * dim + j]);
-    auto ref = GmfIndex(h_vert_refs[i]);
-    if (dim == 2)
-      GmfSetLin(file, GmfVertices, tmp[0], tmp[1], ref);
-    else
-      GmfSetLin(file, GmfVertices, tmp[0], tmp[1], tmp[2], ref);
+  auto h_vert_refs = HostRead<GO>(widen(vert_refs, 0));
+  if (nverts > 0) {
+    GmfSetBlock(file, GmfVertices, 1, nverts, 0, nullptr, nullptr,
+        GmfDoubleVec, dim, const_cast<Real*>(coords.data()),
+        const_cast<Real*>(coords.data() + (nverts - 1) * dim), GmfLong,
+        const_cast<GO*>(h_vert_refs.data()),
+        const_cast<GO*>(h_vert_refs.data() + (nverts - 1)));
   }
   for (Int ent_dim = 1; ent_dim <= dim; ++ent_dim) {
     auto ents2class_dim = mesh->get_array<I8>(ent_dim, "class_dim");
@@ -152,90 +229,41 @@ static void write_meshb_version(Mesh* mesh, GmfFile file, int dim) {
     auto ents_are_eqs = each_eq_to(ents2class_dim, I8(ent_dim));
     auto eqs2ents = collect_marked(ents_are_eqs);
     auto neqs = eqs2ents.size();
-    auto eqs2verts = HostRead<LO>(unmap(eqs2ents, ents2verts, ent_dim + 1));
-    auto eqs2class_id = HostRead<LO>(unmap(eqs2ents, ents2class_id, 1));
+    auto deg = ent_dim + 1;
+    auto eqs2verts = HostRead<GO>(
+        widen(read(unmap(eqs2ents, ents2verts, deg)), 1));
+    auto eqs2class_id =
+        HostRead<GO>(widen(read(unmap(eqs2ents, ents2class_id, 1)), 0));
     auto ent_kwd = simplex_kwds[ent_dim];
     GmfSetKwd(file, ent_kwd, GmfLine(neqs));
-    for (LO i = 0; i < neqs; ++i) {
-      GmfIndex ref = eqs2class_id[i];
-      Few<GmfIndex, 4> tmp;
-      for (Int j = 0; j < (ent_dim + 1); ++j) {
-        tmp[j] = eqs2verts[i * (ent_dim + 1) + j] + 1;
-      }
-      if (ent_dim == 1) {
-        GmfSetLin(file, ent_kwd, tmp[0], tmp[1], ref);
-      } else if (ent_dim == 2) {
-        GmfSetLin(file, ent_kwd, tmp[0], tmp[1], tmp[2], ref);
-      } else {
-        GmfSetLin(file, ent_kwd, tmp[0], tmp[1], tmp[2], tmp[3], ref);
-      }
-    }
+    if (neqs == 0) continue;
+    GmfSetBlock(file, ent_kwd, 1, neqs, 0, nullptr, nullptr, GmfLongVec, deg,
+        const_cast<GO*>(eqs2verts.data()),
+        const_cast<GO*>(eqs2verts.data() + (neqs - 1) * deg), GmfLong,
+        const_cast<GO*>(eqs2class_id.data()),
+        const_cast<GO*>(eqs2class_id.data() + (neqs - 1)));
   }
   GmfCloseMesh(file);
 }
 
-void read(Mesh* mesh, std::string const& filepath) {
+void read_sol(
+    Mesh* mesh, std::string const& filepath, std::string const& sol_name) {
+  ScopedTimer timer("meshb::read_sol");
   int version, dim;
   auto file = GmfOpenMesh(filepath.c_str(), GmfRead, &version, &dim);
   if (!file) {
-    Omega_h_fail(
-        "could not open Meshb file %s for reading\n", filepath.c_str());
+    Omega_h_fail("could not open Meshb solution file %s for reading\n",
+        filepath.c_str());
   }
+  check_version(version, "reading");
   OMEGA_H_CHECK(dim == 2 || dim == 3);
-  switch (version) {
-    case 1:
-      read_meshb_version<1>(mesh, file, dim);
-      return;
-    case 2:
-      read_meshb_version<2>(mesh, file, dim);
-      return;
-    case 3:
-      read_meshb_version<3>(mesh, file, dim);
-      return;
-    case 4:
-      read_meshb_version<4>(mesh, file, dim);
-      return;
-  }
-  Omega_h_fail("unknown libMeshb version %d when reading\n", version);
-}
-
-void write(Mesh* mesh, std::string const& filepath, int version) {
-  auto dim = int(mesh->dim());
-  auto file = GmfOpenMesh(filepath.c_str(), GmfWrite, version, dim);
-  if (!file) {
-    Omega_h_fail(
-        "could not open Meshb file %s for writing\n", filepath.c_str());
-  }
-  switch (version) {
-    case 1:
-      write_meshb_version<1>(mesh, file, dim);
-      return;
-    case 2:
-      write_meshb_version<2>(mesh, file, dim);
-      return;
-    case 3:
-      write_meshb_version<3>(mesh, file, dim);
-      return;
-    case 4:
-      write_meshb_version<4>(mesh, file, dim);
-      return;
-  }
-  Omega_h_fail("unknown libMeshb version %d when writing\n", version);
-}
-
-template <int version>
-static void read_sol_version(Mesh* mesh, GmfFile file, Int dim,
-    std::string const& filepath, std::string const& sol_name) {
-  using GmfReal = typename VersionTypes<version>::RealIn;
-  int type_table[1];
+  int type_table[GmfMaxTyp];
   int ntypes, sol_size;
-  LO nverts =
-      LO(GmfStatKwd(file, GmfSolAtVertices, &ntypes, &sol_size, type_table));
-  safe_goto(file, GmfSolAtVertices);
+  auto nsols =
+      GO(GmfStatKwd(file, GmfSolAtVertices, &ntypes, &sol_size, type_table));
   if (ntypes != 1) {
     Omega_h_fail("\"%s\" has %d fields, Omega_h supports only one\n",
         filepath.c_str(), ntypes);
-    /* also, there was definitely a buffer overflow writing to type_table */
   }
   auto field_type = type_table[0];
   Int ncomps = -1;
@@ -249,49 +277,47 @@ static void read_sol_version(Mesh* mesh, GmfFile file, Int dim,
     Omega_h_fail(
         "unexpected field type %d in \"%s\"\n", field_type, filepath.c_str());
   }
-  HostWrite<Real> hw(ncomps * nverts);
-  for (LO i = 0; i < nverts; ++i) {
-    Few<GmfReal, 6> tmp;
-    GmfGetLin(file, GmfSolAtVertices, tmp.data());
-    for (Int j = 0; j < ncomps; ++j) hw[i * ncomps + j] = Real(tmp[j]);
+  /* in parallel each rank reads one slice and sends it to the copies
+     of the vertices whose global numbers fall in it */
+  auto comm = mesh->comm();
+  GO begin = 0;
+  GO end = nsols;
+  if (comm->size() > 1) {
+    begin = linear_partition_begin(comm, nsols);
+    end = begin + linear_partition_size(comm, nsols);
+  } else {
+    OMEGA_H_CHECK(nsols == mesh->nverts());
+  }
+  auto n = LO(end - begin);
+  HostWrite<Real> hw(n * ncomps);
+  if (n > 0) {
+    auto ok = GmfGetBlock(file, GmfSolAtVertices, begin + 1, end, 0, nullptr,
+        nullptr, GmfDoubleVec, int(ncomps), hw.data(),
+        hw.data() + (n - 1) * ncomps);
+    if (!ok) Omega_h_fail("could not read \"%s\"\n", filepath.c_str());
   }
   GmfCloseMesh(file);
   auto dr = Reals(hw.write());
+  if (comm->size() > 1) {
+    OMEGA_H_CHECK(mesh->nglobal_ents(VERT) == nsols);
+    auto verts2slices = copies_to_linear_owners(comm, mesh->globals(VERT));
+    dr = verts2slices.invert().exch(dr, ncomps);
+  }
   if (field_type == 3) dr = symms_inria2osh(dim, dr);
   mesh->add_tag(VERT, sol_name, ncomps, dr);
 }
 
-void read_sol(
-    Mesh* mesh, std::string const& filepath, std::string const& sol_name) {
-  int version, dim;
-  auto file = GmfOpenMesh(filepath.c_str(), GmfRead, &version, &dim);
+void write_sol(Mesh* mesh, std::string const& filepath,
+    std::string const& sol_name, int version) {
+  ScopedTimer timer("meshb::write_sol");
+  auto dim = int(mesh->dim());
+  auto file = GmfOpenMesh(filepath.c_str(), GmfWrite, version, dim);
   if (!file) {
-    Omega_h_fail("could not open Meshb solution file %s for reading\n",
+    Omega_h_fail("could not open Meshb solution file %s for writing\n",
         filepath.c_str());
   }
+  check_version(version, "writing");
   OMEGA_H_CHECK(dim == 2 || dim == 3);
-  switch (version) {
-    case 1:
-      read_sol_version<1>(mesh, file, dim, filepath, sol_name);
-      return;
-    case 2:
-      read_sol_version<2>(mesh, file, dim, filepath, sol_name);
-      return;
-    case 3:
-      read_sol_version<3>(mesh, file, dim, filepath, sol_name);
-      return;
-    case 4:
-      read_sol_version<4>(mesh, file, dim, filepath, sol_name);
-      return;
-  }
-  Omega_h_fail("unknown libMeshb solution version %d when reading\n", version);
-}
-
-template <int version>
-static void write_sol_version(
-    Mesh* mesh, GmfFile file, std::string const& sol_name) {
-  auto dim = mesh->dim();
-  using GmfReal = typename VersionTypes<version>::RealIn;
   auto nverts = mesh->nverts();
   auto tag = mesh->get_tag<Real>(VERT, sol_name);
   auto ncomps = tag->ncomps();
@@ -312,40 +338,14 @@ static void write_sol_version(
   auto dr = tag->array();
   if (field_type == 3) dr = symms_osh2inria(dim, dr);
   HostRead<Real> hr(dr);
-  for (LO i = 0; i < nverts; ++i) {
-    Few<GmfReal, 6> tmp;
-    for (Int j = 0; j < ncomps; ++j) tmp[j] = GmfReal(hr[i * ncomps + j]);
-    GmfSetLin(file, GmfSolAtVertices, tmp.data());
+  if (nverts > 0) {
+    GmfSetBlock(file, GmfSolAtVertices, 1, nverts, 0, nullptr, nullptr,
+        GmfDoubleVec, int(ncomps), const_cast<Real*>(hr.data()),
+        const_cast<Real*>(hr.data() + (nverts - 1) * ncomps));
   }
   GmfCloseMesh(file);
 }
 
-void write_sol(Mesh* mesh, std::string const& filepath,
-    std::string const& sol_name, int version) {
-  auto dim = int(mesh->dim());
-  auto file = GmfOpenMesh(filepath.c_str(), GmfWrite, version, dim);
-  if (!file) {
-    Omega_h_fail("could not open Meshb solution file %s for writing\n",
-        filepath.c_str());
-  }
-  OMEGA_H_CHECK(dim == 2 || dim == 3);
-  switch (version) {
-    case 1:
-      write_sol_version<1>(mesh, file, sol_name);
-      return;
-    case 2:
-      write_sol_version<2>(mesh, file, sol_name);
-      return;
-    case 3:
-      write_sol_version<3>(mesh, file, sol_name);
-      return;
-    case 4:
-      write_sol_version<4>(mesh, file, sol_name);
-      return;
-  }
-  Omega_h_fail("unknown libMeshb solution version %d when reading\n", version);
-}
-
 }  // namespace meshb
 
 }  // namespace Omega_h
@@ -417,7 +417,7 @@ void get_curve_curvature_metrics(
 }
 
 Reals get_curvature_metrics(Mesh* mesh, Real segment_angle) {
-  auto surface_info = get_surface_info(mesh);
+  auto surface_info = mesh->ask_surface_info();
   auto out = Write<Real>(mesh->nverts() * symm_ncomps(mesh->dim()), 0.0);
   if (mesh->dim() == 3) {
     /* this algorithm creates degenerate metrics that only specify size in
@@ -8,7 +8,9 @@
 #include "Omega_h_int_scan.hpp"
 #include "Omega_h_map.hpp"
 #include "Omega_h_mesh.hpp"
+#include "Omega_h_mixed.hpp"
 #include "Omega_h_owners.hpp"
+#include "Omega_h_profile.hpp"
 
 namespace Omega_h {
 
@@ -122,48 +124,85 @@ void push_down(Mesh* old_mesh, Int ent_dim, Int low_dim,
   }
 }
 
-void push_tags(Mesh const* old_mesh, Mesh* new_mesh, Int ent_dim,
-    Dist old_owners2new_ents) {
-  OMEGA_H_TIME_FUNCTION;
-  OMEGA_H_CHECK(old_owners2new_ents.nroots() == old_mesh->nents(ent_dim));
+/* every tag of ent_dim, and old_own_ranks if it exists, are moved
+   together by exch_arrays: tags are packed into as few exchanges as
+   max_packed_bytes allows, and on very large ranks any tag beyond
+   that is exchanged by itself, unpacked, as push_tags used to do.
+   returns the new owner ranks */
+static Read<I32> push_packed(Mesh const* old_mesh, Mesh* new_mesh,
+    Int ent_dim, Dist old_owners2new_ents, Read<I32> old_own_ranks) {
+  std::vector<MixedArray> arrays;
+  for (Int i = 0; i < old_mesh->ntags(ent_dim); ++i) {
+    auto tag = old_mesh->get_tag(ent_dim, i);
+    switch (tag->type()) {
+      case OMEGA_H_I8:
+        arrays.emplace_back(as<I8>(tag)->array(), tag->ncomps());
+        break;
+      case OMEGA_H_I32:
+        arrays.emplace_back(as<I32>(tag)->array(), tag->ncomps());
+        break;
+      case OMEGA_H_I64:
+        arrays.emplace_back(as<I64>(tag)->array(), tag->ncomps());
+        break;
+      case OMEGA_H_F64:
+        arrays.emplace_back(as<Real>(tag)->array(), tag->ncomps());
+        break;
+    }
+  }
+  if (old_own_ranks.exists()) arrays.emplace_back(old_own_ranks, 1);
+  arrays = exch_arrays(old_owners2new_ents, arrays);
   for (Int i = 0; i < old_mesh->ntags(ent_dim); ++i) {
     auto tag = old_mesh->get_tag(ent_dim, i);
-    if (is<I8>(tag)) {
-      auto array = as<I8>(tag)->array();
-      array = old_owners2new_ents.exch(array, tag->ncomps());
-      new_mesh->add_tag<I8>(ent_dim, tag->name(), tag->ncomps(), array, true);
-    } else if (is<I32>(tag)) {
-      auto array = as<I32>(tag)->array();
-      array = old_owners2new_ents.exch(array, tag->ncomps());
-      new_mesh->add_tag<I32>(ent_dim, tag->name(), tag->ncomps(), array, true);
-    } else if (is<I64>(tag)) {
-      auto array = as<I64>(tag)->array();
-      array = old_owners2new_ents.exch(array, tag->ncomps());
-      new_mesh->add_tag<I64>(ent_dim, tag->name(), tag->ncomps(), array, true);
-    } else if (is<Real>(tag)) {
-      auto array = as<Real>(tag)->array();
-      array = old_owners2new_ents.exch(array, tag->ncomps());
-      new_mesh->add_tag<Real>(ent_dim, tag->name(), tag->ncomps(), array, true);
+    auto const& array = arrays[std::size_t(i)];
+    switch (tag->type()) {
+      case OMEGA_H_I8:
+        new_mesh->add_tag(
+            ent_dim, tag->name(), tag->ncomps(), array.get<I8>(), true);
+        break;
+      case OMEGA_H_I32:
+        new_mesh->add_tag(
+            ent_dim, tag->name(), tag->ncomps(), array.get<I32>(), true);
+        break;
+      case OMEGA_H_I64:
+        new_mesh->add_tag(
+            ent_dim, tag->name(), tag->ncomps(), array.get<I64>(), true);
+        break;
+      case OMEGA_H_F64:
+        new_mesh->add_tag(
+            ent_dim, tag->name(), tag->ncomps(), array.get<Real>(), true);
+        break;
     }
   }
+  if (!old_own_ranks.exists()) return Read<I32>();
+  return arrays.back().get<I32>();
+}
+
+void push_tags(Mesh const* old_mesh, Mesh* new_mesh, Int ent_dim,
+    Dist old_owners2new_ents) {
+  OMEGA_H_TIME_FUNCTION;
+  OMEGA_H_CHECK(old_owners2new_ents.nroots() == old_mesh->nents(ent_dim));
+  push_packed(old_mesh, new_mesh, ent_dim, old_owners2new_ents, Read<I32>());
 }
 
 void push_ents(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
     Dist new_ents2old_owners, Dist old_owners2new_ents, Omega_h_Parting mode) {
-  push_tags(old_mesh, new_mesh, ent_dim, old_owners2new_ents);
-  Read<I32> own_ranks;
+  OMEGA_H_TIME_FUNCTION;
+  OMEGA_H_CHECK(old_owners2new_ents.nroots() == old_mesh->nents(ent_dim));
   /* if we are ghosting, each entity should remain owned by the
    * same rank that owned it before ghosting, as this is the only
    * mechanism we have to identify the ghost layers.
    * if we are doing a vertex-based partitioning, at least the
    * vertices ought to retain their original owners, for similar
    * reasons.
+   * those ranks travel in the same message as the tags.
    */
+  Read<I32> old_own_ranks;
   if ((mode == OMEGA_H_GHOSTED) ||
       ((mode == OMEGA_H_VERT_BASED) && (ent_dim == VERT))) {
-    auto old_own_ranks = old_mesh->ask_owners(ent_dim).ranks;
-    own_ranks = old_owners2new_ents.exch(old_own_ranks, 1);
+    old_own_ranks = old_mesh->ask_owners(ent_dim).ranks;
   }
+  auto own_ranks = push_packed(
+      old_mesh, new_mesh, ent_dim, old_owners2new_ents, old_own_ranks);
   auto owners = update_ownership(new_ents2old_owners, own_ranks);
   new_mesh->set_owners(ent_dim, owners);
 }
@@ -0,0 +1,394 @@
+#include "Omega_h_mixed.hpp"
+
+#include <cstring>
+#include <memory>
+
+#include "Omega_h_dist.hpp"
+#include "Omega_h_for.hpp"
+#include "Omega_h_map.hpp"
+#include "Omega_h_scalar.hpp"
+
+namespace Omega_h {
+
+MixedArray::MixedArray(Read<I8> array, Int width)
+    : type_(OMEGA_H_I8), width_(width), i8_(array) {}
+
+MixedArray::MixedArray(Read<I32> array, Int width)
+    : type_(OMEGA_H_I32), width_(width), i32_(array) {}
+
+MixedArray::MixedArray(Read<I64> array, Int width)
+    : type_(OMEGA_H_I64), width_(width), i64_(array) {}
+
+MixedArray::MixedArray(Read<Real> array, Int width)
+    : type_(OMEGA_H_F64), width_(width), f64_(array) {}
+
+Int MixedArray::nbytes_per_ent() const {
+  switch (type_) {
+    case OMEGA_H_I8:
+      return width_ * Int(sizeof(I8));
+    case OMEGA_H_I32:
+      return width_ * Int(sizeof(I32));
+    case OMEGA_H_I64:
+      return width_ * Int(sizeof(I64));
+    case OMEGA_H_F64:
+      return width_ * Int(sizeof(Real));
+  }
+  OMEGA_H_NORETURN(-1);
+}
+
+LO MixedArray::nents() const {
+  switch (type_) {
+    case OMEGA_H_I8:
+      return divide_no_remainder(i8_.size(), width_);
+    case OMEGA_H_I32:
+      return divide_no_remainder(i32_.size(), width_);
+    case OMEGA_H_I64:
+      return divide_no_remainder(i64_.size(), width_);
+    case OMEGA_H_F64:
+      return divide_no_remainder(f64_.size(), width_);
+  }
+  OMEGA_H_NORETURN(-1);
+}
+
+template <>
+Read<I8> MixedArray::get() const {
+  OMEGA_H_CHECK(type_ == OMEGA_H_I8);
+  return i8_;
+}
+
+template <>
+Read<I32> MixedArray::get() const {
+  OMEGA_H_CHECK(type_ == OMEGA_H_I32);
+  return i32_;
+}
+
+template <>
+Read<I64> MixedArray::get() const {
+  OMEGA_H_CHECK(type_ == OMEGA_H_I64);
+  return i64_;
+}
+
+template <>
+Read<Real> MixedArray::get() const {
+  OMEGA_H_CHECK(type_ == OMEGA_H_F64);
+  return f64_;
+}
+
+Int get_packed_width(std::vector<MixedArray> const& arrays) {
+  Int width = 0;
+  for (auto& array : arrays) width += array.nbytes_per_ent();
+  return width;
+}
+
+template <typename T>
+static void pack_array(
+    Write<I8> packed, Int packed_width, Int offset, Read<T> data, Int width) {
+  auto n = divide_no_remainder(data.size(), width);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    for (Int j = 0; j < width; ++j) {
+      T value = data[i * width + j];
+      std::memcpy(&packed[i * packed_width + offset + Int(sizeof(T)) * j],
+          &value, sizeof(T));
+    }
+  };
+  parallel_for(n, f, "pack_array");
+}
+
+template <typename T>
+static Read<T> unpack_array(
+    Read<I8> packed, Int packed_width, Int offset, Int width) {
+  auto n = divide_no_remainder(packed.size(), packed_width);
+  Write<T> data(n * width);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    for (Int j = 0; j < width; ++j) {
+      T value;
+      std::memcpy(&value,
+          &packed[i * packed_width + offset + Int(sizeof(T)) * j], sizeof(T));
+      data[i * width + j] = value;
+    }
+  };
+  parallel_for(n, f, "unpack_array");
+  return data;
+}
+
+Read<I8> pack_arrays(std::vector<MixedArray> const& arrays) {
+  if (arrays.empty()) return Read<I8>({});
+  auto packed_width = get_packed_width(arrays);
+  auto n = arrays[0].nents();
+  OMEGA_H_CHECK(I64(n) * packed_width <= I64(ArithTraits<LO>::max()));
+  Write<I8> packed(n * packed_width);
+  Int offset = 0;
+  for (auto& array : arrays) {
+    OMEGA_H_CHECK(array.nents() == n);
+    switch (array.type()) {
+      case OMEGA_H_I8:
+        pack_array(packed, packed_width, offset, array.get<I8>(),
+            array.width());
+        break;
+      case OMEGA_H_I32:
+        pack_array(packed, packed_width, offset, array.get<I32>(),
+            array.width());
+        break;
+      case OMEGA_H_I64:
+        pack_array(packed, packed_width, offset, array.get<I64>(),
+            array.width());
+        break;
+      case OMEGA_H_F64:
+        pack_array(packed, packed_width, offset, array.get<Real>(),
+            array.width());
+        break;
+    }
+    offset += array.nbytes_per_ent();
+  }
+  return packed;
+}
+
+std::vector<MixedArray> unpack_arrays(
+    Read<I8> packed, std::vector<MixedArray> const& layout) {
+  std::vector<MixedArray> arrays;
+  auto packed_width = get_packed_width(layout);
+  Int offset = 0;
+  for (auto& array : layout) {
+    auto width = array.width();
+    switch (array.type()) {
+      case OMEGA_H_I8:
+        arrays.emplace_back(
+            unpack_array<I8>(packed, packed_width, offset, width), width);
+        break;
+      case OMEGA_H_I32:
+        arrays.emplace_back(
+            unpack_array<I32>(packed, packed_width, offset, width), width);
+        break;
+      case OMEGA_H_I64:
+        arrays.emplace_back(
+            unpack_array<I64>(packed, packed_width, offset, width), width);
+        break;
+      case OMEGA_H_F64:
+        arrays.emplace_back(
+            unpack_array<Real>(packed, packed_width, offset, width), width);
+        break;
+    }
+    offset += array.nbytes_per_ent();
+  }
+  return arrays;
+}
+
+std::vector<std::size_t> get_packing_batches(
+    std::vector<MixedArray> const& arrays, LO nents, I64 max_bytes) {
+  std::vector<std::size_t> begins;
+  I64 batch_bytes = 0;
+  for (std::size_t i = 0; i < arrays.size(); ++i) {
+    auto bytes = I64(nents) * arrays[i].nbytes_per_ent();
+    if (begins.empty() || batch_bytes + bytes > max_bytes) {
+      begins.push_back(i);
+      batch_bytes = 0;
+    }
+    batch_bytes += bytes;
+  }
+  begins.push_back(arrays.size());
+  return begins;
+}
+
+MixedFuture::MixedFuture(std::vector<MixedArray> ready) {
+  completed_.push_back([]() { return true; });
+  get_.push_back([ready]() { return ready; });
+}
+
+MixedFuture::MixedFuture(Future<I8> packed, std::vector<MixedArray> layout) {
+  auto future = std::make_shared<Future<I8>>(packed);
+  completed_.push_back([future]() { return future->completed(); });
+  get_.push_back(
+      [future, layout]() { return unpack_arrays(future->get(), layout); });
+}
+
+template <typename T>
+MixedFuture::MixedFuture(Future<T> single, Int width) {
+  auto future = std::make_shared<Future<T>>(single);
+  completed_.push_back([future]() { return future->completed(); });
+  get_.push_back([future, width]() {
+    return std::vector<MixedArray>{MixedArray(future->get(), width)};
+  });
+}
+
+void MixedFuture::append(MixedFuture const& other) {
+  completed_.insert(
+      completed_.end(), other.completed_.begin(), other.completed_.end());
+  get_.insert(get_.end(), other.get_.begin(), other.get_.end());
+}
+
+bool MixedFuture::completed() {
+  for (auto& f : completed_) {
+    if (!f()) return false;
+  }
+  return true;
+}
+
+std::vector<MixedArray> MixedFuture::get() {
+  std::vector<MixedArray> arrays;
+  for (auto& f : get_) {
+    auto batch = f();
+    arrays.insert(arrays.end(), batch.begin(), batch.end());
+  }
+  return arrays;
+}
+
+/* the packed sizes on both sides of the exchange count */
+static std::vector<std::size_t> get_packing_batches(
+    Dist const& dist, std::vector<MixedArray> const& arrays) {
+  auto nents = max2(dist.nitems(), dist.invert().nitems());
+  return get_packing_batches(arrays, nents);
+}
+
+template <typename T>
+static MixedArray exch_single(Dist const& dist, MixedArray const& array) {
+  return MixedArray(dist.exch(array.get<T>(), array.width()), array.width());
+}
+
+template <typename T>
+static MixedFuture iexch_single(Dist const& dist, MixedArray const& array) {
+  return MixedFuture(dist.iexch(array.get<T>(), array.width()), array.width());
+}
+
+std::vector<MixedArray> exch_arrays(
+    Dist const& dist, std::vector<MixedArray> const& arrays) {
+  if (arrays.empty()) return arrays;
+  auto begins = get_packing_batches(dist, arrays);
+  std::vector<MixedArray> out;
+  for (std::size_t b = 0; b + 1 < begins.size(); ++b) {
+    if (begins[b + 1] - begins[b] == 1) {
+      auto& array = arrays[begins[b]];
+      switch (array.type()) {
+        case OMEGA_H_I8:
+          out.push_back(exch_single<I8>(dist, array));
+          break;
+        case OMEGA_H_I32:
+          out.push_back(exch_single<I32>(dist, array));
+          break;
+        case OMEGA_H_I64:
+          out.push_back(exch_single<I64>(dist, array));
+          break;
+        case OMEGA_H_F64:
+          out.push_back(exch_single<Real>(dist, array));
+          break;
+      }
+      continue;
+    }
+    std::vector<MixedArray> batch(
+        arrays.begin() + std::ptrdiff_t(begins[b]),
+        arrays.begin() + std::ptrdiff_t(begins[b + 1]));
+    auto packed = dist.exch(pack_arrays(batch), get_packed_width(batch));
+    for (auto& array : unpack_arrays(packed, batch)) out.push_back(array);
+  }
+  return out;
+}
+
+MixedFuture iexch_arrays(
+    Dist const& dist, std::vector<MixedArray> const& arrays) {
+  if (arrays.empty()) return MixedFuture(arrays);
+  auto begins = get_packing_batches(dist, arrays);
+  MixedFuture out;
+  for (std::size_t b = 0; b + 1 < begins.size(); ++b) {
+    if (begins[b + 1] - begins[b] == 1) {
+      auto& array = arrays[begins[b]];
+      switch (array.type()) {
+        case OMEGA_H_I8:
+          out.append(iexch_single<I8>(dist, array));
+          break;
+        case OMEGA_H_I32:
+          out.append(iexch_single<I32>(dist, array));
+          break;
+        case OMEGA_H_I64:
+          out.append(iexch_single<I64>(dist, array));
+          break;
+        case OMEGA_H_F64:
+          out.append(iexch_single<Real>(dist, array));
+          break;
+      }
+      continue;
+    }
+    std::vector<MixedArray> batch(
+        arrays.begin() + std::ptrdiff_t(begins[b]),
+        arrays.begin() + std::ptrdiff_t(begins[b + 1]));
+    auto packed = dist.iexch(pack_arrays(batch), get_packed_width(batch));
+    out.append(MixedFuture(packed, batch));
+  }
+  return out;
+}
+
+template <typename T>
+static MixedArray reduce_onto_roots(
+    LOs roots2items, MixedArray const& items, Omega_h_Op op) {
+  return MixedArray(
+      fan_reduce(roots2items, items.get<T>(), items.width(), op),
+      items.width());
+}
+
+/* sums the items of each root in increasing order of value, after an
+   insertion sort of a scratch copy since fans are short. the result then
+   depends only on the values and not on the order they were received in */
+static Reals sum_in_value_order(LOs roots2items, Reals items, Int width) {
+  auto nroots = roots2items.size() - 1;
+  auto sorted = deep_copy(items, "sorted_items");
+  Write<Real> out(nroots * width);
+  auto f = OMEGA_H_LAMBDA(LO root) {
+    auto begin = roots2items[root];
+    auto end = roots2items[root + 1];
+    for (Int j = 0; j < width; ++j) {
+      for (auto i = begin + 1; i < end; ++i) {
+        auto v = sorted[i * width + j];
+        auto k = i;
+        for (; k > begin && sorted[(k - 1) * width + j] > v; --k) {
+          sorted[k * width + j] = sorted[(k - 1) * width + j];
+        }
+        sorted[k * width + j] = v;
+      }
+      Real sum = 0.0;
+      for (auto i = begin; i < end; ++i) sum += sorted[i * width + j];
+      out[root * width + j] = sum;
+    }
+  };
+  parallel_for(nroots, f, "sum_in_value_order");
+  return out;
+}
+
+std::vector<MixedArray> exch_reduce_arrays(Dist const& dist,
+    std::vector<MixedArray> const& arrays, std::vector<Omega_h_Op> const& ops,
+    bool ordered) {
+  OMEGA_H_CHECK(ops.size() == arrays.size());
+  auto items = exch_arrays(dist, arrays);
+  auto roots2items = dist.invert().roots2items();
+  std::vector<MixedArray> out;
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    auto& array = items[i];
+    auto op = ops[i];
+    switch (array.type()) {
+      case OMEGA_H_I8:
+        out.push_back(reduce_onto_roots<I8>(roots2items, array, op));
+        break;
+      case OMEGA_H_I32:
+        out.push_back(reduce_onto_roots<I32>(roots2items, array, op));
+        break;
+      case OMEGA_H_I64:
+        out.push_back(reduce_onto_roots<I64>(roots2items, array, op));
+        break;
+      case OMEGA_H_F64:
+        if (ordered && op == OMEGA_H_SUM) {
+          out.push_back(MixedArray(sum_in_value_order(roots2items,
+                                       array.get<Real>(), array.width()),
+              array.width()));
+        } else {
+          out.push_back(reduce_onto_roots<Real>(roots2items, array, op));
+        }
+        break;
+    }
+  }
+  return out;
+}
+
+std::vector<MixedArray> exch_reduce_arrays(
+    Dist const& dist, std::vector<MixedArray> const& arrays, Omega_h_Op op) {
+  return exch_reduce_arrays(
+      dist, arrays, std::vector<Omega_h_Op>(arrays.size(), op));
+}
+
+}  // end namespace Omega_h
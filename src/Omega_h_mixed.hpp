@@ -0,0 +1,115 @@
+#ifndef OMEGA_H_MIXED_HPP
+#define OMEGA_H_MIXED_HPP
+
+#include <functional>
+#include <vector>
+
+#include <Omega_h_array.hpp>
+#include <Omega_h_defines.hpp>
+#include <Omega_h_future.hpp>
+
+namespace Omega_h {
+
+class Dist;
+
+/* an array of any of the tag types, together with its
+   number of values per entity. lists of these let arrays of
+   different types and widths be communicated together */
+class MixedArray {
+ public:
+  MixedArray() = default;
+  MixedArray(Read<I8> array, Int width);
+  MixedArray(Read<I32> array, Int width);
+  MixedArray(Read<I64> array, Int width);
+  MixedArray(Read<Real> array, Int width);
+  Omega_h_Type type() const { return type_; }
+  Int width() const { return width_; }
+  Int nbytes_per_ent() const;
+  LO nents() const;
+  template <typename T>
+  Read<T> get() const;
+
+ private:
+  Omega_h_Type type_ = OMEGA_H_I8;
+  Int width_ = 0;
+  Read<I8> i8_;
+  Read<I32> i32_;
+  Read<I64> i64_;
+  Read<Real> f64_;
+};
+
+template <>
+Read<I8> MixedArray::get() const;
+template <>
+Read<I32> MixedArray::get() const;
+template <>
+Read<I64> MixedArray::get() const;
+template <>
+Read<Real> MixedArray::get() const;
+
+/* bytes per entity of the arrays laid side by side */
+Int get_packed_width(std::vector<MixedArray> const& arrays);
+
+/* serializes the arrays, which must all have the same number
+   of entities, into get_packed_width(arrays) bytes per entity.
+   the result must fit in one array, below 2^31 bytes */
+Read<I8> pack_arrays(std::vector<MixedArray> const& arrays);
+
+/* the inverse of pack_arrays; layout gives the types and widths */
+std::vector<MixedArray> unpack_arrays(
+    Read<I8> packed, std::vector<MixedArray> const& layout);
+
+/* the most bytes packed together for one exchange. longer lists of
+   arrays are exchanged in several batches, which bounds the copy that
+   packing adds and keeps packed sizes within LO */
+constexpr I64 max_packed_bytes = I64(1) << 28;
+
+/* splits the arrays, in order, into batches that pack at most
+   (max_bytes) for (nents) entities. returns where each batch begins,
+   followed by arrays.size(). an array that is wider on its own makes
+   a batch by itself, which is exchanged without packing */
+std::vector<std::size_t> get_packing_batches(
+    std::vector<MixedArray> const& arrays, LO nents,
+    I64 max_bytes = max_packed_bytes);
+
+/* result of an asynchronous exchange of several arrays at once */
+class MixedFuture {
+ public:
+  MixedFuture() = default;
+  explicit MixedFuture(std::vector<MixedArray> ready);
+  MixedFuture(Future<I8> packed, std::vector<MixedArray> layout);
+  template <typename T>
+  MixedFuture(Future<T> single, Int width);
+  /* the arrays of (other) will follow those of this future */
+  void append(MixedFuture const& other);
+  bool completed();
+  /* waits for the exchange and returns the arrays in the order given.
+     can only be called once */
+  std::vector<MixedArray> get();
+
+ private:
+  /* one entry per batch */
+  std::vector<std::function<bool()>> completed_;
+  std::vector<std::function<std::vector<MixedArray>()>> get_;
+};
+
+/* sends every array along the Dist, in as few exchanges as
+   get_packing_batches allows */
+std::vector<MixedArray> exch_arrays(
+    Dist const& dist, std::vector<MixedArray> const& arrays);
+MixedFuture iexch_arrays(
+    Dist const& dist, std::vector<MixedArray> const& arrays);
+/* one exchange, then each array is reduced onto the Dist's roots */
+std::vector<MixedArray> exch_reduce_arrays(
+    Dist const& dist, std::vector<MixedArray> const& arrays, Omega_h_Op op);
+/* the same with one operation per array. if (ordered), floating point
+   sums add the values of each root in increasing order, so they are
+   the same whichever ranks hold the copies and however they are
+   numbered. integer sums, minima and maxima are always exact */
+std::vector<MixedArray> exch_reduce_arrays(Dist const& dist,
+    std::vector<MixedArray> const& arrays, std::vector<Omega_h_Op> const& ops,
+    bool ordered = false);
+
+}  // end namespace Omega_h
+
+#endif
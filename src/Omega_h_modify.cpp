@@ -5,15 +5,14 @@
 #include "Omega_h_atomics.hpp"
 #include "Omega_h_element.hpp"
 #include "Omega_h_for.hpp"
-#include "Omega_h_globals.hpp"
 #include "Omega_h_int_scan.hpp"
 #include "Omega_h_linpart.hpp"
 #include "Omega_h_map.hpp"
 #include "Omega_h_mark.hpp"
 #include "Omega_h_mesh.hpp"
+#include "Omega_h_mixed.hpp"
 #include "Omega_h_owners.hpp"
 #include "Omega_h_timer.hpp"
-#include "Omega_h_unmap_mesh.hpp"
 
 namespace Omega_h {
 
@@ -69,75 +68,6 @@ static void modify_conn(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
   new_mesh->set_ents(ent_dim, new_ents2new_lows);
 }
 
-/* this is the case of AMR-style refinement where
-   some entities being split (mods) are actually on
-   the partition boundary.
-   in this case they need to communicate on owners
-   for the child entities.
-   the rule is: a child copy is an owner if its parent
-   copy is an owner */
-static Remotes get_prod_owners_shared(Mesh* mesh, Few<LOs, 4> mods2mds,
-    Few<LOs, 4> mods2prods, LOs prods2new_ents) {
-  auto nprods = prods2new_ents.size();
-  Write<I32> prod_own_ranks(nprods);
-  Write<LO> prod_own_idxs(nprods);
-  for (Int mod_dim = 0; mod_dim < 4; ++mod_dim) {
-    if (!mods2prods[mod_dim].exists()) continue;
-    auto prod_begin = mods2prods[mod_dim].first();
-    auto prod_end = mods2prods[mod_dim].last();
-    auto nmods = mods2prods[mod_dim].size() - 1;
-    auto nmod_prods = prod_end - prod_begin;
-    /* assuming the number of products per split entity is constant! */
-    LO nprods_per_mod;
-    if (nmods == 0) nprods_per_mod = 0;
-    else nprods_per_mod = divide_no_remainder(nmod_prods, nmods);
-    nprods_per_mod = mesh->comm()->allreduce(nprods_per_mod, OMEGA_H_MAX);
-    auto md_ranks = mesh->ask_owners(mod_dim).ranks;
-    auto mod_ranks = read(unmap(mods2mds[mod_dim], md_ranks, 1));
-    auto mod_prod_idxs = unmap_range(prod_begin, prod_end, prods2new_ents, 1);
-    mod_prod_idxs = mesh->sync_subset_array(
-        mod_dim, mod_prod_idxs, mods2mds[mod_dim], -1, nprods_per_mod);
-    map_into_range(mod_prod_idxs, prod_begin, prod_end, prod_own_idxs, 1);
-    expand_into(mod_ranks, mods2prods[mod_dim], prod_own_ranks, 1);
-  }
-  return {prod_own_ranks, prod_own_idxs};
-}
-
-/* set the owners of the mesh after an adaptive rebuild pass.
-   the entities that stay the same retain the same conceptual
-   ownership, just updated by unmap_owners() to reflect new indices.
-   all entities produced by this MPI rank exist only on this
-   MPI rank, so they are their own owners */
-static void modify_owners(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
-    Few<LOs, 4> mods2mds, Few<LOs, 4> mods2prods, LOs prods2new_ents,
-    LOs same_ents2old_ents, LOs same_ents2new_ents, LOs old_ents2new_ents,
-    bool mods_can_be_shared) {
-  OMEGA_H_TIME_FUNCTION;
-  auto same_owners =
-      unmap_owners(old_mesh, ent_dim, same_ents2old_ents, old_ents2new_ents);
-  auto same_own_ranks = same_owners.ranks;
-  auto same_own_idxs = same_owners.idxs;
-  auto nprods = prods2new_ents.size();
-  Remotes prod_owners;
-  if (mods_can_be_shared) {
-    prod_owners =
-        get_prod_owners_shared(old_mesh, mods2mds, mods2prods, prods2new_ents);
-  } else {
-    prod_owners.ranks = Read<I32>(nprods, new_mesh->comm()->rank());
-    prod_owners.idxs = prods2new_ents;
-  }
-  auto nsame_ents = same_ents2old_ents.size();
-  auto nnew_ents = nsame_ents + nprods;
-  Write<I32> new_own_ranks(nnew_ents);
-  Write<LO> new_own_idxs(nnew_ents);
-  map_into(same_own_ranks, same_ents2new_ents, new_own_ranks, 1);
-  map_into(same_own_idxs, same_ents2new_ents, new_own_idxs, 1);
-  map_into(prod_owners.ranks, prods2new_ents, new_own_ranks, 1);
-  map_into(prod_owners.idxs, prods2new_ents, new_own_idxs, 1);
-  auto new_owners = Remotes(Read<I32>(new_own_ranks), LOs(new_own_idxs));
-  new_mesh->set_owners(ent_dim, new_owners);
-}
-
 static LOs collect_same(
     Mesh* mesh, Int ent_dim, Few<Bytes, 4> mds_are_mods, bool keep_mods) {
   if (keep_mods || (!mds_are_mods[ent_dim].exists())) {
@@ -403,50 +333,246 @@ void assign_new_numbering(Read<T> old_ents2new_numbers,
   *p_prods2new_numbers = prods2new_offsets_w;
 }
 
-static void modify_globals(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
-    bool keep_mods, Few<LOs, 4> mods2mds, Few<LOs, 4> mods2prods,
-    LOs prods2new_ents, LOs same_ents2old_ents, LOs same_ents2new_ents,
-    Few<LOs, 4> mods2reps, LOs global_rep_counts) {
+/* the new owner of an entity that stays the same is the new local
+   index its owner copy received, which modified entities learn from
+   their owners by an exchange along the old Dist.
+   this is also the case of AMR-style refinement where
+   some entities being split (mods) are actually on
+   the partition boundary.
+   in this case they need to communicate on owners
+   for the child entities.
+   the rule is: a child copy is an owner if its parent
+   copy is an owner.
+   everything sent from owners to copies of one dimension goes in one
+   packed exchange, and all of them are posted before any is waited on */
+struct OwnerExchanges {
+  std::vector<MixedFuture> futures;  // one per old mesh dimension
+  std::vector<LO> nprods_per_mod;    // indexed by (ent_dim * 4 + mod_dim)
+};
+
+static OwnerExchanges post_owner_exchanges(
+    Mesh* old_mesh, ModifiedEnts const& modified) {
+  OMEGA_H_TIME_FUNCTION;
+  auto const dim = old_mesh->dim();
+  OwnerExchanges out;
+  out.nprods_per_mod.assign(16, 0);
+  bool any_shared = false;
+  for (Int ent_dim = 0; ent_dim <= dim; ++ent_dim) {
+    auto& m = modified.dims[ent_dim];
+    if (!m.exists || !m.mods_can_be_shared) continue;
+    any_shared = true;
+    for (Int mod_dim = 0; mod_dim <= dim; ++mod_dim) {
+      if (!m.mods2prods[mod_dim].exists()) continue;
+      auto nmods = m.mods2prods[mod_dim].size() - 1;
+      auto nmod_prods = m.mods2prods[mod_dim].last() -
+                        m.mods2prods[mod_dim].first();
+      /* assuming the number of products per split entity is constant! */
+      if (nmods == 0) continue;
+      out.nprods_per_mod[ent_dim * 4 + mod_dim] =
+          divide_no_remainder(nmod_prods, nmods);
+    }
+  }
+  if (any_shared) {
+    out.nprods_per_mod =
+        old_mesh->comm()->allreduce(out.nprods_per_mod, OMEGA_H_MAX);
+  }
+  for (Int d = 0; d <= dim; ++d) {
+    std::vector<MixedArray> arrays;
+    if (modified.dims[d].exists) {
+      arrays.push_back(MixedArray(modified.dims[d].old_ents2new_ents, 1));
+    }
+    for (Int ent_dim = 0; ent_dim <= dim; ++ent_dim) {
+      auto& m = modified.dims[ent_dim];
+      if (!m.exists || !m.mods_can_be_shared) continue;
+      if (!m.mods2prods[d].exists()) continue;
+      auto width = out.nprods_per_mod[ent_dim * 4 + d];
+      if (width == 0) continue;
+      auto mod_prod_idxs = unmap_range(m.mods2prods[d].first(),
+          m.mods2prods[d].last(), m.prods2new_ents, 1);
+      arrays.push_back(MixedArray(
+          map_onto(mod_prod_idxs, m.mods2mds[d], old_mesh->nents(d), -1, width),
+          width));
+    }
+    out.futures.push_back(old_mesh->isync_arrays(d, arrays));
+  }
+  return out;
+}
+
+/* receives the exchanges in the order post_owner_exchanges() packed them
+   and sets the owners of every new entity. all entities produced
+   by this MPI rank from unshared modifications exist only on this
+   MPI rank, so they are their own owners */
+static void finish_owner_exchanges(Mesh* old_mesh, Mesh* new_mesh,
+    ModifiedEnts const& modified, OwnerExchanges& exchanges) {
+  OMEGA_H_TIME_FUNCTION;
+  auto const dim = old_mesh->dim();
+  std::vector<std::vector<MixedArray>> received;
+  std::vector<std::size_t> next;
+  for (Int d = 0; d <= dim; ++d) {
+    received.push_back(exchanges.futures[std::size_t(d)].get());
+    next.push_back(modified.dims[d].exists ? 1 : 0);
+  }
+  for (Int ent_dim = 0; ent_dim <= dim; ++ent_dim) {
+    auto& m = modified.dims[ent_dim];
+    if (!m.exists) continue;
+    auto old_copies2new_owners = received[std::size_t(ent_dim)][0].get<LO>();
+    auto same_own_idxs =
+        read(unmap(m.same_ents2old_ents, old_copies2new_owners, 1));
+    auto old_own_ranks = old_mesh->ask_owners(ent_dim).ranks;
+    auto same_own_ranks = read(unmap(m.same_ents2old_ents, old_own_ranks, 1));
+    auto nprods = m.prods2new_ents.size();
+    Remotes prod_owners;
+    if (m.mods_can_be_shared) {
+      Write<I32> prod_own_ranks(nprods);
+      Write<LO> prod_own_idxs(nprods);
+      for (Int mod_dim = 0; mod_dim <= dim; ++mod_dim) {
+        if (!m.mods2prods[mod_dim].exists()) continue;
+        auto prod_begin = m.mods2prods[mod_dim].first();
+        auto prod_end = m.mods2prods[mod_dim].last();
+        auto width = exchanges.nprods_per_mod[ent_dim * 4 + mod_dim];
+        if (width != 0) {
+          auto& arrays = received[std::size_t(mod_dim)];
+          auto md_prod_idxs = arrays[next[std::size_t(mod_dim)]++].get<LO>();
+          auto mod_prod_idxs =
+              read(unmap(m.mods2mds[mod_dim], md_prod_idxs, width));
+          map_into_range(mod_prod_idxs, prod_begin, prod_end, prod_own_idxs, 1);
+        }
+        auto md_ranks = old_mesh->ask_owners(mod_dim).ranks;
+        auto mod_ranks = read(unmap(m.mods2mds[mod_dim], md_ranks, 1));
+        expand_into(mod_ranks, m.mods2prods[mod_dim], prod_own_ranks, 1);
+      }
+      prod_owners = Remotes(Read<I32>(prod_own_ranks), LOs(prod_own_idxs));
+    } else {
+      prod_owners.ranks = Read<I32>(nprods, new_mesh->comm()->rank());
+      prod_owners.idxs = m.prods2new_ents;
+    }
+    auto nnew_ents = new_mesh->nents(ent_dim);
+    Write<I32> new_own_ranks(nnew_ents);
+    Write<LO> new_own_idxs(nnew_ents);
+    map_into(same_own_ranks, m.same_ents2new_ents, new_own_ranks, 1);
+    map_into(same_own_idxs, m.same_ents2new_ents, new_own_idxs, 1);
+    map_into(prod_owners.ranks, m.prods2new_ents, new_own_ranks, 1);
+    map_into(prod_owners.idxs, m.prods2new_ents, new_own_idxs, 1);
+    new_mesh->set_owners(
+        ent_dim, Remotes(Read<I32>(new_own_ranks), LOs(new_own_idxs)));
+  }
+}
+
+/* new globals are derived from a scan of the representative counts,
+   ordered by old globals. rather than one linear partition per dimension,
+   all dimensions share one over a concatenated global numbering in which
+   dimension (d) is shifted past the ones below it, so a single Dist,
+   a single reduction and a single exscan of a 4-vector serve them all */
+static void modify_globals(
+    Mesh* old_mesh, Mesh* new_mesh, ModifiedEnts const& modified) {
   OMEGA_H_TIME_FUNCTION;
-  auto const nsame_ents = same_ents2old_ents.size();
-  OMEGA_H_CHECK(nsame_ents == same_ents2new_ents.size());
-  auto const nprods = prods2new_ents.size();
-  auto const old_globals = old_mesh->globals(ent_dim);
   auto const comm = old_mesh->comm();
-  auto const old_ents2lins = copies_to_linear_owners(comm, old_globals);
-  auto const lins2old_ents = old_ents2lins.invert();
-  auto const nlins = lins2old_ents.nroots();
+  auto const dim = old_mesh->dim();
+  std::vector<GO> max_globals(4, -1);
+  for (Int d = 0; d <= dim; ++d) {
+    if (!modified.dims[d].exists) continue;
+    max_globals[std::size_t(d)] =
+        max2(GO(-1), get_max(old_mesh->globals(d)));
+  }
+  max_globals = comm->allreduce(max_globals, OMEGA_H_MAX);
+  Few<GO, 5> bases;
+  Few<LO, 5> copy_offsets;
+  bases[0] = 0;
+  copy_offsets[0] = 0;
+  for (Int d = 0; d < 4; ++d) {
+    bases[d + 1] = bases[d] + max_globals[std::size_t(d)] + 1;
+    copy_offsets[d + 1] = copy_offsets[d];
+    if (modified.dims[d].exists) copy_offsets[d + 1] += old_mesh->nents(d);
+  }
+  auto const total = bases[4];
+  Write<GO> copy_globals(copy_offsets[4]);
+  Write<LO> copy_rep_counts(copy_offsets[4]);
+  for (Int d = 0; d <= dim; ++d) {
+    if (!modified.dims[d].exists) continue;
+    map_into_range(add_to_each(old_mesh->globals(d), bases[d]),
+        copy_offsets[d], copy_offsets[d + 1], copy_globals, 1);
+    map_into_range(modified.dims[d].global_rep_counts, copy_offsets[d],
+        copy_offsets[d + 1], copy_rep_counts, 1);
+  }
+  auto const nlins = linear_partition_size(comm, total);
+  auto const copies2lins =
+      Dist(comm, globals_to_linear_owners(comm, read(copy_globals), total),
+          nlins);
   auto const lin_rep_counts =
-      old_ents2lins.exch_reduce(global_rep_counts, 1, OMEGA_H_SUM);
+      copies2lins.exch_reduce(LOs(copy_rep_counts), 1, OMEGA_H_SUM);
   OMEGA_H_CHECK(lin_rep_counts.size() == nlins);
-  auto const lin_globals = rescan_globals(old_mesh, lin_rep_counts);
-  auto const old_ents2new_globals =
-      lins2old_ents.exch(Read<GO>(lin_globals), 1);
-  Few<LOs, 4> global_rep2md_order;
-  for (Int mod_dim = 0; mod_dim <= old_mesh->dim(); ++mod_dim) {
-    if ((mod_dim > ent_dim) && mods2prods[mod_dim].exists()) {
-      auto const name =
-          std::string("rep_") + hypercube_singular_name(ent_dim) + "2md_order";
-      global_rep2md_order[mod_dim] = old_mesh->get_array<LO>(mod_dim, name);
+  /* the linear range of this rank is split into one segment per dimension */
+  auto const lin_begin = linear_partition_begin(comm, total);
+  Few<LO, 5> lin_offsets;
+  for (Int d = 0; d <= 4; ++d) {
+    auto const g = min2(max2(bases[d], lin_begin), lin_begin + nlins);
+    lin_offsets[d] = LO(g - lin_begin);
+  }
+  Few<LOs, 4> lin_scans;
+  std::vector<GO> nnew_ents(4, 0);
+  for (Int d = 0; d < 4; ++d) {
+    lin_scans[d] = offset_scan(
+        unmap_range(lin_offsets[d], lin_offsets[d + 1], lin_rep_counts, 1));
+    nnew_ents[std::size_t(d)] = lin_scans[d].last();
+  }
+  auto const starts = comm->exscan(nnew_ents, OMEGA_H_SUM);
+  Write<GO> lin_globals(nlins);
+  for (Int d = 0; d < 4; ++d) {
+    auto const scan = lin_scans[d];
+    auto const begin = lin_offsets[d];
+    auto const start = starts[std::size_t(d)];
+    auto f = OMEGA_H_LAMBDA(LO i) {
+      lin_globals[begin + i] = start + scan[i];
+    };
+    parallel_for(lin_offsets[d + 1] - begin, std::move(f));
+  }
+  auto const copy_new_globals =
+      copies2lins.invert().exch(Read<GO>(lin_globals), 1);
+  for (Int ent_dim = 0; ent_dim <= dim; ++ent_dim) {
+    auto& m = modified.dims[ent_dim];
+    if (!m.exists) continue;
+    auto const old_ents2new_globals = unmap_range(copy_offsets[ent_dim],
+        copy_offsets[ent_dim + 1], copy_new_globals, 1);
+    Few<LOs, 4> global_rep2md_order;
+    for (Int mod_dim = ent_dim + 1; mod_dim <= dim; ++mod_dim) {
+      if (m.mods2prods[mod_dim].exists()) {
+        auto const name = std::string("rep_") +
+                          hypercube_singular_name(ent_dim) + "2md_order";
+        global_rep2md_order[mod_dim] = old_mesh->get_array<LO>(mod_dim, name);
+      }
     }
+    Read<GO> same_ents2new_globals;
+    Read<GO> prods2new_globals;
+    assign_new_numbering(old_ents2new_globals, m.same_ents2old_ents,
+        m.mods2mds, m.mods2reps, m.mods2prods, global_rep2md_order,
+        &same_ents2new_globals, &prods2new_globals, m.keep_mods);
+    auto nnew_ents_dim = new_mesh->nents(ent_dim);
+    OMEGA_H_CHECK(nnew_ents_dim ==
+                  m.same_ents2old_ents.size() + m.prods2new_ents.size());
+    Write<GO> new_globals(nnew_ents_dim);
+    map_into(same_ents2new_globals, m.same_ents2new_ents, new_globals, 1);
+    map_into(prods2new_globals, m.prods2new_ents, new_globals, 1);
+    new_mesh->add_tag(ent_dim, "global", 1, Read<GO>(new_globals));
   }
-  Read<GO> same_ents2new_globals;
-  Read<GO> prods2new_globals;
-  assign_new_numbering(old_ents2new_globals, same_ents2old_ents, mods2mds,
-      mods2reps, mods2prods, global_rep2md_order, &same_ents2new_globals,
-      &prods2new_globals, keep_mods);
-  auto nnew_ents = new_mesh->nents(ent_dim);
-  OMEGA_H_CHECK(nnew_ents == nsame_ents + nprods);
-  Write<GO> new_globals(nnew_ents);
-  map_into(same_ents2new_globals, same_ents2new_ents, new_globals, 1);
-  map_into(prods2new_globals, prods2new_ents, new_globals, 1);
-  new_mesh->add_tag(ent_dim, "global", 1, Read<GO>(new_globals));
+}
+
+void modify_owners_and_globals(
+    Mesh* old_mesh, Mesh* new_mesh, ModifiedEnts const& modified) {
+  OMEGA_H_TIME_FUNCTION;
+  if (old_mesh->comm()->size() == 1) {
+    modify_globals(old_mesh, new_mesh, modified);
+    return;
+  }
+  /* the owner exchanges are in flight while globals are computed */
+  auto exchanges = post_owner_exchanges(old_mesh, modified);
+  modify_globals(old_mesh, new_mesh, modified);
+  finish_owner_exchanges(old_mesh, new_mesh, modified, exchanges);
 }
 
 void modify_ents_adapt(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim, Int key_dim,
     LOs keys2kds, LOs keys2prods, LOs prod_verts2verts, LOs old_lows2new_lows,
     LOs* p_prods2new_ents, LOs* p_same_ents2old_ents, LOs* p_same_ents2new_ents,
-    LOs* p_old_ents2new_ents) {
+    LOs* p_old_ents2new_ents, ModifiedEnts* modified) {
   OMEGA_H_TIME_FUNCTION;
   Few<LOs, 4> mods2mds;
   Few<Bytes, 4> mds_are_mods;
@@ -462,14 +588,16 @@ void modify_ents_adapt(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim, Int key_dim,
   modify_ents(old_mesh, new_mesh, ent_dim, mods2mds, mds_are_mods, mods2prods,
       prod_verts2verts, old_lows2new_lows,
       /*keep_mods*/ false, /*mods_can_be_shared*/ false, p_prods2new_ents,
-      p_same_ents2old_ents, p_same_ents2new_ents, p_old_ents2new_ents);
+      p_same_ents2old_ents, p_same_ents2new_ents, p_old_ents2new_ents,
+      modified);
 }
 
 void modify_ents(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
     Few<LOs, 4> mods2mds, Few<Bytes, 4> mds_are_mods, Few<LOs, 4> mods2prods,
     LOs prod_verts2verts, LOs old_lows2new_lows, bool keep_mods,
     bool mods_can_be_shared, LOs* p_prods2new_ents, LOs* p_same_ents2old_ents,
-    LOs* p_same_ents2new_ents, LOs* p_old_ents2new_ents) {
+    LOs* p_same_ents2new_ents, LOs* p_old_ents2new_ents,
+    ModifiedEnts* modified) {
   OMEGA_H_TIME_FUNCTION;
   *p_same_ents2old_ents =
       collect_same(old_mesh, ent_dim, mds_are_mods, keep_mods);
@@ -504,16 +632,19 @@ void modify_ents(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
         *p_prods2new_ents, *p_same_ents2old_ents, *p_same_ents2new_ents,
         old_lows2new_lows);
   }
-  if (old_mesh->comm()->size() > 1) {
-    modify_owners(old_mesh, new_mesh, ent_dim, mods2mds, mods2prods,
-        *p_prods2new_ents, *p_same_ents2old_ents, *p_same_ents2new_ents,
-        *p_old_ents2new_ents, mods_can_be_shared);
-  }
-  auto global_rep_counts = get_rep_counts(old_mesh, ent_dim, mods2mds,
-      mods2reps, mods2nprods, *p_same_ents2old_ents, /*count_non_owned*/ false);
-  modify_globals(old_mesh, new_mesh, ent_dim, keep_mods, mods2mds, mods2prods,
-      *p_prods2new_ents, *p_same_ents2old_ents, *p_same_ents2new_ents,
-      mods2reps, global_rep_counts);
+  auto& m = modified->dims[ent_dim];
+  m.exists = true;
+  m.keep_mods = keep_mods;
+  m.mods_can_be_shared = mods_can_be_shared;
+  m.mods2mds = mods2mds;
+  m.mods2prods = mods2prods;
+  m.mods2reps = mods2reps;
+  m.global_rep_counts = get_rep_counts(old_mesh, ent_dim, mods2mds, mods2reps,
+      mods2nprods, *p_same_ents2old_ents, /*count_non_owned*/ false);
+  m.prods2new_ents = *p_prods2new_ents;
+  m.same_ents2old_ents = *p_same_ents2old_ents;
+  m.same_ents2new_ents = *p_same_ents2new_ents;
+  m.old_ents2new_ents = *p_old_ents2new_ents;
 }
 
 void set_owners_by_indset(
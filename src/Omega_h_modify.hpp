@@ -9,6 +9,26 @@ namespace Omega_h {
 
 class Mesh;
 
+/* what modify_ents() leaves behind for one entity dimension so that
+   the owners and globals of the new entities can be assigned later */
+struct ModifiedDim {
+  bool exists = false;
+  bool keep_mods = false;
+  bool mods_can_be_shared = false;
+  Few<LOs, 4> mods2mds;
+  Few<LOs, 4> mods2prods;
+  Few<LOs, 4> mods2reps;
+  LOs global_rep_counts;
+  LOs prods2new_ents;
+  LOs same_ents2old_ents;
+  LOs same_ents2new_ents;
+  LOs old_ents2new_ents;
+};
+
+struct ModifiedEnts {
+  ModifiedDim dims[4];
+};
+
 LOs get_rep2md_order_adapt(
     Mesh* mesh, Int key_dim, Int rep_dim, Bytes kds_are_keys);
 
@@ -18,13 +38,19 @@ Few<LOs, 4> get_rep2md_order(Mesh* mesh, Int rep_dim, Few<LOs, 4> mods2mds,
 void modify_ents_adapt(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim, Int key_dim,
     LOs keys2kds, LOs keys2prods, LOs prod_verts2verts, LOs old_lows2new_lows,
     LOs* p_prods2new_ents, LOs* p_same_ents2old_ents, LOs* p_same_ents2new_ents,
-    LOs* p_old_ents2new_ents);
+    LOs* p_old_ents2new_ents, ModifiedEnts* modified);
 
 void modify_ents(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
     Few<LOs, 4> mods2mds, Few<Bytes, 4> mds_are_mods, Few<LOs, 4> mods2prods,
     LOs prod_verts2verts, LOs old_lows2new_lows, bool keep_mods,
     bool mods_can_be_shared, LOs* p_prods2new_ents, LOs* p_same_ents2old_ents,
-    LOs* p_same_ents2new_ents, LOs* p_old_ents2new_ents);
+    LOs* p_same_ents2new_ents, LOs* p_old_ents2new_ents,
+    ModifiedEnts* modified);
+
+/* once modify_ents() has run for every dimension, gives all new entities
+   their owners and globals with a fixed number of collectives */
+void modify_owners_and_globals(
+    Mesh* old_mesh, Mesh* new_mesh, ModifiedEnts const& modified);
 
 void set_owners_by_indset(
     Mesh* mesh, Int key_dim, LOs keys2kds, Graph kds2elems);
@@ -0,0 +1,475 @@
+#include "Omega_h_osh_stream.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+#ifdef OMEGA_H_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "Omega_h_element.hpp"
+#include "Omega_h_file.hpp"
+#include "Omega_h_profile.hpp"
+
+namespace Omega_h {
+
+namespace binary {
+
+/* reader of the data of one stored array. it remembers where it is in
+   the file, so several can take turns on one file. compressed data can
+   only be inflated forward, so every (checkpoint_bytes) of output the
+   inflate state is saved; moving backward resumes from the nearest
+   checkpoint instead of the start of the array, which bounds both the
+   memory kept and the data inflated again */
+class ArrayStream {
+ public:
+  ArrayStream(std::istream& file, StoredArray const& array, bool is_compressed)
+      : file_(file),
+        offset_(array.offset),
+        is_compressed_(is_compressed),
+        position_(0),
+        next_in_(array.offset) {
+#ifdef OMEGA_H_USE_ZLIB
+    if (is_compressed_) {
+      std::memset(&zs_, 0, sizeof(zs_));
+      OMEGA_H_CHECK(::inflateInit(&zs_) == Z_OK);
+      in_left_ = array.compressed_bytes;
+      in_.resize(std::size_t(1) << 16);
+      save(&start_);
+    }
+#else
+    OMEGA_H_CHECK(!is_compressed_);
+#endif
+  }
+  ArrayStream(ArrayStream const&) = delete;
+  ArrayStream& operator=(ArrayStream const&) = delete;
+  ~ArrayStream() {
+#ifdef OMEGA_H_USE_ZLIB
+    if (is_compressed_) {
+      ::inflateEnd(&zs_);
+      ::inflateEnd(&start_.zs);
+      for (auto& checkpoint : checkpoints_) ::inflateEnd(&checkpoint.zs);
+    }
+#endif
+  }
+  /* bytes of data read or skipped so far */
+  std::size_t position() const { return position_; }
+  void read(char* out, std::size_t nbytes) {
+    if (nbytes == 0) return;
+#ifdef OMEGA_H_USE_ZLIB
+    if (is_compressed_) {
+      if (position_ >= next_checkpoint()) {
+        checkpoints_.emplace_back();
+        save(&checkpoints_.back());
+      }
+      position_ += nbytes;
+      zs_.next_out = reinterpret_cast< ::Bytef*>(out);
+      zs_.avail_out = static_cast<uInt>(nbytes);
+      while (zs_.avail_out) {
+        if (zs_.avail_in == 0) {
+          OMEGA_H_CHECK(in_left_ > 0);
+          auto n = std::min(I64(in_.size()), in_left_);
+          file_.seekg(next_in_);
+          file_.read(reinterpret_cast<char*>(in_.data()), n);
+          OMEGA_H_CHECK(bool(file_));
+          next_in_ += n;
+          in_left_ -= n;
+          zs_.next_in = in_.data();
+          zs_.avail_in = static_cast<uInt>(n);
+        }
+        auto ret = ::inflate(&zs_, Z_NO_FLUSH);
+        OMEGA_H_CHECK(ret == Z_OK || ret == Z_STREAM_END);
+        if (ret == Z_STREAM_END) OMEGA_H_CHECK(zs_.avail_out == 0);
+      }
+      return;
+    }
+#endif
+    position_ += nbytes;
+    file_.seekg(offset_ + std::streamoff(position_ - nbytes));
+    file_.read(out, std::streamsize(nbytes));
+    OMEGA_H_CHECK(bool(file_));
+  }
+  /* moves to byte (pos) of the data */
+  void seek(std::size_t pos) {
+    if (!is_compressed_) {
+      position_ = pos;
+      return;
+    }
+#ifdef OMEGA_H_USE_ZLIB
+    if (pos < position_) {
+      auto it = std::upper_bound(checkpoints_.begin(), checkpoints_.end(), pos,
+          [](std::size_t p, Checkpoint const& c) { return p < c.position; });
+      restore((it == checkpoints_.begin()) ? start_ : *(it - 1));
+    }
+#endif
+    char scratch[1 << 12];
+    while (position_ < pos) {
+      auto n = std::min(pos - position_, sizeof(scratch));
+      read(scratch, n);
+    }
+  }
+
+ private:
+  std::istream& file_;
+  std::streamoff offset_;
+  bool is_compressed_;
+  std::size_t position_;
+  std::streamoff next_in_;  // where the unread compressed input starts
+#ifdef OMEGA_H_USE_ZLIB
+  static constexpr std::size_t checkpoint_bytes = std::size_t(1) << 22;
+  struct Checkpoint {
+    ::z_stream zs;
+    std::size_t position;
+    std::streamoff next_in;
+    I64 in_left;
+  };
+  std::size_t next_checkpoint() const {
+    auto last = checkpoints_.empty() ? 0 : checkpoints_.back().position;
+    return last + checkpoint_bytes;
+  }
+  /* input the inflate state holds but has not consumed is left in the
+     file, to be read again after a restore. zlib ties a state to the
+     address of its z_stream, so checkpoints never move */
+  void save(Checkpoint* checkpoint) {
+    OMEGA_H_CHECK(::inflateCopy(&checkpoint->zs, &zs_) == Z_OK);
+    checkpoint->zs.next_in = nullptr;
+    checkpoint->zs.avail_in = 0;
+    checkpoint->position = position_;
+    checkpoint->next_in = next_in_ - std::streamoff(zs_.avail_in);
+    checkpoint->in_left = in_left_ + I64(zs_.avail_in);
+  }
+  void restore(Checkpoint& checkpoint) {
+    ::inflateEnd(&zs_);
+    OMEGA_H_CHECK(::inflateCopy(&zs_, &checkpoint.zs) == Z_OK);
+    position_ = checkpoint.position;
+    next_in_ = checkpoint.next_in;
+    in_left_ = checkpoint.in_left;
+  }
+  ::z_stream zs_;
+  std::vector< ::Bytef> in_;
+  I64 in_left_ = 0;
+  Checkpoint start_;
+  std::deque<Checkpoint> checkpoints_;
+#endif
+};
+
+namespace {
+
+template <typename T>
+T read_scalar(std::istream& file, bool needs_swapping) {
+  T val;
+  read_value(file, val, needs_swapping);
+  return val;
+}
+
+StoredArray skim_array(std::istream& file, std::size_t scalar_size,
+    bool is_compressed, bool needs_swapping) {
+  StoredArray array;
+  array.size = read_scalar<LO>(file, needs_swapping);
+  OMEGA_H_CHECK(array.size >= 0);
+  I64 nbytes = I64(array.size) * I64(scalar_size);
+  if (is_compressed) {
+    array.compressed_bytes = read_scalar<I64>(file, needs_swapping);
+    nbytes = array.compressed_bytes;
+  }
+  array.offset = file.tellg();
+  file.seekg(nbytes, std::ios::cur);
+  return array;
+}
+
+template <typename T>
+struct StoredType;
+template <>
+struct StoredType<I8> {
+  static constexpr Omega_h_Type value = OMEGA_H_I8;
+};
+template <>
+struct StoredType<I32> {
+  static constexpr Omega_h_Type value = OMEGA_H_I32;
+};
+template <>
+struct StoredType<I64> {
+  static constexpr Omega_h_Type value = OMEGA_H_I64;
+};
+template <>
+struct StoredType<Real> {
+  static constexpr Omega_h_Type value = OMEGA_H_F64;
+};
+
+std::size_t scalar_size(Omega_h_Type type) {
+  switch (type) {
+    case OMEGA_H_I8:
+      return sizeof(I8);
+    case OMEGA_H_I32:
+      return sizeof(I32);
+    case OMEGA_H_I64:
+      return sizeof(I64);
+    case OMEGA_H_F64:
+      return sizeof(Real);
+  }
+  Omega_h_fail("unexpected tag type in binary stream\n");
+  OMEGA_H_NORETURN(0);
+}
+
+/* sorted unique copy of (ids), and (ids) renumbered into it */
+void compact(LOs ids, LOs* uniq_out, LOs* local_out) {
+  HostRead<LO> h_ids(ids);
+  std::vector<LO> uniq(h_ids.data(), h_ids.data() + h_ids.size());
+  std::sort(uniq.begin(), uniq.end());
+  uniq.erase(std::unique(uniq.begin(), uniq.end()), uniq.end());
+  HostWrite<LO> h_uniq(LO(uniq.size()));
+  std::copy(uniq.begin(), uniq.end(), h_uniq.data());
+  HostWrite<LO> h_local(h_ids.size());
+  for (LO i = 0; i < h_ids.size(); ++i) {
+    h_local[i] = LO(
+        std::lower_bound(uniq.begin(), uniq.end(), h_ids[i]) - uniq.begin());
+  }
+  *uniq_out = h_uniq.write();
+  *local_out = h_local.write();
+}
+
+}  // end anonymous namespace
+
+PartReader::PartReader(filesystem::path const& path, I32 part, I32 version)
+    : part_(part),
+      nparts_(1),
+      family_(OMEGA_H_SIMPLEX),
+      dim_(0),
+      parting_(OMEGA_H_ELEM_BASED),
+      nghost_layers_(0),
+      is_compressed_(false),
+      needs_swapping_(!is_little_endian_cpu()) {
+  auto filepath = path;
+  filepath /= std::to_string(part);
+  if (version != -1) filepath += ".osh";
+  file_.open(filepath.c_str(), std::ios::binary);
+  if (!file_.is_open()) {
+    Omega_h_fail("could not open file \"%s\"\n", filepath.c_str());
+  }
+  unsigned char magic_in[2];
+  file_.read(reinterpret_cast<char*>(magic_in), sizeof(magic_in));
+  OMEGA_H_CHECK(magic_in[0] == 0xa1);
+  OMEGA_H_CHECK(magic_in[1] == 0x1a);
+  auto& s = needs_swapping_;
+  if (version == -1) version = read_scalar<I32>(file_, s);
+  OMEGA_H_CHECK(1 <= version && version <= latest_version);
+  is_compressed_ = read_scalar<I8>(file_, s);
+  if (version >= 7) family_ = Omega_h_Family(read_scalar<I8>(file_, s));
+  Int const dim = read_scalar<I8>(file_, s);
+  OMEGA_H_CHECK(1 <= dim && dim <= 3);
+  dim_ = dim;
+  nparts_ = read_scalar<I32>(file_, s);
+  OMEGA_H_CHECK(read_scalar<I32>(file_, s) == part);
+  parting_ = Omega_h_Parting(read_scalar<I8>(file_, s));
+  if (version >= 3) nghost_layers_ = read_scalar<I32>(file_, s);
+  if (read_scalar<I8>(file_, s)) {
+    auto naxes = read_scalar<I32>(file_, s);
+    file_.seekg(std::streamoff(naxes) * 3 * sizeof(Real), std::ios::cur);
+  }
+  if (version < 6) read_scalar<I8>(file_, s);
+  for (Int d = 0; d < 4; ++d) nents_[d] = 0;
+  nents_[VERT] = read_scalar<LO>(file_, s);
+  auto const c = bool(is_compressed_);
+  for (Int d = 1; d <= dim; ++d) {
+    down_[d] = skim_array(file_, sizeof(LO), c, s);
+    nents_[d] = divide_no_remainder(
+        down_[d].size, element_degree(family_, d, d - 1));
+    if (d > 1) codes_[d] = skim_array(file_, sizeof(I8), c, s);
+  }
+  for (Int d = 0; d <= dim; ++d) {
+    auto ntags = read_scalar<Int>(file_, s);
+    for (Int i = 0; i < ntags; ++i) {
+      StoredTag tag;
+      read(file_, tag.name, s);
+      tag.ncomps = read_scalar<I8>(file_, s);
+      tag.type = Omega_h_Type(read_scalar<I8>(file_, s));
+      if (version < 5) {
+        read_scalar<I8>(file_, s);
+        if (2 <= version) read_scalar<I8>(file_, s);
+      }
+      tag.array = skim_array(file_, scalar_size(tag.type), c, s);
+      tags_[d].push_back(tag);
+    }
+    if (nparts_ > 1) {
+      owner_ranks_[d] = skim_array(file_, sizeof(I32), c, s);
+      skim_array(file_, sizeof(LO), c, s);
+    }
+  }
+  OMEGA_H_CHECK(bool(file_));
+}
+
+LO PartReader::nents(Int ent_dim) const { return nents_[ent_dim]; }
+
+std::vector<StoredTag> const& PartReader::tags(Int ent_dim) const {
+  return tags_[ent_dim];
+}
+
+bool PartReader::has_tag(Int ent_dim, std::string const& name) const {
+  for (auto& tag : tags_[ent_dim]) {
+    if (tag.name == name) return true;
+  }
+  return false;
+}
+
+StoredTag const& PartReader::get_tag(
+    Int ent_dim, std::string const& name) const {
+  for (auto& tag : tags_[ent_dim]) {
+    if (tag.name == name) return tag;
+  }
+  Omega_h_fail("part %d has no tag \"%s\" on dimension %d\n", part_,
+      name.c_str(), ent_dim);
+  OMEGA_H_NORETURN(tags_[ent_dim].front());
+}
+
+ArrayStream& PartReader::seek(StoredArray const& array, std::size_t pos) {
+  auto& stream = streams_[array.offset];
+  if (!stream) {
+    stream = std::make_shared<ArrayStream>(file_, array, is_compressed_);
+  }
+  stream->seek(pos);
+  return *stream;
+}
+
+template <typename T>
+Read<T> PartReader::read_range(
+    StoredArray const& array, Int width, LO begin, LO end) {
+  OMEGA_H_CHECK(0 <= begin && begin <= end);
+  OMEGA_H_CHECK(LO(I64(end) * width) <= array.size);
+  auto& stream =
+      seek(array, std::size_t(begin) * std::size_t(width) * sizeof(T));
+  HostWrite<T> out((end - begin) * width);
+  stream.read(reinterpret_cast<char*>(nonnull(out.data())),
+      std::size_t(out.size()) * sizeof(T));
+  return swap_bytes(Read<T>(out.write()), needs_swapping_);
+}
+
+template <typename T>
+Read<T> PartReader::read_subset(StoredArray const& array, Int width, LOs ents) {
+  HostRead<LO> h_ents(ents);
+  std::vector<LO> order(std::size_t(h_ents.size()));
+  for (LO i = 0; i < h_ents.size(); ++i) order[std::size_t(i)] = i;
+  std::sort(order.begin(), order.end(),
+      [&](LO a, LO b) { return h_ents[a] < h_ents[b]; });
+  HostWrite<T> out(h_ents.size() * width);
+  auto const entry_bytes = std::size_t(width) * sizeof(T);
+  std::vector<T> entry(static_cast<std::size_t>(width));
+  LO last = -1;  // entity currently held in (entry)
+  for (auto i : order) {
+    auto ent = h_ents[i];
+    OMEGA_H_CHECK(0 <= ent && LO(I64(ent + 1) * width) <= array.size);
+    if (ent != last) {
+      auto& stream = seek(array, std::size_t(ent) * entry_bytes);
+      stream.read(reinterpret_cast<char*>(entry.data()), entry_bytes);
+      last = ent;
+    }
+    std::copy(entry.begin(), entry.end(), out.data() + i * width);
+  }
+  return swap_bytes(Read<T>(out.write()), needs_swapping_);
+}
+
+template <typename T>
+Read<T> PartReader::read_tag(
+    Int ent_dim, std::string const& name, LO begin, LO end) {
+  auto& tag = get_tag(ent_dim, name);
+  OMEGA_H_CHECK(tag.type == StoredType<T>::value);
+  return read_range<T>(tag.array, tag.ncomps, begin, end);
+}
+
+template <typename T>
+Read<T> PartReader::read_tag(Int ent_dim, std::string const& name, LOs ents) {
+  auto& tag = get_tag(ent_dim, name);
+  OMEGA_H_CHECK(tag.type == StoredType<T>::value);
+  return read_subset<T>(tag.array, tag.ncomps, ents);
+}
+
+Read<I32> PartReader::read_owner_ranks(Int ent_dim, LOs ents) {
+  if (nparts_ == 1) return Read<I32>(ents.size(), part_);
+  return read_subset<I32>(owner_ranks_[ent_dim], 1, ents);
+}
+
+Read<I32> PartReader::read_owner_ranks(Int ent_dim, LO begin, LO end) {
+  if (nparts_ == 1) return Read<I32>(end - begin, part_);
+  return read_range<I32>(owner_ranks_[ent_dim], 1, begin, end);
+}
+
+Adj PartReader::read_down(Int ent_dim, LO begin, LO end) {
+  auto deg = element_degree(family_, ent_dim, ent_dim - 1);
+  Adj down(read_range<LO>(down_[ent_dim], deg, begin, end));
+  if (ent_dim > 1) down.codes = read_range<I8>(codes_[ent_dim], deg, begin, end);
+  return down;
+}
+
+Adj PartReader::read_down(Int ent_dim, LOs ents) {
+  auto deg = element_degree(family_, ent_dim, ent_dim - 1);
+  Adj down(read_subset<LO>(down_[ent_dim], deg, ents));
+  if (ent_dim > 1) down.codes = read_subset<I8>(codes_[ent_dim], deg, ents);
+  return down;
+}
+
+/* composes the downward adjacencies one dimension at a time exactly as
+   Mesh::ask_verts_of() does, but only over the lower entities the chunk
+   actually touches, compacted to a local numbering at each step */
+EntChunk read_ent_chunk(PartReader* part, Int ent_dim, LO begin, LO end) {
+  OMEGA_H_TIME_FUNCTION;
+  EntChunk chunk;
+  chunk.begin = begin;
+  chunk.end = end;
+  if (ent_dim == VERT) {
+    chunk.verts = LOs(end - begin, begin, 1);
+    chunk.ents2verts = LOs(end - begin, 0, 1);
+    return chunk;
+  }
+  auto h2l = part->read_down(ent_dim, begin, end);
+  for (Int mid_dim = ent_dim - 1; mid_dim > VERT; --mid_dim) {
+    LOs mids;
+    LOs h2m_local;
+    compact(h2l.ab2b, &mids, &h2m_local);
+    auto m2l = part->read_down(mid_dim, mids);
+    h2l = transit(Adj(h2m_local, h2l.codes), m2l, part->family(), ent_dim,
+        mid_dim - 1);
+  }
+  compact(h2l.ab2b, &chunk.verts, &chunk.ents2verts);
+  return chunk;
+}
+
+std::vector<I32> get_stream_parts(filesystem::path const& path, CommPtr comm) {
+  auto nparts = read_nparts(path, comm);
+  std::vector<I32> parts;
+  for (I32 part = comm->rank(); part < nparts; part += comm->size()) {
+    parts.push_back(part);
+  }
+  return parts;
+}
+
+void for_each_ent_chunk(filesystem::path const& path, CommPtr comm,
+    Int ent_dim, LO max_chunk_ents,
+    std::function<void(PartReader*, EntChunk const&)> const& f) {
+  OMEGA_H_TIME_FUNCTION;
+  OMEGA_H_CHECK(max_chunk_ents > 0);
+  auto const version = read_version(path, comm);
+  for (auto part : get_stream_parts(path, comm)) {
+    PartReader reader(path, part, version);
+    auto const dim = (ent_dim == -1) ? reader.dim() : ent_dim;
+    auto const nents = reader.nents(dim);
+    for (LO begin = 0; begin < nents; begin += max_chunk_ents) {
+      auto const end = std::min(nents, begin + max_chunk_ents);
+      f(&reader, read_ent_chunk(&reader, dim, begin, end));
+    }
+  }
+}
+
+#define OMEGA_H_INST(T)                                                        \
+  template Read<T> PartReader::read_tag(                                       \
+      Int ent_dim, std::string const& name, LO begin, LO end);                 \
+  template Read<T> PartReader::read_tag(                                       \
+      Int ent_dim, std::string const& name, LOs ents);
+OMEGA_H_INST(I8)
+OMEGA_H_INST(I32)
+OMEGA_H_INST(I64)
+OMEGA_H_INST(Real)
+#undef OMEGA_H_INST
+
+}  // namespace binary
+
+}  // end namespace Omega_h
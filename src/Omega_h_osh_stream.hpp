@@ -0,0 +1,131 @@
+#ifndef OMEGA_H_OSH_STREAM_HPP
+#define OMEGA_H_OSH_STREAM_HPP
+
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Omega_h_adj.hpp>
+#include <Omega_h_comm.hpp>
+#include <Omega_h_filesystem.hpp>
+
+namespace Omega_h {
+
+namespace binary {
+
+/* where one array of a part file is stored */
+struct StoredArray {
+  std::streamoff offset = -1;  // start of the (possibly compressed) data
+  LO size = 0;                 // number of scalars
+  I64 compressed_bytes = -1;   // -1 if stored uncompressed
+  bool exists() const { return offset >= 0; }
+};
+
+class ArrayStream;
+
+struct StoredTag {
+  std::string name;
+  Int ncomps;
+  Omega_h_Type type;
+  StoredArray array;
+};
+
+/* out-of-core access to one part of a .osh directory.
+   opening a part only skims it, seeking past the stored arrays.
+   afterwards any range or subset of the entities of one array can be
+   read by inflating that array alone through a bounded buffer, so memory
+   use follows what is asked for rather than the size of the part.
+   each array keeps one stream, which resumes from a saved inflate state
+   when it has to move backward, so reading an array in chunks inflates
+   it about once in whatever order the chunks come */
+class PartReader {
+ public:
+  PartReader(filesystem::path const& path, I32 part, I32 version);
+  I32 part() const { return part_; }
+  I32 nparts() const { return nparts_; }
+  Omega_h_Family family() const { return family_; }
+  Int dim() const { return dim_; }
+  Omega_h_Parting parting() const { return parting_; }
+  Int nghost_layers() const { return nghost_layers_; }
+  LO nents(Int ent_dim) const;
+  std::vector<StoredTag> const& tags(Int ent_dim) const;
+  bool has_tag(Int ent_dim, std::string const& name) const;
+  StoredTag const& get_tag(Int ent_dim, std::string const& name) const;
+  /* values of the entities [begin, end) */
+  template <typename T>
+  Read<T> read_tag(Int ent_dim, std::string const& name, LO begin, LO end);
+  /* values of the given entities, in the given order */
+  template <typename T>
+  Read<T> read_tag(Int ent_dim, std::string const& name, LOs ents);
+  Read<I32> read_owner_ranks(Int ent_dim, LOs ents);
+  Read<I32> read_owner_ranks(Int ent_dim, LO begin, LO end);
+  /* adjacency to dimension (ent_dim - 1) */
+  Adj read_down(Int ent_dim, LO begin, LO end);
+  Adj read_down(Int ent_dim, LOs ents);
+
+ private:
+  template <typename T>
+  Read<T> read_range(StoredArray const& array, Int width, LO begin, LO end);
+  template <typename T>
+  Read<T> read_subset(StoredArray const& array, Int width, LOs ents);
+  /* the stream of (array), moved to byte (pos) of its data */
+  ArrayStream& seek(StoredArray const& array, std::size_t pos);
+  std::ifstream file_;
+  I32 part_;
+  I32 nparts_;
+  Omega_h_Family family_;
+  Int dim_;
+  Omega_h_Parting parting_;
+  Int nghost_layers_;
+  bool is_compressed_;
+  bool needs_swapping_;
+  LO nents_[4];
+  StoredArray down_[4];
+  StoredArray codes_[4];
+  std::vector<StoredTag> tags_[4];
+  StoredArray owner_ranks_[4];
+  std::map<std::streamoff, std::shared_ptr<ArrayStream>> streams_;
+};
+
+/* a contiguous range of the entities of one part, along with
+   just the vertices they use */
+struct EntChunk {
+  LO begin;
+  LO end;
+  LOs verts;       // part vertices used by the chunk, sorted
+  LOs ents2verts;  // connectivity into (verts)
+};
+
+EntChunk read_ent_chunk(PartReader* part, Int ent_dim, LO begin, LO end);
+
+/* the parts of a .osh directory that this rank handles when streaming it.
+   parts are dealt round-robin, so any number of ranks can stream any
+   number of parts */
+std::vector<I32> get_stream_parts(filesystem::path const& path, CommPtr comm);
+
+/* calls (f) on every chunk of at most (max_chunk_ents) entities of
+   dimension (ent_dim) in the parts handled by this rank.
+   (ent_dim) -1 means the dimension of the mesh */
+void for_each_ent_chunk(filesystem::path const& path, CommPtr comm,
+    Int ent_dim, LO max_chunk_ents,
+    std::function<void(PartReader*, EntChunk const&)> const& f);
+
+#define OMEGA_H_EXPL_INST_DECL(T)                                              \
+  extern template Read<T> PartReader::read_tag(                                \
+      Int ent_dim, std::string const& name, LO begin, LO end);                 \
+  extern template Read<T> PartReader::read_tag(                                \
+      Int ent_dim, std::string const& name, LOs ents);
+OMEGA_H_EXPL_INST_DECL(I8)
+OMEGA_H_EXPL_INST_DECL(I32)
+OMEGA_H_EXPL_INST_DECL(I64)
+OMEGA_H_EXPL_INST_DECL(Real)
+#undef OMEGA_H_EXPL_INST_DECL
+
+}  // namespace binary
+
+}  // end namespace Omega_h
+
+#endif
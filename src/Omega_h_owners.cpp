@@ -5,6 +5,7 @@
 #include "Omega_h_int_scan.hpp"
 #include "Omega_h_linpart.hpp"
 #include "Omega_h_mesh.hpp"
+#include "Omega_h_mixed.hpp"
 
 namespace Omega_h {
 
@@ -12,15 +13,19 @@ Remotes update_ownership(Dist copies2old_owners, Read<I32> own_ranks) {
   auto ncopies = copies2old_owners.nitems();
   auto old_owners2copies = copies2old_owners.invert();
   auto nold_owners = old_owners2copies.nroots();
-  auto serv_copies2copy_idxs = copies2old_owners.exch(LOs(ncopies, 0, 1), 1);
+  /* whatever the old owners need from the copies goes in one exchange,
+     and so does everything they send back */
+  std::vector<MixedArray> copy_data = {{LOs(ncopies, 0, 1), 1}};
+  if (own_ranks.exists()) copy_data.push_back({own_ranks, 1});
+  auto serv_copy_data = exch_arrays(copies2old_owners, copy_data);
+  auto serv_copies2copy_idxs = serv_copy_data[0].get<LO>();
   auto client2serv_comm = copies2old_owners.comm();
   auto serv_copies2clients = old_owners2copies.items2msgs();
   auto old_owners2serv_copies = old_owners2copies.roots2items();
   auto clients2ranks = old_owners2copies.msgs2ranks();
   Write<LO> old_owners2own_idxs(nold_owners);
-  Read<LO> copies2own_ranks;
   if (own_ranks.exists()) {
-    auto serv_copies2own_ranks = copies2old_owners.exch(own_ranks, 1);
+    auto serv_copies2own_ranks = serv_copy_data[1].get<I32>();
     auto f = OMEGA_H_LAMBDA(LO old_owner) {
       auto own_idx = -1;
       for (auto serv_copy = old_owners2serv_copies[old_owner];
@@ -36,38 +41,38 @@ Remotes update_ownership(Dist copies2old_owners, Read<I32> own_ranks) {
       old_owners2own_idxs[old_owner] = own_idx;
     };
     parallel_for(nold_owners, f, "update_ownership(ranks)");
-    copies2own_ranks = own_ranks;
-  } else {
-    Write<I32> old_owners2own_ranks(nold_owners);
-    auto clients2ncopies = client2serv_comm->allgather(ncopies);
-    auto f = OMEGA_H_LAMBDA(LO old_owner) {
-      I32 own_rank = -1;
-      LO nown_client_copies = -1;
-      LO own_idx = -1;
-      for (auto serv_copy = old_owners2serv_copies[old_owner];
-           serv_copy < old_owners2serv_copies[old_owner + 1]; ++serv_copy) {
-        auto client = serv_copies2clients[serv_copy];
-        auto nclient_copies = clients2ncopies[client];
-        auto client_rank = clients2ranks[client];
-        if ((own_rank == -1) || (nclient_copies < nown_client_copies) ||
-            ((nclient_copies == nown_client_copies) &&
-                (client_rank < own_rank))) {
-          auto copy_idx = serv_copies2copy_idxs[serv_copy];
-          own_rank = client_rank;
-          nown_client_copies = nclient_copies;
-          own_idx = copy_idx;
-        }
-      }
-      old_owners2own_ranks[old_owner] = own_rank;
-      old_owners2own_idxs[old_owner] = own_idx;
-    };
-    parallel_for(nold_owners, f, "update_ownership");
-    copies2own_ranks =
-        old_owners2copies.exch(Read<I32>(old_owners2own_ranks), 1);
+    auto copies2own_idxs =
+        old_owners2copies.exch(Read<LO>(old_owners2own_idxs), 1);
+    return Remotes(own_ranks, copies2own_idxs);
   }
-  auto copies2own_idxs =
-      old_owners2copies.exch(Read<LO>(old_owners2own_idxs), 1);
-  return Remotes(copies2own_ranks, copies2own_idxs);
+  Write<I32> old_owners2own_ranks(nold_owners);
+  auto clients2ncopies = client2serv_comm->allgather(ncopies);
+  auto f = OMEGA_H_LAMBDA(LO old_owner) {
+    I32 own_rank = -1;
+    LO nown_client_copies = -1;
+    LO own_idx = -1;
+    for (auto serv_copy = old_owners2serv_copies[old_owner];
+         serv_copy < old_owners2serv_copies[old_owner + 1]; ++serv_copy) {
+      auto client = serv_copies2clients[serv_copy];
+      auto nclient_copies = clients2ncopies[client];
+      auto client_rank = clients2ranks[client];
+      if ((own_rank == -1) || (nclient_copies < nown_client_copies) ||
+          ((nclient_copies == nown_client_copies) &&
+              (client_rank < own_rank))) {
+        auto copy_idx = serv_copies2copy_idxs[serv_copy];
+        own_rank = client_rank;
+        nown_client_copies = nclient_copies;
+        own_idx = copy_idx;
+      }
+    }
+    old_owners2own_ranks[old_owner] = own_rank;
+    old_owners2own_idxs[old_owner] = own_idx;
+  };
+  parallel_for(nold_owners, f, "update_ownership");
+  auto owner_data = exch_arrays(old_owners2copies,
+      {{Read<I32>(old_owners2own_ranks), 1},
+          {Read<LO>(old_owners2own_idxs), 1}});
+  return Remotes(owner_data[0].get<I32>(), owner_data[1].get<LO>());
 }
 
 /* uses update_ownership() with a linear partitioning of
@@ -83,13 +88,9 @@ Remotes owners_from_globals(
 }
 
 template <typename T>
-Read<T> reduce_data_to_owners(
-    Read<T> copy_data, Dist copies2owners, Int ncomps) {
-  auto owners2copies = copies2owners.invert();
-  auto serv_copy_data = copies2owners.exch(copy_data, ncomps);
-  auto nowners = owners2copies.nroots();
-  auto comm = copies2owners.parent_comm();
-  auto owners2serv_copies = owners2copies.roots2items();
+static Read<T> take_first_copies(
+    LOs owners2serv_copies, Read<T> serv_copy_data, Int ncomps) {
+  auto nowners = owners2serv_copies.size() - 1;
   auto owner_data_w = Write<T>(nowners * ncomps);
   auto f = OMEGA_H_LAMBDA(LO owner) {
     auto sc_begin = owners2serv_copies[owner];
@@ -101,6 +102,47 @@ Read<T> reduce_data_to_owners(
   return owner_data_w;
 }
 
+template <typename T>
+Read<T> reduce_data_to_owners(
+    Read<T> copy_data, Dist copies2owners, Int ncomps) {
+  auto serv_copy_data = copies2owners.exch(copy_data, ncomps);
+  auto owners2serv_copies = copies2owners.invert().roots2items();
+  return take_first_copies(owners2serv_copies, serv_copy_data, ncomps);
+}
+
+std::vector<MixedArray> reduce_data_to_owners(
+    std::vector<MixedArray> const& copy_data, Dist copies2owners) {
+  auto serv_copy_data = exch_arrays(copies2owners, copy_data);
+  auto owners2serv_copies = copies2owners.invert().roots2items();
+  std::vector<MixedArray> out;
+  for (auto& array : serv_copy_data) {
+    auto width = array.width();
+    switch (array.type()) {
+      case OMEGA_H_I8:
+        out.push_back({take_first_copies(owners2serv_copies, array.get<I8>(),
+                           width),
+            width});
+        break;
+      case OMEGA_H_I32:
+        out.push_back({take_first_copies(owners2serv_copies,
+                           array.get<I32>(), width),
+            width});
+        break;
+      case OMEGA_H_I64:
+        out.push_back({take_first_copies(owners2serv_copies,
+                           array.get<I64>(), width),
+            width});
+        break;
+      case OMEGA_H_F64:
+        out.push_back({take_first_copies(owners2serv_copies,
+                           array.get<Real>(), width),
+            width});
+        break;
+    }
+  }
+  return out;
+}
+
 GOs globals_from_owners(Mesh* mesh, Int ent_dim) {
   auto nnew_ents = mesh->nents(ent_dim);
   if (!mesh->could_be_shared(ent_dim)) {
@@ -112,6 +154,40 @@ GOs globals_from_owners(Mesh* mesh, Int ent_dim) {
   return mesh->sync_array(ent_dim, new_globals, 1);
 }
 
+Graph get_sharers(Mesh* mesh, Int ent_dim) {
+  auto owners2copies = mesh->ask_dist(ent_dim).invert();
+  auto nents = mesh->nents(ent_dim);
+  auto h_ents2copies = HostRead<LO>(owners2copies.roots2items());
+  auto copies = owners2copies.items2dests();
+  auto h_copy_ranks = HostRead<I32>(copies.ranks);
+  auto h_copy_idxs = HostRead<LO>(copies.idxs);
+  LO nmsgs = 0;
+  for (LO i = 0; i < nents; ++i) {
+    auto ncopies = h_ents2copies[i + 1] - h_ents2copies[i];
+    nmsgs += ncopies * (ncopies - 1);
+  }
+  HostWrite<I32> msg_ranks(nmsgs);
+  HostWrite<LO> msg_idxs(nmsgs);
+  HostWrite<I32> msg_sharers(nmsgs);
+  LO msg = 0;
+  for (LO i = 0; i < nents; ++i) {
+    for (auto to = h_ents2copies[i]; to < h_ents2copies[i + 1]; ++to) {
+      for (auto about = h_ents2copies[i]; about < h_ents2copies[i + 1];
+           ++about) {
+        if (about == to) continue;
+        msg_ranks[msg] = h_copy_ranks[to];
+        msg_idxs[msg] = h_copy_idxs[to];
+        msg_sharers[msg] = h_copy_ranks[about];
+        ++msg;
+      }
+    }
+  }
+  auto dist = Dist(mesh->comm(),
+      Remotes(msg_ranks.write(), msg_idxs.write()), nents);
+  auto sharers = dist.exch(Read<I32>(msg_sharers.write()), 1);
+  return Graph(dist.invert().roots2items(), sharers);
+}
+
 #define INST(T)                                                                \
   template Read<T> reduce_data_to_owners(                                      \
       Read<T> copy_data, Dist copies2owners, Int ncomps);
@@ -2,6 +2,7 @@
 #define OMEGA_H_OWNERS_HPP
 
 #include <Omega_h_dist.hpp>
+#include <Omega_h_mixed.hpp>
 #include <Omega_h_remotes.hpp>
 
 namespace Omega_h {
@@ -34,12 +35,21 @@ template <typename T>
 Read<T> reduce_data_to_owners(
     Read<T> copy_data, Dist copies2owners, Int ncomps);
 
+/* reduce_data_to_owners for several arrays in one exchange */
+std::vector<MixedArray> reduce_data_to_owners(
+    std::vector<MixedArray> const& copy_data, Dist copies2owners);
+
 /* computes new global numbers of entities of dimension (ent_dim).
    owned entities on the same MPI rank will be numbered consecutively,
    and all entities owned by MPI rank (i) will be numbered before
    those owned by MPI rank (i + 1). */
 GOs globals_from_owners(Mesh* mesh, Int ent_dim);
 
+/* for each entity of dimension (ent_dim), the other ranks that have
+   a copy of it. the owner of each entity tells every copy about all
+   the others */
+Graph get_sharers(Mesh* mesh, Int ent_dim);
+
 #define OMEGA_H_INST_DECL(T)                                                   \
   extern template Read<T> reduce_data_to_owners(                               \
       Read<T> copy_data, Dist copies2owners, Int ncomps);
@@ -32,7 +32,7 @@ static std::size_t underlying_total_size(Pool& pool) {
 }
 
 void* allocate(Pool& pool, std::size_t size) {
-  ScopedTimer timer("pool allocate");
+  OMEGA_H_TIME_REGION("pool allocate");
   std::size_t shift;
   for (shift = 0; ((std::size_t(1) << shift) < size); ++shift)
     ;
@@ -58,7 +58,7 @@ void* allocate(Pool& pool, std::size_t size) {
 }
 
 void deallocate(Pool& pool, void* data, std::size_t size) {
-  ScopedTimer timer("pool deallocate");
+  OMEGA_H_TIME_REGION("pool deallocate");
   std::size_t shift;
   for (shift = 0; ((std::size_t(1) << shift) < size); ++shift)
     ;
@@ -1,14 +1,166 @@
 #include <Omega_h_profile.hpp>
 #include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <deque>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <queue>
+#include <unordered_map>
+
+#ifndef _MSC_VER
+#include <sys/time.h>
+#endif
+
+#include <Omega_h_comm.hpp>
+#include <Omega_h_dist.hpp>
+#include <Omega_h_fail.hpp>
+
+extern "C" void Omega_h_sample_handler(int s);
 
 namespace Omega_h {
 namespace profile {
 
-OMEGA_H_DLL History* global_singleton_history = nullptr;
+OMEGA_H_DLL OMEGA_H_THREAD_LOCAL History* global_singleton_history = nullptr;
+OMEGA_H_DLL std::atomic<std::size_t> pending_samples(0);
+
+/* the signal may arrive on any thread, so the handler reserves a slot
+   with a compare-and-swap before storing current_frame plus one in it.
+   zero marks a slot that is reserved but not yet written. the sampled
+   History attributes the samples when it next drains */
+static constexpr std::size_t sample_capacity = 4 * drain_threshold;
+static std::atomic<std::size_t> sample_buffer[sample_capacity];
+static std::atomic<History*> sampled_history(nullptr);
+
+}  // namespace profile
+}  // namespace Omega_h
+
+extern "C" void Omega_h_sample_handler(int) {
+  using namespace Omega_h::profile;
+  auto h = sampled_history.load();
+  if (h == nullptr) return;
+  auto n = pending_samples.load();
+  do {
+    if (n >= sample_capacity) return;
+  } while (!pending_samples.compare_exchange_weak(n, n + 1));
+  sample_buffer[n].store(h->current_frame + 1);
+}
+
+namespace Omega_h {
+namespace profile {
+
+namespace {
+/* shared by all threads. a deque keeps the names, and so the
+   pointers get_region_name returns, in place as more are added */
+struct Regions {
+  std::mutex mutex;
+  std::deque<std::string> names;
+  std::unordered_map<std::string, RegionId> ids;
+};
+}  // end anonymous namespace
+
+static Regions& get_regions() {
+  static Regions regions;
+  return regions;
+}
+
+RegionId intern(char const* name) {
+  auto& regions = get_regions();
+  std::lock_guard<std::mutex> lock(regions.mutex);
+  auto it = regions.ids.find(name);
+  if (it != regions.ids.end()) return it->second;
+  auto region = regions.names.size();
+  regions.names.push_back(name);
+  regions.ids[name] = region;
+  return region;
+}
+
+char const* get_region_name(RegionId region) {
+  auto& regions = get_regions();
+  std::lock_guard<std::mutex> lock(regions.mutex);
+  return regions.names[region].c_str();
+}
+
+History::History()
+    : current_frame(invalid),
+      last_root(invalid),
+      recent_root(invalid),
+      is_sampling(false),
+      sample_period(0.0) {}
 
-History::History() : current_frame(invalid), last_root(invalid) {}
+#ifndef _MSC_VER
+static void set_sample_timer(double period) {
+  itimerval timer;
+  timer.it_interval.tv_sec = time_t(period);
+  timer.it_interval.tv_usec =
+      suseconds_t((period - double(timer.it_interval.tv_sec)) * 1e6);
+  timer.it_value = timer.it_interval;
+  OMEGA_H_CHECK(0 == setitimer(ITIMER_PROF, &timer, nullptr));
+}
+#endif
+
+/* handlers may keep reserving slots meanwhile, so the count is only
+   reset once no slot has been reserved since it was read */
+void History::drain_samples() {
+  std::size_t drained = 0;
+  while (true) {
+    auto n = pending_samples.load();
+    for (; drained < n; ++drained) {
+      std::size_t sample;
+      /* a handler has reserved this slot and is about to fill it */
+      while ((sample = sample_buffer[drained].exchange(0)) == 0) {
+      }
+      auto frame = sample - 1;
+      if (frame < frames.size()) frames[frame].number_of_samples += 1;
+    }
+    if (pending_samples.compare_exchange_strong(n, 0)) return;
+  }
+}
+
+void start_sampling(History* h, double period) {
+#ifndef _MSC_VER
+  OMEGA_H_CHECK(sampled_history == nullptr);
+  OMEGA_H_CHECK(period > 0.0);
+  h->is_sampling = true;
+  h->sample_period = period;
+  for (auto& slot : sample_buffer) slot.store(0);
+  pending_samples = 0;
+  sampled_history = h;
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_handler = Omega_h_sample_handler;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  OMEGA_H_CHECK(0 == sigaction(SIGPROF, &action, nullptr));
+  set_sample_timer(period);
+#else
+  (void)h;
+  (void)period;
+  Omega_h_fail("the sampling profiler needs POSIX interval timers\n");
+#endif
+}
+
+void stop_sampling(History* h) {
+  if (!h->is_sampling) return;
+#ifndef _MSC_VER
+  set_sample_timer(0.0);
+  h->drain_samples();
+  sampled_history = nullptr;
+  signal(SIGPROF, SIG_IGN);
+#endif
+  h->is_sampling = false;
+  /* children are always created after their parents */
+  for (auto& frame : h->frames) {
+    frame.total_runtime = double(frame.number_of_samples) * h->sample_period;
+  }
+  for (auto i = h->frames.size(); i-- > 0;) {
+    auto parent = h->frames[i].parent;
+    if (parent != invalid) {
+      h->frames[parent].total_runtime += h->frames[i].total_runtime;
+    }
+  }
+}
 
 std::size_t History::first(std::size_t parent_index) const {
   if (parent_index != invalid) return frames[parent_index].first_child;
@@ -165,5 +317,208 @@ void print_top_down_and_bottom_up(History const& h) {
   print_time_sorted(h_inv);
 }
 
+/* paths are the names from the root down, separated by this character */
+static constexpr char path_separator = '\x1f';
+
+static std::string get_path(History const& h, std::size_t frame) {
+  std::string path = h.get_name(frame);
+  for (frame = h.parent(frame); frame != invalid; frame = h.parent(frame)) {
+    path = std::string(h.get_name(frame)) + path_separator + path;
+  }
+  return path;
+}
+
+static std::vector<std::string> split(std::string const& s, char separator) {
+  std::vector<std::string> parts;
+  std::size_t begin = 0;
+  while (begin < s.size()) {
+    auto end = s.find(separator, begin);
+    if (end == std::string::npos) end = s.size();
+    parts.push_back(s.substr(begin, end - begin));
+    begin = end + 1;
+  }
+  return parts;
+}
+
+/* every path of h in pre-order, each followed by a null character */
+static std::string serialize_paths(History const& h) {
+  std::string s;
+  for (auto frame : h) {
+    s += get_path(h, frame);
+    s += '\0';
+  }
+  return s;
+}
+
+static void add_paths(History* h, std::string const& paths) {
+  for (auto& path : split(paths, '\0')) {
+    auto frame = invalid;
+    for (auto& name : split(path, path_separator)) {
+      frame = h->find_or_create_child_of(frame, name.c_str());
+    }
+  }
+}
+
+static std::size_t find_path(History const& h, std::string const& path) {
+  auto frame = invalid;
+  for (auto& name : split(path, path_separator)) {
+    frame = h.find_child_of(frame, name.c_str());
+    if (frame == invalid) break;
+  }
+  return frame;
+}
+
+/* concatenation, in rank order, of every rank's string onto rank 0 */
+static std::string gather_to_root(std::string const& local, CommPtr comm) {
+  auto const n = LO(local.size());
+  auto const offset = comm->exscan(n, OMEGA_H_SUM);
+  auto const total = comm->allreduce(n, OMEGA_H_SUM);
+  HostWrite<I8> h_local(n);
+  for (LO i = 0; i < n; ++i) h_local[i] = I8(local[std::size_t(i)]);
+  Dist dist(comm, Remotes(Read<I32>(n, 0), LOs(n, offset, 1)),
+      comm->rank() == 0 ? total : 0);
+  HostRead<I8> h_all(dist.exch(Read<I8>(h_local.write()), 1));
+  std::string all(std::size_t(h_all.size()), '\0');
+  for (LO i = 0; i < h_all.size(); ++i) all[std::size_t(i)] = char(h_all[i]);
+  return all;
+}
+
+double ParallelFrame::imbalance() const {
+  if (time.mean > 0.0) return time.max / time.mean;
+  return 1.0;
+}
+
+ParallelHistory reduce_history(History const& h, CommPtr comm) {
+  /* the communication below is itself timed, so work on a snapshot */
+  auto const local = h;
+  auto paths = serialize_paths(local);
+  paths = gather_to_root(paths, comm);
+  if (comm->rank() == 0) {
+    History all;
+    add_paths(&all, paths);
+    paths = serialize_paths(all);
+  }
+  comm->bcast_string(paths);
+  /* every rank, rank 0 included, creates the merged frames in the
+     pre-order of (paths), so frame i is the one of path i */
+  History merged;
+  add_paths(&merged, paths);
+  auto const path_list = split(paths, '\0');
+  auto const n = merged.frames.size();
+  /* per frame: time, calls and whether this rank entered it */
+  std::vector<Real> values(3 * n, 0.0);
+  for (std::size_t i = 0; i < n; ++i) {
+    auto frame = find_path(local, path_list[i]);
+    if (frame == invalid) continue;
+    values[i] = local.time(frame);
+    values[n + i] = Real(local.calls(frame));
+    values[2 * n + i] = 1.0;
+  }
+  auto const mins = comm->allreduce(values, OMEGA_H_MIN);
+  auto const maxs = comm->allreduce(values, OMEGA_H_MAX);
+  auto const sums = comm->allreduce(values, OMEGA_H_SUM);
+  std::vector<I32> max_ranks(2 * n, comm->size());
+  for (std::size_t i = 0; i < 2 * n; ++i) {
+    if (values[i] == maxs[i]) max_ranks[i] = comm->rank();
+  }
+  max_ranks = comm->allreduce(max_ranks, OMEGA_H_MIN);
+  ParallelHistory ph;
+  ph.comm_size = comm->size();
+  ph.frames.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    auto& frame = ph.frames[i];
+    frame.parent = merged.parent(i);
+    frame.name = merged.get_name(i);
+    frame.nranks = I32(sums[2 * n + i]);
+    for (std::size_t j = 0; j < 2; ++j) {
+      auto& stats = (j == 0) ? frame.time : frame.calls;
+      stats.min = mins[j * n + i];
+      stats.max = maxs[j * n + i];
+      stats.mean = sums[j * n + i] / Real(ph.comm_size);
+      stats.max_rank = max_ranks[j * n + i];
+    }
+  }
+  return ph;
+}
+
+static void print_time_sorted_recursive(ParallelHistory const& h,
+    std::vector<std::vector<std::size_t>> const& children, std::size_t frame,
+    std::size_t depth) {
+  auto child_frames = children[frame == invalid ? 0 : frame + 1];
+  std::stable_sort(begin(child_frames), end(child_frames),
+      [&](std::size_t a, std::size_t b) {
+        return h.frames[a].time.max > h.frames[b].time.max;
+      });
+  for (auto child : child_frames) {
+    auto& f = h.frames[child];
+    for (std::size_t i = 0; i < depth; ++i) std::cout << "|  ";
+    std::cout << f.name << ' ' << f.time.mean << ' ' << f.time.min << ' '
+              << f.time.max << " @" << f.time.max_rank << ' ' << f.imbalance()
+              << ' ' << f.calls.mean << ' ' << f.calls.min << ' '
+              << f.calls.max << " @" << f.calls.max_rank << ' ' << f.nranks
+              << '\n';
+    print_time_sorted_recursive(h, children, child, depth + 1);
+  }
+}
+
+void print_time_sorted(ParallelHistory const& h) {
+  /* children[0] are the roots, children[i + 1] those of frame i */
+  std::vector<std::vector<std::size_t>> children(h.frames.size() + 1);
+  for (std::size_t i = 0; i < h.frames.size(); ++i) {
+    auto parent = h.frames[i].parent;
+    children[parent == invalid ? 0 : parent + 1].push_back(i);
+  }
+  std::cout << "\n";
+  std::cout << "ACROSS " << h.comm_size << " RANKS:\n";
+  std::cout << "==============\n";
+  std::cout << "name time(mean min max @rank imbalance)"
+               " calls(mean min max @rank) ranks\n";
+  print_time_sorted_recursive(h, children, invalid, 0);
+}
+
+static void write_json_string(std::ostream& stream, std::string const& s) {
+  stream << '"';
+  for (auto c : s) {
+    if (c == '"' || c == '\\') {
+      stream << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      stream << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+             << int(c) << std::dec << std::setfill(' ');
+    } else {
+      stream << c;
+    }
+  }
+  stream << '"';
+}
+
+static void write_json(std::ostream& stream, RankStats const& stats) {
+  stream << "{\"min\": " << stats.min << ", \"max\": " << stats.max
+         << ", \"mean\": " << stats.mean
+         << ", \"max_rank\": " << stats.max_rank << "}";
+}
+
+void write_json(std::ostream& stream, ParallelHistory const& h) {
+  auto const old_precision = stream.precision(17);
+  stream << "{\n\"comm_size\": " << h.comm_size << ",\n\"regions\": [";
+  for (std::size_t i = 0; i < h.frames.size(); ++i) {
+    auto& f = h.frames[i];
+    stream << (i ? ",\n" : "\n") << "{\"name\": ";
+    write_json_string(stream, f.name);
+    stream << ", \"parent\": ";
+    if (f.parent == invalid) {
+      stream << -1;
+    } else {
+      stream << f.parent;
+    }
+    stream << ", \"ranks\": " << f.nranks << ", \"time\": ";
+    write_json(stream, f.time);
+    stream << ", \"calls\": ";
+    write_json(stream, f.calls);
+    stream << ", \"imbalance\": " << f.imbalance() << "}";
+  }
+  stream << "\n]\n}\n";
+  stream.precision(old_precision);
+}
+
 }  // namespace profile
 }  // namespace Omega_h
@@ -2,13 +2,21 @@
 #define OMEGA_H_STACK_HPP
 
 #include <Omega_h_timer.hpp>
+#include <atomic>
 #include <cstring>
+#include <iosfwd>
+#include <memory>
+#include <string>
 #include <vector>
 #ifdef OMEGA_H_USE_KOKKOS
 #include <Omega_h_kokkos.hpp>
 #endif
 
 namespace Omega_h {
+
+class Comm;
+typedef std::shared_ptr<Comm> CommPtr;
+
 namespace profile {
 
 struct Strings {
@@ -27,90 +35,122 @@ struct Strings {
 
 static constexpr std::size_t invalid = std::numeric_limits<std::size_t>::max();
 
+/* region names are interned once into small integers, so entering
+   a region compares integers rather than strings */
+typedef std::size_t RegionId;
+RegionId intern(char const* name);
+char const* get_region_name(RegionId region);
+
 struct Frame {
   std::size_t parent;
   std::size_t first_child;
   std::size_t last_child;
   std::size_t next_sibling;
-  std::size_t name_ptr;
+  std::size_t recent_child;  // child last entered, checked first
+  RegionId region;
   Now start_time;
   double total_runtime;
   std::size_t number_of_calls;
+  std::size_t number_of_samples;
 };
 
+/* samples the sampling profiler has taken but not yet attributed */
+OMEGA_H_DLL extern std::atomic<std::size_t> pending_samples;
+static constexpr std::size_t drain_threshold = 1 << 12;
+
 struct History {
   std::vector<Frame> frames;
   std::size_t current_frame;
   std::size_t last_root;
-  Strings names;
+  std::size_t recent_root;
+  /* in sampling mode regions are only entered and left; time comes
+     from periodic samples of current_frame instead of clock reads */
+  bool is_sampling;
+  double sample_period;
   History();
   inline const char* get_name(std::size_t frame) const {
-    return names.get(frames[frame].name_ptr);
+    return get_region_name(frames[frame].region);
   }
   inline std::size_t find_child_of(
-      std::size_t parent_index, char const* name) const {
-    if (parent_index == invalid) return find_root(name);
+      std::size_t parent_index, RegionId region) const {
+    if (parent_index == invalid) return find_root(region);
+    auto recent = frames[parent_index].recent_child;
+    if (recent != invalid && frames[recent].region == region) return recent;
     for (std::size_t child = frames[parent_index].first_child; child != invalid;
          child = frames[child].next_sibling) {
-      if (0 == std::strcmp(get_name(child), name)) {
+      if (frames[child].region == region) {
         return child;
       }
     }
     return invalid;
   }
-  inline std::size_t create_child_of(
-      std::size_t parent_index, char const* name) {
-    if (parent_index == invalid) return create_root(name);
-    auto index = frames.size();
+  inline std::size_t find_child_of(
+      std::size_t parent_index, char const* name) const {
+    return find_child_of(parent_index, intern(name));
+  }
+  inline Frame& new_frame(std::size_t parent_index, RegionId region) {
     frames.push_back(Frame());
     auto& frame = frames.back();
-    auto& parent_frame = frames[parent_index];
     frame.parent = parent_index;
     frame.first_child = invalid;
     frame.last_child = invalid;
+    frame.next_sibling = invalid;
+    frame.recent_child = invalid;
+    frame.region = region;
+    frame.total_runtime = 0.0;
+    frame.number_of_calls = 0;
+    frame.number_of_samples = 0;
+    return frame;
+  }
+  inline std::size_t create_child_of(
+      std::size_t parent_index, RegionId region) {
+    if (parent_index == invalid) return create_root(region);
+    auto index = frames.size();
+    new_frame(parent_index, region);
+    auto& parent_frame = frames[parent_index];
     auto old_last = parent_frame.last_child;
     if (old_last != invalid) {
       frames[old_last].next_sibling = index;
     } else {
       parent_frame.first_child = index;
     }
-    frame.next_sibling = invalid;
     parent_frame.last_child = index;
-    frame.name_ptr = names.save(name);
-    frame.total_runtime = 0.0;
-    frame.number_of_calls = 0;
     return index;
   }
+  inline std::size_t create_child_of(
+      std::size_t parent_index, char const* name) {
+    return create_child_of(parent_index, intern(name));
+  }
   inline std::size_t create_child_of_current(char const* name) {
     return create_child_of(current_frame, name);
   }
-  inline std::size_t find_root(char const* name) const {
+  inline std::size_t find_root(RegionId region) const {
     if (frames.empty()) return invalid;
+    if (recent_root != invalid && frames[recent_root].region == region) {
+      return recent_root;
+    }
     for (std::size_t i = 0; i != invalid; i = frames[i].next_sibling) {
-      if (frames[i].parent == invalid &&
-          (0 == std::strcmp(get_name(i), name))) {
+      if (frames[i].parent == invalid && frames[i].region == region) {
         return i;
       }
     }
     return invalid;
   }
-  inline std::size_t create_root(char const* name) {
+  inline std::size_t find_root(char const* name) const {
+    return find_root(intern(name));
+  }
+  inline std::size_t create_root(RegionId region) {
     auto index = frames.size();
-    frames.push_back(Frame());
-    auto& frame = frames.back();
-    frame.parent = invalid;
-    frame.first_child = invalid;
-    frame.last_child = invalid;
+    new_frame(invalid, region);
     if (index != 0) {
       frames[last_root].next_sibling = index;
     }
     last_root = index;
-    frame.next_sibling = invalid;
-    frame.name_ptr = names.save(name);
-    frame.total_runtime = 0.0;
-    frame.number_of_calls = 0;
     return index;
   }
+  inline std::size_t create_root(char const* name) {
+    return create_root(intern(name));
+  }
   inline std::size_t find(char const* name) {
     return find_child_of(current_frame, name);
   }
@@ -118,26 +158,38 @@ struct History {
     return create_child_of(current_frame, name);
   }
   inline std::size_t find_or_create(char const* name) {
-    return find_or_create_child_of(current_frame, name);
+    return find_or_create_child_of(current_frame, intern(name));
+  }
+  inline std::size_t find_or_create_child_of(
+      std::size_t parent_index, RegionId region) {
+    auto found = find_child_of(parent_index, region);
+    if (found == invalid) found = create_child_of(parent_index, region);
+    if (parent_index == invalid) {
+      recent_root = found;
+    } else {
+      frames[parent_index].recent_child = found;
+    }
+    return found;
   }
   inline std::size_t find_or_create_child_of(
       std::size_t parent_index, char const* name) {
-    auto found = find_child_of(parent_index, name);
-    if (found != invalid) return found;
-    return create_child_of(parent_index, name);
+    return find_or_create_child_of(parent_index, intern(name));
   }
-  inline std::size_t push(char const* name) {
-    std::size_t id = find_or_create(name);
+  inline std::size_t push(RegionId region) {
+    std::size_t id = find_or_create_child_of(current_frame, region);
     current_frame = id;
     return id;
   }
+  inline std::size_t push(char const* name) { return push(intern(name)); }
   inline void pop() { current_frame = frames[current_frame].parent; }
-  inline void start(char const* const name) {
-    auto id = push(name);
+  inline void start(RegionId region) {
+    auto id = push(region);
     frames[id].number_of_calls += 1;
-    frames[id].start_time = now();
+    if (!is_sampling) frames[id].start_time = now();
   }
+  inline void start(char const* const name) { start(intern(name)); }
   inline double measure_runtime() { 
+    if (is_sampling) return 0.0;
     auto current_time = now();
     auto current_runtime = current_time - frames[current_frame].start_time;
     return current_runtime;
@@ -146,9 +198,14 @@ struct History {
     return frames[current_frame].total_runtime + measure_runtime();
   }
   inline void stop() {
-    frames[current_frame].total_runtime = measure_total_runtime();
+    if (is_sampling) {
+      if (pending_samples >= drain_threshold) drain_samples();
+    } else {
+      frames[current_frame].total_runtime = measure_total_runtime();
+    }
     pop();
   }
+  void drain_samples();
   std::size_t first(std::size_t parent) const;
   std::size_t next(std::size_t sibling) const;
   std::size_t parent(std::size_t child) const;
@@ -157,13 +214,55 @@ struct History {
   std::size_t calls(std::size_t frame) const;
 };
 
-OMEGA_H_DLL extern History* global_singleton_history;
+OMEGA_H_DLL extern OMEGA_H_THREAD_LOCAL History* global_singleton_history;
+
+/* puts h in sampling mode and samples it every (period) seconds of
+   ITIMER_PROF time, which is CPU time summed over all threads of the
+   process, not wall time: with k threads busy, samples come about k
+   times as often. any thread may take a sample; each is charged to
+   the current frame of h. only one History can be sampled at a time */
+void start_sampling(History* h, double period);
+/* stops sampling and converts the samples of each frame and its
+   descendants into its total_runtime, so the usual reports apply.
+   those runtimes are CPU seconds over all threads */
+void stop_sampling(History* h);
 
 void simple_print(profile::History const& history);
 History invert(History const& h);
 void print_time_sorted(History const& h);
 void print_top_down_and_bottom_up(History const& h);
 
+/* a statistic of one region over all ranks of a communicator.
+   ranks that never entered the region count as zero */
+struct RankStats {
+  double min;
+  double max;
+  double mean;
+  I32 max_rank;  // lowest rank attaining the maximum
+};
+
+struct ParallelFrame {
+  std::size_t parent;
+  std::string name;
+  I32 nranks;  // number of ranks that entered the region
+  RankStats time;
+  RankStats calls;
+  /* maximum over mean time, 1 is perfectly balanced */
+  double imbalance() const;
+};
+
+/* the union of the profile trees of all ranks, with frames
+   merged by their path from the root. frames are in pre-order */
+struct ParallelHistory {
+  I32 comm_size;
+  std::vector<ParallelFrame> frames;
+};
+
+/* collective over comm, the result is the same on all ranks */
+ParallelHistory reduce_history(History const& h, CommPtr comm);
+void print_time_sorted(ParallelHistory const& h);
+void write_json(std::ostream& stream, ParallelHistory const& h);
+
 }  // namespace profile
 }  // namespace Omega_h
 
@@ -178,6 +277,15 @@ inline void begin_code(char const* name) {
   }
 }
 
+inline void begin_code(profile::RegionId region) {
+#ifdef OMEGA_H_USE_KOKKOS
+  Kokkos::Profiling::pushRegion(profile::get_region_name(region));
+#endif
+  if (profile::global_singleton_history) {
+    profile::global_singleton_history->start(region);
+  }
+}
+
 inline double get_runtime () {
   double runtime = 0.0;
   if (profile::global_singleton_history) {
@@ -197,6 +305,7 @@ inline void end_code() {
 
 struct ScopedTimer {
   ScopedTimer(char const* name) { begin_code(name); }
+  ScopedTimer(profile::RegionId region) { begin_code(region); }
   ~ScopedTimer() { end_code(); }
   ScopedTimer(ScopedTimer const&) = delete;
   ScopedTimer(ScopedTimer&&) = delete;
@@ -207,7 +316,16 @@ struct ScopedTimer {
 
 }  // namespace Omega_h
 
+/* the function name is interned on the first call only */
 #define OMEGA_H_TIME_FUNCTION                                                  \
-  ::Omega_h::ScopedTimer omega_h_scoped_function_timer(__FUNCTION__)
+  static ::Omega_h::profile::RegionId const omega_h_function_region =          \
+      ::Omega_h::profile::intern(__FUNCTION__);                                \
+  ::Omega_h::ScopedTimer omega_h_scoped_function_timer(omega_h_function_region)
+
+/* the same for a region named by a string literal, for hot regions */
+#define OMEGA_H_TIME_REGION(name)                                              \
+  static ::Omega_h::profile::RegionId const omega_h_named_region =             \
+      ::Omega_h::profile::intern(name);                                        \
+  ::Omega_h::ScopedTimer omega_h_scoped_region_timer(omega_h_named_region)
 
 #endif
@@ -17,4 +17,15 @@ Reals unit_uniform_random_reals_from_globals(
   return out;
 }
 
+GOs random_priorities_from_globals(
+    GOs const globals, I64 const seed, I64 const iteration) {
+  auto const n = globals.size();
+  auto const out = Write<GO>(n);
+  auto functor = OMEGA_H_LAMBDA(LO const i) {
+    out[i] = random_priority(seed, globals[i], iteration);
+  };
+  parallel_for(n, std::move(functor), "random_priorities_from_globals");
+  return out;
+}
+
 }  // namespace Omega_h
@@ -7,6 +7,9 @@ namespace Omega_h {
 
 Reals unit_uniform_random_reals_from_globals(
     GOs const globals, I64 const seed, I64 const counter);
+/* random_priority() of each global number */
+GOs random_priorities_from_globals(
+    GOs const globals, I64 const seed, I64 const iteration);
 
 }
 
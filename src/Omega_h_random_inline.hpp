@@ -32,6 +32,17 @@ OMEGA_H_INLINE Few<std::uint64_t, 2> run_philox_cbrng(
   return ctr;
 }
 
+/* a non-negative random priority for the item with global number (global).
+   it depends only on (seed, global, iteration), not on which rank holds
+   the item, so algorithms ordered by it are independent of rank count */
+OMEGA_H_INLINE I64 random_priority(I64 seed, GO global, I64 iteration) {
+  Few<std::uint64_t, 2> ctr;
+  ctr[0] = static_cast<std::uint64_t>(iteration);
+  ctr[1] = static_cast<std::uint64_t>(seed);
+  auto bits = run_philox_cbrng(ctr, static_cast<std::uint64_t>(global));
+  return static_cast<I64>(bits[0] >> 1);
+}
+
 OMEGA_H_INLINE Real unit_uniform_deviate_from_uint64(std::uint64_t x) {
   return static_cast<Real>(x) /
          static_cast<Real>(ArithTraits<std::uint64_t>::max());
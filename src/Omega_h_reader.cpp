@@ -4,6 +4,7 @@
 #include <fstream>
 #include <ios>
 #include <iostream>
+#include <iterator>
 #include <set>
 #include <sstream>
 #include <algorithm>
@@ -40,7 +41,7 @@ void print_underline(std::ostream& os, std::string const& above,
 
 }  // end anonymous namespace
 
-void Reader::at_token(std::istream& stream) {
+void Reader::at_token() {
   bool done = false;
   /* this can loop arbitrarily as reductions are made,
      because they don't consume the token */
@@ -48,9 +49,10 @@ void Reader::at_token(std::istream& stream) {
     auto parser_action = get_action(parser, parser_state, lexer_token);
     if (parser_action.kind == ACTION_NONE) {
       std::stringstream ss;
-      ss << "error: Parser failure at line " << line;
-      ss << " column " << column << " of " << stream_name << '\n';
-      error_print_line(stream, ss);
+      ss << "error: Parser failure at line " << get_line(position);
+      ss << " column " << get_column(position) << " of " << stream_name
+         << '\n';
+      error_print_line(position, ss);
       std::set<std::string> expect_names;
       for (int expect_token = 0; expect_token < grammar->nterminals;
            ++expect_token) {
@@ -99,9 +101,10 @@ void Reader::at_token(std::istream& stream) {
             this->at_reduce(parser_action.production, reduction_rhs);
       } catch (const ParserFail& e) {
         std::stringstream ss;
-        ss << "error: Parser failure at line " << line;
-        ss << " column " << column << " of " << stream_name << '\n';
-        error_print_line(stream, ss);
+        ss << "error: Parser failure at line " << get_line(position);
+        ss << " column " << get_column(position) << " of " << stream_name
+           << '\n';
+        error_print_line(position, ss);
         ss << '\n' << e.what();
         throw ParserFail(ss.str());
       }
@@ -125,16 +128,17 @@ void Reader::indent_mismatch() {
   OMEGA_H_CHECK(!indent_stack.empty());
   auto top = indent_stack.back();
   std::stringstream ss;
-  ss << "error: Indentation characters beginning line " << line << " of "
-     << stream_name << " don't match those beginning line " << top.line << '\n';
+  ss << "error: Indentation characters beginning line " << get_line(position)
+     << " of " << stream_name << " don't match those beginning line "
+     << top.line << '\n';
   ss << "It is strongly recommended not to mix tabs and spaces in "
         "indentation-sensitive formats\n";
   throw ParserFail(ss.str());
 }
 
-void Reader::at_token_indent(std::istream& stream) {
+void Reader::at_token_indent() {
   if (!sensing_indent || lexer_token != tables->indent_info.newline_token) {
-    at_token(stream);
+    at_token();
     return;
   }
   auto last_newline_pos = lexer_text.find_last_of("\n");
@@ -144,17 +148,18 @@ void Reader::at_token_indent(std::istream& stream) {
   auto lexer_indent =
       lexer_text.substr(last_newline_pos + 1, std::string::npos);
   // the at_token call is allowed to do anything to lexer_text
-  at_token(stream);
+  at_token();
   lexer_text.clear();
   std::size_t minlen = std::min(lexer_indent.length(), indent_text.length());
   if (lexer_indent.length() > indent_text.length()) {
     if (0 != lexer_indent.compare(0, indent_text.length(), indent_text)) {
       indent_mismatch();
     }
-    indent_stack.push_back({line, indent_text.length(), lexer_indent.length()});
+    indent_stack.push_back(
+        {get_line(position), indent_text.length(), lexer_indent.length()});
     indent_text = lexer_indent;
     lexer_token = tables->indent_info.indent_token;
-    at_token(stream);
+    at_token();
   } else if (lexer_indent.length() < indent_text.length()) {
     if (0 != indent_text.compare(0, lexer_indent.length(), lexer_indent)) {
       indent_mismatch();
@@ -164,7 +169,7 @@ void Reader::at_token_indent(std::istream& stream) {
       if (top.end_length <= minlen) break;
       indent_stack.pop_back();
       lexer_token = tables->indent_info.dedent_token;
-      at_token(stream);
+      at_token();
     }
     indent_text = lexer_indent;
   } else {
@@ -174,44 +179,45 @@ void Reader::at_token_indent(std::istream& stream) {
   }
 }
 
-void Reader::backtrack_to_last_accept(std::istream& stream) {
-  /* all the last_accept and backtracking is driven by
-    the "accept the longest match" rule */
-  line = last_lexer_accept_line;
-  column = last_lexer_accept_column;
-  line_text = last_lexer_accept_line_text;
-  while (lexer_text.size() > last_lexer_accept) {
-    bool ok = !stream.unget().fail();
-    OMEGA_H_CHECK(ok);
-    lexer_text.pop_back();
-  }
-}
-
 void Reader::reset_lexer_state() {
   lexer_state = 0;
   lexer_text.clear();
   lexer_token = -1;
+  last_lexer_accept = token_start;
 }
 
-void Reader::at_lexer_end(std::istream& stream) {
+/* (end) is the end of the text the lexer has seen, which for a
+   failed step includes the character it failed on. errors are
+   reported at (position) */
+void Reader::at_lexer_end(std::size_t end) {
   if (lexer_token == -1) {
     std::stringstream ss;
-    if (lexer_text.find('\n') == std::string::npos) {
-      ss << "error: Could not tokenize this (line " << line;
-      ss << " column " << column << " of " << stream_name << "):\n";
+    auto text_begin = input + token_start;
+    auto text_end = input + end;
+    auto where = position;
+    if (std::find(text_begin, text_end, '\n') == text_end) {
+      ss << "error: Could not tokenize this (line " << get_line(where);
+      ss << " column " << get_column(where) << " of " << stream_name
+         << "):\n";
+      auto line_start = get_line_start(where);
+      std::string line_text(input + line_start, text_end);
       ss << line_text << '\n';
-      OMEGA_H_CHECK(line_text.size() >= lexer_text.size());
-      print_underline(ss, line_text, line_text.size() - lexer_text.size(),
-          line_text.size());
+      print_underline(
+          ss, line_text, token_start - line_start, line_text.size());
     } else {
-      ss << "error: Could not tokenize this (ends at line " << line;
-      ss << " column " << column << " of " << stream_name << "):\n";
-      ss << lexer_text << '\n';
+      ss << "error: Could not tokenize this (ends at line " << get_line(where);
+      ss << " column " << get_column(where) << " of " << stream_name
+         << "):\n";
+      ss << std::string(text_begin, text_end) << '\n';
     }
     throw ParserFail(ss.str());
   }
-  backtrack_to_last_accept(stream);
-  at_token_indent(stream);
+  /* all the last_accept and backtracking is driven by
+    the "accept the longest match" rule */
+  lexer_text.assign(input + token_start, last_lexer_accept - token_start);
+  position = last_lexer_accept;
+  at_token_indent();
+  token_start = position;
   reset_lexer_state();
 }
 
@@ -223,42 +229,57 @@ Reader::Reader(ReaderTablesPtr tables_in)
   OMEGA_H_CHECK(get_determinism(lexer));
 }
 
-void Reader::update_position(char c) {
-  if (c == '\n') {
-    ++line;
-    column = 1;
-    line_text.clear();
-  } else {
-    ++column;
+/* newlines are counted from the last query, so the increasing
+   queries made while parsing take linear time overall */
+std::size_t Reader::get_line(std::size_t pos) {
+  if (pos < counted_position) {
+    counted_position = 0;
+    counted_lines = 1;
   }
+  counted_lines += std::size_t(
+      std::count(input + counted_position, input + pos, '\n'));
+  counted_position = pos;
+  return counted_lines;
+}
+
+std::size_t Reader::get_line_start(std::size_t pos) const {
+  while (pos > 0 && input[pos - 1] != '\n') --pos;
+  return pos;
+}
+
+std::size_t Reader::get_column(std::size_t pos) const {
+  return pos - get_line_start(pos) + 1;
 }
 
-void Reader::error_print_line(std::istream& is, std::ostream& os) {
-  auto oldpos = line_text.size();
-  char c;
-  while (is.get(c)) {
-    if (c == '\n' || c == '\r') break;
-    line_text.push_back(c);
+void Reader::error_print_line(std::size_t pos, std::ostream& os) {
+  auto line_start = get_line_start(pos);
+  auto line_end = pos;
+  while (line_end < input_size && input[line_end] != '\n' &&
+         input[line_end] != '\r') {
+    ++line_end;
   }
-  if (line_text.empty()) return;
+  if (line_end == line_start) return;
+  std::string line_text(input + line_start, input + line_end);
   os << line_text << '\n';
+  auto oldpos = pos - line_start;
   if (oldpos > 0) print_indicator(os, line_text, oldpos - 1);
 }
 
-any Reader::read_stream(
-    std::istream& stream, std::string const& stream_name_in) {
-  line = 1;
-  column = 1;
-  lexer_state = 0;
-  lexer_text.clear();
-  line_text.clear();
-  lexer_token = -1;
+any Reader::read_chars(
+    char const* data, std::size_t size, std::string const& name) {
+  input = data;
+  input_size = size;
+  position = 0;
+  token_start = 0;
+  counted_position = 0;
+  counted_lines = 1;
+  reset_lexer_state();
   parser_state = 0;
   parser_stack.clear();
   parser_stack.push_back(parser_state);
   value_stack.clear();
   did_accept = false;
-  stream_name = stream_name_in;
+  stream_name = name;
   if (tables->indent_info.is_sensitive) {
     sensing_indent = true;
     indent_text.clear();
@@ -266,45 +287,44 @@ any Reader::read_stream(
   } else {
     sensing_indent = false;
   }
-  char c;
-  while (stream.get(c)) {
+  std::size_t pos = 0;
+  while (pos < input_size) {
+    auto c = input[pos];
     if (!is_symbol(c)) {
       std::stringstream ss;
       ss << "error: Unexpected character code " << int(c);
-      ss << " at line " << line << " column " << column;
+      ss << " at line " << get_line(pos) << " column " << get_column(pos);
       ss << " of " << stream_name << '\n';
-      error_print_line(stream, ss);
+      error_print_line(pos + 1, ss);
       throw ParserFail(ss.str());
     }
-    line_text.push_back(c);
-    lexer_text.push_back(c);
     auto lexer_symbol = get_symbol(c);
     lexer_state = step(lexer, lexer_state, lexer_symbol);
     if (lexer_state == -1) {
-      at_lexer_end(stream);
+      /* scanning resumes after the longest match */
+      position = pos;
+      at_lexer_end(pos + 1);
+      pos = token_start;
     } else {
+      ++pos;
       auto token = accepts(lexer, lexer_state);
-      update_position(c);
       if (token != -1) {
         lexer_token = token;
-        last_lexer_accept = lexer_text.size();
-        last_lexer_accept_line = line;
-        last_lexer_accept_column = column;
-        last_lexer_accept_line_text = line_text;
+        last_lexer_accept = pos;
       }
     }
   }
-  if (last_lexer_accept < lexer_text.size()) {
+  if (lexer_token != -1 && last_lexer_accept < pos) {
     std::stringstream ss;
-    std::string bad_str =
-        lexer_text.substr(last_lexer_accept, std::string::npos);
+    std::string bad_str(input + last_lexer_accept, input + pos);
     ss << "error: Could not tokenize \"" << bad_str;
     ss << "\" at end of " << stream_name << '\n';
     throw ParserFail(ss.str());
   }
-  at_lexer_end(stream);
+  position = pos;
+  at_lexer_end(pos);
   lexer_token = get_end_terminal(*grammar);
-  at_token(stream);
+  at_token();
   if (!did_accept) {
     Omega_h_fail(
         "The EOF terminal was accepted but the root nonterminal was not "
@@ -315,10 +335,16 @@ any Reader::read_stream(
   return std::move(value_stack.back());
 }
 
+any Reader::read_stream(
+    std::istream& stream, std::string const& stream_name_in) {
+  std::string contents{std::istreambuf_iterator<char>(stream),
+      std::istreambuf_iterator<char>()};
+  return read_chars(contents.data(), contents.size(), stream_name_in);
+}
+
 any Reader::read_string(
     std::string const& string, std::string const& string_name) {
-  std::istringstream stream(string);
-  return read_stream(stream, string_name);
+  return read_chars(string.data(), string.size(), string_name);
 }
 
 any Reader::read_file(std::string const& file_name) {
@@ -30,16 +30,18 @@ class Reader {
   Parser const& parser;
   FiniteAutomaton const& lexer;
   GrammarPtr grammar;
-  std::size_t line;
-  std::size_t column;
+  /* the whole input is scanned from memory. positions are offsets
+     into it, lines and columns are only computed for messages */
+  char const* input;
+  std::size_t input_size;
+  std::size_t position;  // end of the text handed to the parser so far
+  std::size_t token_start;
   int lexer_state;
-  std::string lexer_text;
-  std::string line_text;
+  std::string lexer_text;  // reused, so tokens do not allocate
   int lexer_token;
-  std::size_t last_lexer_accept;
-  std::size_t last_lexer_accept_line;
-  std::size_t last_lexer_accept_column;
-  std::string last_lexer_accept_line_text;
+  std::size_t last_lexer_accept;  // end of the longest match so far
+  std::size_t counted_position;
+  std::size_t counted_lines;
   int parser_state;
   std::vector<int> parser_stack;
   std::vector<any> value_stack;
@@ -65,14 +67,17 @@ class Reader {
   std::vector<std::size_t> symbol_indentation_stack;
 
  private:  // helper methods
-  void at_token(std::istream& stream);
+  any read_chars(
+      char const* data, std::size_t size, std::string const& name);
+  void at_token();
   [[noreturn]] void indent_mismatch();
-  void at_token_indent(std::istream& stream);
-  void at_lexer_end(std::istream& stream);
-  void backtrack_to_last_accept(std::istream& stream);
+  void at_token_indent();
+  void at_lexer_end(std::size_t end);
   void reset_lexer_state();
-  void update_position(char c);
-  void error_print_line(std::istream& is, std::ostream& os);
+  std::size_t get_line(std::size_t pos);
+  std::size_t get_line_start(std::size_t pos) const;
+  std::size_t get_column(std::size_t pos) const;
+  void error_print_line(std::size_t pos, std::ostream& os);
 };
 
 class DebugReader : public Reader {
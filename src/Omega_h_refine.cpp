@@ -53,6 +53,7 @@ static void refine_element_based(Mesh* mesh, AdaptOpts const& opts) {
   auto keys2midverts = LOs();
   auto old_verts2new_verts = LOs();
   auto old_lows2new_lows = LOs();
+  ModifiedEnts modified;
   for (Int ent_dim = 0; ent_dim <= mesh->dim(); ++ent_dim) {
     auto keys2prods = LOs();
     auto prod_verts2verts = LOs();
@@ -68,7 +69,8 @@ static void refine_element_based(Mesh* mesh, AdaptOpts const& opts) {
     auto old_ents2new_ents = LOs();
     modify_ents_adapt(mesh, &new_mesh, ent_dim, EDGE, keys2edges, keys2prods,
         prod_verts2verts, old_lows2new_lows, &prods2new_ents,
-        &same_ents2old_ents, &same_ents2new_ents, &old_ents2new_ents);
+        &same_ents2old_ents, &same_ents2new_ents, &old_ents2new_ents,
+        &modified);
     if (ent_dim == VERT) {
       keys2midverts = prods2new_ents;
       old_verts2new_verts = old_ents2new_ents;
@@ -78,6 +80,7 @@ static void refine_element_based(Mesh* mesh, AdaptOpts const& opts) {
         same_ents2new_ents);
     old_lows2new_lows = old_ents2new_ents;
   }
+  modify_owners_and_globals(mesh, &new_mesh, modified);
   *mesh = new_mesh;
 }
 
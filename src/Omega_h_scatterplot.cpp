@@ -1,12 +1,21 @@
 #include <Omega_h_scatterplot.hpp>
 
+#include <Omega_h_array_ops.hpp>
+#include <Omega_h_dist.hpp>
+#include <Omega_h_file.hpp>
 #include <Omega_h_for.hpp>
 #include <Omega_h_linpart.hpp>
+#include <Omega_h_map.hpp>
 #include <Omega_h_mesh.hpp>
 #include <Omega_h_owners.hpp>
+#include <Omega_h_profile.hpp>
+#include <Omega_h_sort.hpp>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
-#include <iomanip>
+#include <sstream>
 
 namespace Omega_h {
 
@@ -38,30 +47,217 @@ Reals get_radial_scatter_coords(Reals coords, Vector<dim> center) {
   return coords_1d_w;
 }
 
+/* (ncomps) agreed on by all ranks, including ranks without points */
+static Int get_ncomps(CommPtr comm, Reals coords_1d, Reals data) {
+  Int ncomps = 0;
+  if (coords_1d.size()) {
+    ncomps = divide_no_remainder(data.size(), coords_1d.size());
+  }
+  return comm->allreduce(ncomps, OMEGA_H_MAX);
+}
+
+/* each rank writes its (block) at byte (offset) of one shared file,
+   replacing any previous contents of the file */
+static void write_at(std::string const& path, CommPtr comm,
+    std::string const& block, GO offset) {
+#ifdef OMEGA_H_USE_MPI
+  MPI_File file;
+  auto err = MPI_File_open(comm->get_impl(), path.c_str(),
+      MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL, &file);
+  if (err != MPI_SUCCESS) {
+    Omega_h_fail("could not open %s for writing\n", path.c_str());
+  }
+  OMEGA_H_CHECK(MPI_File_set_size(file, 0) == MPI_SUCCESS);
+  /* MPI counts are int, larger blocks go in several collective calls */
+  GO const max_chunk = GO(1) << 30;
+  GO size = GO(block.size());
+  auto nchunks =
+      comm->allreduce((size + max_chunk - 1) / max_chunk, OMEGA_H_MAX);
+  for (GO chunk = 0; chunk < nchunks; ++chunk) {
+    auto chunk_begin = std::min(chunk * max_chunk, size);
+    auto chunk_end = std::min(chunk_begin + max_chunk, size);
+    MPI_Status status;
+    OMEGA_H_CHECK(MPI_SUCCESS ==
+                  MPI_File_write_at_all(file, MPI_Offset(offset + chunk_begin),
+                      block.data() + chunk_begin, int(chunk_end - chunk_begin),
+                      MPI_BYTE, &status));
+  }
+  OMEGA_H_CHECK(MPI_File_close(&file) == MPI_SUCCESS);
+#else
+  /* several ranks can only be threads of this process: rank 0 replaces
+     the file and then each rank writes its block in place */
+  if (comm->rank() == 0) {
+    std::ofstream os(
+        path.c_str(), std::ios_base::trunc | std::ios_base::binary);
+    if (!os.is_open()) {
+      Omega_h_fail("could not open %s for writing\n", path.c_str());
+    }
+  }
+  comm->barrier();
+  {
+    std::fstream os(path.c_str(),
+        std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    if (!os.is_open()) {
+      Omega_h_fail("could not open %s for writing\n", path.c_str());
+    }
+    os.seekp(std::streamoff(offset));
+    os.write(block.data(), std::streamsize(block.size()));
+  }
+  comm->barrier();
+#endif
+}
+
 void write_scatterplot(std::string const& path, CommPtr comm, Reals coords_1d,
     Reals data, std::string const& separator) {
+  OMEGA_H_TIME_FUNCTION;
   HostRead<Real> coords_1d_h(coords_1d);
   HostRead<Real> data_h(data);
-  auto ncomps = divide_no_remainder(data.size(), coords_1d.size());
-  for (I32 rank = 0; rank < comm->size(); ++rank) {
-    std::ofstream os;
-    if (rank)
-      os.open(path.c_str(), std::ios_base::ate);
-    else
-      os.open(path.c_str(), std::ios_base::trunc);
-    os << std::scientific << std::setprecision(17);
-    if (comm->rank() == rank) {
-      for (LO i = 0; i < coords_1d_h.size(); ++i) {
-        os << coords_1d_h[i];
-        for (Int j = 0; j < ncomps; ++j) {
-          os << separator << data_h[i * ncomps + j];
-        }
-        os << '\n';
-      }
+  auto ncomps = get_ncomps(comm, coords_1d, data);
+  /* every rank formats its block at once, then the blocks land at
+     offsets given by one scan instead of rank by rank appends.
+     the numbers print as std::scientific with 17 digits did */
+  std::string block;
+  block.reserve(
+      std::size_t(coords_1d_h.size()) * std::size_t(ncomps + 1) * 26);
+  char buf[32];
+  auto append = [&](Real x) {
+    auto len = std::snprintf(buf, sizeof(buf), "%.17e", x);
+    block.append(buf, std::size_t(len));
+  };
+  for (LO i = 0; i < coords_1d_h.size(); ++i) {
+    append(coords_1d_h[i]);
+    for (Int j = 0; j < ncomps; ++j) {
+      block += separator;
+      append(data_h[i * ncomps + j]);
+    }
+    block += '\n';
+  }
+  auto offset = comm->exscan(GO(block.size()), OMEGA_H_SUM);
+  write_at(path, comm, block, offset);
+}
+
+/* keys which order like the values they come from */
+OMEGA_H_INLINE GO get_order_key(Real x) {
+  union {
+    Real r;
+    GO i;
+  } u;
+  u.r = x;
+  return (u.i < 0) ? (u.i ^ ArithTraits<GO>::max()) : u.i;
+}
+
+/* destination ranks such that each rank receives one range
+   of the keys, with splitters drawn from samples of all ranks.
+   (sorted_keys) are the local keys in ascending order */
+static Read<I32> get_key_ranges(CommPtr comm, GOs keys, GOs sorted_keys) {
+  auto nranks = comm->size();
+  constexpr Int nsamples = 32;
+  auto const missing = ArithTraits<GO>::min();
+  std::vector<GO> samples(std::size_t(nranks * nsamples), missing);
+  HostRead<GO> sorted_keys_h(sorted_keys);
+  auto n = sorted_keys_h.size();
+  if (n) {
+    for (Int j = 0; j < nsamples; ++j) {
+      samples[std::size_t(comm->rank() * nsamples + j)] =
+          sorted_keys_h[LO((GO(j) * n) / nsamples)];
     }
-    os.close();
-    comm->barrier();
   }
+  samples = comm->allreduce(samples, OMEGA_H_MAX);
+  std::vector<GO> valid;
+  for (auto sample : samples) {
+    if (sample != missing) valid.push_back(sample);
+  }
+  /* no rank has any keys, so there is nothing to send */
+  if (valid.empty()) return Read<I32>(keys.size(), 0);
+  std::sort(valid.begin(), valid.end());
+  std::vector<GO> splitters;
+  for (I32 rank = 1; rank < nranks; ++rank) {
+    splitters.push_back(valid[(valid.size() * std::size_t(rank)) /
+                              std::size_t(nranks)]);
+  }
+  HostRead<GO> keys_h(keys);
+  HostWrite<I32> ranks_h(keys_h.size());
+  for (LO i = 0; i < keys_h.size(); ++i) {
+    ranks_h[i] =
+        I32(std::upper_bound(splitters.begin(), splitters.end(), keys_h[i]) -
+            splitters.begin());
+  }
+  return ranks_h.write();
+}
+
+static std::string get_npy_header(GO nrows, Int ncols) {
+  std::stringstream dict;
+  dict << "{'descr': '" << (is_little_endian_cpu() ? '<' : '>')
+       << "f8', 'fortran_order': False, 'shape': (" << nrows << ", " << ncols
+       << "), }";
+  auto header = dict.str();
+  /* magic, version 1.0, a 2-byte length, then the dictionary
+     padded with spaces and a newline to a multiple of 64 bytes */
+  std::size_t const prefix = 10;
+  auto padded = ((prefix + header.size() + 1 + 63) / 64) * 64;
+  header.append(padded - prefix - header.size() - 1, ' ');
+  header += '\n';
+  auto len = header.size();
+  std::string out("\x93NUMPY\x01\x00", 8);
+  out += char(len & 0xFF);
+  out += char((len >> 8) & 0xFF);
+  return out + header;
+}
+
+void write_sorted_scatterplot_npy(
+    std::string const& path, CommPtr comm, Reals coords_1d, Reals data) {
+  OMEGA_H_TIME_FUNCTION;
+  auto ncomps = get_ncomps(comm, coords_1d, data);
+  auto ncols = ncomps + 1;
+  auto n = coords_1d.size();
+  auto begin = comm->exscan(GO(n), OMEGA_H_SUM);
+  Write<Real> rows_w(n * ncols);
+  Write<GO> keys_w(n * 2);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    rows_w[i * ncols] = coords_1d[i];
+    for (Int j = 0; j < ncomps; ++j) {
+      rows_w[i * ncols + 1 + j] = data[i * ncomps + j];
+    }
+    /* ties are broken by the original order, so the file
+       does not depend on the number of ranks */
+    keys_w[i * 2 + 0] = get_order_key(coords_1d[i]);
+    keys_w[i * 2 + 1] = begin + i;
+  };
+  parallel_for(n, f, "scatterplot_rows");
+  Reals rows = rows_w;
+  GOs keys = keys_w;
+  if (comm->size() > 1) {
+    auto perm = sort_by_keys(keys, 2);
+    auto sorted_keys = unmap(perm, get_component(keys, 2, 0), 1);
+    auto ranks = get_key_ranges(comm, get_component(keys, 2, 0), sorted_keys);
+    Dist dist;
+    dist.set_parent_comm(comm);
+    dist.set_dest_ranks(ranks);
+    rows = dist.exch(rows, ncols);
+    keys = dist.exch(keys, 2);
+  }
+  auto perm = sort_by_keys(keys, 2);
+  rows = unmap(perm, rows, ncols);
+  auto nrows = divide_no_remainder(rows.size(), ncols);
+  auto total = comm->allreduce(GO(nrows), OMEGA_H_SUM);
+  auto header = get_npy_header(total, ncols);
+  HostRead<Real> rows_h(rows);
+  std::string block;
+  if (comm->rank() == 0) block = header;
+  auto nbytes = std::size_t(rows_h.size()) * sizeof(Real);
+  auto header_bytes = block.size();
+  block.resize(header_bytes + nbytes);
+  if (nbytes) std::memcpy(&block[header_bytes], rows_h.data(), nbytes);
+  auto offset = GO(header.size()) +
+                comm->exscan(GO(nrows), OMEGA_H_SUM) * GO(ncols) *
+                    GO(sizeof(Real));
+  if (comm->rank() == 0) offset = 0;
+  write_at(path, comm, block, offset);
+}
+
+static bool ends_with(std::string const& s, std::string const& suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
 }
 
 void write_scatterplot(std::string const& path, Mesh* mesh, Int ent_dim,
@@ -70,10 +266,16 @@ void write_scatterplot(std::string const& path, Mesh* mesh, Int ent_dim,
   auto ncomps = divide_no_remainder(data.size(), coords_1d.size());
   if (comm->size() > 1) {
     auto copies2lins = copies_to_linear_owners(comm, mesh->globals(ent_dim));
-    coords_1d = reduce_data_to_owners(coords_1d, copies2lins, 1);
-    data = reduce_data_to_owners(data, copies2lins, ncomps);
+    auto lin_data = reduce_data_to_owners(
+        {{coords_1d, 1}, {data, ncomps}}, copies2lins);
+    coords_1d = lin_data[0].get<Real>();
+    data = lin_data[1].get<Real>();
+  }
+  if (ends_with(path, ".npy")) {
+    write_sorted_scatterplot_npy(path, comm, coords_1d, data);
+  } else {
+    write_scatterplot(path, comm, coords_1d, data, separator);
   }
-  write_scatterplot(path, comm, coords_1d, data, separator);
 }
 
 template <Int dim>
@@ -18,6 +18,12 @@ template <Int dim>
 Reals get_radial_scatter_coords(Reals coords, Vector<dim> center);
 void write_scatterplot(std::string const& path, CommPtr comm, Reals coords_1d,
     Reals data, std::string const& separator);
+/* writes a NumPy .npy file holding a float64 array with one row
+   (coordinate, data...) per point, rows sorted by coordinate */
+void write_sorted_scatterplot_npy(
+    std::string const& path, CommPtr comm, Reals coords_1d, Reals data);
+/* paths ending in ".npy" are written by write_sorted_scatterplot_npy,
+   the separator is then ignored */
 void write_scatterplot(std::string const& path, Mesh* mesh, Int ent_dim,
     Reals coords_1d, Reals data, std::string const& separator);
 template <Int dim>
@@ -7,7 +7,7 @@
 
 namespace Omega_h {
 
-OMEGA_H_DLL bool entering_parallel = false;
+OMEGA_H_DLL OMEGA_H_THREAD_LOCAL bool entering_parallel = false;
 Allocs* global_allocs = nullptr;
 
 void start_tracking_allocations() {
@@ -17,6 +17,7 @@ void start_tracking_allocations() {
   global_allocs->last = nullptr;
   global_allocs->total_bytes = 0;
   global_allocs->high_water_bytes = 0;
+  global_allocs->keeps_high_water_records = true;
 }
 
 void stop_tracking_allocations(Library* lib) {
@@ -55,8 +56,22 @@ Alloc::Alloc(std::size_t size_in, std::string&& name_in)
   init();
 }
 
+Alloc::Alloc(std::size_t size_in, std::string const& name_in,
+    void* adopted_ptr, std::function<void()> release_in)
+    : size(size_in),
+      name(name_in),
+      ptr(adopted_ptr),
+      use_count(1),
+      release(std::move(release_in)) {
+  track();
+}
+
 OMEGA_H_DLL Alloc::~Alloc() {
-  ::Omega_h::maybe_pooled_device_free(ptr, size);
+  if (release) {
+    release();
+  } else {
+    ::Omega_h::maybe_pooled_device_free(ptr, size);
+  }
   auto ga = global_allocs;
   if (ga) {
     if (next == nullptr) {
@@ -90,6 +105,11 @@ void Alloc::init() {
     auto s = ss.str();
     Omega_h_fail("%s\n", s.c_str());
   }
+  track();
+}
+
+void Alloc::track() {
+  auto ga = global_allocs;
   if (ga) {
     auto old_last = ga->last;
     this->prev = old_last;
@@ -98,12 +118,13 @@ void Alloc::init() {
       old_last->next = this;
     } else {
       ga->first = this;
-      ga->last = this;
     }
+    ga->last = this;
     ga->total_bytes += size;
     if (ga->total_bytes > ga->high_water_bytes) {
-      Omega_h::ScopedTimer high_water_timer("high water update");
       ga->high_water_bytes = ga->total_bytes;
+      if (!ga->keeps_high_water_records) return;
+      Omega_h::ScopedTimer high_water_timer("high water update");
       ga->high_water_records.clear();
       for (auto a = ga->first; a; a = a->next) {
         ga->high_water_records.push_back({a->name, a->size});
@@ -124,6 +145,14 @@ SharedAlloc::SharedAlloc(std::size_t size_in, std::string&& name_in) {
 
 SharedAlloc::SharedAlloc(std::size_t size_in) : SharedAlloc(size_in, "") {}
 
+SharedAlloc SharedAlloc::adopt(void* ptr_in, std::size_t size_in,
+    std::string const& name_in, std::function<void()> release_in) {
+  SharedAlloc out;
+  out.alloc = new Alloc(size_in, name_in, ptr_in, std::move(release_in));
+  out.direct_ptr = ptr_in;
+  return out;
+}
+
 SharedAlloc SharedAlloc::identity(std::size_t size_in) {
   SharedAlloc out;
   out.direct_ptr = nullptr;
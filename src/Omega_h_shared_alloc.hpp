@@ -3,6 +3,7 @@
 
 #include <Omega_h_macros.h>
 #include <cstddef>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -12,7 +13,7 @@ class Library;
 
 struct Allocs;
 
-OMEGA_H_DLL extern bool entering_parallel;
+OMEGA_H_DLL extern OMEGA_H_THREAD_LOCAL bool entering_parallel;
 extern Allocs* global_allocs;
 
 void start_tracking_allocations();
@@ -25,14 +26,19 @@ struct Alloc {
   int use_count;
   Alloc* prev;
   Alloc* next;
+  /* when set, ptr was adopted from outside and this releases it */
+  std::function<void()> release;
   Alloc(std::size_t size_in, std::string const& name_in);
   Alloc(std::size_t size_in, std::string&& name_in);
+  Alloc(std::size_t size_in, std::string const& name_in, void* adopted_ptr,
+      std::function<void()> release_in);
   OMEGA_H_DLL ~Alloc();
   Alloc(Alloc const&) = delete;
   Alloc(Alloc&&) = delete;
   Alloc& operator=(Alloc const&) = delete;
   Alloc& operator=(Alloc&&) = delete;
   void init();
+  void track();
 };
 
 struct HighWaterRecord {
@@ -45,6 +51,9 @@ struct Allocs {
   Alloc* last;
   std::size_t total_bytes;
   std::size_t high_water_bytes;
+  /* copying the records at each new high water mark costs time that
+     benchmarks would rather not measure */
+  bool keeps_high_water_records;
   std::vector<HighWaterRecord> high_water_records;
 };
 
@@ -147,6 +156,10 @@ struct SharedAlloc {
   }
   OMEGA_H_INLINE void* data() const noexcept { return direct_ptr; }
   static SharedAlloc identity(std::size_t size_in);
+  /* wraps memory owned by someone else (e.g. a NumPy array) without copying.
+     (release) is called once the last reference goes away. */
+  static SharedAlloc adopt(void* ptr_in, std::size_t size_in,
+      std::string const& name_in, std::function<void()> release_in);
 };
 
 }  // namespace Omega_h
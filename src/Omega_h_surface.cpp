@@ -4,12 +4,51 @@
 #include "Omega_h_for.hpp"
 #include "Omega_h_map.hpp"
 #include "Omega_h_mark.hpp"
+#include "Omega_h_mesh.hpp"
+#include "Omega_h_profile.hpp"
 #include "Omega_h_shape.hpp"
 
 namespace Omega_h {
 
 namespace {
 
+/* The boundary surface and its curves, extracted once: each subset
+   comes with its inverse map and its vertices' upward adjacency, so
+   the kernels below index into them instead of rebuilding maps. */
+struct SurfaceSubsets {
+  LOs surf_side2side;
+  LOs side2surf_side;
+  LOs surf_vert2vert;
+  LOs vert2surf_vert;
+  Adj surf_verts2sides;
+  LOs curv_edge2edge;
+  LOs edge2curv_edge;
+  LOs curv_vert2vert;
+  LOs vert2curv_vert;
+  Adj curv_verts2edges;
+};
+
+void extract_surf_subset(Mesh* mesh, LOs surf_side2side, LOs surf_vert2vert,
+    SurfaceSubsets* s) {
+  auto sdim = mesh->dim() - 1;
+  s->surf_side2side = surf_side2side;
+  s->side2surf_side = invert_injective_map(surf_side2side, mesh->nents(sdim));
+  s->surf_vert2vert = surf_vert2vert;
+  s->vert2surf_vert = invert_injective_map(surf_vert2vert, mesh->nverts());
+  s->surf_verts2sides =
+      unmap_adjacency(surf_vert2vert, mesh->ask_up(VERT, sdim));
+}
+
+void extract_curv_subset(Mesh* mesh, LOs curv_edge2edge, LOs curv_vert2vert,
+    SurfaceSubsets* s) {
+  s->curv_edge2edge = curv_edge2edge;
+  s->edge2curv_edge = invert_injective_map(curv_edge2edge, mesh->nedges());
+  s->curv_vert2vert = curv_vert2vert;
+  s->vert2curv_vert = invert_injective_map(curv_vert2vert, mesh->nverts());
+  s->curv_verts2edges =
+      unmap_adjacency(curv_vert2vert, mesh->ask_up(VERT, EDGE));
+}
+
 Reals get_triangle_normals(Mesh* mesh, LOs surf_tri2tri) {
   OMEGA_H_CHECK(mesh->dim() == 3);
   auto nsurf_tris = surf_tri2tri.size();
@@ -76,41 +115,57 @@ Reals get_hinge_angles_tmpl(Mesh* mesh, Reals surf_side_normals,
   return angles;
 }
 
-}  // end anonymous namespace
-
-Reals get_side_vectors(Mesh* mesh, LOs surf_side2side) {
-  if (mesh->dim() == 3) return get_triangle_normals(mesh, surf_side2side);
-  if (mesh->dim() == 2) return get_edge_normals(mesh, surf_side2side);
-  OMEGA_H_NORETURN(Reals());
-}
-
+/* tangents and lengths of curve edges come out of the same gather */
 template <Int dim>
-Reals get_curv_edge_tangents_dim(Mesh* mesh, LOs curv_edge2edge) {
+void get_curv_edge_tangents_dim(Mesh* mesh, LOs curv_edge2edge,
+    Reals* tangents_out, Reals* lengths_out) {
   OMEGA_H_CHECK(mesh->dim() == dim);
   auto ncurv_edges = curv_edge2edge.size();
   auto ev2v = mesh->ask_verts_of(EDGE);
   auto coords = mesh->coords();
   Write<Real> normals(ncurv_edges * dim);
+  Write<Real> lengths(ncurv_edges);
   auto lambda = OMEGA_H_LAMBDA(LO curv_edge) {
     auto e = curv_edge2edge[curv_edge];
     auto v = gather_verts<2>(ev2v, e);
     auto x = gather_vectors<2, dim>(coords, v);
     auto b = simplex_basis<dim, 1>(x);
-    auto n = normalize(b[0]);
-    set_vector(normals, curv_edge, n);
+    auto l = norm(b[0]);
+    set_vector(normals, curv_edge, b[0] / l);
+    lengths[curv_edge] = l;
   };
   parallel_for(ncurv_edges, lambda, "get_curv_edge_tangents");
-  return normals;
+  *tangents_out = normals;
+  if (lengths_out) *lengths_out = lengths;
 }
 
-Reals get_curv_edge_tangents(Mesh* mesh, LOs curv_edge2edge) {
-  if (mesh->dim() == 3)
-    return get_curv_edge_tangents_dim<3>(mesh, curv_edge2edge);
-  if (mesh->dim() == 2)
-    return get_curv_edge_tangents_dim<2>(mesh, curv_edge2edge);
+void get_curv_edge_tangents(Mesh* mesh, LOs curv_edge2edge,
+    Reals* tangents_out, Reals* lengths_out) {
+  if (mesh->dim() == 3) {
+    get_curv_edge_tangents_dim<3>(
+        mesh, curv_edge2edge, tangents_out, lengths_out);
+  } else if (mesh->dim() == 2) {
+    get_curv_edge_tangents_dim<2>(
+        mesh, curv_edge2edge, tangents_out, lengths_out);
+  } else {
+    OMEGA_H_NORETURN();
+  }
+}
+
+}  // end anonymous namespace
+
+Reals get_side_vectors(Mesh* mesh, LOs surf_side2side) {
+  if (mesh->dim() == 3) return get_triangle_normals(mesh, surf_side2side);
+  if (mesh->dim() == 2) return get_edge_normals(mesh, surf_side2side);
   OMEGA_H_NORETURN(Reals());
 }
 
+Reals get_curv_edge_tangents(Mesh* mesh, LOs curv_edge2edge) {
+  Reals tangents;
+  get_curv_edge_tangents(mesh, curv_edge2edge, &tangents, nullptr);
+  return tangents;
+}
+
 Reals get_hinge_angles(Mesh* mesh, Reals surf_side_normals,
     LOs surf_hinge2hinge, LOs side2surf_side) {
   switch (mesh->dim()) {
@@ -124,27 +179,33 @@ Reals get_hinge_angles(Mesh* mesh, Reals surf_side_normals,
   OMEGA_H_NORETURN(Reals());
 }
 
+namespace {
+
 /*
  * Max, Nelson.
  * "Weights for computing vertex normals from facet normals."
  * Journal of Graphics Tools 4.2 (1999): 1-6.
+ *
+ * The weights and the weighted average are computed in one sweep
+ * over each surface vertex's adjacent triangles.
  */
 
-Reals tri_vert_normal_weights(
-    Mesh* mesh, Adj surf_verts2tris, LOs tri2surf_tri) {
+Reals get_tri_vert_normals(
+    Mesh* mesh, SurfaceSubsets const& s, Reals surf_tri_normals) {
+  auto surf_verts2tris = s.surf_verts2sides;
+  auto tri2surf_tri = s.side2surf_side;
   auto nsurf_verts = surf_verts2tris.nnodes();
   auto fv2v = mesh->ask_verts_of(FACE);
   auto coords = mesh->coords();
-  auto nweights = surf_verts2tris.nedges();
-  auto weights = Write<Real>(nweights);
+  auto normals = Write<Real>(nsurf_verts * 3);
   auto func = OMEGA_H_LAMBDA(LO surf_vert) {
+    Real ws = 0.0;
+    auto n = zero_vector<3>();
     for (auto vf = surf_verts2tris.a2ab[surf_vert];
          vf < surf_verts2tris.a2ab[surf_vert + 1]; ++vf) {
       auto f = surf_verts2tris.ab2b[vf];
-      if (tri2surf_tri[f] < 0) {
-        weights[vf] = 0.0;
-        continue;
-      }
+      auto surf_tri = tri2surf_tri[f];
+      if (surf_tri < 0) continue;
       auto code = surf_verts2tris.codes[vf];
       auto ffv = code_which_down(code);
       auto rot = rotation_to_first(3, ffv);
@@ -155,11 +216,13 @@ Reals tri_vert_normal_weights(
       auto b = simplex_basis<3, 2>(ffv2p);
       auto w =
           norm(cross(b[0], b[1])) / (norm_squared(b[0]) * norm_squared(b[1]));
-      weights[vf] = w;
+      n = n + get_vector<3>(surf_tri_normals, surf_tri) * w;
+      ws += w;
     }
+    set_vector(normals, surf_vert, n / ws);
   };
-  parallel_for(nsurf_verts, func, "tri_vert_normal_weights");
-  return weights;
+  parallel_for(nsurf_verts, func, "get_tri_vert_normals");
+  return normals;
 }
 
 /* following the same derivation as Max did above,
@@ -167,49 +230,44 @@ Reals tri_vert_normal_weights(
  * one over the length of the edge.
  */
 
-Reals get_recip_length_weights(
-    Mesh* mesh, Adj surf_verts2edges, LOs edge2surf_edge) {
-  auto edge2len = measure_edges_real(mesh);
-  auto nedges = mesh->nedges();
-  auto edge2weight_w = Write<Real>(nedges);
-  auto f = OMEGA_H_LAMBDA(LO edge) {
-    if (edge2surf_edge[edge] == -1)
-      edge2weight_w[edge] = 0.0;
-    else
-      edge2weight_w[edge] = 1.0 / edge2len[edge];
+Reals get_edge_vert_normals(Mesh* mesh, SurfaceSubsets const& s,
+    Reals surf_edge_normals, Reals surf_edge_lengths) {
+  OMEGA_H_CHECK(mesh->dim() == 2);
+  auto surf_verts2edges = s.surf_verts2sides;
+  auto edge2surf_edge = s.side2surf_side;
+  auto nsurf_verts = surf_verts2edges.nnodes();
+  auto normals = Write<Real>(nsurf_verts * 2);
+  auto func = OMEGA_H_LAMBDA(LO surf_vert) {
+    Real ws = 0.0;
+    auto n = zero_vector<2>();
+    for (auto ve = surf_verts2edges.a2ab[surf_vert];
+         ve < surf_verts2edges.a2ab[surf_vert + 1]; ++ve) {
+      auto e = surf_verts2edges.ab2b[ve];
+      auto surf_edge = edge2surf_edge[e];
+      if (surf_edge < 0) continue;
+      auto w = 1.0 / surf_edge_lengths[surf_edge];
+      n = n + get_vector<2>(surf_edge_normals, surf_edge) * w;
+      ws += w;
+    }
+    set_vector(normals, surf_vert, n / ws);
   };
-  parallel_for(nedges, f, "get_recip_length_weights");
-  auto edge2weight = Reals(edge2weight_w);
-  return unmap(surf_verts2edges.ab2b, edge2weight, 1);
-}
-
-static Reals side_vert_normal_weights(
-    Mesh* mesh, Adj surf_verts2sides, LOs side2surf_side) {
-  if (mesh->dim() == 3) {
-    return tri_vert_normal_weights(mesh, surf_verts2sides, side2surf_side);
-  }
-  if (mesh->dim() == 2) {
-    return get_recip_length_weights(mesh, surf_verts2sides, side2surf_side);
-  }
-  OMEGA_H_NORETURN(Reals());
+  parallel_for(nsurf_verts, func, "get_edge_vert_normals");
+  return normals;
 }
 
-Reals get_side_vert_normals(Mesh* mesh, LOs surf_side2side,
-    Reals surf_side_normals, LOs surf_vert2vert) {
+Reals get_side_vert_normals(Mesh* mesh, SurfaceSubsets const& s,
+    Reals surf_side_normals, Reals surf_side_lengths) {
   OMEGA_H_CHECK(mesh->owners_have_all_upward(VERT));
   auto dim = mesh->dim();
-  auto verts2sides = mesh->ask_up(VERT, dim - 1);
-  auto surf_verts2sides = unmap_adjacency(surf_vert2vert, verts2sides);
-  auto nsides = mesh->nents(dim - 1);
-  auto side2surf_side = invert_injective_map(surf_side2side, nsides);
-  auto weights =
-      side_vert_normal_weights(mesh, surf_verts2sides, side2surf_side);
-  auto side_normals =
-      map_onto(surf_side_normals, surf_side2side, nsides, 0.0, dim);
-  auto surf_vert_normals =
-      graph_weighted_average(surf_verts2sides, weights, side_normals, dim);
+  Reals surf_vert_normals;
+  if (dim == 3) {
+    surf_vert_normals = get_tri_vert_normals(mesh, s, surf_side_normals);
+  } else {
+    surf_vert_normals =
+        get_edge_vert_normals(mesh, s, surf_side_normals, surf_side_lengths);
+  }
   surf_vert_normals = mesh->sync_subset_array(
-      VERT, surf_vert_normals, surf_vert2vert, 0.0, dim);
+      VERT, surf_vert_normals, s.surf_vert2vert, 0.0, dim);
   return normalize_vectors(surf_vert_normals, dim);
 }
 
@@ -218,89 +276,77 @@ Reals get_side_vert_normals(Mesh* mesh, LOs surf_side2side,
  * (this will be very common when we derive edges from only
  *  element connectivity).
  * In order to handle this case, we locally negate vectors as
- * necessary to get a correct tangent vector at each vertex
+ * necessary to get a correct tangent vector at each vertex.
+ * The flip of an arc is whether its vertex is not the
+ * lc-th local vertex of the edge, lc counting only curve edges.
  */
-Read<I8> get_curv_vert_edge_flips(
-    Adj curv_verts2edges, LOs edge2curv_edge) {
-  auto out = Write<I8>(curv_verts2edges.nedges());
+Read<I8> get_curv_edge_vert_flips(Mesh* mesh, SurfaceSubsets const& s) {
+  auto curv_verts2edges = s.curv_verts2edges;
+  auto edge2curv_edge = s.edge2curv_edge;
+  auto out = Write<I8>(mesh->nedges() * 2, I8(0));
   auto ncurv_verts = curv_verts2edges.nnodes();
   auto f = OMEGA_H_LAMBDA(LO curv_vert) {
     Int lc = 0;
     for (auto ve = curv_verts2edges.a2ab[curv_vert];
          ve < curv_verts2edges.a2ab[curv_vert + 1]; ++ve) {
       auto e = curv_verts2edges.ab2b[ve];
-      auto ce = edge2curv_edge[e];
-      if (-1 == ce) continue;
+      if (-1 == edge2curv_edge[e]) continue;
       auto code = curv_verts2edges.codes[ve];
       auto eev = code_which_down(code);
-      out[ve] = I8(eev != lc);
+      out[e * 2 + eev] = I8(eev != lc);
       ++lc;
     }
   };
-  parallel_for(ncurv_verts, f, "get_curv_vert_edge_flips");
+  parallel_for(ncurv_verts, f, "get_curv_edge_vert_flips");
   return out;
 }
 
-Read<I8> get_curv_edge_vert_flips(
-    Mesh* mesh, Adj curv_verts2edges, LOs edge2curv_edge) {
-  auto in = get_curv_vert_edge_flips(curv_verts2edges, edge2curv_edge);
-  auto out = Write<I8>(mesh->nedges() * 2, I8(0));
+/* flips, reciprocal length weights and the weighted average of
+ * edge tangents all happen in one sweep per curve vertex */
+template <Int dim>
+Reals get_curv_vert_tangents_dim(Mesh* mesh, SurfaceSubsets const& s,
+    Reals curv_edge_tangents, Reals curv_edge_lengths) {
+  OMEGA_H_CHECK(mesh->dim() == dim);
+  OMEGA_H_CHECK(mesh->owners_have_all_upward(VERT));
+  auto curv_verts2edges = s.curv_verts2edges;
+  auto edge2curv_edge = s.edge2curv_edge;
   auto ncurv_verts = curv_verts2edges.nnodes();
+  auto tangents = Write<Real>(ncurv_verts * dim);
   auto f = OMEGA_H_LAMBDA(LO curv_vert) {
+    Int lc = 0;
+    Real ws = 0.0;
+    auto t = zero_vector<dim>();
     for (auto ve = curv_verts2edges.a2ab[curv_vert];
          ve < curv_verts2edges.a2ab[curv_vert + 1]; ++ve) {
       auto e = curv_verts2edges.ab2b[ve];
+      auto ce = edge2curv_edge[e];
+      if (-1 == ce) continue;
       auto code = curv_verts2edges.codes[ve];
       auto eev = code_which_down(code);
-      out[e * 2 + eev] = in[ve];
-    }
-  };
-  parallel_for(ncurv_verts, f, "get_curv_edge_vert_flips");
-  return out;
-}
-
-template <Int dim>
-Reals get_curv_vert_tangents_dim(Mesh* mesh, LOs curv_edge2edge,
-    Reals curv_edge_tangents, LOs curv_vert2vert) {
-  OMEGA_H_CHECK(mesh->dim() == dim);
-  OMEGA_H_CHECK(mesh->owners_have_all_upward(VERT));
-  auto verts2edges = mesh->ask_up(VERT, EDGE);
-  auto curv_verts2edges = unmap_adjacency(curv_vert2vert, verts2edges);
-  auto narcs = curv_verts2edges.nedges();
-  auto edge2curv_edge = invert_injective_map(curv_edge2edge, mesh->nedges());
-  auto arcs2tangents_w = Write<Real>(narcs * dim);
-  auto arcs2flip = get_curv_vert_edge_flips(curv_verts2edges, edge2curv_edge);
-  auto f = OMEGA_H_LAMBDA(LO arc) {
-    auto e = curv_verts2edges.ab2b[arc];
-    auto ce = edge2curv_edge[e];
-    if (-1 == ce)
-      set_vector(arcs2tangents_w, arc, zero_vector<dim>());
-    else {
       auto tangent = get_vector<dim>(curv_edge_tangents, ce);
-      if (arcs2flip[arc]) tangent = -tangent;
-      set_vector(arcs2tangents_w, arc, tangent);
+      if (eev != lc) tangent = -tangent;
+      ++lc;
+      auto w = 1.0 / curv_edge_lengths[ce];
+      t = t + tangent * w;
+      ws += w;
     }
+    set_vector(tangents, curv_vert, t / ws);
   };
-  parallel_for(narcs, f, "get_curv_vert_tangents");
-  auto arcs2tangents = Reals(arcs2tangents_w);
-  auto weights =
-      get_recip_length_weights(mesh, curv_verts2edges, edge2curv_edge);
-  auto curv_vert_tangents = graph_weighted_average_arc_data(
-      curv_verts2edges, weights, arcs2tangents, dim);
-  curv_vert_tangents = mesh->sync_subset_array(
-      VERT, curv_vert_tangents, curv_vert2vert, 0.0, dim);
+  parallel_for(ncurv_verts, f, "get_curv_vert_tangents");
+  auto curv_vert_tangents = mesh->sync_subset_array(
+      VERT, Reals(tangents), s.curv_vert2vert, 0.0, dim);
   return normalize_vectors(curv_vert_tangents, dim);
 }
 
-Reals get_curv_vert_tangents(Mesh* mesh, LOs curv_edge2edge,
-    Reals curv_edge_tangents, LOs curv_vert2vert) {
+Reals get_curv_vert_tangents(Mesh* mesh, SurfaceSubsets const& s,
+    Reals curv_edge_tangents, Reals curv_edge_lengths) {
   if (mesh->dim() == 3) {
     return get_curv_vert_tangents_dim<3>(
-        mesh, curv_edge2edge, curv_edge_tangents, curv_vert2vert);
+        mesh, s, curv_edge_tangents, curv_edge_lengths);
   }
   if (mesh->dim() == 2) {
     return get_curv_vert_tangents_dim<2>(
-        mesh, curv_edge2edge, curv_edge_tangents, curv_vert2vert);
+        mesh, s, curv_edge_tangents, curv_edge_lengths);
   }
   OMEGA_H_NORETURN(Reals());
 }
@@ -311,9 +357,10 @@ Reals get_curv_vert_tangents(Mesh* mesh, LOs curv_edge2edge,
  * 3DPVT 2004. Proceedings. 2nd International Symposium on. IEEE, 2004.
  */
 
-Reals get_surf_tri_IIs(Mesh* mesh, LOs surf_tri2tri, Reals surf_tri_normals,
-    LOs surf_vert2vert, Reals surf_vert_normals) {
-  auto vert2surf_vert = invert_injective_map(surf_vert2vert, mesh->nverts());
+Reals get_surf_tri_IIs(Mesh* mesh, SurfaceSubsets const& s,
+    Reals surf_tri_normals, Reals surf_vert_normals) {
+  auto surf_tri2tri = s.surf_side2side;
+  auto vert2surf_vert = s.vert2surf_vert;
   auto tris2verts = mesh->ask_verts_of(FACE);
   auto coords = mesh->coords();
   auto nsurf_tris = surf_tri2tri.size();
@@ -404,37 +451,47 @@ OMEGA_H_INLINE Matrix<3, 3> rotate_to_plane(Vector<3> n, Matrix<3, 3> tnuv) {
   return r * tnuv;
 }
 
-Reals get_surf_vert_IIs(Mesh* mesh, LOs surf_tri2tri, Reals surf_tri_normals,
-    Reals surf_tri_IIs, LOs surf_vert2vert, Reals surf_vert_normals) {
+/* a triangle "touches the boundary" of the surface if one of its
+ * vertices is not a surface vertex (it lies on a curve or corner) */
+OMEGA_H_INLINE bool tri_touches_bdry(
+    LOs tris2verts, LOs vert2surf_vert, LO tri) {
+  for (Int i = 0; i < 3; ++i) {
+    if (vert2surf_vert[tris2verts[tri * 3 + i]] < 0) return true;
+  }
+  return false;
+}
+
+Reals get_surf_vert_IIs(Mesh* mesh, SurfaceSubsets const& s,
+    Reals surf_tri_normals, Reals surf_tri_IIs, Reals surf_vert_normals) {
+  auto surf_vert2vert = s.surf_vert2vert;
+  auto vert2surf_vert = s.vert2surf_vert;
   auto nsurf_verts = surf_vert2vert.size();
-  auto verts2tris = mesh->ask_up(VERT, FACE);
-  auto tri2surf_tri = invert_injective_map(surf_tri2tri, mesh->nfaces());
+  auto surf_verts2tris = s.surf_verts2sides;
+  auto tri2surf_tri = s.side2surf_side;
   auto coords = mesh->coords();
   auto tris2verts = mesh->ask_verts_of(FACE);
-  auto verts_not_surf = map_onto(
-      Read<I8>(nsurf_verts, I8(0)), surf_vert2vert, mesh->nverts(), I8(1), 1);
-  auto tris_touch_bdry = mark_up(mesh, VERT, FACE, verts_not_surf);
   auto surf_vert_IIs_w = Write<Real>(nsurf_verts * 3);
   auto f = OMEGA_H_LAMBDA(LO surf_vert) {
-    auto vert = surf_vert2vert[surf_vert];
     auto n = get_vector<3>(surf_vert_normals, surf_vert);
     auto nuv = form_ortho_basis(n);
     Real ws = 0.0;
     Vector<3> comps = vector_3(0.0, 0.0, 0.0);
     Int nadj_int_tris = 0;
-    for (auto vt = verts2tris.a2ab[vert]; vt < verts2tris.a2ab[vert + 1];
-         ++vt) {
-      auto tri = verts2tris.ab2b[vt];
+    for (auto vt = surf_verts2tris.a2ab[surf_vert];
+         vt < surf_verts2tris.a2ab[surf_vert + 1]; ++vt) {
+      auto tri = surf_verts2tris.ab2b[vt];
       auto surf_tri = tri2surf_tri[tri];
       if (surf_tri < 0) continue;
-      if (!tris_touch_bdry[tri]) ++nadj_int_tris;
+      if (!tri_touches_bdry(tris2verts, vert2surf_vert, tri)) ++nadj_int_tris;
     }
-    for (auto vt = verts2tris.a2ab[vert]; vt < verts2tris.a2ab[vert + 1];
-         ++vt) {
-      auto tri = verts2tris.ab2b[vt];
+    for (auto vt = surf_verts2tris.a2ab[surf_vert];
+         vt < surf_verts2tris.a2ab[surf_vert + 1]; ++vt) {
+      auto tri = surf_verts2tris.ab2b[vt];
       auto surf_tri = tri2surf_tri[tri];
       if (surf_tri < 0) continue;
-      if (nadj_int_tris && tris_touch_bdry[tri]) continue;
+      if (nadj_int_tris && tri_touches_bdry(tris2verts, vert2surf_vert, tri)) {
+        continue;
+      }
       auto tn = get_vector<3>(surf_tri_normals, surf_tri);
       auto fnuv = form_ortho_basis(tn);
       fnuv = rotate_to_plane(n, fnuv);
@@ -449,7 +506,7 @@ Reals get_surf_vert_IIs(Mesh* mesh, LOs surf_tri2tri, Reals surf_tri_normals,
       tri_comps[0] = jac[0] * (tri_II * jac[0]);
       tri_comps[1] = jac[1] * (tri_II * jac[1]);
       tri_comps[2] = jac[0] * (tri_II * jac[1]);
-      auto code = verts2tris.codes[vt];
+      auto code = surf_verts2tris.codes[vt];
       auto ttv = code_which_down(code);
       auto ttv2v = gather_verts<3>(tris2verts, tri);
       auto p = gather_vectors<3, 3>(coords, ttv2v);
@@ -466,21 +523,19 @@ Reals get_surf_vert_IIs(Mesh* mesh, LOs surf_tri2tri, Reals surf_tri_normals,
 }
 
 template <Int dim>
-Reals get_curv_edge_curvatures_dim(Mesh* mesh, LOs curv_edge2edge,
-    Reals curv_edge_tangents, LOs curv_vert2vert, Reals curv_vert_tangents) {
-  auto vert2curv_vert = invert_injective_map(curv_vert2vert, mesh->nverts());
-  auto edge2curv_edge = invert_injective_map(curv_edge2edge, mesh->nedges());
+Reals get_curv_edge_curvatures_dim(Mesh* mesh, SurfaceSubsets const& s,
+    Reals curv_edge_tangents, Reals curv_edge_lengths,
+    Reals curv_vert_tangents) {
+  auto curv_edge2edge = s.curv_edge2edge;
+  auto vert2curv_vert = s.vert2curv_vert;
   auto edges2verts = mesh->ask_verts_of(EDGE);
   auto ncurv_edges = curv_edge2edge.size();
   auto curv_edges2curvature_w = Write<Real>(ncurv_edges);
-  auto verts2edges = mesh->ask_up(VERT, EDGE);
-  auto curv_verts2edges = unmap_adjacency(curv_vert2vert, verts2edges);
-  auto ev_flips =
-      get_curv_edge_vert_flips(mesh, curv_verts2edges, edge2curv_edge);
-  auto coords = mesh->coords();
+  auto ev_flips = get_curv_edge_vert_flips(mesh, s);
   auto f = OMEGA_H_LAMBDA(LO curv_edge) {
     auto edge = curv_edge2edge[curv_edge];
-    auto et = get_vector<dim>(curv_edge_tangents, curv_edge);
+    auto u = get_vector<dim>(curv_edge_tangents, curv_edge);
+    auto l = curv_edge_lengths[curv_edge];
     Few<Vector<dim>, 2> ts;
     auto eev2v = gather_verts<2>(edges2verts, edge);
     for (Int eev = 0; eev < 2; ++eev) {
@@ -491,14 +546,10 @@ Reals get_curv_edge_curvatures_dim(Mesh* mesh, LOs curv_edge2edge,
         vt = get_vector<dim>(curv_vert_tangents, curv_vert);
         if (ev_flips[edge * 2 + eev]) vt = -vt;
       } else {
-        vt = et;
+        vt = u;
       }
       ts[eev] = vt;
     }
-    auto p = gather_vectors<2, dim>(coords, eev2v);
-    auto e = p[1] - p[0];
-    auto l = norm(e);
-    auto u = e / l;
     auto dt = ts[1] - ts[0];
     auto curvature = norm(dt - (u * (dt * u))) / l;
     curv_edges2curvature_w[curv_edge] = curvature;
@@ -509,30 +560,38 @@ Reals get_curv_edge_curvatures_dim(Mesh* mesh, LOs curv_edge2edge,
       EDGE, curv_edges2curvature, curv_edge2edge, 0.0, 1);
 }
 
-Reals get_curv_edge_curvatures(Mesh* mesh, LOs curv_edge2edge,
-    Reals curv_edge_tangents, LOs curv_vert2vert, Reals curv_vert_tangents) {
+Reals get_curv_edge_curvatures(Mesh* mesh, SurfaceSubsets const& s,
+    Reals curv_edge_tangents, Reals curv_edge_lengths,
+    Reals curv_vert_tangents) {
   if (mesh->dim() == 3) {
-    return get_curv_edge_curvatures_dim<3>(mesh, curv_edge2edge,
-        curv_edge_tangents, curv_vert2vert, curv_vert_tangents);
+    return get_curv_edge_curvatures_dim<3>(
+        mesh, s, curv_edge_tangents, curv_edge_lengths, curv_vert_tangents);
   }
   if (mesh->dim() == 2) {
-    return get_curv_edge_curvatures_dim<2>(mesh, curv_edge2edge,
-        curv_edge_tangents, curv_vert2vert, curv_vert_tangents);
+    return get_curv_edge_curvatures_dim<2>(
+        mesh, s, curv_edge_tangents, curv_edge_lengths, curv_vert_tangents);
   }
   OMEGA_H_NORETURN(Reals());
 }
 
-template <Int dim>
-Reals get_curv_vert_curvatures_dim(Mesh* mesh, LOs curv_edge2edge,
-    Reals curv_edge_curvatures, LOs curv_vert2vert) {
+/* an edge "touches the boundary" of the curve
+ * if one of its vertices is not a curve vertex */
+OMEGA_H_INLINE bool edge_touches_bdry(
+    LOs edges2verts, LOs vert2curv_vert, LO edge) {
+  return vert2curv_vert[edges2verts[edge * 2 + 0]] < 0 ||
+         vert2curv_vert[edges2verts[edge * 2 + 1]] < 0;
+}
+
+/* note that curve edge lengths are only known for curve edges,
+ * and only those contribute to the weighted average */
+Reals get_curv_vert_curvatures(Mesh* mesh, SurfaceSubsets const& s,
+    Reals curv_edge_curvatures, Reals curv_edge_lengths) {
   auto verts2edges = mesh->ask_up(VERT, EDGE);
   auto edges2verts = mesh->ask_verts_of(EDGE);
-  auto edge2curv_edge = invert_injective_map(curv_edge2edge, mesh->nedges());
+  auto curv_vert2vert = s.curv_vert2vert;
+  auto vert2curv_vert = s.vert2curv_vert;
+  auto edge2curv_edge = s.edge2curv_edge;
   auto ncurv_verts = curv_vert2vert.size();
-  auto verts_not_curv = map_onto(
-      Read<I8>(ncurv_verts, I8(0)), curv_vert2vert, mesh->nverts(), I8(1), 1);
-  auto edges_touch_bdry = mark_up(mesh, VERT, EDGE, verts_not_curv);
-  auto coords = mesh->coords();
   auto curv_vert_curvatures_w = Write<Real>(ncurv_verts);
   auto f = OMEGA_H_LAMBDA(LO curv_vert) {
     auto vert = curv_vert2vert[curv_vert];
@@ -540,7 +599,7 @@ Reals get_curv_vert_curvatures_dim(Mesh* mesh, LOs curv_edge2edge,
     for (auto ve = verts2edges.a2ab[vert]; ve < verts2edges.a2ab[vert + 1];
          ++ve) {
       auto edge = verts2edges.ab2b[ve];
-      nadj_int_edges += !edges_touch_bdry[edge];
+      nadj_int_edges += !edge_touches_bdry(edges2verts, vert2curv_vert, edge);
     }
     Real ws = 0.0;
     Real curvature = 0.0;
@@ -549,10 +608,11 @@ Reals get_curv_vert_curvatures_dim(Mesh* mesh, LOs curv_edge2edge,
       auto edge = verts2edges.ab2b[ve];
       auto curv_edge = edge2curv_edge[edge];
       if (curv_edge < 0) continue;
-      if (nadj_int_edges && edges_touch_bdry[edge]) continue;
-      auto eev2v = gather_verts<2>(edges2verts, edge);
-      auto p = gather_vectors<2, dim>(coords, eev2v);
-      auto l = norm(p[1] - p[0]);
+      if (nadj_int_edges &&
+          edge_touches_bdry(edges2verts, vert2curv_vert, edge)) {
+        continue;
+      }
+      auto l = curv_edge_lengths[curv_edge];
       auto ec = curv_edge_curvatures[curv_edge];
       curvature += ec * l;
       ws += l;
@@ -566,56 +626,100 @@ Reals get_curv_vert_curvatures_dim(Mesh* mesh, LOs curv_edge2edge,
       VERT, curv_vert_curvatures, curv_vert2vert, 0.0, 1);
 }
 
-Reals get_curv_vert_curvatures(Mesh* mesh, LOs curv_edge2edge,
-    Reals curv_edge_curvatures, LOs curv_vert2vert) {
-  if (mesh->dim() == 3) {
-    return get_curv_vert_curvatures_dim<3>(
-        mesh, curv_edge2edge, curv_edge_curvatures, curv_vert2vert);
-  }
+}  // end anonymous namespace
+
+Reals get_side_vert_normals(Mesh* mesh, LOs surf_side2side,
+    Reals surf_side_normals, LOs surf_vert2vert) {
+  SurfaceSubsets s;
+  extract_surf_subset(mesh, surf_side2side, surf_vert2vert, &s);
+  Reals surf_side_lengths;
   if (mesh->dim() == 2) {
-    return get_curv_vert_curvatures_dim<2>(
-        mesh, curv_edge2edge, curv_edge_curvatures, curv_vert2vert);
+    surf_side_lengths = measure_edges_real(mesh, surf_side2side);
   }
-  OMEGA_H_NORETURN(Reals());
+  return get_side_vert_normals(mesh, s, surf_side_normals, surf_side_lengths);
+}
+
+Reals get_curv_vert_tangents(Mesh* mesh, LOs curv_edge2edge,
+    Reals curv_edge_tangents, LOs curv_vert2vert) {
+  SurfaceSubsets s;
+  extract_curv_subset(mesh, curv_edge2edge, curv_vert2vert, &s);
+  auto curv_edge_lengths = measure_edges_real(mesh, curv_edge2edge);
+  return get_curv_vert_tangents(
+      mesh, s, curv_edge_tangents, curv_edge_lengths);
+}
+
+Reals get_surf_tri_IIs(Mesh* mesh, LOs surf_tri2tri, Reals surf_tri_normals,
+    LOs surf_vert2vert, Reals surf_vert_normals) {
+  SurfaceSubsets s;
+  extract_surf_subset(mesh, surf_tri2tri, surf_vert2vert, &s);
+  return get_surf_tri_IIs(mesh, s, surf_tri_normals, surf_vert_normals);
 }
 
+Reals get_surf_vert_IIs(Mesh* mesh, LOs surf_tri2tri, Reals surf_tri_normals,
+    Reals surf_tri_IIs, LOs surf_vert2vert, Reals surf_vert_normals) {
+  SurfaceSubsets s;
+  extract_surf_subset(mesh, surf_tri2tri, surf_vert2vert, &s);
+  return get_surf_vert_IIs(
+      mesh, s, surf_tri_normals, surf_tri_IIs, surf_vert_normals);
+}
+
+Reals get_curv_edge_curvatures(Mesh* mesh, LOs curv_edge2edge,
+    Reals curv_edge_tangents, LOs curv_vert2vert, Reals curv_vert_tangents) {
+  SurfaceSubsets s;
+  extract_curv_subset(mesh, curv_edge2edge, curv_vert2vert, &s);
+  auto curv_edge_lengths = measure_edges_real(mesh, curv_edge2edge);
+  return get_curv_edge_curvatures(
+      mesh, s, curv_edge_tangents, curv_edge_lengths, curv_vert_tangents);
+}
+
+Reals get_curv_vert_curvatures(Mesh* mesh, LOs curv_edge2edge,
+    Reals curv_edge_curvatures, LOs curv_vert2vert) {
+  SurfaceSubsets s;
+  extract_curv_subset(mesh, curv_edge2edge, curv_vert2vert, &s);
+  auto curv_edge_lengths = measure_edges_real(mesh, curv_edge2edge);
+  return get_curv_vert_curvatures(
+      mesh, s, curv_edge_curvatures, curv_edge_lengths);
+}
+
+/* extracts the surface and curve subsets once and runs every
+ * kernel against them; the result is cached by Mesh::ask_surface_info */
 SurfaceInfo get_surface_info(Mesh* mesh) {
+  OMEGA_H_TIME_FUNCTION;
   SurfaceInfo out;
   if (mesh->dim() == 1) return out;
   auto sdim = mesh->dim() - 1;
-  auto sides_are_surf = mark_by_class_dim(mesh, sdim, sdim);
-  auto verts_are_surf = mark_by_class_dim(mesh, VERT, sdim);
-  auto surf_side2side = collect_marked(sides_are_surf);
-  auto surf_vert2vert = collect_marked(verts_are_surf);
-  LOs curv_edge2edge;
-  LOs curv_vert2vert;
+  SurfaceSubsets s;
+  auto surf_side2side = collect_marked(mark_by_class_dim(mesh, sdim, sdim));
+  auto surf_vert2vert = collect_marked(mark_by_class_dim(mesh, VERT, sdim));
   if (mesh->dim() == 3) {
+    extract_surf_subset(mesh, surf_side2side, surf_vert2vert, &s);
     auto surf_side_normals = get_side_vectors(mesh, surf_side2side);
-    auto surf_vert_normals = get_side_vert_normals(
-        mesh, surf_side2side, surf_side_normals, surf_vert2vert);
-    auto edges_are_curv = mark_by_class_dim(mesh, EDGE, EDGE);
-    auto verts_are_curv = mark_by_class_dim(mesh, VERT, EDGE);
-    curv_edge2edge = collect_marked(edges_are_curv);
-    curv_vert2vert = collect_marked(verts_are_curv);
-    auto surf_tri_IIs = get_surf_tri_IIs(mesh, surf_side2side,
-        surf_side_normals, surf_vert2vert, surf_vert_normals);
-    auto surf_vert_IIs = get_surf_vert_IIs(mesh, surf_side2side,
-        surf_side_normals, surf_tri_IIs, surf_vert2vert, surf_vert_normals);
+    auto surf_vert_normals =
+        get_side_vert_normals(mesh, s, surf_side_normals, Reals());
+    auto surf_tri_IIs =
+        get_surf_tri_IIs(mesh, s, surf_side_normals, surf_vert_normals);
+    auto surf_vert_IIs = get_surf_vert_IIs(
+        mesh, s, surf_side_normals, surf_tri_IIs, surf_vert_normals);
     out.surf_vert2vert = surf_vert2vert;
     out.surf_vert_normals = surf_vert_normals;
     out.surf_vert_IIs = surf_vert_IIs;
+    auto curv_edge2edge = collect_marked(mark_by_class_dim(mesh, EDGE, EDGE));
+    auto curv_vert2vert = collect_marked(mark_by_class_dim(mesh, VERT, EDGE));
+    extract_curv_subset(mesh, curv_edge2edge, curv_vert2vert, &s);
   } else {
-    curv_edge2edge = surf_side2side;
-    curv_vert2vert = surf_vert2vert;
+    extract_curv_subset(mesh, surf_side2side, surf_vert2vert, &s);
   }
-  auto curv_edge_tangents = get_curv_edge_tangents(mesh, curv_edge2edge);
-  auto curv_vert_tangents = get_curv_vert_tangents(
-      mesh, curv_edge2edge, curv_edge_tangents, curv_vert2vert);
-  auto curv_edge_curvatures = get_curv_edge_curvatures(mesh, curv_edge2edge,
-      curv_edge_tangents, curv_vert2vert, curv_vert_tangents);
+  Reals curv_edge_tangents;
+  Reals curv_edge_lengths;
+  get_curv_edge_tangents(
+      mesh, s.curv_edge2edge, &curv_edge_tangents, &curv_edge_lengths);
+  auto curv_vert_tangents =
+      get_curv_vert_tangents(mesh, s, curv_edge_tangents, curv_edge_lengths);
+  auto curv_edge_curvatures = get_curv_edge_curvatures(
+      mesh, s, curv_edge_tangents, curv_edge_lengths, curv_vert_tangents);
   auto curv_vert_curvatures = get_curv_vert_curvatures(
-      mesh, curv_edge2edge, curv_edge_curvatures, curv_vert2vert);
-  out.curv_vert2vert = curv_vert2vert;
+      mesh, s, curv_edge_curvatures, curv_edge_lengths);
+  out.curv_vert2vert = s.curv_vert2vert;
   out.curv_vert_tangents = curv_vert_tangents;
   out.curv_vert_curvatures = curv_vert_curvatures;
   return out;
@@ -58,6 +58,7 @@ static void swap3d_element_based(Mesh* mesh, AdaptOpts const& opts) {
   auto prod_verts2verts =
       swap3d_topology(mesh, keys2edges, edges_configs, keys2prods);
   auto old_lows2new_lows = LOs(mesh->nverts(), 0, 1);
+  ModifiedEnts modified;
   for (Int ent_dim = EDGE; ent_dim <= mesh->dim(); ++ent_dim) {
     auto prods2new_ents = LOs();
     auto same_ents2old_ents = LOs();
@@ -66,12 +67,13 @@ static void swap3d_element_based(Mesh* mesh, AdaptOpts const& opts) {
     modify_ents_adapt(mesh, &new_mesh, ent_dim, EDGE, keys2edges,
         keys2prods[ent_dim], prod_verts2verts[ent_dim], old_lows2new_lows,
         &prods2new_ents, &same_ents2old_ents, &same_ents2new_ents,
-        &old_ents2new_ents);
+        &old_ents2new_ents, &modified);
     transfer_swap(mesh, opts.xfer_opts, &new_mesh, ent_dim, keys2edges,
         keys2prods[ent_dim], prods2new_ents, same_ents2old_ents,
         same_ents2new_ents);
     old_lows2new_lows = old_ents2new_ents;
   }
+  modify_owners_and_globals(mesh, &new_mesh, modified);
   *mesh = new_mesh;
 }
 
@@ -12,14 +12,73 @@ struct Choice {
   Real quality;
 };
 
-template <typename QualityMeasure, typename LengthMeasure>
-OMEGA_H_DEVICE Choice choose(Loop loop, QualityMeasure const& quality_measure,
+/* the quality of the two tets that unique triangle (uniq_tri)
+   of the loop polygon forms with the edge vertices */
+template <typename QualityMeasure>
+OMEGA_H_DEVICE Real measure_unique_tri(
+    Loop const& loop, Int uniq_tri, QualityMeasure const& quality_measure) {
+  auto tri_verts2loop_verts = swap_triangles[loop.size][uniq_tri];
+  /* the first three tet vertices are
+     the same as the bottom triangle,
+     curling into the tet. we fill these
+     in from the triangle table for the current
+     2D mesh being explored */
+  Few<LO, 4> tet_verts2verts;
+  for (Int tri_vert = 0; tri_vert < 3; ++tri_vert) {
+    auto loop_vert = tri_verts2loop_verts[tri_vert];
+    auto vert = loop.loop_verts2verts[loop_vert];
+    tet_verts2verts[tri_vert] = vert;
+  }
+  /* each triangle will support two tets,
+     one above and one below. this loop
+     forms those tets, swapping vertices
+     in between to maintain proper orientation.
+     (mfr means Region of Face of Mesh) */
+  Real tri_minqual = 1.0;
+  for (Int tri_tet = 0; tri_tet < 2; ++tri_tet) {
+    tet_verts2verts[3] = loop.eev2v[1 - tri_tet];
+    auto tet_qual = quality_measure.measure(tet_verts2verts);
+    tri_minqual = min2(tri_minqual, tet_qual);
+    swap2(tet_verts2verts[1], tet_verts2verts[2]);
+  }
+  return tri_minqual;
+}
+
+/* measures unique triangles on first use */
+template <typename QualityMeasure>
+struct CachedTriQualities {
+  Loop const& loop;
+  QualityMeasure const& quality_measure;
+  bool cached[MAX_UNIQUE_TRIS];
+  Real quals[MAX_UNIQUE_TRIS];
+  OMEGA_H_DEVICE CachedTriQualities(
+      Loop const& loop_in, QualityMeasure const& quality_measure_in)
+      : loop(loop_in), quality_measure(quality_measure_in) {
+    for (Int i = 0; i < MAX_UNIQUE_TRIS; ++i) cached[i] = false;
+  }
+  OMEGA_H_DEVICE Real operator()(Int uniq_tri) {
+    if (!cached[uniq_tri]) {
+      quals[uniq_tri] = measure_unique_tri(loop, uniq_tri, quality_measure);
+      cached[uniq_tri] = true;
+    }
+    return quals[uniq_tri];
+  }
+};
+
+/* reads unique triangle qualities that were all measured beforehand */
+struct StoredTriQualities {
+  Reals const& quals;
+  LO first;
+  OMEGA_H_DEVICE Real operator()(Int uniq_tri) const {
+    return quals[first + uniq_tri];
+  }
+};
+
+template <typename TriQualities, typename LengthMeasure>
+OMEGA_H_DEVICE Choice choose_given(Loop loop, TriQualities& tri_quals,
     LengthMeasure const& length_measure, Real max_length_allowed) {
   auto nmeshes = swap_mesh_counts[loop.size];
   auto nmesh_tris = swap_mesh_sizes[loop.size];
-  auto uniq_tris2loop_verts = swap_triangles[loop.size];
-  bool uniq_tris_cached[MAX_UNIQUE_TRIS] = {false};
-  Real uniq_tri_quals[MAX_UNIQUE_TRIS] = {0};
   bool uniq_edgs_cached[MAX_UNIQUE_EDGES] = {false};
   Real uniq_edg_lens[MAX_UNIQUE_EDGES] = {0};
   Choice choice;
@@ -30,35 +89,7 @@ OMEGA_H_DEVICE Choice choose(Loop loop, QualityMeasure const& quality_measure,
     auto mesh_tris2uniq_tris = &swap_meshes[loop.size][mesh * nmesh_tris];
     for (Int mesh_tri = 0; mesh_tri < nmesh_tris; ++mesh_tri) {
       auto uniq_tri = mesh_tris2uniq_tris[mesh_tri];
-      if (!uniq_tris_cached[uniq_tri]) {
-        auto tri_verts2loop_verts = uniq_tris2loop_verts[uniq_tri];
-        /* the first three tet vertices are
-           the same as the bottom triangle,
-           curling into the tet. we fill these
-           in from the triangle table for the current
-           2D mesh being explored */
-        Few<LO, 4> tet_verts2verts;
-        for (Int tri_vert = 0; tri_vert < 3; ++tri_vert) {
-          auto loop_vert = tri_verts2loop_verts[tri_vert];
-          auto vert = loop.loop_verts2verts[loop_vert];
-          tet_verts2verts[tri_vert] = vert;
-        }
-        /* each triangle will support two tets,
-           one above and one below. this loop
-           forms those tets, swapping vertices
-           in between to maintain proper orientation.
-           (mfr means Region of Face of Mesh) */
-        Real tri_minqual = 1.0;
-        for (Int tri_tet = 0; tri_tet < 2; ++tri_tet) {
-          tet_verts2verts[3] = loop.eev2v[1 - tri_tet];
-          auto tet_qual = quality_measure.measure(tet_verts2verts);
-          tri_minqual = min2(tri_minqual, tet_qual);
-          swap2(tet_verts2verts[1], tet_verts2verts[2]);
-        }
-        uniq_tris_cached[uniq_tri] = true;
-        uniq_tri_quals[uniq_tri] = tri_minqual;
-      }
-      auto tri_minqual = uniq_tri_quals[uniq_tri];
+      auto tri_minqual = tri_quals(uniq_tri);
       mesh_minqual = min2(mesh_minqual, tri_minqual);
       /* if we know this swap configuration will make
          negative tets, don't bother computing the rest of it. */
@@ -99,6 +130,13 @@ OMEGA_H_DEVICE Choice choose(Loop loop, QualityMeasure const& quality_measure,
   return choice;
 }
 
+template <typename QualityMeasure, typename LengthMeasure>
+OMEGA_H_DEVICE Choice choose(Loop loop, QualityMeasure const& quality_measure,
+    LengthMeasure const& length_measure, Real max_length_allowed) {
+  CachedTriQualities<QualityMeasure> tri_quals(loop, quality_measure);
+  return choose_given(loop, tri_quals, length_measure, max_length_allowed);
+}
+
 }  // end namespace swap3d
 
 }  // end namespace Omega_h
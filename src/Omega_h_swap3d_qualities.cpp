@@ -1,15 +1,43 @@
 #include "Omega_h_swap3d.hpp"
 
 #include "Omega_h_for.hpp"
+#include "Omega_h_int_scan.hpp"
+#include "Omega_h_map.hpp"
 #include "Omega_h_quality.hpp"
 #include "Omega_h_swap3d_choice.hpp"
 #include "Omega_h_swap3d_loop.hpp"
 
 namespace Omega_h {
 
-template <Int metric_dim>
-void swap3d_qualities_tmpl(Mesh* mesh, AdaptOpts const& opts,
-    LOs cands2edges, Reals* cand_quals, Read<I8>* cand_configs) {
+/* candidates are evaluated in three passes rather than one kernel per
+   candidate: their loops are gathered once into flat arrays, then the
+   unique triangles of all loops are measured as one flat set of equal
+   work items, and finally each candidate picks its configuration from
+   those stored qualities. this keeps the expensive tet quality kernel
+   free of the branching of find_loop() and of the configuration tables */
+
+namespace {
+
+struct Loops {
+  Read<I8> sizes;  // zero for candidates that are not evaluated
+  LOs eev2v;
+  LOs loop_verts2verts;
+};
+
+OMEGA_H_DEVICE swap3d::Loop get_loop(Loops const& loops, LO cand) {
+  swap3d::Loop loop;
+  loop.size = loops.sizes[cand];
+  for (Int eev = 0; eev < 2; ++eev) {
+    loop.eev2v[eev] = loops.eev2v[cand * 2 + eev];
+  }
+  for (Int lv = 0; lv < loop.size; ++lv) {
+    loop.loop_verts2verts[lv] =
+        loops.loop_verts2verts[cand * swap3d::MAX_EDGE_SWAP + lv];
+  }
+  return loop;
+}
+
+Loops gather_loops(Mesh* mesh, LOs cands2edges) {
   auto edges2tets = mesh->ask_up(EDGE, REGION);
   auto edges2edge_tets = edges2tets.a2ab;
   auto edge_tets2tets = edges2tets.ab2b;
@@ -17,12 +45,10 @@ void swap3d_qualities_tmpl(Mesh* mesh, AdaptOpts const& opts,
   auto edge_verts2verts = mesh->ask_verts_of(EDGE);
   auto tet_verts2verts = mesh->ask_verts_of(REGION);
   auto edges_are_owned = mesh->owned(EDGE);
-  auto quality_measure = MetricElementQualities<3, metric_dim>(mesh);
-  auto length_measure = MetricEdgeLengths<3, metric_dim>(mesh);
-  auto max_length = opts.max_length_allowed;
   auto ncands = cands2edges.size();
-  auto cand_quals_w = Write<Real>(ncands);
-  auto cand_configs_w = Write<I8>(ncands);
+  auto sizes_w = Write<I8>(ncands);
+  auto eev2v_w = Write<LO>(ncands * 2);
+  auto loop_verts2verts_w = Write<LO>(ncands * swap3d::MAX_EDGE_SWAP);
   auto f = OMEGA_H_LAMBDA(LO cand) {
     auto edge = cands2edges[cand];
     /* non-owned edges will have incomplete cavities
@@ -30,19 +56,77 @@ void swap3d_qualities_tmpl(Mesh* mesh, AdaptOpts const& opts,
        in find_loop(). don't bother; their results
        will be overwritten by the owner's anyways */
     if (!edges_are_owned[edge]) {
-      cand_configs_w[cand] = -1;
-      cand_quals_w[cand] = -1.0;
+      sizes_w[cand] = 0;
       return;
     }
     auto loop = swap3d::find_loop(edges2edge_tets, edge_tets2tets,
         edge_tet_codes, edge_verts2verts, tet_verts2verts, edge);
     if (loop.size > swap3d::MAX_EDGE_SWAP) {
+      sizes_w[cand] = 0;
+      return;
+    }
+    sizes_w[cand] = static_cast<I8>(loop.size);
+    for (Int eev = 0; eev < 2; ++eev) {
+      eev2v_w[cand * 2 + eev] = loop.eev2v[eev];
+    }
+    for (Int lv = 0; lv < loop.size; ++lv) {
+      loop_verts2verts_w[cand * swap3d::MAX_EDGE_SWAP + lv] =
+          loop.loop_verts2verts[lv];
+    }
+  };
+  parallel_for(ncands, f, "swap3d_gather_loops");
+  return {sizes_w, eev2v_w, loop_verts2verts_w};
+}
+
+LOs get_cands2tris(Loops const& loops) {
+  auto ncands = loops.sizes.size();
+  auto ntris_w = Write<LO>(ncands);
+  auto f = OMEGA_H_LAMBDA(LO cand) {
+    ntris_w[cand] = swap3d::swap_triangle_counts[loops.sizes[cand]];
+  };
+  parallel_for(ncands, f, "swap3d_count_tris");
+  return offset_scan(LOs(ntris_w));
+}
+
+template <Int metric_dim>
+Reals measure_tris(Mesh* mesh, Loops const& loops, LOs cands2tris) {
+  auto quality_measure = MetricElementQualities<3, metric_dim>(mesh);
+  auto tris2cands = invert_fan(cands2tris);
+  auto ntris = tris2cands.size();
+  auto quals_w = Write<Real>(ntris);
+  auto f = OMEGA_H_LAMBDA(LO tri) {
+    auto cand = tris2cands[tri];
+    auto loop = get_loop(loops, cand);
+    auto uniq_tri = tri - cands2tris[cand];
+    quals_w[tri] = swap3d::measure_unique_tri(loop, uniq_tri, quality_measure);
+  };
+  parallel_for(ntris, f, "swap3d_measure_tris");
+  return quals_w;
+}
+
+}  // end anonymous namespace
+
+template <Int metric_dim>
+void swap3d_qualities_tmpl(Mesh* mesh, AdaptOpts const& opts,
+    LOs cands2edges, Reals* cand_quals, Read<I8>* cand_configs) {
+  auto loops = gather_loops(mesh, cands2edges);
+  auto cands2tris = get_cands2tris(loops);
+  auto tri_quals = measure_tris<metric_dim>(mesh, loops, cands2tris);
+  auto length_measure = MetricEdgeLengths<3, metric_dim>(mesh);
+  auto max_length = opts.max_length_allowed;
+  auto ncands = cands2edges.size();
+  auto cand_quals_w = Write<Real>(ncands);
+  auto cand_configs_w = Write<I8>(ncands);
+  auto f = OMEGA_H_LAMBDA(LO cand) {
+    if (loops.sizes[cand] == 0) {
       cand_configs_w[cand] = -1;
       cand_quals_w[cand] = -1.0;
       return;
     }
-    auto choice =
-        swap3d::choose(loop, quality_measure, length_measure, max_length);
+    auto loop = get_loop(loops, cand);
+    swap3d::StoredTriQualities loop_tri_quals = {tri_quals, cands2tris[cand]};
+    auto choice = swap3d::choose_given(
+        loop, loop_tri_quals, length_measure, max_length);
     static_assert(swap3d::MAX_CONFIGS <= INT8_MAX,
         "int8_t must be able to represent all swap configurations");
     cand_configs_w[cand] = static_cast<I8>(choice.mesh);
@@ -110,6 +110,10 @@ OMEGA_H_CONSTANT_DATA static swap_tri_t const* const
     swap_triangles[MAX_EDGE_SWAP + 1] = {nullptr, nullptr, nullptr, triangles_3,
         triangles_4, triangles_5, triangles_6, triangles_7};
 
+/* number of unique triangles of an N-sided polygon, N choose 3 */
+OMEGA_H_CONSTANT_DATA static Int const
+    swap_triangle_counts[MAX_EDGE_SWAP + 1] = {0, 0, 0, 1, 4, 10, 20, 35};
+
 OMEGA_H_CONSTANT_DATA static Int const* const swap_meshes[MAX_EDGE_SWAP + 1] = {
     nullptr, nullptr, nullptr, meshes_3, meshes_4, meshes_5, meshes_6,
     meshes_7};
@@ -0,0 +1,21 @@
+#ifndef OMEGA_H_UGAWG_HPP
+#define OMEGA_H_UGAWG_HPP
+
+#include <string>
+
+#include <Omega_h_array.hpp>
+
+namespace Omega_h {
+
+class Mesh;
+
+/* the analytic metric fields of the Unstructured Grid Adaptation
+   Working Group benchmarks, at the vertices of a 3D mesh:
+   cube-linear, cube-cylinder-linear, cube-cylinder-polar-1
+   and cube-cylinder-polar-2 */
+Reals get_ugawg_metric(Mesh* mesh, std::string const& name);
+bool is_ugawg_metric(std::string const& name);
+
+}  // end namespace Omega_h
+
+#endif
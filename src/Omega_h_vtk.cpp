@@ -1,7 +1,9 @@
 #include "Omega_h_vtk.hpp"
 #include "Omega_h_profile.hpp"
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -17,6 +19,7 @@
 #include "Omega_h_element.hpp"
 #include "Omega_h_file.hpp"
 #include "Omega_h_mesh.hpp"
+#include "Omega_h_osh_stream.hpp"
 #include "Omega_h_tag.hpp"
 #include "Omega_h_xml_lite.hpp"
 
@@ -24,6 +27,9 @@ namespace Omega_h {
 
 namespace vtk {
 
+/* the uncompressed size of the zlib blocks, as VTK itself uses */
+static constexpr std::uint64_t vtk_block_bytes = std::uint64_t(1) << 15;
+
 TagSet get_all_vtk_tags(Mesh* mesh, Int cell_dim) {
   TagSet tags;
   get_all_dim_tags(mesh, VERT, &tags);
@@ -140,21 +146,39 @@ void write_array(std::ostream& stream, std::string const& name, Int ncomps,
   std::string encoded;
 #ifdef OMEGA_H_USE_ZLIB
   if (compress) {
+    /* independent blocks, as VTK expects, compressed in parallel */
     begin_code("zlib");
-    uLong source_bytes = uncompressed_bytes;
-    uLong dest_bytes = ::compressBound(source_bytes);
-    auto compressed = new ::Bytef[dest_bytes];
-    int ret = ::compress2(compressed, &dest_bytes,
-        reinterpret_cast<const ::Bytef*>(nonnull(uncompressed.data())),
-        source_bytes, Z_BEST_SPEED);
+    auto nblocks = (uncompressed_bytes + vtk_block_bytes - 1) / vtk_block_bytes;
+    std::vector<std::vector< ::Bytef>> blocks(nblocks);
+    std::vector<int> rets(nblocks, Z_OK);
+    auto source = reinterpret_cast<const ::Bytef*>(uncompressed.data());
+#ifdef OMEGA_H_USE_OPENMP
+#pragma omp parallel for
+#endif
+    for (std::int64_t b = 0; b < std::int64_t(nblocks); ++b) {
+      auto offset = std::uint64_t(b) * vtk_block_bytes;
+      uLong source_bytes =
+          uLong(std::min(vtk_block_bytes, uncompressed_bytes - offset));
+      uLong dest_bytes = ::compressBound(source_bytes);
+      auto& block = blocks[std::size_t(b)];
+      block.resize(dest_bytes);
+      rets[std::size_t(b)] = ::compress2(block.data(), &dest_bytes,
+          source + offset, source_bytes, Z_BEST_SPEED);
+      block.resize(dest_bytes);
+    }
     end_code();
-    OMEGA_H_CHECK(ret == Z_OK);
+    std::vector<std::uint64_t> header = {
+        nblocks, vtk_block_bytes, uncompressed_bytes % vtk_block_bytes};
+    std::vector< ::Bytef> compressed;
+    for (std::size_t b = 0; b < nblocks; ++b) {
+      OMEGA_H_CHECK(rets[b] == Z_OK);
+      header.push_back(blocks[b].size());
+      compressed.insert(compressed.end(), blocks[b].begin(), blocks[b].end());
+    }
     begin_code("base64");
-    encoded = base64::encode(compressed, dest_bytes);
-    delete[] compressed;
-    std::uint64_t header[4] = {
-        1, uncompressed_bytes, uncompressed_bytes, dest_bytes};
-    enc_header = base64::encode(header, sizeof(header));
+    encoded = base64::encode(compressed.data(), compressed.size());
+    enc_header = base64::encode(
+        header.data(), header.size() * sizeof(std::uint64_t));
     end_code();
   } else
 #else
@@ -178,65 +202,114 @@ void write_array(std::ostream& stream, std::string const& name, Int ncomps,
   end_code();
 }
 
+/* the characters from (begin) on, decoded in parallel */
+static Read<I8> decode_payload(
+    std::string const& encoded, std::size_t begin, std::uint64_t nbytes) {
+  OMEGA_H_CHECK(begin <= encoded.size());
+  auto nchars = encoded.size() - begin;
+  OMEGA_H_CHECK(nchars <= std::size_t(ArithTraits<LO>::max()));
+  HostWrite<I8> text(LO(nchars), "base64");
+  std::memcpy(nonnull(text.data()), encoded.data() + begin, nchars);
+  return base64::decode(text.write(), nbytes);
+}
+
 template <typename T>
 static Read<T> read_array(
     std::istream& stream, LO size, bool needs_swapping, bool is_compressed) {
   auto enc_both = base64::read_encoded(stream);
-  std::uint64_t uncompressed_bytes;
-  std::string encoded;
+  auto uncompressed_bytes = std::uint64_t(size) * sizeof(T);
+  HostWrite<T> uncompressed(size);
+  auto dest = reinterpret_cast< ::Bytef*>(nonnull(uncompressed.data()));
 #ifdef OMEGA_H_USE_ZLIB
-  std::uint64_t compressed_bytes;
   if (is_compressed) {
-    std::uint64_t header[4];
-    auto nheader_chars = base64::encoded_size(sizeof(header));
-    auto enc_header = enc_both.substr(0, nheader_chars);
-    base64::decode(enc_header, header, sizeof(header));
+    /* the header holds the number of blocks, the block size, the size
+       of a partial last block (zero if it is full) and the compressed
+       size of each block */
+    std::uint64_t counts[3];
+    auto ncount_chars = base64::encoded_size(sizeof(counts));
+    OMEGA_H_CHECK(enc_both.size() >= ncount_chars);
+    base64::decode(enc_both.substr(0, ncount_chars), counts, sizeof(counts));
     if (needs_swapping) {
-      for (std::uint64_t i = 0; i < 4; ++i) {
-        binary::swap_bytes(header[i]);
+      for (auto& count : counts) binary::swap_bytes(count);
+    }
+    auto nblocks = counts[0];
+    auto block_bytes = counts[1];
+    auto last_bytes = counts[2] ? counts[2] : block_bytes;
+    std::vector<std::uint64_t> header(3 + nblocks);
+    auto nheader_chars =
+        base64::encoded_size(header.size() * sizeof(std::uint64_t));
+    OMEGA_H_CHECK(enc_both.size() >= nheader_chars);
+    base64::decode(enc_both.substr(0, nheader_chars), header.data(),
+        header.size() * sizeof(std::uint64_t));
+    std::vector<std::uint64_t> offsets(nblocks + 1, 0);
+    for (std::uint64_t b = 0; b < nblocks; ++b) {
+      if (needs_swapping) binary::swap_bytes(header[3 + b]);
+      offsets[b + 1] = offsets[b] + header[3 + b];
+    }
+    auto total_bytes = nblocks ? (nblocks - 1) * block_bytes + last_bytes : 0;
+    OMEGA_H_CHECK(total_bytes == uncompressed_bytes);
+    auto compressed = HostRead<I8>(
+        decode_payload(enc_both, nheader_chars, offsets[nblocks]));
+    auto source = reinterpret_cast<const ::Bytef*>(compressed.data());
+    std::vector<int> rets(nblocks, Z_OK);
+#ifdef OMEGA_H_USE_OPENMP
+#pragma omp parallel for
+#endif
+    for (std::int64_t b = 0; b < std::int64_t(nblocks); ++b) {
+      auto i = std::size_t(b);
+      auto expected = (i + 1 == nblocks) ? last_bytes : block_bytes;
+      uLong dest_bytes = uLong(expected);
+      rets[i] = ::uncompress(dest + i * block_bytes, &dest_bytes,
+          source + offsets[i], uLong(offsets[i + 1] - offsets[i]));
+      if (rets[i] == Z_OK && dest_bytes != uLong(expected)) {
+        rets[i] = Z_DATA_ERROR;
+      }
+    }
+    for (std::size_t i = 0; i < rets.size(); ++i) {
+      if (rets[i] != Z_OK) {
+        Omega_h_fail("code %d: couldn't decompress block %zu of %zu\n",
+            rets[i], i, std::size_t(nblocks));
       }
     }
-    encoded = enc_both.substr(nheader_chars);
-    uncompressed_bytes = header[2];
-    compressed_bytes = header[3];
   } else
 #else
   OMEGA_H_CHECK(is_compressed == false);
 #endif
   {
+    std::uint64_t nbytes;
     auto nheader_chars = base64::encoded_size(sizeof(std::uint64_t));
-    auto enc_header = enc_both.substr(0, nheader_chars);
-    base64::decode(enc_header, &uncompressed_bytes, sizeof(uncompressed_bytes));
-    if (needs_swapping) binary::swap_bytes(uncompressed_bytes);
-#ifdef OMEGA_H_USE_ZLIB
-    compressed_bytes = uncompressed_bytes;
-#endif
-    encoded = enc_both.substr(nheader_chars);
+    OMEGA_H_CHECK(enc_both.size() >= nheader_chars);
+    base64::decode(enc_both.substr(0, nheader_chars), &nbytes, sizeof(nbytes));
+    if (needs_swapping) binary::swap_bytes(nbytes);
+    OMEGA_H_CHECK(nbytes == uncompressed_bytes);
+    auto decoded = HostRead<I8>(
+        decode_payload(enc_both, nheader_chars, uncompressed_bytes));
+    std::memcpy(dest, decoded.data(), uncompressed_bytes);
   }
-  OMEGA_H_CHECK(uncompressed_bytes == std::uint64_t(size) * sizeof(T));
-  HostWrite<T> uncompressed(size);
-#ifdef OMEGA_H_USE_ZLIB
-  if (is_compressed) {
-    auto compressed = new ::Bytef[compressed_bytes];
-    base64::decode(encoded, compressed, compressed_bytes);
-    uLong dest_bytes = static_cast<uLong>(uncompressed_bytes);
-    uLong source_bytes = static_cast<uLong>(compressed_bytes);
-    ::Bytef* uncompressed_ptr =
-        reinterpret_cast< ::Bytef*>(nonnull(uncompressed.data()));
-    int ret =
-        ::uncompress(uncompressed_ptr, &dest_bytes, compressed, source_bytes);
-    if (ret != Z_OK) {
-      Omega_h_fail(
-          "code %d: couln't decompress \"%s\"\n", ret, encoded.c_str());
+  return binary::swap_bytes(Read<T>(uncompressed.write()), needs_swapping);
+}
+
+static void write_reals(std::ostream& stream, std::string const& name,
+    Int ncomps, Reals array, Int space_dim, bool compress) {
+  if (1 < space_dim && space_dim < 3) {
+    if (ncomps == space_dim) {
+      // VTK / ParaView expect vector fields to have 3 components
+      // regardless of whether this is a 2D mesh or not.
+      // this filter adds a 3rd zero component to any
+      // fields with 2 components for 2D meshes
+      write_array(
+          stream, name, 3, resize_vectors(array, space_dim, 3), compress);
+    } else if (ncomps == symm_ncomps(space_dim)) {
+      // Likewise, ParaView has component names specially set up for
+      // 3D symmetric tensors
+      write_array(stream, name, symm_ncomps(3),
+          resize_symms(array, space_dim, 3), compress);
+    } else {
+      write_array(stream, name, ncomps, array, compress);
     }
-    OMEGA_H_CHECK(dest_bytes == static_cast<uLong>(uncompressed_bytes));
-    delete[] compressed;
-  } else
-#endif
-  {
-    base64::decode(encoded, nonnull(uncompressed.data()), uncompressed_bytes);
+  } else {
+    write_array(stream, name, ncomps, array, compress);
   }
-  return binary::swap_bytes(Read<T>(uncompressed.write()), needs_swapping);
 }
 
 void write_tag(
@@ -252,26 +325,8 @@ void write_tag(
     write_array(
         stream, tag->name(), tag->ncomps(), as<I64>(tag)->array(), compress);
   } else if (is<Real>(tag)) {
-    Reals array = as<Real>(tag)->array();
-    if (1 < space_dim && space_dim < 3) {
-      if (tag->ncomps() == space_dim) {
-        // VTK / ParaView expect vector fields to have 3 components
-        // regardless of whether this is a 2D mesh or not.
-        // this filter adds a 3rd zero component to any
-        // fields with 2 components for 2D meshes
-        write_array(stream, tag->name(), 3, resize_vectors(array, space_dim, 3),
-            compress);
-      } else if (tag->ncomps() == symm_ncomps(space_dim)) {
-        // Likewise, ParaView has component names specially set up for
-        // 3D symmetric tensors
-        write_array(stream, tag->name(), symm_ncomps(3),
-            resize_symms(array, space_dim, 3), compress);
-      } else {
-        write_array(stream, tag->name(), tag->ncomps(), array, compress);
-      }
-    } else {
-      write_array(stream, tag->name(), tag->ncomps(), array, compress);
-    }
+    write_reals(stream, tag->name(), tag->ncomps(), as<Real>(tag)->array(),
+        space_dim, compress);
   } else {
     Omega_h_fail("unknown tag type in write_tag");
   }
@@ -502,24 +557,29 @@ static void write_p_data_array2(std::ostream& stream, std::string const& name,
   }
 }
 
-void write_p_tag(std::ostream& stream, TagBase const* tag, Int space_dim) {
-  if (tag->type() == OMEGA_H_REAL) {
+static void write_p_tag(std::ostream& stream, std::string const& name,
+    Int ncomps, Omega_h_Type type, Int space_dim) {
+  if (type == OMEGA_H_REAL) {
     if (1 < space_dim && space_dim < 3) {
-      if (tag->ncomps() == space_dim) {
-        write_p_data_array2(stream, tag->name(), 3, OMEGA_H_REAL);
-      } else if (tag->ncomps() == symm_ncomps(space_dim)) {
-        write_p_data_array2(stream, tag->name(), symm_ncomps(3), OMEGA_H_REAL);
+      if (ncomps == space_dim) {
+        write_p_data_array2(stream, name, 3, OMEGA_H_REAL);
+      } else if (ncomps == symm_ncomps(space_dim)) {
+        write_p_data_array2(stream, name, symm_ncomps(3), OMEGA_H_REAL);
       } else {
-        write_p_data_array2(stream, tag->name(), tag->ncomps(), OMEGA_H_REAL);
+        write_p_data_array2(stream, name, ncomps, OMEGA_H_REAL);
       }
     } else {
-      write_p_data_array2(stream, tag->name(), tag->ncomps(), OMEGA_H_REAL);
+      write_p_data_array2(stream, name, ncomps, OMEGA_H_REAL);
     }
   } else {
-    write_p_data_array2(stream, tag->name(), tag->ncomps(), tag->type());
+    write_p_data_array2(stream, name, ncomps, type);
   }
 }
 
+void write_p_tag(std::ostream& stream, TagBase const* tag, Int space_dim) {
+  write_p_tag(stream, tag->name(), tag->ncomps(), tag->type(), space_dim);
+}
+
 static filesystem::path piece_filename(
     filesystem::path const& piecepath, I32 rank) {
   auto piece_filename = piecepath;
@@ -879,6 +939,208 @@ void write_parallel(std::string const& path, Mesh* mesh, bool compress) {
   write_parallel(path, mesh, mesh->dim(), compress);
 }
 
+static filesystem::path chunk_piece_filename(
+    filesystem::path const& piecepath, I32 part, I32 chunk) {
+  auto piece_filename = piecepath;
+  piece_filename += '_';
+  piece_filename += std::to_string(part);
+  piece_filename += '_';
+  piece_filename += std::to_string(chunk);
+  piece_filename += ".vtu";
+  return piece_filename;
+}
+
+/* vertex data of a chunk is gathered from its vertex list,
+   cell data is read as the contiguous range of the chunk */
+template <typename T>
+static Read<T> read_chunk_tag(binary::PartReader* part, Int ent_dim,
+    std::string const& name, binary::EntChunk const& chunk, bool is_cells) {
+  if (is_cells) {
+    return part->read_tag<T>(ent_dim, name, chunk.begin, chunk.end);
+  }
+  return part->read_tag<T>(ent_dim, name, chunk.verts);
+}
+
+static void write_chunk_tag(std::ostream& stream, binary::PartReader* part,
+    Int ent_dim, binary::StoredTag const& tag, binary::EntChunk const& chunk,
+    bool is_cells, bool compress) {
+  switch (tag.type) {
+    case OMEGA_H_I8:
+      write_array(stream, tag.name, tag.ncomps,
+          read_chunk_tag<I8>(part, ent_dim, tag.name, chunk, is_cells),
+          compress);
+      break;
+    case OMEGA_H_I32:
+      write_array(stream, tag.name, tag.ncomps,
+          read_chunk_tag<I32>(part, ent_dim, tag.name, chunk, is_cells),
+          compress);
+      break;
+    case OMEGA_H_I64:
+      write_array(stream, tag.name, tag.ncomps,
+          read_chunk_tag<I64>(part, ent_dim, tag.name, chunk, is_cells),
+          compress);
+      break;
+    case OMEGA_H_F64:
+      write_reals(stream, tag.name, tag.ncomps,
+          read_chunk_tag<Real>(part, ent_dim, tag.name, chunk, is_cells),
+          part->dim(), compress);
+      break;
+  }
+}
+
+static bool is_streamed_tag(binary::StoredTag const& tag, bool is_cells) {
+  return tag.name != "global" && (is_cells || tag.name != "coordinates");
+}
+
+/* same arrays, in the same order, as write_vtu() with get_all_vtk_tags() */
+static void write_chunk_data(std::ostream& stream, binary::PartReader* part,
+    Int ent_dim, binary::EntChunk const& chunk, bool is_cells, bool compress) {
+  if (part->has_tag(ent_dim, "global")) {
+    write_chunk_tag(stream, part, ent_dim, part->get_tag(ent_dim, "global"),
+        chunk, is_cells, compress);
+  }
+  auto ents = is_cells ? LOs(chunk.end - chunk.begin, chunk.begin, 1)
+                       : chunk.verts;
+  write_array(stream, "local", 1, ents, compress);
+  if (part->nparts() > 1) {
+    auto ranks = is_cells
+                     ? part->read_owner_ranks(ent_dim, chunk.begin, chunk.end)
+                     : part->read_owner_ranks(ent_dim, chunk.verts);
+    write_array(stream, "owner", 1, ranks, compress);
+    if (is_cells && part->parting() == OMEGA_H_GHOSTED) {
+      auto owned = each_eq_to(ranks, part->part());
+      auto ghost_types = each_eq_to(owned, static_cast<I8>(0));
+      write_array<I8, std::uint8_t>(
+          stream, "vtkGhostType", 1, ghost_types, compress);
+    }
+  }
+  for (auto& tag : part->tags(ent_dim)) {
+    if (is_streamed_tag(tag, is_cells)) {
+      write_chunk_tag(stream, part, ent_dim, tag, chunk, is_cells, compress);
+    }
+  }
+}
+
+static void write_chunk_vtu(std::ostream& stream, binary::PartReader* part,
+    Int cell_dim, binary::EntChunk const& chunk, bool compress) {
+  OMEGA_H_TIME_FUNCTION;
+  auto const ncells = chunk.end - chunk.begin;
+  write_vtkfile_vtu_start_tag(stream, compress);
+  stream << "<UnstructuredGrid>\n";
+  stream << "<Piece NumberOfPoints=\"" << chunk.verts.size() << "\"";
+  stream << " NumberOfCells=\"" << ncells << "\">\n";
+  stream << "<Cells>\n";
+  Read<I8> types(ncells, vtk_type(part->family(), cell_dim));
+  write_array(stream, "types", 1, types, compress);
+  auto deg = element_degree(part->family(), cell_dim, VERT);
+  write_array(stream, "connectivity", 1, chunk.ents2verts, compress);
+  write_array(stream, "offsets", 1, LOs(ncells, deg, deg), compress);
+  stream << "</Cells>\n";
+  stream << "<Points>\n";
+  auto coords = part->read_tag<Real>(VERT, "coordinates", chunk.verts);
+  write_array(stream, "coordinates", 3,
+      resize_vectors(coords, part->dim(), 3), compress);
+  stream << "</Points>\n";
+  stream << "<PointData>\n";
+  write_chunk_data(stream, part, VERT, chunk, false, compress);
+  stream << "</PointData>\n";
+  stream << "<CellData>\n";
+  write_chunk_data(stream, part, cell_dim, chunk, true, compress);
+  stream << "</CellData>\n";
+  stream << "</Piece>\n";
+  stream << "</UnstructuredGrid>\n";
+  stream << "</VTKFile>\n";
+}
+
+static void write_chunk_p_data(std::ostream& stream, binary::PartReader* part,
+    Int ent_dim, bool is_cells) {
+  if (part->has_tag(ent_dim, "global")) {
+    write_p_data_array2(stream, "global", 1, OMEGA_H_I64);
+  }
+  write_p_data_array2(stream, "local", 1, OMEGA_H_I32);
+  if (part->nparts() > 1) {
+    write_p_data_array2(stream, "owner", 1, OMEGA_H_I32);
+    if (is_cells && part->parting() == OMEGA_H_GHOSTED) {
+      write_p_data_array<std::uint8_t>(stream, "vtkGhostType", 1);
+    }
+  }
+  for (auto& tag : part->tags(ent_dim)) {
+    if (is_streamed_tag(tag, is_cells)) {
+      write_p_tag(stream, tag.name, tag.ncomps, tag.type, part->dim());
+    }
+  }
+}
+
+static void write_chunk_pvtu(filesystem::path const& filename,
+    binary::PartReader* part, Int cell_dim,
+    filesystem::path const& piecepath, std::vector<I32> const& nchunks) {
+  std::ofstream stream(filename.c_str());
+  OMEGA_H_CHECK(stream.is_open());
+  stream << "<VTKFile type=\"PUnstructuredGrid\">\n";
+  stream << "<PUnstructuredGrid";
+  stream << " GhostLevel=\"";
+  if (part->parting() == OMEGA_H_GHOSTED) {
+    stream << part->nghost_layers();
+  } else {
+    stream << Int(0);
+  }
+  stream << "\">\n";
+  stream << "<PPoints>\n";
+  write_p_data_array<Real>(stream, "coordinates", 3);
+  stream << "</PPoints>\n";
+  stream << "<PPointData>\n";
+  write_chunk_p_data(stream, part, VERT, false);
+  stream << "</PPointData>\n";
+  stream << "<PCellData>\n";
+  write_chunk_p_data(stream, part, cell_dim, true);
+  stream << "</PCellData>\n";
+  for (I32 p = 0; p < I32(nchunks.size()); ++p) {
+    for (I32 c = 0; c < nchunks[std::size_t(p)]; ++c) {
+      stream << "<Piece Source=\"" << chunk_piece_filename(piecepath, p, c)
+             << "\"/>\n";
+    }
+  }
+  stream << "</PUnstructuredGrid>\n";
+  stream << "</VTKFile>\n";
+}
+
+void write_parallel_streamed(filesystem::path const& osh_path,
+    filesystem::path const& path, CommPtr comm, Int cell_dim,
+    LO max_chunk_ents, bool compress) {
+  ScopedTimer timer("vtk::write_parallel_streamed");
+  auto const rank = comm->rank();
+  if (rank == 0) {
+    filesystem::create_directory(path);
+  }
+  comm->barrier();
+  auto const piecesdir = path / "pieces";
+  if (rank == 0) {
+    filesystem::create_directory(piecesdir);
+  }
+  comm->barrier();
+  auto const piecepath = piecesdir / "piece";
+  std::vector<I32> nchunks(std::size_t(binary::read_nparts(osh_path, comm)), 0);
+  auto f = [&](binary::PartReader* part, binary::EntChunk const& chunk) {
+    auto const dim = (cell_dim == -1) ? part->dim() : cell_dim;
+    auto& n = nchunks[std::size_t(part->part())];
+    auto const filename = chunk_piece_filename(piecepath, part->part(), n++);
+    std::ofstream stream(filename.c_str());
+    OMEGA_H_CHECK(stream.is_open());
+    write_chunk_vtu(stream, part, dim, chunk, compress);
+  };
+  binary::for_each_ent_chunk(osh_path, comm, cell_dim, max_chunk_ents, f);
+  nchunks = comm->allreduce(nchunks, OMEGA_H_SUM);
+  auto const version = binary::read_version(osh_path, comm);
+  if (rank == 0) {
+    binary::PartReader part(osh_path, 0, version);
+    if (cell_dim == -1) cell_dim = part.dim();
+    auto const relative_piecepath = filesystem::path("pieces") / "piece";
+    write_chunk_pvtu(
+        get_pvtu_path(path), &part, cell_dim, relative_piecepath, nchunks);
+  }
+  comm->barrier();
+}
+
 void read_parallel(filesystem::path const& pvtupath, CommPtr comm, Mesh* mesh) {
   I32 npieces;
   filesystem::path vtupath;
@@ -1,6 +1,7 @@
 #ifndef OMEGA_H_PY_HPP
 #define OMEGA_H_PY_HPP
 
+#include <Omega_h_array.hpp>
 #include <Omega_h_config.h>
 
 #ifdef __GNUC__
@@ -8,6 +9,7 @@
 #pragma GCC diagnostic ignored "-Wshadow"
 #endif
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
 #ifdef __GNUC__
@@ -17,6 +19,45 @@
 namespace py = pybind11;
 
 namespace Omega_h {
+
+/* Adopts the buffer of a NumPy array without copying (when the backend
+   allows it). The returned array keeps the NumPy object alive. */
+template <class T>
+Write<T> numpy_to_write(
+    py::array_t<T, py::array::c_style | py::array::forcecast> a,
+    std::string const& name = "") {
+  auto size = static_cast<LO>(a.size());
+  auto data = const_cast<T*>(a.data());
+  PyObject* owner = a.release().ptr();
+  auto release = [owner]() {
+    py::gil_scoped_acquire acquire;
+    Py_DECREF(owner);
+  };
+  return adopt_host_data(data, size, release, name);
+}
+
+/* Returns a read-only NumPy view of an array, shaped (size/ncomps, ncomps)
+   if ncomps > 1. The view keeps the array alive. */
+template <class T>
+py::array_t<T> read_to_numpy(Read<T> a, Int ncomps = 1) {
+  auto holder = new HostRead<T>(a);
+  py::capsule base(
+      holder, [](void* p) { delete static_cast<HostRead<T>*>(p); });
+  auto const width = static_cast<std::ptrdiff_t>(sizeof(T));
+  std::vector<std::ptrdiff_t> shape;
+  std::vector<std::ptrdiff_t> strides;
+  if (ncomps == 1) {
+    shape = {holder->size()};
+    strides = {width};
+  } else {
+    shape = {holder->size() / ncomps, ncomps};
+    strides = {width * ncomps, width};
+  }
+  py::array_t<T> out(shape, strides, holder->data(), base);
+  out.attr("flags").attr("writeable") = false;
+  return out;
+}
+
 class Library;
 extern std::unique_ptr<Library> pybind11_global_library;
 void pybind11_defines(py::module& module);
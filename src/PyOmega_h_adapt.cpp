@@ -47,12 +47,15 @@ void pybind11_adapt(py::module& module) {
   module.def("grade_fix_adapt", &grade_fix_adapt,
       "Apply gradation control, possibly fix quality, then adapt",
       py::arg("mesh"), py::arg("opts"), py::arg("target_metric"),
-      py::arg("verbose") = true);
-  module.def("add_implied_metric_tag", &add_implied_metric_tag);
-  module.def("generate_target_metric_tag", &generate_target_metric_tag);
+      py::arg("verbose") = true, py::call_guard<py::gil_scoped_release>());
+  module.def("add_implied_metric_tag", &add_implied_metric_tag,
+      py::call_guard<py::gil_scoped_release>());
+  module.def("generate_target_metric_tag", &generate_target_metric_tag,
+      py::call_guard<py::gil_scoped_release>());
   module.def("approach_metric", &approach_metric, py::arg("mesh"),
-      py::arg("opts"), py::arg("min_step") = 1e-4);
-  module.def("adapt", &adapt);
+      py::arg("opts"), py::arg("min_step") = 1e-4,
+      py::call_guard<py::gil_scoped_release>());
+  module.def("adapt", &adapt, py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace Omega_h
@@ -11,13 +11,33 @@ static void pybind11_array_type(py::module& module,
   auto hostread_name = std::string("HostRead_") + py_scalar;
   auto hostwrite_name = std::string("HostWrite_") + py_scalar;
   auto deepcopy_name = std::string("deep_copy_") + py_scalar;
+  using NumPyArray =
+      py::array_t<Scalar, py::array::c_style | py::array::forcecast>;
   py::class_<Write<Scalar>>(module, write_name.c_str())
+      .def(py::init(&numpy_to_write<Scalar>),
+          "Adopt a NumPy buffer without copying", py::arg("array"),
+          py::arg("name") = "")
       .def("size", &Write<Scalar>::size);
   py::class_<Read<Scalar>>(module, read_name.c_str())
       .def(py::init<Write<Scalar>>())
-      .def("size", &Read<Scalar>::size);
+      .def(py::init([](NumPyArray a, std::string const& name) {
+        return Read<Scalar>(numpy_to_write<Scalar>(a, name));
+      }),
+          "Adopt a NumPy buffer without copying", py::arg("array"),
+          py::arg("name") = "")
+      .def("size", &Read<Scalar>::size)
+      .def("numpy",
+          [](Read<Scalar> a, Int ncomps) {
+            return read_to_numpy(a, ncomps);
+          },
+          "Read-only NumPy view of this array", py::arg("ncomps") = 1);
   py::class_<Wrapper, Read<Scalar>>(module, py_wrapper.c_str())
       .def(py::init<Write<Scalar>>())
+      .def(py::init([](NumPyArray a, std::string const& name) {
+        return Wrapper(numpy_to_write<Scalar>(a, name));
+      }),
+          "Adopt a NumPy buffer without copying", py::arg("array"),
+          py::arg("name") = "")
       .def(py::init<LO, Scalar, std::string const&>(), py::arg("size"),
           py::arg("value"), py::arg("name") = "");
   py::class_<HostRead<Scalar>>(
@@ -16,20 +16,34 @@ void pybind11_file(py::module& module) {
       &vtk::write_parallel;
   void (*vtk_write_parallel)(std::string const&, Mesh*, bool) =
       &vtk::write_parallel;
-  module.def("gmsh_read_file", gmsh_read_file, "Read a Gmsh file");
-  module.def("gmsh_write_file", gmsh_write_file, "Write a Gmsh file");
+  void (*binary_write_file)(filesystem::path const&, Mesh*) = &binary::write;
+  Mesh (*binary_read_file)(filesystem::path const&, CommPtr, bool) =
+      &binary::read;
+  using release_gil = py::call_guard<py::gil_scoped_release>;
+  module.def("gmsh_read_file", gmsh_read_file, "Read a Gmsh file",
+      release_gil());
+  module.def("gmsh_write_file", gmsh_write_file, "Write a Gmsh file",
+      release_gil());
+  module.def("binary_write_file", binary_write_file,
+      "Write a mesh as an .osh directory", py::arg("path"), py::arg("mesh"),
+      release_gil());
+  module.def("binary_read_file", binary_read_file,
+      "Read a mesh from an .osh directory", py::arg("path"), py::arg("comm"),
+      py::arg("strict") = false, release_gil());
   module.def("vtk_write_vtu", vtk_write_vtu, "Write a mesh as a .vtu file",
-      py::arg("path"), py::arg("mesh"), py::arg("compress") = true);
+      py::arg("path"), py::arg("mesh"), py::arg("compress") = true,
+      release_gil());
   module.def("vtk_write_vtu_dim", vtk_write_vtu_dim,
       "Write entities of one dimension as a .vtu file", py::arg("path"),
-      py::arg("mesh"), py::arg("cell_dim"), py::arg("compress") = true);
+      py::arg("mesh"), py::arg("cell_dim"), py::arg("compress") = true,
+      release_gil());
   module.def("vtk_write_parallel", vtk_write_parallel,
       "Write a mesh as a directory of parallel VTK files", py::arg("path"),
-      py::arg("mesh"), py::arg("compress") = true);
+      py::arg("mesh"), py::arg("compress") = true, release_gil());
   module.def("vtk_write_parallel_dim", vtk_write_parallel_dim,
       "Write entities of one dimension as a directory of parallel VTK files",
       py::arg("path"), py::arg("mesh"), py::arg("cell_dim"),
-      py::arg("compress") = true);
+      py::arg("compress") = true, release_gil());
 }
 
 }  // namespace Omega_h
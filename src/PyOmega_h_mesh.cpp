@@ -8,6 +8,13 @@ namespace Omega_h {
       &Mesh::add_tag<T>;
 #define OMEGA_H_DEF_TYPE(T, name)                                              \
   .def("get_array_" #name, &Mesh::get_array<T>)                                \
+      .def("get_numpy_" #name,                                                 \
+          [](Mesh* mesh, Int ent_dim, std::string const& tag_name) {           \
+            auto tag = mesh->get_tag<T>(ent_dim, tag_name);                    \
+            return read_to_numpy(tag->array(), tag->ncomps());                 \
+          },                                                                   \
+          "Read-only NumPy view of a " #name " tag", py::arg("ent_dim"),       \
+          py::arg("name"))                                                     \
       .def("add_tag_" #name, add_tag_##name,                                   \
           "Add " #name " tag array to the mesh",                               \
           py::arg("ent_dim") = OMEGA_H_VERT, py::arg("name"),                  \
@@ -29,9 +36,15 @@ void pybind11_mesh(py::module& module) {
           py::arg("verbose") = false) OMEGA_H_DEF_TYPE(I8, int8)
           OMEGA_H_DEF_TYPE(I32, int32) OMEGA_H_DEF_TYPE(I64, int64)
               OMEGA_H_DEF_TYPE(Real, float64)
-      .def("min_quality", &Omega_h::Mesh::min_quality)
-      .def("max_length", &Omega_h::Mesh::max_length)
-      .def("balance", balance, py::arg("predictive") = false);
+      .def("coords_numpy",
+          [](Mesh* mesh) { return read_to_numpy(mesh->coords(), mesh->dim()); },
+          "Read-only NumPy view of the vertex coordinates")
+      .def("min_quality", &Omega_h::Mesh::min_quality,
+          py::call_guard<py::gil_scoped_release>())
+      .def("max_length", &Omega_h::Mesh::max_length,
+          py::call_guard<py::gil_scoped_release>())
+      .def("balance", balance, py::arg("predictive") = false,
+          py::call_guard<py::gil_scoped_release>());
   module.def(
       "new_empty_mesh", []() { return Mesh(pybind11_global_library.get()); });
 }
@@ -1,18 +1,26 @@
+#include <cctype>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include "Omega_h_array_ops.hpp"
 #include "Omega_h_build.hpp"
 #include "Omega_h_cmdline.hpp"
 #include "Omega_h_class.hpp"
 #include "Omega_h_element.hpp"
 #include "Omega_h_file.hpp"
+#include "Omega_h_for.hpp"
 #include "Omega_h_mesh.hpp"
 
 // this is super-specific to a single kind of output generated
 // by tetgen from CT data with no attempt for generalization.
 
+// the few header lines are read one at a time and the large numeric
+// sections are read in bounded chunks, each parsed in parallel.
+
 static std::string get_line(std::istream& stream) {
   std::string line;
   std::getline(stream, line);
+  if (!line.empty() && line.back() == '\r') line.pop_back();
   return line;
 }
 
@@ -20,147 +28,109 @@ static void check_line(std::istream& stream, std::string want) {
   auto line = get_line(stream);
   if (line != want) {
     Omega_h_fail("wanted line: \"%s\" but got: \"%s\"\n",
-        line.c_str(), want.c_str());
+        want.c_str(), line.c_str());
   }
 }
 
 static void check_header(std::istream& stream) {
-//check_line(stream, "# vtk DataFile Version 4.2");
+  //check_line(stream, "# vtk DataFile Version 4.2");
   get_line(stream);
-//check_line(stream, "3D Slicer output. SPACE=RAS");
+  //check_line(stream, "3D Slicer output. SPACE=RAS");
   get_line(stream);
   check_line(stream, "ASCII");
   check_line(stream, "DATASET UNSTRUCTURED_GRID");
 }
 
-template <class T>
-static void read_val(std::istream& stream, T& value) {
-  stream >> value;
-}
-
-static void eat_newlines(std::istream& stream) {
-  while (stream.peek() == int('\n')) stream.get();
+static bool is_letter(char c) {
+  return std::isalpha(static_cast<unsigned char>(c)) != 0;
+}
+
+/* skips to the next line that starts with a letter, which must be
+   the header of the section (marker), and returns the rest of it.
+   lines of numbers left over from an earlier section are skipped */
+static std::istringstream get_section(
+    std::istream& stream, std::string const& marker) {
+  while (stream) {
+    auto line = get_line(stream);
+    auto first = line.find_first_not_of(" \t");
+    if (first == std::string::npos || !is_letter(line[first])) continue;
+    std::istringstream header(line);
+    std::string got;
+    header >> got;
+    if (got != marker) {
+      Omega_h_fail("wanted section \"%s\" but got: \"%s\"\n",
+          marker.c_str(), line.c_str());
+    }
+    return header;
+  }
+  Omega_h_fail("missing section \"%s\"\n", marker.c_str());
 }
 
-static int get_npoints(std::istream& stream) {
+static Omega_h::Reals get_coords(std::istream& stream) {
+  auto header = get_section(stream, "POINTS");
   int npoints;
-  std::string points_marker;
   std::string double_marker;
-  read_val(stream, points_marker);
-  read_val(stream, npoints);
-  read_val(stream, double_marker);
-  OMEGA_H_CHECK(points_marker == "POINTS");
+  header >> npoints >> double_marker;
   OMEGA_H_CHECK(double_marker == "double");
-  return npoints;
-}
-
-static Omega_h::HostWrite<Omega_h::Real> get_coords(std::istream& stream) {
-  int npoints = get_npoints(stream);
-  Omega_h::HostWrite<Omega_h::Real> coords(npoints * 3);
-  for (int pt = 0; pt < npoints; ++pt) {
-    Omega_h::Real val;
-    for (int d = 0; d < 3; ++d) {
-      read_val(stream, val);
-      coords[pt * 3 + d] = val;
-    }
-  }
-  eat_newlines(stream);
-  return coords;
+  return Omega_h::read_reals(stream, npoints * 3);
 }
 
-static int get_cell_nelems(std::istream& stream) {
+static Omega_h::LOs get_ev2v(std::istream& stream) {
+  auto header = get_section(stream, "CELLS");
   int nelems;
-  int garbage;
-  std::string cells_marker;
-  read_val(stream, cells_marker);
-  read_val(stream, nelems);
-  read_val(stream, garbage);
-  OMEGA_H_CHECK(cells_marker == "CELLS");
+  int nints;
+  header >> nelems >> nints;
   OMEGA_H_CHECK(nelems > 0);
-  return nelems;
-}
-
-static Omega_h::HostWrite<Omega_h::LO> get_ev2v(std::istream& stream) {
-  int nelems = get_cell_nelems(stream);
-  int neev = Omega_h::element_degree(OMEGA_H_SIMPLEX,  3, 0);
-  Omega_h::HostWrite<Omega_h::LO> ev2v(nelems * neev);
-  for (int elem = 0; elem < nelems; ++elem) {
-    Omega_h::LO val;
-    read_val(stream, val);
-    OMEGA_H_CHECK(val == neev);
+  int neev = Omega_h::element_degree(OMEGA_H_SIMPLEX, 3, 0);
+  OMEGA_H_CHECK(nints == nelems * (neev + 1));
+  auto cells = Omega_h::read_los(stream, nints);
+  auto counts = Omega_h::get_component(cells, neev + 1, 0);
+  OMEGA_H_CHECK(Omega_h::get_min(counts) == neev);
+  OMEGA_H_CHECK(Omega_h::get_max(counts) == neev);
+  Omega_h::Write<Omega_h::LO> ev2v(nelems * neev);
+  auto f = OMEGA_H_LAMBDA(Omega_h::LO elem) {
     for (int v = 0; v < neev; ++v) {
-      read_val(stream, val);
-      ev2v[elem * neev + v] = val;
+      ev2v[elem * neev + v] = cells[elem * (neev + 1) + 1 + v];
     }
-  }
-  eat_newlines(stream);
+  };
+  Omega_h::parallel_for(nelems, f, "strip_cell_counts");
   return ev2v;
 }
 
+/* the types themselves are skipped along with the next section's
+   leading lines */
 static void eat_elem_types(std::istream& stream) {
+  auto header = get_section(stream, "CELL_TYPES");
   int nlines;
-  int garbage;
-  std::string cell_type_marker;
-  read_val(stream, cell_type_marker);
-  read_val(stream, nlines);
-  OMEGA_H_CHECK(cell_type_marker == "CELL_TYPES");
-  for (int i = 0; i < nlines; ++i) read_val(stream, garbage);
-  eat_newlines(stream);
+  header >> nlines;
 }
 
-static int get_mat_id_nelems(std::istream& stream) {
+static Omega_h::LOs get_elem_mat_ids(std::istream& stream) {
+  auto header = get_section(stream, "CELL_DATA");
   int nelems;
-  std::string cell_data_marker;
-  std::string scalars_marker;
-  read_val(stream, cell_data_marker);
-  read_val(stream, nelems);
-  read_val(stream, scalars_marker);
-  OMEGA_H_CHECK(cell_data_marker == "CELL_DATA");
+  header >> nelems;
   get_line(stream);
   get_line(stream);
-  return nelems;
+  return Omega_h::read_los(stream, nelems);
 }
 
-static Omega_h::HostWrite<Omega_h::LO> get_elem_mat_ids(std::istream& stream) {
-  int nelems = get_mat_id_nelems(stream);
-  Omega_h::HostWrite<Omega_h::LO> mat(nelems);
-  for (int elem = 0; elem < nelems; ++elem) {
-    Omega_h::LO mat_id;
-    read_val(stream, mat_id);
-    mat[elem] = mat_id;
-  }
-  eat_newlines(stream);
-  return mat;
-}
-
-static void build_mesh(
-    Omega_h::Mesh* mesh,
-    Omega_h::HostWrite<Omega_h::Real> h_coords,
-    Omega_h::HostWrite<Omega_h::LO> h_ev2v) {
-  Omega_h::Read<Omega_h::Real> coords(h_coords.write());
-  Omega_h::Read<Omega_h::LO> ev2v(h_ev2v.write());
-  Omega_h::build_from_elems_and_coords(
-      mesh, OMEGA_H_SIMPLEX, 3, ev2v, coords);
-}
-
-static void classify(
-    Omega_h::Mesh* mesh,
-    Omega_h::HostWrite<Omega_h::LO> h_mat) {
-  Omega_h::Read<Omega_h::LO> mat(h_mat.write());
+static void classify(Omega_h::Mesh* mesh, Omega_h::LOs mat) {
   mesh->add_tag(3, "class_id", 1, mat);
   Omega_h::finalize_classification(mesh);
 }
 
 static void build(Omega_h::Mesh* mesh, std::string vtk_path) {
-  std::ifstream file(vtk_path.c_str());
-  OMEGA_H_CHECK(file.is_open());
-  check_header(file);
-  auto coords = get_coords(file);
-  auto ev2v = get_ev2v(file);
-  eat_elem_types(file);
-  auto mat = get_elem_mat_ids(file);
-  //OMEGA_H_CHECK(file.eof());
-  build_mesh(mesh, coords, ev2v);
+  std::ifstream stream(vtk_path.c_str(), std::ios::binary);
+  if (!stream.is_open()) {
+    Omega_h_fail("couldn't open \"%s\"\n", vtk_path.c_str());
+  }
+  check_header(stream);
+  auto coords = get_coords(stream);
+  auto ev2v = get_ev2v(stream);
+  eat_elem_types(stream);
+  auto mat = get_elem_mat_ids(stream);
+  Omega_h::build_from_elems_and_coords(
+      mesh, OMEGA_H_SIMPLEX, 3, ev2v, coords);
   classify(mesh, mat);
   Omega_h::reorder_by_hilbert(mesh);
 }
@@ -184,4 +154,3 @@ int main(int argc, char** argv) {
   build(&mesh, vtk_path);
   Omega_h::binary::write(osh_path, &mesh);
 }
-
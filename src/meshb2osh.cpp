@@ -19,7 +19,12 @@ int main(int argc, char** argv) {
     return -1;
   }
   Omega_h::Mesh mesh(&lib);
-  Omega_h::meshb::read(&mesh, argv[1]);
+  auto world = lib.world();
+  if (world->size() > 1) {
+    Omega_h::meshb::read_sliced(&mesh, argv[1], world);
+  } else {
+    Omega_h::meshb::read(&mesh, argv[1]);
+  }
 #ifdef OMEGA_H_USE_EGADS
   if (argc == 4) {
     auto eg = Omega_h::egads_load(argv[2]);
@@ -1,12 +1,25 @@
 #include <Omega_h_array_ops.hpp>
 #include <Omega_h_bipart.hpp>
 #include <Omega_h_build.hpp>
+#include <Omega_h_coloring.hpp>
 #include <Omega_h_compare.hpp>
+#include <Omega_h_element.hpp>
 #include <Omega_h_for.hpp>
+#include <Omega_h_indset.hpp>
 #include <Omega_h_inertia.hpp>
+#include <Omega_h_linpart.hpp>
+#include <Omega_h_map.hpp>
+#include <Omega_h_mark.hpp>
+#include <Omega_h_metric.hpp>
 #include <Omega_h_owners.hpp>
+#include <Omega_h_profile.hpp>
+#include <Omega_h_refine.hpp>
+#include <Omega_h_scatterplot.hpp>
 #include <Omega_h_vtk.hpp>
 
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <sstream>
 
 using namespace Omega_h;
@@ -52,6 +65,23 @@ static void test_one_rank(CommPtr comm) {
   }
 }
 
+/* ordered sums are bitwise the same however the copies are ordered,
+   here where the unordered sums are 1 and 2 */
+static void test_ordered_sums(CommPtr comm) {
+  Reals values[2] = {Reals({1e16, 1., 1., 2., -1e16, 3., 1., 4., 0.5, 5.}),
+      Reals({0.5, 5., 1., 4., 1., 2., 1e16, 1., -1e16, 3.})};
+  LOs roots[2] = {LOs({0, 0, 0, 0, 1}), LOs({1, 0, 0, 0, 0})};
+  for (Int i = 0; i < 2; ++i) {
+    Dist dist;
+    dist.set_parent_comm(comm);
+    dist.set_dest_ranks(Read<I32>(5, comm->rank()));
+    dist.set_dest_idxs(roots[i], 2);
+    auto sums = exch_reduce_arrays(
+        dist, {MixedArray(values[i], 2)}, {OMEGA_H_SUM}, true);
+    OMEGA_H_CHECK(sums[0].get<Real>() == Reals({0., 10., 0.5, 5.}));
+  }
+}
+
 static void test_two_ranks_dist(CommPtr comm) {
   OMEGA_H_CHECK(comm->size() == 2);
   Dist dist;
@@ -363,7 +393,280 @@ static void test_binary_io(Library* lib, CommPtr comm) {
       OMEGA_H_SAME == compare_meshes(&mesh0, &mesh2, opts, true, true));
 }
 
-static void test_two_ranks(Library* lib, CommPtr comm) {
+static void test_box_distributed(CommPtr comm) {
+  auto a = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 1., 3, 2, 4);
+  auto b = build_box_distributed(comm, OMEGA_H_SIMPLEX, 1., 1., 1., 3, 2, 4);
+  for (Int ent_dim = 0; ent_dim <= 3; ++ent_dim) {
+    OMEGA_H_CHECK(a.nglobal_ents(ent_dim) == b.nglobal_ents(ent_dim));
+    auto owned_class_id_sum = [=](Mesh* m) {
+      auto ids = m->get_array<ClassId>(ent_dim, "class_id");
+      auto owned = m->owned(ent_dim);
+      return get_sum(comm, read(multiply_each(ids, array_cast<LO>(owned))));
+    };
+    OMEGA_H_CHECK(owned_class_id_sum(&a) == owned_class_id_sum(&b));
+    /* every copy agrees with its owner on its global number and on
+       its vertices, in order */
+    auto globals = b.globals(ent_dim);
+    OMEGA_H_CHECK(b.sync_array(ent_dim, globals, 1) == globals);
+    if (ent_dim > 0) {
+      auto deg = element_degree(OMEGA_H_SIMPLEX, ent_dim, VERT);
+      auto vert_globals =
+          read(unmap(b.ask_verts_of(ent_dim), b.globals(VERT), 1));
+      OMEGA_H_CHECK(b.sync_array(ent_dim, vert_globals, deg) == vert_globals);
+    }
+  }
+  OMEGA_H_CHECK(are_close(get_sum(comm, b.ask_sizes()), 1.0));
+}
+
+static void test_migrate_mixed_tags(CommPtr comm) {
+  auto mesh = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 0., 4, 4, 0);
+  mesh.set_parting(OMEGA_H_ELEM_BASED);
+  auto add_tags = [](Mesh* m) {
+    auto globals = m->globals(VERT);
+    auto n = m->nverts();
+    Write<I8> a(n);
+    Write<I32> b(n * 3);
+    Write<I64> c(n);
+    Write<Real> d(n * 2);
+    auto f = OMEGA_H_LAMBDA(LO v) {
+      auto g = globals[v];
+      a[v] = I8(g % 100);
+      for (Int i = 0; i < 3; ++i) b[v * 3 + i] = I32(g * (i + 1));
+      c[v] = g * 10000000000;
+      d[v * 2 + 0] = Real(g) / 2.0;
+      d[v * 2 + 1] = -Real(g);
+    };
+    parallel_for(n, f);
+    m->add_tag(VERT, "a", 1, Read<I8>(a));
+    m->add_tag(VERT, "b", 3, Read<I32>(b));
+    m->add_tag(VERT, "c", 1, Read<I64>(c));
+    m->add_tag(VERT, "d", 2, Reals(d));
+  };
+  add_tags(&mesh);
+  mesh.set_parting(OMEGA_H_GHOSTED);
+  Mesh expected = mesh;
+  for (auto name : {"a", "b", "c", "d"}) expected.remove_tag(VERT, name);
+  add_tags(&expected);
+  OMEGA_H_CHECK(mesh.get_array<I8>(VERT, "a") ==
+                expected.get_array<I8>(VERT, "a"));
+  OMEGA_H_CHECK(mesh.get_array<I32>(VERT, "b") ==
+                expected.get_array<I32>(VERT, "b"));
+  OMEGA_H_CHECK(mesh.get_array<I64>(VERT, "c") ==
+                expected.get_array<I64>(VERT, "c"));
+  OMEGA_H_CHECK(mesh.get_array<Real>(VERT, "d") ==
+                expected.get_array<Real>(VERT, "d"));
+  auto owners = mesh.ask_owners(VERT);
+  OMEGA_H_CHECK(get_max(comm, owners.ranks) < comm->size());
+}
+
+static void test_sync_arrays(CommPtr comm) {
+  auto mesh = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 0., 4, 4, 0);
+  mesh.set_parting(OMEGA_H_GHOSTED);
+  auto globals = mesh.globals(VERT);
+  auto owned = mesh.owned(VERT);
+  auto n = mesh.nverts();
+  Write<I8> a(n);
+  Write<I64> b(n * 2);
+  Write<Real> c(n * 3);
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    auto g = owned[v] ? globals[v] : GO(-1);
+    a[v] = I8(g % 7);
+    b[v * 2 + 0] = g;
+    b[v * 2 + 1] = -g;
+    for (Int i = 0; i < 3; ++i) c[v * 3 + i] = Real(g) * (i + 1);
+  };
+  parallel_for(n, f);
+  auto synced = mesh.sync_arrays(
+      VERT, {{Read<I8>(a), 1}, {Read<I64>(b), 2}, {Reals(c), 3}});
+  OMEGA_H_CHECK(synced.size() == 3);
+  auto future = mesh.isync_arrays(
+      VERT, {{Read<I8>(a), 1}, {Read<I64>(b), 2}, {Reals(c), 3}});
+  auto isynced = future.get();
+  OMEGA_H_CHECK(synced[0].get<I8>() == mesh.sync_array(VERT, Read<I8>(a), 1));
+  OMEGA_H_CHECK(synced[1].get<I64>() == mesh.sync_array(VERT, Read<I64>(b), 2));
+  OMEGA_H_CHECK(synced[2].get<Real>() == mesh.sync_array(VERT, Reals(c), 3));
+  OMEGA_H_CHECK(isynced[1].get<I64>() == synced[1].get<I64>());
+  OMEGA_H_CHECK(get_min(comm, synced[1].get<I64>()) == -get_max(comm, globals));
+  auto ones = Read<I32>(n, 1);
+  auto reduced = mesh.reduce_arrays(
+      VERT, {{ones, 1}, {Reals(c), 3}}, OMEGA_H_SUM);
+  OMEGA_H_CHECK(
+      reduced[0].get<I32>() == mesh.reduce_array(VERT, ones, 1, OMEGA_H_SUM));
+  OMEGA_H_CHECK(reduced[1].get<Real>() ==
+                mesh.reduce_array(VERT, Reals(c), 3, OMEGA_H_SUM));
+  auto mixed_ops = mesh.reduce_arrays(VERT,
+      {{ones, 1}, {Reals(c), 3}, {Reals(c), 3}},
+      {OMEGA_H_SUM, OMEGA_H_MAX, OMEGA_H_SUM}, true);
+  OMEGA_H_CHECK(mixed_ops[0].get<I32>() == reduced[0].get<I32>());
+  OMEGA_H_CHECK(mixed_ops[1].get<Real>() ==
+                mesh.reduce_array(VERT, Reals(c), 3, OMEGA_H_MAX));
+  OMEGA_H_CHECK(are_close(mixed_ops[2].get<Real>(), reduced[1].get<Real>()));
+}
+
+static void test_vector_collectives(CommPtr comm) {
+  auto rank = comm->rank();
+  std::vector<GO> x = {GO(rank + 1), GO(10 * (rank + 1)), 0, -1};
+  auto sums = comm->allreduce(x, OMEGA_H_SUM);
+  OMEGA_H_CHECK(sums == std::vector<GO>({3, 30, 0, -2}));
+  auto starts = comm->exscan(x, OMEGA_H_SUM);
+  if (rank == 0) OMEGA_H_CHECK(starts == std::vector<GO>({0, 0, 0, 0}));
+  if (rank == 1) OMEGA_H_CHECK(starts == std::vector<GO>({1, 10, 0, -1}));
+  OMEGA_H_CHECK(linear_partition_begin(comm, 7) == GO(rank * 4));
+  std::vector<Real> y = {Real(rank + 1), 2.0, Real(rank), -Real(rank)};
+  comm->allreduce_sum_max(y, 2);
+  OMEGA_H_CHECK(y == std::vector<Real>({3.0, 4.0, 1.0, 0.0}));
+}
+
+static void test_region_interning() {
+  auto a = profile::intern("interned a");
+  OMEGA_H_CHECK(profile::intern("interned a") == a);
+  OMEGA_H_CHECK(profile::intern("interned b") != a);
+  OMEGA_H_CHECK(std::string(profile::get_region_name(a)) == "interned a");
+  profile::History h;
+  h.start(a);
+  h.stop();
+  h.start("interned a");
+  h.stop();
+  OMEGA_H_CHECK(h.frames.size() == 1);
+  OMEGA_H_CHECK(h.calls(0) == 2);
+}
+
+/* rank 1 enters a region nested in a common one, twice */
+static void test_reduce_history(CommPtr comm) {
+  profile::History h;
+  h.start("common");
+  if (comm->rank() == 1) {
+    for (int i = 0; i < 2; ++i) {
+      h.start("only_one");
+      h.stop();
+    }
+  }
+  h.stop();
+  auto ph = profile::reduce_history(h, comm);
+  OMEGA_H_CHECK(ph.comm_size == 2);
+  OMEGA_H_CHECK(ph.frames.size() == 2);
+  auto& common = ph.frames[0];
+  OMEGA_H_CHECK(common.name == "common");
+  OMEGA_H_CHECK(common.parent == profile::invalid);
+  OMEGA_H_CHECK(common.nranks == 2);
+  OMEGA_H_CHECK(common.calls.min == 1.0 && common.calls.max == 1.0);
+  OMEGA_H_CHECK(common.calls.max_rank == 0);
+  auto& only_one = ph.frames[1];
+  OMEGA_H_CHECK(only_one.name == "only_one");
+  OMEGA_H_CHECK(only_one.parent == 0);
+  OMEGA_H_CHECK(only_one.nranks == 1);
+  OMEGA_H_CHECK(only_one.calls.min == 0.0 && only_one.calls.max == 2.0);
+  OMEGA_H_CHECK(only_one.calls.mean == 1.0);
+  OMEGA_H_CHECK(only_one.calls.max_rank == 1);
+  std::stringstream json;
+  profile::write_json(json, ph);
+  OMEGA_H_CHECK(json.str().find("\"name\": \"only_one\", \"parent\": 0") !=
+                std::string::npos);
+}
+
+/* rank 0 sees {A, D} and rank 1 sees {A, A/C, D}, so the order in which
+   rank 0 first meets the frames differs from their pre-order */
+static void test_reduce_history_subsets(CommPtr comm) {
+  profile::History h;
+  h.start("A");
+  if (comm->rank() == 1) {
+    for (int i = 0; i < 3; ++i) {
+      h.start("C");
+      h.stop();
+    }
+  }
+  h.stop();
+  for (int i = 0; i <= comm->rank(); ++i) {
+    h.start("D");
+    h.stop();
+  }
+  auto ph = profile::reduce_history(h, comm);
+  OMEGA_H_CHECK(ph.frames.size() == 3);
+  auto& a = ph.frames[0];
+  OMEGA_H_CHECK(a.name == "A" && a.parent == profile::invalid);
+  OMEGA_H_CHECK(a.nranks == 2 && a.calls.max == 1.0);
+  auto& c = ph.frames[1];
+  OMEGA_H_CHECK(c.name == "C" && c.parent == 0);
+  OMEGA_H_CHECK(c.nranks == 1);
+  OMEGA_H_CHECK(c.calls.min == 0.0 && c.calls.max == 3.0);
+  OMEGA_H_CHECK(c.calls.max_rank == 1);
+  auto& d = ph.frames[2];
+  OMEGA_H_CHECK(d.name == "D" && d.parent == profile::invalid);
+  OMEGA_H_CHECK(d.nranks == 2);
+  OMEGA_H_CHECK(d.calls.min == 1.0 && d.calls.max == 2.0);
+  OMEGA_H_CHECK(d.calls.max_rank == 1);
+}
+
+/* a sampled History reports through the same reduction as a timed one */
+static void test_sampling_profiler(CommPtr comm) {
+  profile::History h;
+  profile::start_sampling(&h, 1e-3);
+  h.start("outer");
+  h.start("inner");
+  volatile double x = 0.0;
+  Now t0 = now();
+  while (now() - t0 < 0.2) x = x + 1.0;
+  h.stop();
+  h.stop();
+  profile::stop_sampling(&h);
+  OMEGA_H_CHECK(!h.is_sampling);
+  OMEGA_H_CHECK(h.frames.size() == 2);
+  OMEGA_H_CHECK(h.calls(1) == 1);
+  OMEGA_H_CHECK(h.time(1) > 0.0);
+  OMEGA_H_CHECK(h.time(0) >= h.time(1));
+  auto ph = profile::reduce_history(h, comm);
+  OMEGA_H_CHECK(ph.frames.size() == 2);
+  OMEGA_H_CHECK(ph.frames[1].time.min > 0.0);
+}
+
+/* after a parallel rebuild, the owned copies of each dimension carry
+   exactly the globals 0 .. n-1, and every copy agrees with its owner */
+static void test_refine_numbering(CommPtr comm) {
+  auto mesh = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 1., 2, 2, 2);
+  mesh.add_tag(VERT, "metric", 1,
+      Reals(mesh.nverts(), metric_eigenvalue_from_length(0.3)));
+  auto opts = AdaptOpts(&mesh);
+  opts.verbosity = SILENT;
+  while (refine_by_size(&mesh, opts))
+    ;
+  for (Int ent_dim = 0; ent_dim <= mesh.dim(); ++ent_dim) {
+    auto globals = mesh.globals(ent_dim);
+    OMEGA_H_CHECK(mesh.sync_array(ent_dim, globals, 1) == globals);
+    auto n = mesh.nglobal_ents(ent_dim);
+    auto owned_globals = unmap(collect_marked(mesh.owned(ent_dim)), globals, 1);
+    auto owned_sum = get_sum(comm, read(owned_globals));
+    OMEGA_H_CHECK(owned_sum == n * (n - 1) / 2);
+    OMEGA_H_CHECK(get_max(comm, globals) == n - 1);
+  }
+}
+
+/* randomized independent sets and colorings only depend on the seed and
+   the global numbers, so every rank count gives the serial answer */
+static void test_random_rank_independence(Library* lib, CommPtr comm) {
+  auto mesh = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 0., 8, 8, 0);
+  mesh.set_parting(OMEGA_H_GHOSTED);
+  auto serial = build_box(lib->self(), OMEGA_H_SIMPLEX, 1., 1., 0., 8, 8, 0);
+  auto check = [&](Int ent_dim, Read<I32> values, Read<I32> serial_values) {
+    auto owned = mesh.owned(ent_dim);
+    auto owned2ents = collect_marked(owned);
+    auto owned_globals = unmap(owned2ents, mesh.globals(ent_dim), 1);
+    Write<LO> serial_ents(owned_globals.size());
+    auto f = OMEGA_H_LAMBDA(LO i) { serial_ents[i] = LO(owned_globals[i]); };
+    parallel_for(serial_ents.size(), f);
+    auto expected = read(unmap(LOs(serial_ents), serial_values, 1));
+    OMEGA_H_CHECK(read(unmap(owned2ents, values, 1)) == expected);
+  };
+  auto indset = [](Mesh* m) {
+    auto n = m->nverts();
+    return array_cast<I32>(find_random_indset(
+        m, VERT, Reals(n, 1.), Read<I8>(n, 1), 3));
+  };
+  check(VERT, indset(&mesh), indset(&serial));
+  check(VERT, color_ents(&mesh, VERT, 3), color_ents(&serial, VERT, 3));
+  check(FACE, color_ents(&mesh, FACE, 5), color_ents(&serial, FACE, 5));
+}
+
+static void test_two_ranks(Library* lib, CommPtr comm, bool can_sample) {
   test_two_ranks_dist(comm);
   test_two_ranks_dist_for_two_variable_sized_actors(comm);
   test_two_rank_for_four_variable_sized_actors(comm);
@@ -374,6 +677,15 @@ static void test_two_ranks(Library* lib, CommPtr comm) {
   test_construct(lib, comm);
   test_read_vtu(lib, comm);
   test_binary_io(lib, comm);
+  test_box_distributed(comm);
+  test_migrate_mixed_tags(comm);
+  test_sync_arrays(comm);
+  test_vector_collectives(comm);
+  test_region_interning();
+  test_reduce_history(comm);
+  test_reduce_history_subsets(comm);
+  if (can_sample) test_sampling_profiler(comm);
+  test_refine_numbering(comm);
 }
 
 void test_rib(CommPtr comm) {
@@ -406,23 +718,206 @@ void test_rib(CommPtr comm) {
   OMEGA_H_CHECK(masses == Reals(n, 1));
 }
 
-int main(int argc, char** argv) {
-  auto lib = Library(&argc, &argv);
-  auto world = lib.world();
+/* enough points that the cut is bracketed by a random sample first */
+static void test_sampled_bisection(CommPtr comm) {
+  auto rank = comm->rank();
+  auto size = comm->size();
+  LO n = 1000;
+  Write<Real> w_coords(n * 3);
+  Write<GO> w_keys(n);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto global = GO(i) * size + rank;
+    set_vector(w_coords, i, vector_3(Real(global * global), 0, 0));
+    w_keys[i] = global;
+  };
+  parallel_for(n, f);
+  Reals masses(n, 1);
+  Vector<3> axis;
+  Real tolerance = 2.5;
+  auto marked = inertia::mark_bisection(
+      comm, Reals(w_coords), masses, tolerance, axis, GOs(w_keys));
+  auto nmarked = get_sum(comm, marked);
+  OMEGA_H_CHECK(std::abs(Real(nmarked) - Real(n * size) / 2.) <= tolerance);
+  OMEGA_H_CHECK(are_close(axis, vector_3(1, 0, 0)));
+}
+
+/* the sampled cuts are opt-in, and the keys travel with their points */
+static void test_sampled_rib(CommPtr comm) {
+  auto rank = comm->rank();
+  auto size = comm->size();
+  LO n = 1000;
+  Write<Real> w_coords(n * 3);
+  Write<GO> w_keys(n);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto global = GO(i) * size + rank;
+    set_vector(w_coords, i, vector_3(Real(global), 0, 0));
+    w_keys[i] = global;
+  };
+  parallel_for(n, f);
+  Reals coords(w_coords);
+  Reals masses(n, 1);
+  GOs keys(w_keys);
+  auto owners = Remotes(Read<I32>(n, rank), LOs(n, 0, 1));
+  auto hints = inertia::Rib();
+  hints.sample_cuts = true;
+  inertia::recursively_bisect(
+      comm, 2.5, &coords, &masses, &owners, &hints, &keys);
+  OMEGA_H_CHECK(keys.size() == masses.size());
+  OMEGA_H_CHECK(std::abs(get_sum(comm, masses) - Real(n * size)) < 1e-10);
+  auto nkeys = keys.size();
+  auto check = OMEGA_H_LAMBDA(LO i) {
+    OMEGA_H_CHECK(get_vector<3>(coords, i)[0] == Real(keys[i]));
+    OMEGA_H_CHECK(GO(owners.idxs[i]) * size + owners.ranks[i] == keys[i]);
+  };
+  parallel_for(nkeys, check);
+  OMEGA_H_CHECK(std::abs(Real(nkeys) - Real(n)) <= 2.5 * Real(size));
+  auto mesh = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 0., 8, 8, 0);
+  auto mesh_hints = std::make_shared<inertia::Rib>();
+  mesh_hints->sample_cuts = true;
+  mesh.set_rib_hints(mesh_hints);
+  mesh.balance();
+  OMEGA_H_CHECK(mesh.rib_hints()->sample_cuts);
+  OMEGA_H_CHECK(mesh.nglobal_ents(mesh.dim()) == 8 * 8 * 2);
+}
+
+static void test_parallel_scatterplot(CommPtr comm) {
+  auto rank = comm->rank();
+  auto size = comm->size();
+  LO n = 100;
+  Write<Real> w_coords(n);
+  Write<Real> w_data(n * 2);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto global = GO(i) * size + rank;
+    w_coords[i] = 50.0 - Real(global);
+    w_data[i * 2 + 0] = Real(global);
+    w_data[i * 2 + 1] = 1.0 / 3.0;
+  };
+  parallel_for(n, f);
+  write_scatterplot("scatter.txt", comm, w_coords, w_data, ",");
+  write_sorted_scatterplot_npy("scatter.npy", comm, w_coords, w_data);
+  if (rank == 0) {
+    GO total = GO(n) * size;
+    std::ifstream text("scatter.txt");
+    std::string line;
+    GO nlines = 0;
+    while (std::getline(text, line)) ++nlines;
+    OMEGA_H_CHECK(nlines == total);
+    std::ifstream npy("scatter.npy", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(npy)),
+        std::istreambuf_iterator<char>());
+    auto header_size = 10 + std::size_t(std::uint8_t(bytes[8])) +
+                       (std::size_t(std::uint8_t(bytes[9])) << 8);
+    OMEGA_H_CHECK(header_size % 64 == 0);
+    OMEGA_H_CHECK(bytes.size() == header_size + std::size_t(total * 3) * 8);
+    std::vector<Real> rows(std::size_t(total * 3));
+    std::memcpy(rows.data(), &bytes[header_size], rows.size() * 8);
+    for (GO i = 0; i < total; ++i) {
+      auto global = Real(total - 1 - i);
+      OMEGA_H_CHECK(rows[std::size_t(i * 3 + 0)] == 50.0 - global);
+      OMEGA_H_CHECK(rows[std::size_t(i * 3 + 1)] == global);
+    }
+  }
+  comm->barrier();
+  write_sorted_scatterplot_npy(
+      "empty.npy", comm, Reals(0, 0.0), Reals(0, 0.0));
+  if (rank == 0) {
+    std::ifstream npy("empty.npy", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(npy)),
+        std::istreambuf_iterator<char>());
+    auto header_size = 10 + std::size_t(std::uint8_t(bytes[8])) +
+                       (std::size_t(std::uint8_t(bytes[9])) << 8);
+    OMEGA_H_CHECK(bytes.size() == header_size);
+  }
+  comm->barrier();
+}
+
+#ifndef OMEGA_H_USE_MPI
+/* each rank sends one number to the next rank around a ring and two
+   to the one after. the futures are waited on in a different order
+   on odd and even ranks */
+static void test_thread_ring(CommPtr comm) {
+  auto rank = comm->rank();
+  auto size = comm->size();
+  auto graph = comm->graph(Read<I32>({(rank + 1) % size, (rank + 2) % size}));
+  auto sources = HostRead<I32>(graph->sources());
+  OMEGA_H_CHECK(sources.size() == 2);
+  /* from the source that sends us its part j, we get j + 1 copies
+     of its rank * 10 + j */
+  auto j0 = (rank - sources[0] + size - 1) % size;
+  auto j1 = (rank - sources[1] + size - 1) % size;
+  HostWrite<I32> h_expected(j0 + j1 + 2);
+  for (LO k = 0; k < h_expected.size(); ++k) {
+    h_expected[k] = (k <= j0) ? (sources[0] * 10 + j0) : (sources[1] * 10 + j1);
+  }
+  auto expected = Read<I32>(h_expected.write());
+  auto sendbuf = Read<I32>({rank * 10, rank * 10 + 1, rank * 10 + 1});
+  auto sdispls = LOs({0, 1, 3});
+  auto rdispls = LOs({0, j0 + 1, j0 + j1 + 2});
+  auto first = graph->ialltoallv(sendbuf, sdispls, rdispls, 1);
+  auto second = graph->ialltoallv(sendbuf, sdispls, rdispls, 1);
+  if (rank % 2) {
+    OMEGA_H_CHECK(second.get() == expected);
+    while (!first.completed())
+      ;
+    OMEGA_H_CHECK(first.get() == expected);
+  } else {
+    OMEGA_H_CHECK(first.get() == expected);
+    OMEGA_H_CHECK(second.get() == expected);
+  }
+  /* a future dropped on some ranks still delivers to the others */
+  {
+    auto third = graph->ialltoallv(sendbuf, sdispls, rdispls, 1);
+    if (rank % 2) OMEGA_H_CHECK(third.get() == expected);
+  }
+  OMEGA_H_CHECK(graph->allgather(rank) == graph->sources());
+  OMEGA_H_CHECK(comm->exscan(I64(rank), OMEGA_H_SUM) == rank * (rank - 1) / 2);
+  auto name = std::string(rank == 0 ? "root" : "other");
+  comm->bcast_string(name);
+  OMEGA_H_CHECK(name == "root");
+}
+
+static void test_thread_ranks(Library* lib) {
+  auto traffic = run_thread_ranks(lib, 3, test_thread_ring);
+  OMEGA_H_CHECK(traffic.size() == 3);
+  for (auto& rank_traffic : traffic) {
+    OMEGA_H_CHECK(rank_traffic.messages == 4 * 2);
+    OMEGA_H_CHECK(rank_traffic.bytes == 3 * 3 * 4 + 2 * 4);
+  }
+}
+#endif
+
+static void run_tests(Library* lib, CommPtr world, bool can_sample) {
   if (world->rank() == 0) {
-    test_one_rank(lib.self());
+    test_one_rank(lib->self());
   }
   auto one = world->split(world->rank(), 0);
   if (world->rank() == 0) {
     test_one_rank(one);
     test_one_rank(one->dup());
+    test_ordered_sums(one);
   }
   if (world->size() >= 2) {
     auto two = world->split(world->rank() / 2, world->rank() % 2);
     if (world->rank() / 2 == 0) {
-      test_two_ranks(&lib, two);
+      test_two_ranks(lib, two, can_sample);
     }
   }
   world->barrier();
   test_rib(world);
+  test_sampled_bisection(world);
+  test_sampled_rib(world);
+  test_random_rank_independence(lib, world);
+  test_parallel_scatterplot(world);
+}
+
+int main(int argc, char** argv) {
+  auto lib = Library(&argc, &argv);
+  run_tests(&lib, lib.world(), true);
+#ifndef OMEGA_H_USE_MPI
+  test_thread_ranks(&lib);
+  /* the sampling profiler is process-wide, so ranks that are
+     threads can not each sample themselves */
+  run_thread_ranks(
+      &lib, 4, [&](CommPtr world) { run_tests(&lib, world, false); });
+#endif
 }
@@ -35,6 +35,10 @@ int main(int argc, char** argv) {
   }
   Omega_h::Mesh mesh(&lib);
   Omega_h::binary::read(inpath, lib.world(), &mesh);
-  Omega_h::exodus::write(outpath, &mesh, verbose, classify_with);
+  if (comm->size() == 1) {
+    Omega_h::exodus::write(outpath, &mesh, verbose, classify_with);
+  } else {
+    Omega_h::exodus::write_parallel(outpath, &mesh, verbose, classify_with);
+  }
   return 0;
 }
@@ -20,6 +20,7 @@ int main(int argc, char** argv) {
   cmdline.add_arg<std::string>("output.osh");
   auto& family_flag = cmdline.add_flag("--family", "simplex or hypercube");
   cmdline.add_flag("--symmetric", "split hypercubes symmetrically");
+  cmdline.add_flag("--distributed", "generate one block of the box per rank");
   family_flag.add_arg<std::string>("type");
   if (!cmdline.parse_final(world, &argc, argv)) return -1;
   auto x = cmdline.get<double>("length");
@@ -43,7 +44,16 @@ int main(int argc, char** argv) {
     }
   }
   auto symmetric = cmdline.parsed("--symmetric");
-  auto mesh = Omega_h::build_box(world, family, x, y, z, nx, ny, nz, symmetric);
+  Omega_h::Mesh mesh(&lib);
+  if (cmdline.parsed("--distributed")) {
+    if (symmetric) {
+      std::cout << "--distributed does not support --symmetric\n";
+      return -1;
+    }
+    mesh = Omega_h::build_box_distributed(world, family, x, y, z, nx, ny, nz);
+  } else {
+    mesh = Omega_h::build_box(world, family, x, y, z, nx, ny, nz, symmetric);
+  }
   Omega_h::binary::write(outdir, &mesh);
   return 0;
 }
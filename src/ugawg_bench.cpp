@@ -0,0 +1,533 @@
+#include <Omega_h_adapt.hpp>
+#include <Omega_h_array_ops.hpp>
+#include <Omega_h_build.hpp>
+#include <Omega_h_cmdline.hpp>
+#include <Omega_h_file.hpp>
+#include <Omega_h_histogram.hpp>
+#include <Omega_h_library.hpp>
+#include <Omega_h_mesh.hpp>
+#include <Omega_h_metric.hpp>
+#include <Omega_h_profile.hpp>
+#include <Omega_h_shared_alloc.hpp>
+#include <Omega_h_timer.hpp>
+#include <Omega_h_ugawg.hpp>
+
+#ifdef OMEGA_H_USE_OPENMP
+#include <omp.h>
+#endif
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+// runs the UGAWG adaptation benchmarks on a generated (or given) mesh and
+// records, per case, the wall time of each profiled phase, the memory high
+// water mark and the size and quality of the result as JSON. given a
+// baseline from an earlier run, it reports every metric that moved outside
+// its tolerance and exits with an error. ugawg_bench_baseline.json holds
+// the metrics of the small test run that do not depend on the machine.
+//
+// thread counts come from the usual places (OMP_NUM_THREADS,
+// --kokkos-threads=N), rank counts from mpirun. the cases that need
+// input data (hsc) are not included; run them through --input instead.
+
+using namespace Omega_h;
+
+namespace {
+
+constexpr Int dim = 3;
+
+struct Options {
+  std::vector<std::string> cases;
+  Real scale;
+  LO divisions;
+  std::string input_path;
+  Int phase_depth;
+  Real min_quality_allowed;
+};
+
+std::vector<std::string> split_list(std::string const& s) {
+  std::vector<std::string> out;
+  std::stringstream stream(s);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) out.push_back(item);
+  }
+  return out;
+}
+
+/* the polar metrics are meant for the cylinder geometry. on the cube
+   they take many small steps, so they only run when asked for */
+std::vector<std::string> get_default_cases() {
+  return {"cube-linear", "cube-cylinder-linear", "cone-cone", "parallel-adapt"};
+}
+
+bool is_case(std::string const& name) {
+  return is_ugawg_metric(name) || name == "cone-cone" ||
+         name == "parallel-adapt";
+}
+
+int get_nthreads() {
+#if defined(OMEGA_H_USE_OPENMP)
+  return omp_get_max_threads();
+#elif defined(OMEGA_H_USE_KOKKOS)
+  return int(Kokkos::DefaultExecutionSpace::concurrency());
+#else
+  return 1;
+#endif
+}
+
+Mesh get_initial_mesh(Library* lib, Options const& opts) {
+  if (!opts.input_path.empty()) {
+    return binary::read(opts.input_path, lib->world());
+  }
+  auto n = opts.divisions;
+  return build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., n, n, n);
+}
+
+/* (scale) multiplies the number of elements each case asks for */
+void set_target_metric(
+    Mesh* mesh, std::string const& name, Real scale, GO base_nelems) {
+  Reals metrics;
+  if (is_ugawg_metric(name)) {
+    metrics = get_ugawg_metric(mesh, name);
+  } else if (name == "cone-cone") {
+    auto metric = diagonal(
+        metric_eigenvalues_from_lengths(vector_3(0.1, 0.1, 0.1)));
+    metrics = repeat_symm(mesh->nverts(), metric);
+  } else {
+    OMEGA_H_CHECK(name == "parallel-adapt");
+    auto implied = mesh->get_array<Real>(VERT, "metric");
+    auto nelems = Real(base_nelems) * Real(mesh->comm()->size());
+    auto scalar = get_metric_scalar_for_nelems(mesh, implied, nelems);
+    metrics = multiply_each_by(implied, scalar);
+    scale = 1.0;
+  }
+  metrics = multiply_each_by(metrics, std::pow(scale, 2.0 / Real(dim)));
+  /* as ugawg_cylinder does for its boundary layer metric */
+  if (name == "cube-cylinder-polar-1") {
+    metrics = limit_metric_gradation(mesh, metrics, 1.0, 1e-2, false);
+  }
+  mesh->add_tag(VERT, "target_metric", symm_ncomps(dim), metrics);
+}
+
+void set_implied_metric(Mesh* mesh, bool should_limit) {
+  auto metrics = get_implied_metrics(mesh);
+  if (should_limit) {
+    metrics = limit_metric_gradation(mesh, metrics, 1.0, 1e-2, false);
+  }
+  mesh->add_tag(VERT, "metric", symm_ncomps(dim), metrics);
+}
+
+/* elements per rank of the parallel-adapt case, before scaling */
+constexpr GO parallel_adapt_nelems = 20000;
+
+I64 run_case(Mesh* mesh, std::string const& name, Options const& opts) {
+  auto is_analytic = is_ugawg_metric(name);
+  auto base_nelems = GO(std::ceil(opts.scale * Real(parallel_adapt_nelems)));
+  {
+    ScopedTimer timer("setup");
+    if (name == "parallel-adapt") mesh->balance();
+    mesh->set_parting(OMEGA_H_GHOSTED);
+    set_implied_metric(mesh, !is_analytic);
+    set_target_metric(mesh, name, opts.scale, base_nelems);
+    mesh->set_parting(OMEGA_H_ELEM_BASED);
+    mesh->ask_lengths();
+    mesh->ask_qualities();
+  }
+  ScopedTimer timer("adapt loop");
+  auto adapt_opts = AdaptOpts(mesh);
+  adapt_opts.verbosity = SILENT;
+  adapt_opts.max_length_allowed = adapt_opts.max_length_desired * 2.0;
+  if (opts.min_quality_allowed > 0.0) {
+    adapt_opts.min_quality_allowed = opts.min_quality_allowed;
+  }
+  I64 niterations = 0;
+  while (approach_metric(mesh, adapt_opts)) {
+    adapt(mesh, adapt_opts);
+    ++niterations;
+    if (is_analytic && mesh->has_tag(VERT, "target_metric")) {
+      set_target_metric(mesh, name, opts.scale, base_nelems);
+    }
+  }
+  if (name == "cube-cylinder-polar-2") {
+    adapt(mesh, adapt_opts);
+    ++niterations;
+  }
+  return niterations;
+}
+
+void write_json_string(std::ostream& stream, std::string const& s) {
+  stream << '"';
+  for (auto c : s) {
+    if (c == '"' || c == '\\') stream << '\\';
+    stream << c;
+  }
+  stream << '"';
+}
+
+void write_json_stats(std::ostream& stream, FieldStats const& stats) {
+  stream << "{\"min\": " << stats.actual.min << ", \"mean\": " << stats.mean
+         << ", \"max\": " << stats.actual.max << "}";
+}
+
+/* the phases are the profile regions up to (depth) levels below the
+   root of the case, named by their path. times are maxima over ranks */
+void write_json_phases(std::ostream& stream,
+    profile::ParallelHistory const& history, Int depth) {
+  std::vector<std::string> paths(history.frames.size());
+  std::vector<Int> depths(history.frames.size(), 0);
+  bool is_first = true;
+  stream << "{";
+  for (std::size_t i = 0; i < history.frames.size(); ++i) {
+    auto& frame = history.frames[i];
+    if (frame.parent == profile::invalid) {
+      paths[i] = frame.name;
+      depths[i] = 1;
+    } else {
+      paths[i] = paths[frame.parent] + "/" + frame.name;
+      depths[i] = depths[frame.parent] + 1;
+    }
+    if (depths[i] > depth) continue;
+    stream << (is_first ? "\n        " : ",\n        ");
+    is_first = false;
+    write_json_string(stream, paths[i]);
+    stream << ": {\"time\": " << frame.time.max
+           << ", \"calls\": " << frame.calls.max << "}";
+  }
+  stream << (is_first ? "}" : "\n      }");
+}
+
+void bench_case(Library* lib, std::string const& name, Options const& opts,
+    std::ostream& json) {
+  auto comm = lib->world();
+  auto mesh = get_initial_mesh(lib, opts);
+  /* a fresh profile and high water mark for each case */
+  auto const outer_history = profile::global_singleton_history;
+  profile::History history;
+  profile::global_singleton_history = &history;
+  global_allocs->high_water_bytes = global_allocs->total_bytes;
+  global_allocs->high_water_records.clear();
+  comm->barrier();
+  auto t0 = now();
+  auto niterations = run_case(&mesh, name, opts);
+  comm->barrier();
+  auto t1 = now();
+  profile::global_singleton_history = outer_history;
+  auto wall_time = comm->allreduce(Real(t1 - t0), OMEGA_H_MAX);
+  auto peak_bytes =
+      comm->allreduce(I64(global_allocs->high_water_bytes), OMEGA_H_MAX);
+  auto phases = profile::reduce_history(history, comm);
+  auto adapt_opts = AdaptOpts(&mesh);
+  auto stats = get_field_stats(&mesh,
+      {{dim, Reals(), {adapt_opts.min_quality_desired, 1.0}, 0, 0.0, 1.0,
+           STATS_QUALITY},
+          {EDGE, Reals(),
+              {adapt_opts.min_length_desired, adapt_opts.max_length_desired},
+              0, 0.0, 0.0, STATS_LENGTH}});
+  auto nelems = mesh.nglobal_ents(dim);
+  auto nverts = mesh.nglobal_ents(VERT);
+  if (comm->rank() == 0) {
+    std::cout << name << ": " << nelems << " elements, " << wall_time
+              << " seconds, " << peak_bytes << " peak bytes\n";
+  }
+  json << "    ";
+  write_json_string(json, name);
+  json << ": {\n      \"wall_time\": " << wall_time
+       << ",\n      \"peak_bytes\": " << peak_bytes
+       << ",\n      \"iterations\": " << niterations
+       << ",\n      \"nelems\": " << nelems << ",\n      \"nverts\": " << nverts
+       << ",\n      \"quality\": ";
+  write_json_stats(json, stats[0]);
+  json << ",\n      \"length\": ";
+  write_json_stats(json, stats[1]);
+  json << ",\n      \"phases\": ";
+  write_json_phases(json, phases, opts.phase_depth);
+  json << "\n    }";
+}
+
+/* just enough JSON to read back what this program writes: the numbers
+   of nested objects, keyed by their dot-separated path */
+typedef std::map<std::string, Real> FlatJson;
+
+struct JsonReader {
+  std::string const& text;
+  std::size_t pos;
+  void skip_space() {
+    while (pos < text.size() && std::isspace(int(text[pos]))) ++pos;
+  }
+  bool accept(char c) {
+    skip_space();
+    if (pos < text.size() && text[pos] == c) {
+      ++pos;
+      return true;
+    }
+    return false;
+  }
+  void expect(char c) {
+    if (!accept(c)) {
+      Omega_h_fail("JSON: expected '%c' at offset %zu\n", c, pos);
+    }
+  }
+  std::string read_string() {
+    expect('"');
+    std::string out;
+    while (pos < text.size() && text[pos] != '"') {
+      if (text[pos] == '\\') ++pos;
+      if (pos < text.size()) out.push_back(text[pos++]);
+    }
+    expect('"');
+    return out;
+  }
+  void read_value(std::string const& path, FlatJson* out) {
+    skip_space();
+    if (accept('{')) {
+      if (accept('}')) return;
+      do {
+        auto key = read_string();
+        expect(':');
+        read_value(path.empty() ? key : (path + "." + key), out);
+      } while (accept(','));
+      expect('}');
+    } else if (accept('[')) {
+      if (accept(']')) return;
+      std::size_t i = 0;
+      do {
+        read_value(path + "." + std::to_string(i++), out);
+      } while (accept(','));
+      expect(']');
+    } else if (pos < text.size() && text[pos] == '"') {
+      read_string();
+    } else {
+      auto begin = text.c_str() + pos;
+      char* end;
+      auto value = std::strtod(begin, &end);
+      if (end == begin) {
+        /* true, false and null carry nothing to compare */
+        while (pos < text.size() && std::isalpha(int(text[pos]))) ++pos;
+        if (text.c_str() + pos == begin) {
+          Omega_h_fail("JSON: unexpected character at offset %zu\n", pos);
+        }
+        return;
+      }
+      pos += std::size_t(end - begin);
+      (*out)[path] = value;
+    }
+  }
+};
+
+FlatJson read_flat_json(std::string const& text) {
+  FlatJson out;
+  JsonReader reader{text, 0};
+  reader.read_value("", &out);
+  return out;
+}
+
+struct Tolerances {
+  Real time;     // relative slowdown
+  Real memory;   // relative growth
+  Real count;    // relative change either way
+  Real quality;  // absolute drop
+  Real min_time;  // times below this are noise
+};
+
+bool ends_with(std::string const& s, std::string const& suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/* checks every metric of the baseline that has a tolerance, printing
+   each one that regressed. returns the number of regressions */
+int compare_to_baseline(
+    FlatJson const& baseline, FlatJson const& current, Tolerances const& tol) {
+  int nregressions = 0;
+  int nchecked = 0;
+  auto report = [&](std::string const& key, Real before, Real after,
+                    char const* why) {
+    std::cout << "REGRESSION " << key << ": " << before << " -> " << after
+              << " (" << why << ")\n";
+    ++nregressions;
+  };
+  for (auto& entry : baseline) {
+    auto& key = entry.first;
+    auto before = entry.second;
+    auto it = current.find(key);
+    auto is_config = (key == "comm_size" || key == "threads" ||
+                      key == "scale" || key == "divisions");
+    auto is_time = ends_with(key, ".time") || ends_with(key, ".wall_time");
+    auto is_memory = ends_with(key, ".peak_bytes");
+    auto is_count = ends_with(key, ".nelems") || ends_with(key, ".nverts") ||
+                    ends_with(key, ".iterations");
+    auto is_quality =
+        ends_with(key, ".quality.min") || ends_with(key, ".quality.mean");
+    if (!(is_config || is_time || is_memory || is_count || is_quality)) {
+      continue;
+    }
+    if (it == current.end()) {
+      /* phases come and go as the code changes, cases should not */
+      if (key.find(".phases.") == std::string::npos) {
+        std::cout << "MISSING " << key << '\n';
+        ++nregressions;
+      }
+      continue;
+    }
+    auto after = it->second;
+    ++nchecked;
+    if (is_config) {
+      if (after != before) report(key, before, after, "different setup");
+    } else if (is_time) {
+      if (before >= tol.min_time && after > before * (1.0 + tol.time)) {
+        report(key, before, after, "slower");
+      }
+    } else if (is_memory) {
+      if (after > before * (1.0 + tol.memory)) {
+        report(key, before, after, "more memory");
+      }
+    } else if (is_count) {
+      if (std::abs(after - before) > tol.count * before) {
+        report(key, before, after, "different size");
+      }
+    } else if (after < before - tol.quality) {
+      report(key, before, after, "worse quality");
+    }
+  }
+  std::cout << nchecked << " metrics compared to the baseline, "
+            << nregressions << " regressions\n";
+  return nregressions;
+}
+
+}  // end anonymous namespace
+
+int main(int argc, char** argv) {
+  auto lib = Library(&argc, &argv);
+  /* tracking must start before the first array is allocated. only the
+     peak byte count is kept, so the timings do not pay for listing the
+     arrays at each new peak (--osh-memory still gets its list) */
+  if (!global_allocs) {
+    start_tracking_allocations();
+    global_allocs->keeps_high_water_records = false;
+  }
+  auto world = lib.world();
+  CmdLine cmdline;
+  auto& cases_flag = cmdline.add_flag("--cases",
+      "comma-separated cases from cube-linear,cube-cylinder-linear,"
+      "cube-cylinder-polar-1,cube-cylinder-polar-2,cone-cone,parallel-adapt "
+      "(default all but the polar ones)");
+  cases_flag.add_arg<std::string>("names");
+  auto& scale_flag =
+      cmdline.add_flag("--scale", "multiplies the target element counts");
+  scale_flag.add_arg<double>("factor");
+  auto& divisions_flag =
+      cmdline.add_flag("--divisions", "divisions of the initial unit cube");
+  divisions_flag.add_arg<int>("n");
+  auto& input_flag = cmdline.add_flag("--input", "initial mesh, not a cube");
+  input_flag.add_arg<std::string>("mesh.osh");
+  auto& depth_flag =
+      cmdline.add_flag("--phase-depth", "profile levels recorded per case");
+  depth_flag.add_arg<int>("levels");
+  auto& quality_allowed_flag = cmdline.add_flag("--min-quality-allowed",
+      "lower quality limit of the adaptation, for the polar cases");
+  quality_allowed_flag.add_arg<double>("quality");
+  auto& json_flag = cmdline.add_flag("--json", "where to write the results");
+  json_flag.add_arg<std::string>("results.json");
+  auto& baseline_flag =
+      cmdline.add_flag("--baseline", "results to compare against");
+  baseline_flag.add_arg<std::string>("baseline.json");
+  auto& time_flag =
+      cmdline.add_flag("--time-tolerance", "allowed relative slowdown");
+  time_flag.add_arg<double>("fraction");
+  auto& memory_flag = cmdline.add_flag(
+      "--memory-tolerance", "allowed relative growth of peak memory");
+  memory_flag.add_arg<double>("fraction");
+  auto& count_flag = cmdline.add_flag(
+      "--count-tolerance", "allowed relative change of entity counts");
+  count_flag.add_arg<double>("fraction");
+  auto& quality_flag = cmdline.add_flag(
+      "--quality-tolerance", "allowed drop of minimum and mean quality");
+  quality_flag.add_arg<double>("amount");
+  auto& min_time_flag = cmdline.add_flag(
+      "--min-time", "times below this many seconds are not compared");
+  min_time_flag.add_arg<double>("seconds");
+  if (!cmdline.parse_final(world, &argc, argv)) return -1;
+  Options opts;
+  opts.cases = cmdline.parsed("--cases")
+                   ? split_list(cmdline.get<std::string>("--cases", "names"))
+                   : get_default_cases();
+  opts.scale = cmdline.parsed("--scale")
+                   ? cmdline.get<double>("--scale", "factor")
+                   : 1.0;
+  opts.divisions = cmdline.parsed("--divisions")
+                       ? cmdline.get<int>("--divisions", "n")
+                       : 4;
+  if (cmdline.parsed("--input")) {
+    opts.input_path = cmdline.get<std::string>("--input", "mesh.osh");
+  }
+  opts.phase_depth = cmdline.parsed("--phase-depth")
+                         ? cmdline.get<int>("--phase-depth", "levels")
+                         : 3;
+  opts.min_quality_allowed =
+      cmdline.parsed("--min-quality-allowed")
+          ? cmdline.get<double>("--min-quality-allowed", "quality")
+          : 0.0;
+  for (auto& name : opts.cases) {
+    if (!is_case(name)) {
+      Omega_h_fail("no benchmark case named %s\n", name.c_str());
+    }
+  }
+  std::stringstream json;
+  json << std::setprecision(17);
+  json << "{\n  \"comm_size\": " << world->size()
+       << ",\n  \"threads\": " << get_nthreads()
+       << ",\n  \"scale\": " << opts.scale
+       << ",\n  \"divisions\": " << opts.divisions << ",\n  \"cases\": {\n";
+  for (std::size_t i = 0; i < opts.cases.size(); ++i) {
+    if (i) json << ",\n";
+    bench_case(&lib, opts.cases[i], opts, json);
+  }
+  json << "\n  }\n}\n";
+  int nregressions = 0;
+  if (world->rank() == 0) {
+    auto json_path = cmdline.parsed("--json")
+                         ? cmdline.get<std::string>("--json", "results.json")
+                         : std::string("ugawg_bench.json");
+    std::ofstream file(json_path.c_str());
+    OMEGA_H_CHECK(file.is_open());
+    file << json.str();
+    std::cout << "wrote " << json_path << '\n';
+    if (cmdline.parsed("--baseline")) {
+      auto baseline_path =
+          cmdline.get<std::string>("--baseline", "baseline.json");
+      std::ifstream baseline_file(baseline_path.c_str());
+      if (!baseline_file.is_open()) {
+        Omega_h_fail("couldn't open baseline %s\n", baseline_path.c_str());
+      }
+      std::stringstream baseline_text;
+      baseline_text << baseline_file.rdbuf();
+      Tolerances tol;
+      tol.time = cmdline.parsed("--time-tolerance")
+                     ? cmdline.get<double>("--time-tolerance", "fraction")
+                     : 0.25;
+      tol.memory = cmdline.parsed("--memory-tolerance")
+                       ? cmdline.get<double>("--memory-tolerance", "fraction")
+                       : 0.10;
+      tol.count = cmdline.parsed("--count-tolerance")
+                      ? cmdline.get<double>("--count-tolerance", "fraction")
+                      : 0.05;
+      tol.quality = cmdline.parsed("--quality-tolerance")
+                        ? cmdline.get<double>("--quality-tolerance", "amount")
+                        : 0.02;
+      tol.min_time = cmdline.parsed("--min-time")
+                         ? cmdline.get<double>("--min-time", "seconds")
+                         : 0.05;
+      nregressions = compare_to_baseline(read_flat_json(baseline_text.str()),
+          read_flat_json(json.str()), tol);
+    }
+  }
+  world->bcast(nregressions);
+  return nregressions ? 2 : 0;
+}
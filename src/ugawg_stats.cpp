@@ -6,6 +6,7 @@
 #include <Omega_h_histogram.hpp>
 #include <Omega_h_mesh.hpp>
 #include <Omega_h_metric.hpp>
+#include <Omega_h_ugawg.hpp>
 
 #include <iostream>
 
@@ -13,99 +14,11 @@ using namespace Omega_h;
 
 constexpr Int dim = 3;
 
-static Reals get_cube_linear_metric(Mesh* mesh) {
-  auto coords = mesh->coords();
-  auto out = Write<Real>(mesh->nverts() * symm_ncomps(dim));
-  auto f = OMEGA_H_LAMBDA(LO v) {
-    auto z = coords[v * dim + (dim - 1)];
-    auto h = Vector<dim>();
-    for (Int i = 0; i < dim - 1; ++i) h[i] = 0.1;
-    h[dim - 1] = 0.001 + 0.198 * std::abs(z - 0.5);
-    auto m = diagonal(metric_eigenvalues_from_lengths(h));
-    set_symm(out, v, m);
-  };
-  parallel_for(mesh->nverts(), f);
-  return out;
-}
-
-static Reals get_cube_cylinder_shock_metric(Mesh* mesh) {
-  auto coords = mesh->coords();
-  auto out = Write<Real>(mesh->nverts() * symm_ncomps(dim));
-  constexpr Real h0 = 0.001;
-  auto f = OMEGA_H_LAMBDA(LO v) {
-    auto p = get_vector<dim>(coords, v);
-    auto z = p[2];
-    auto h = vector_3(0.1, 0.1, h0 + 2 * (0.1 - h0) * std::abs(z - 0.5));
-    auto m = diagonal(metric_eigenvalues_from_lengths(h));
-    set_symm(out, v, m);
-  };
-  parallel_for(mesh->nverts(), f);
-  return out;
-}
-
-static Reals get_cube_cylinder_layer_metric(Mesh* mesh) {
-  auto coords = mesh->coords();
-  auto out = Write<Real>(mesh->nverts() * symm_ncomps(dim));
-  constexpr Real h0 = 0.001;
-  constexpr Real h_z = 1.0 / 10.0;
-  constexpr Real h_t = 1.0 / 10.0;
-  auto f = OMEGA_H_LAMBDA(LO v) {
-    auto p = get_vector<dim>(coords, v);
-    auto x = p[0];
-    auto y = p[1];
-    auto xy = vector_2(x, y);
-    auto radius = norm(xy);
-    auto t = std::atan2(y, x);
-    auto h = vector_3(h0 + 2 * (0.1 - h0) * std::abs(radius - 0.5), h_t, h_z);
-    auto rotation = rotate(t, vector_3(0, 0, 1));
-    auto m = compose_metric(rotation, h);
-    set_symm(out, v, m);
-  };
-  parallel_for(mesh->nverts(), f);
-  return out;
-}
-
-static Reals get_cube_cylinder_quality_layer_metric(Mesh* mesh) {
-  auto coords = mesh->coords();
-  auto out = Write<Real>(mesh->nverts() * symm_ncomps(dim));
-  constexpr Real h0 = 0.001;
-  constexpr Real h_z = 1.0 / 10.0;
-  auto f = OMEGA_H_LAMBDA(LO v) {
-    auto p = get_vector<dim>(coords, v);
-    auto x = p[0];
-    auto y = p[1];
-    auto xy = vector_2(x, y);
-    auto radius = norm(xy);
-    auto t = std::atan2(y, x);
-    auto d = (0.6 - radius) * 10.0;
-    Real h_t = (d < 0.0) ? (1.0 / 10.0)
-                         : (d * (1.0 / 40.0) + (1.0 - d) * (1.0 / 10.0));
-    auto h = vector_3(h0 + 2 * (0.1 - h0) * std::abs(radius - 0.5), h_t, h_z);
-    auto rotation = rotate(t, vector_3(0, 0, 1));
-    auto m = compose_metric(rotation, h);
-    set_symm(out, v, m);
-  };
-  parallel_for(mesh->nverts(), f);
-  return out;
-}
-
 static Reals get_metric(Mesh* mesh, std::string const& name) {
   if (name == "implied") {
     return get_implied_metrics(mesh);
   }
-  if (name == "cube-linear") {
-    return get_cube_linear_metric(mesh);
-  }
-  if (name == "cube-cylinder-linear") {
-    return get_cube_cylinder_shock_metric(mesh);
-  }
-  if (name == "cube-cylinder-polar-1") {
-    return get_cube_cylinder_layer_metric(mesh);
-  }
-  if (name == "cube-cylinder-polar-2") {
-    return get_cube_cylinder_quality_layer_metric(mesh);
-  }
-  Omega_h_fail("no UGAWG metric named %s\n", name.c_str());
+  return get_ugawg_metric(mesh, name);
 }
 
 int main(int argc, char** argv) {
@@ -178,10 +91,15 @@ int main(int argc, char** argv) {
   auto metrics = get_metric(&mesh, metric_name);
   mesh.add_tag(VERT, "metric", symm_ncomps(dim), metrics);
   print_adapt_status(&mesh, opts);
-  auto qh = get_histogram(&mesh, mesh.dim(), opts.nquality_histogram_bins, 0.0,
-      1.0, mesh.ask_qualities());
-  auto lh = get_histogram(&mesh, EDGE, opts.nlength_histogram_bins,
-      opts.length_histogram_min, opts.length_histogram_max, mesh.ask_lengths());
+  auto stats = get_field_stats(&mesh,
+      {{mesh.dim(), Reals(), {0.0, 1.0}, opts.nquality_histogram_bins, 0.0,
+           1.0, STATS_QUALITY},
+          {EDGE, Reals(),
+              {opts.length_histogram_min, opts.length_histogram_max},
+              opts.nlength_histogram_bins, opts.length_histogram_min,
+              opts.length_histogram_max, STATS_LENGTH}});
+  auto qh = stats[0].histogram;
+  auto lh = stats[1].histogram;
   if (cmdline.parsed("-f")) {
     auto qf = cmdline.get<std::string>("-f", "quality-histogram-file");
     auto lf = cmdline.get<std::string>("-f", "length-histogram-file");
@@ -8,6 +8,7 @@
 #include "Omega_h_linpart.hpp"
 #include "Omega_h_map.hpp"
 #include "Omega_h_mark.hpp"
+#include "Omega_h_mixed.hpp"
 #include "Omega_h_sort.hpp"
 
 using namespace Omega_h;
@@ -309,6 +310,29 @@ static void test_array_from_kokkos() {
 #endif
 }
 
+static void test_pack_arrays() {
+  std::vector<MixedArray> arrays = {{Read<I8>({1, 2, 3}), 1},
+      {Read<I64>({-4, 5, -6, 7, -8, 9}), 2}, {Reals({0.5, 1.5, 2.5}), 1},
+      {Read<I32>({10, 11, 12}), 1}};
+  OMEGA_H_CHECK(get_packed_width(arrays) == 1 + 16 + 8 + 4);
+  auto packed = pack_arrays(arrays);
+  OMEGA_H_CHECK(packed.size() == 3 * 29);
+  auto unpacked = unpack_arrays(packed, arrays);
+  OMEGA_H_CHECK(unpacked.size() == 4);
+  OMEGA_H_CHECK(unpacked[0].get<I8>() == arrays[0].get<I8>());
+  OMEGA_H_CHECK(unpacked[1].get<I64>() == arrays[1].get<I64>());
+  OMEGA_H_CHECK(unpacked[1].width() == 2);
+  OMEGA_H_CHECK(unpacked[2].get<Real>() == arrays[2].get<Real>());
+  OMEGA_H_CHECK(unpacked[3].get<I32>() == arrays[3].get<I32>());
+  OMEGA_H_CHECK(get_packing_batches(arrays, 3) ==
+                std::vector<std::size_t>({0, 4}));
+  OMEGA_H_CHECK(get_packing_batches(arrays, 3, 60) ==
+                std::vector<std::size_t>({0, 2, 4}));
+  OMEGA_H_CHECK(get_packing_batches(arrays, 3, 24) ==
+                std::vector<std::size_t>({0, 1, 2, 3, 4}));
+  OMEGA_H_CHECK(get_packing_batches({}, 3) == std::vector<std::size_t>({0}));
+}
+
 int main(int argc, char** argv) {
   auto lib = Library(&argc, &argv);
   OMEGA_H_CHECK(std::string(lib.version()) == OMEGA_H_SEMVER);
@@ -332,4 +356,5 @@ int main(int argc, char** argv) {
   test_expr();
   test_expr2();
   test_array_from_kokkos();
+  test_pack_arrays();
 }
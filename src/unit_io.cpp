@@ -1,20 +1,28 @@
 #include "Omega_h_array_ops.hpp"
 #include "Omega_h_build.hpp"
 #include "Omega_h_compare.hpp"
+#include "Omega_h_element.hpp"
+#include "Omega_h_file.hpp"
+#include "Omega_h_map.hpp"
+#include "Omega_h_osh_stream.hpp"
 #include "Omega_h_vtk.hpp"
 #include "Omega_h_xml_lite.hpp"
 
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <locale>
 #include <sstream>
 
 #ifdef OMEGA_H_USE_GMSH
 #include <gmsh.h>
-#include "Omega_h_element.hpp"
 #include "Omega_h_shape.hpp"
 #endif  // OMEGA_H_USE_GMSH
 
+#ifdef OMEGA_H_USE_SEACASEXODUS
+#include <exodusII.h>
+#endif  // OMEGA_H_USE_SEACASEXODUS
+
 using namespace Omega_h;
 
 #ifdef OMEGA_H_USE_GMSH
@@ -986,6 +994,70 @@ static void test_file(Library* lib) {
   }
 }
 
+static void test_osh_stream(Library* lib, Int ent_dim) {
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 2, 2, 2);
+  binary::write("stream_box.osh", &mesh);
+  auto ev2v = HostRead<LO>(mesh.ask_verts_of(ent_dim));
+  auto coords = mesh.coords();
+  auto globals = HostRead<GO>(mesh.globals(ent_dim));
+  auto deg = element_degree(mesh.family(), ent_dim, VERT);
+  LO nstreamed = 0;
+  auto f = [&](binary::PartReader* part, binary::EntChunk const& chunk) {
+    OMEGA_H_CHECK(part->nents(ent_dim) == mesh.nents(ent_dim));
+    OMEGA_H_CHECK(chunk.end - chunk.begin <= 7);
+    OMEGA_H_CHECK(chunk.begin == nstreamed);
+    auto verts = HostRead<LO>(chunk.verts);
+    auto ents2verts = HostRead<LO>(chunk.ents2verts);
+    for (LO i = 0; i < ents2verts.size(); ++i) {
+      OMEGA_H_CHECK(verts[ents2verts[i]] == ev2v[chunk.begin * deg + i]);
+    }
+    auto chunk_coords = part->read_tag<Real>(VERT, "coordinates", chunk.verts);
+    OMEGA_H_CHECK(
+        chunk_coords == Reals(unmap(chunk.verts, coords, mesh.dim())));
+    auto chunk_globals = HostRead<GO>(
+        part->read_tag<GO>(ent_dim, "global", chunk.begin, chunk.end));
+    for (LO i = 0; i < chunk_globals.size(); ++i) {
+      OMEGA_H_CHECK(chunk_globals[i] == globals[chunk.begin + i]);
+    }
+    nstreamed = chunk.end;
+  };
+  binary::for_each_ent_chunk("stream_box.osh", lib->world(), ent_dim, 7, f);
+  OMEGA_H_CHECK(nstreamed == mesh.nents(ent_dim));
+}
+
+/* subsets that move backward through an array larger than the
+   distance between inflate checkpoints */
+static void test_osh_stream_backward(Library* lib) {
+  auto mesh =
+      build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 0., 0., 1 << 20, 0, 0);
+  binary::write("stream_line.osh", &mesh);
+  auto coords = mesh.coords();
+  auto nverts = mesh.nverts();
+  auto version = binary::read_version("stream_line.osh", lib->world());
+  binary::PartReader part("stream_line.osh", 0, version);
+  for (auto begin : {nverts - 5, nverts / 4 * 3, LO(0), nverts - 3,
+           nverts / 2 + 10, nverts / 4}) {
+    auto ents = LOs({begin + 2, begin, begin + 1});
+    OMEGA_H_CHECK(part.read_tag<Real>(VERT, "coordinates", ents) ==
+                  Reals(unmap(ents, coords, 1)));
+  }
+}
+
+static void test_osh_stream(Library* lib) {
+  test_osh_stream(lib, 3);
+  test_osh_stream(lib, 2);
+  test_osh_stream(lib, 1);
+  test_osh_stream_backward(lib);
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 2, 2, 2);
+  binary::write("stream_box.osh", &mesh);
+  vtk::write_parallel_streamed("stream_box.osh", "stream_box_vtk", lib->world());
+  Mesh mesh2(lib);
+  vtk::read_parallel("stream_box_vtk/pieces.pvtu", lib->world(), &mesh2);
+  OMEGA_H_CHECK(mesh2.ask_verts_of(3) == mesh.ask_verts_of(3));
+  OMEGA_H_CHECK(mesh2.coords() == mesh.coords());
+  OMEGA_H_CHECK(mesh2.globals(3) == mesh.globals(3));
+}
+
 #ifdef OMEGA_H_USE_GMSH
 Omega_h_Comparison light_compare_meshes(Mesh& a, Mesh& b) {
   OMEGA_H_CHECK(a.comm()->size() == b.comm()->size());
@@ -1055,6 +1127,117 @@ static void test_gmsh_parallel(Library* lib) {
 
 #endif  // OMEGA_H_USE_GMSH
 
+#ifdef OMEGA_H_USE_LIBMESHB
+/* the block reads and writes against the mesh they came from, with
+   32-bit (version 2) and 64-bit (version 4) numbers in the file */
+static void test_meshb(Library* lib) {
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 2, 2, 2);
+  auto const nmetric = mesh.nverts() * symm_ncomps(3);
+  mesh.add_tag(VERT, "metric", symm_ncomps(3), Read<Real>(nmetric, 1.0, 0.25));
+  for (int version : {2, 4}) {
+    auto path = "meshb_box_v" + std::to_string(version);
+    meshb::write(&mesh, path + ".meshb", version);
+    meshb::write_sol(&mesh, path + ".solb", "metric", version);
+    Mesh mesh2(lib);
+    meshb::read(&mesh2, path + ".meshb");
+    meshb::read_sol(&mesh2, path + ".solb", "metric");
+    OMEGA_H_CHECK(mesh2.nverts() == mesh.nverts());
+    OMEGA_H_CHECK(mesh2.coords() == mesh.coords());
+    OMEGA_H_CHECK(mesh2.ask_elem_verts() == mesh.ask_elem_verts());
+    for (Int ent_dim = mesh.dim() - 1; ent_dim <= mesh.dim(); ++ent_dim) {
+      OMEGA_H_CHECK(mesh2.get_array<I8>(ent_dim, "class_dim") ==
+                    mesh.get_array<I8>(ent_dim, "class_dim"));
+      auto eqs = each_eq_to(mesh.get_array<I8>(ent_dim, "class_dim"),
+          I8(ent_dim));
+      auto ids = mesh.get_array<ClassId>(ent_dim, "class_id");
+      auto ids2 = mesh2.get_array<ClassId>(ent_dim, "class_id");
+      OMEGA_H_CHECK(
+          read(multiply_each(ids, array_cast<ClassId>(eqs))) ==
+          read(multiply_each(ids2, array_cast<ClassId>(eqs))));
+    }
+    OMEGA_H_CHECK(mesh2.get_array<Real>(VERT, "metric") ==
+                  mesh.get_array<Real>(VERT, "metric"));
+    Mesh sliced(lib);
+    meshb::read_sliced(&sliced, path + ".meshb", lib->world());
+    OMEGA_H_CHECK(sliced.nglobal_ents(VERT) == GO(mesh.nverts()));
+    OMEGA_H_CHECK(sliced.nglobal_ents(mesh.dim()) == GO(mesh.nelems()));
+    /* sides are classified by exposure over all ranks */
+    auto comm = lib->world();
+    for (Int ent_dim = mesh.dim() - 1; ent_dim <= mesh.dim(); ++ent_dim) {
+      for (I8 class_dim = 0; class_dim <= mesh.dim(); ++class_dim) {
+        auto nsliced = get_sum(comm,
+            sliced.owned_array(ent_dim,
+                each_eq_to(sliced.get_array<I8>(ent_dim, "class_dim"),
+                    class_dim),
+                1));
+        auto nserial = get_sum(
+            each_eq_to(mesh.get_array<I8>(ent_dim, "class_dim"), class_dim));
+        OMEGA_H_CHECK(nsliced == nserial);
+      }
+    }
+    OMEGA_H_CHECK(sliced.has_tag(VERT, "class_dim"));
+  }
+}
+#endif  // OMEGA_H_USE_LIBMESHB
+
+#ifdef OMEGA_H_USE_SEACASEXODUS
+static Mesh read_exodus(Library* lib, std::string const& path) {
+  Mesh mesh(lib);
+  auto file = exodus::open(path);
+  exodus::read_mesh(file, &mesh);
+  exodus::close(file);
+  return mesh;
+}
+
+/* write_parallel against the serial writer: the same global set sizes
+   on any number of ranks, and the same mesh when there is one */
+static void test_exodus_parallel(Library* lib) {
+  auto world = lib->world();
+  auto mesh = build_box(world, OMEGA_H_SIMPLEX, 1., 1., 1., 2, 2, 2);
+  mesh.set_parting(OMEGA_H_GHOSTED);
+  auto const nelems = mesh.nelems();
+  exodus::write_parallel("box_spread.exo", &mesh);
+  OMEGA_H_CHECK(mesh.parting() == OMEGA_H_GHOSTED);
+  OMEGA_H_CHECK(mesh.nelems() == nelems);
+  if (world->rank() == 0) {
+    auto serial = build_box(lib->self(), OMEGA_H_SIMPLEX, 1., 1., 1., 2, 2, 2);
+    exodus::write("box_serial.exo", &serial);
+  }
+  world->barrier();
+  auto nparts = std::to_string(world->size());
+  auto part = std::to_string(world->rank());
+  part.insert(0, nparts.size() - part.size(), '0');
+  auto part_path = "box_spread.exo." + nparts + "." + part;
+  auto spread_file = exodus::open(part_path);
+  auto serial_file = exodus::open("box_serial.exo");
+  ex_set_int64_status(spread_file, EX_ALL_INT64_API);
+  ex_set_int64_status(serial_file, EX_ALL_INT64_API);
+  int64_t nnodes, nelems_global, nblocks, nnode_sets, nside_sets;
+  OMEGA_H_CHECK(0 <= ex_get_init_global(spread_file, &nnodes, &nelems_global,
+                         &nblocks, &nnode_sets, &nside_sets));
+  OMEGA_H_CHECK(nnodes == 27 && nelems_global == 48);
+  std::vector<int64_t> ids(static_cast<std::size_t>(nnode_sets));
+  std::vector<int64_t> counts(ids.size()), nfactors(ids.size());
+  OMEGA_H_CHECK(0 <= ex_get_ns_param_global(spread_file, ids.data(),
+                         counts.data(), nfactors.data()));
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    int64_t count, nfactors_serial;
+    OMEGA_H_CHECK(0 <= ex_get_set_param(serial_file, EX_NODE_SET, ids[i],
+                           &count, &nfactors_serial));
+    OMEGA_H_CHECK(counts[i] == count);
+  }
+  exodus::close(spread_file);
+  exodus::close(serial_file);
+  if (world->size() == 1) {
+    auto a = read_exodus(lib, "box_serial.exo");
+    auto b = read_exodus(lib, part_path);
+    OMEGA_H_CHECK(a.nverts() == b.nverts());
+    OMEGA_H_CHECK(a.coords() == b.coords());
+    OMEGA_H_CHECK(a.ask_elem_verts() == b.ask_elem_verts());
+  }
+}
+#endif  // OMEGA_H_USE_SEACASEXODUS
+
 static void test_gmsh(Library* lib) {
   const auto nranks = lib->world()->size();
   {
@@ -1134,10 +1317,10 @@ static void test_xml() {
   OMEGA_H_CHECK(tag.type == xml_lite::Tag::END);
 }
 
-static void test_read_vtu(Mesh* mesh0) {
+static void test_read_vtu(Mesh* mesh0, bool compress) {
   std::stringstream stream;
-  vtk::write_vtu(
-      stream, mesh0, mesh0->dim(), vtk::get_all_vtk_tags(mesh0, mesh0->dim()));
+  vtk::write_vtu(stream, mesh0, mesh0->dim(),
+      vtk::get_all_vtk_tags(mesh0, mesh0->dim()), compress);
   Mesh mesh1(mesh0->library());
   vtk::read_vtu(stream, mesh0->comm(), &mesh1);
   auto opts = MeshCompareOpts::init(mesh0, VarCompareOpts::zero_tolerance());
@@ -1147,7 +1330,89 @@ static void test_read_vtu(Mesh* mesh0) {
 
 static void test_read_vtu(Library* lib) {
   auto mesh0 = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 1, 1, 1);
-  test_read_vtu(&mesh0);
+  test_read_vtu(&mesh0, OMEGA_H_DEFAULT_COMPRESS);
+  /* large enough for several compressed blocks */
+  auto mesh1 = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 8, 8, 8);
+  test_read_vtu(&mesh1, vtk::dont_compress);
+  test_read_vtu(&mesh1, OMEGA_H_DEFAULT_COMPRESS);
+}
+
+static Read<I8> to_text(std::string const& s) {
+  HostWrite<I8> text(LO(s.size()));
+  for (LO i = 0; i < text.size(); ++i) text[i] = I8(s[std::size_t(i)]);
+  return text.write();
+}
+
+static void test_parse_numbers() {
+  std::string const s =
+      " 0 1.5 -2.25e3\n\t0.1 3.141592653589793 1e-310 +7.E+2"
+      " 123456789012345678901234 2.2250738585072014e-308 -0.0 \n";
+  auto text = to_text(s);
+  auto reals = HostRead<Real>(parse_reals(text, 0, text.size(), 10));
+  std::istringstream stream(s);
+  stream.imbue(std::locale::classic());
+  for (LO i = 0; i < reals.size(); ++i) {
+    Real expected;
+    stream >> expected;
+    OMEGA_H_CHECK(reals[i] == expected);
+  }
+  /* only part of the text, and no numbers at all */
+  auto part = HostRead<Real>(parse_reals(text, 3, 7, 1));
+  OMEGA_H_CHECK(part[0] == 1.5);
+  OMEGA_H_CHECK(parse_reals(text, 0, 1, 0).size() == 0);
+  auto ints = to_text("4 -12\r\n  0 2147483647");
+  OMEGA_H_CHECK(
+      parse_los(ints, 0, ints.size(), 4) == LOs({4, -12, 0, 2147483647}));
+}
+
+/* hands out one character at a time and can neither seek nor put
+   back more than it just gave, like a pipe */
+struct PipeBuf : public std::streambuf {
+  std::string text;
+  std::size_t pos;
+  char c;
+  PipeBuf(std::string const& text_in) : text(text_in), pos(0), c(0) {}
+  int_type underflow() override {
+    if (pos == text.size()) return traits_type::eof();
+    c = text[pos++];
+    setg(&c, &c, &c + 1);
+    return traits_type::to_int_type(c);
+  }
+};
+
+static void test_read_numbers(std::istream& stream, std::size_t chunk_bytes) {
+  auto reals = read_reals(stream, 3, chunk_bytes);
+  OMEGA_H_CHECK(reals == Reals({1.5, -2.0, 30.0}));
+  auto ints = read_los(stream, 0, chunk_bytes);
+  OMEGA_H_CHECK(ints.size() == 0);
+  reals = read_reals(stream, 1, chunk_bytes);
+  OMEGA_H_CHECK(reals == Reals({42.5}));
+  ints = read_los(stream, 4, chunk_bytes);
+  OMEGA_H_CHECK(ints == LOs({5, 6, 7, 8}));
+  std::string rest;
+  stream >> rest;
+  OMEGA_H_CHECK(rest == "tail");
+}
+
+static void test_read_numbers() {
+  std::string const s = "1.5 -2  30\n\n4.25e1 5 6\t7 8 tail\n";
+  /* every chunk size, down to chunks shorter than one number */
+  for (std::size_t chunk_bytes = 1; chunk_bytes <= s.size() + 1;
+       ++chunk_bytes) {
+    std::istringstream stream(s);
+    test_read_numbers(stream, chunk_bytes);
+    PipeBuf pipe(s);
+    std::istream pipe_stream(&pipe);
+    test_read_numbers(pipe_stream, chunk_bytes);
+  }
+  /* the last number may end the stream */
+  PipeBuf pipe("1 2 3");
+  std::istream pipe_stream(&pipe);
+  OMEGA_H_CHECK(read_los(pipe_stream, 3) == LOs({1, 2, 3}));
+  OMEGA_H_CHECK(bool(pipe_stream));
+  /* numbers after the ones asked for are left alone */
+  std::istringstream stream("1 2 3 4 5 6 7");
+  OMEGA_H_CHECK(read_reals_txt(stream, 3, 2) == Reals({1, 2, 3, 4, 5, 6}));
 }
 
 int main(int argc, char** argv) {
@@ -1156,11 +1421,20 @@ int main(int argc, char** argv) {
   if (lib.world()->size() == 1) {
     test_file_components();
     test_file(&lib);
+    test_osh_stream(&lib);
     test_xml();
     test_read_vtu(&lib);
+    test_parse_numbers();
+    test_read_numbers();
+#ifdef OMEGA_H_USE_LIBMESHB
+    test_meshb(&lib);
+#endif  // OMEGA_H_USE_LIBMESHB
   }
   test_gmsh(&lib);
 #ifdef OMEGA_H_USE_GMSH
   test_gmsh_parallel(&lib);
 #endif  // OMEGA_H_USE_GMSH
+#ifdef OMEGA_H_USE_SEACASEXODUS
+  test_exodus_parallel(&lib);
+#endif  // OMEGA_H_USE_SEACASEXODUS
 }
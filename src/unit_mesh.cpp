@@ -1,19 +1,29 @@
 #include "Omega_h_align.hpp"
 #include "Omega_h_array_ops.hpp"
 #include "Omega_h_bbox.hpp"
+#include "Omega_h_box.hpp"
 #include "Omega_h_build.hpp"
+#ifndef _MSC_VER
+#include "Omega_h_coloring.hpp"
+#endif
 #include "Omega_h_compare.hpp"
 #include "Omega_h_confined.hpp"
 #include "Omega_h_for.hpp"
 #include "Omega_h_hilbert.hpp"
+#include "Omega_h_histogram.hpp"
 #include "Omega_h_hypercube.hpp"
+#include "Omega_h_indset.hpp"
 #include "Omega_h_inertia.hpp"
 #include "Omega_h_int_scan.hpp"
+#include "Omega_h_map.hpp"
+#include "Omega_h_mark.hpp"
 #include "Omega_h_mesh.hpp"
 #include "Omega_h_quality.hpp"
 #include "Omega_h_recover.hpp"
 #include "Omega_h_refine_qualities.hpp"
 #include "Omega_h_shape.hpp"
+#include "Omega_h_simplify.hpp"
+#include "Omega_h_surface.hpp"
 #include "Omega_h_swap2d.hpp"
 #include "Omega_h_swap3d_choice.hpp"
 #include "Omega_h_swap3d_loop.hpp"
@@ -371,6 +381,43 @@ static void test_inertial_bisect(Library* lib) {
   OMEGA_H_CHECK(marked == Read<I8>({1, 0, 1, 0}));
 }
 
+#ifndef _MSC_VER
+static void test_random_indset_and_coloring(Library* lib) {
+  auto mesh = build_box(lib->self(), OMEGA_H_SIMPLEX, 1., 1., 0., 6, 6, 0);
+  auto nverts = mesh.nverts();
+  auto device_indset = find_random_indset(
+      &mesh, VERT, Reals(nverts, 1.), Read<I8>(nverts, 1), 42);
+  auto indset = HostRead<I8>(device_indset);
+  auto colors = HostRead<I32>(color_ents(&mesh, VERT, 42));
+  auto edges2verts = HostRead<LO>(mesh.ask_verts_of(EDGE));
+  std::vector<bool> covered(std::size_t(nverts), false);
+  for (LO e = 0; e < mesh.nedges(); ++e) {
+    auto a = edges2verts[e * 2 + 0];
+    auto b = edges2verts[e * 2 + 1];
+    OMEGA_H_CHECK(!(indset[a] && indset[b]));
+    OMEGA_H_CHECK(colors[a] != colors[b]);
+    if (indset[a]) covered[std::size_t(b)] = true;
+    if (indset[b]) covered[std::size_t(a)] = true;
+  }
+  for (LO v = 0; v < nverts; ++v) {
+    OMEGA_H_CHECK(indset[v] || covered[std::size_t(v)]);
+    OMEGA_H_CHECK(0 <= colors[v] && colors[v] <= 6);
+  }
+  auto other = find_random_indset(
+      &mesh, VERT, Reals(nverts, 1.), Read<I8>(nverts, 1), 42);
+  OMEGA_H_CHECK(other == device_indset);
+  auto elem_colors = HostRead<I32>(color_ents(&mesh, FACE, 7));
+  auto dual = mesh.ask_dual();
+  auto dual_offsets = HostRead<LO>(dual.a2ab);
+  auto dual_edges = HostRead<LO>(dual.ab2b);
+  for (LO t = 0; t < mesh.nfaces(); ++t) {
+    for (auto j = dual_offsets[t]; j < dual_offsets[t + 1]; ++j) {
+      OMEGA_H_CHECK(elem_colors[t] != elem_colors[dual_edges[j]]);
+    }
+  }
+}
+#endif
+
 static void test_average_field(Library* lib) {
   auto mesh = Mesh(lib);
   build_box_internal(&mesh, OMEGA_H_SIMPLEX, 1, 1, 0, 1, 1, 0);
@@ -399,6 +446,38 @@ static void test_mark_up_down(Library* lib) {
       mark_up(&mesh, VERT, FACE, Read<I8>({0, 1, 0, 0})) == Read<I8>({1, 0}));
 }
 
+static void test_class_closures(Library* lib) {
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 2, 2, 2);
+  auto brute_force = [&](Int ent_dim, Int class_dim, ClassId class_id) {
+    auto eq_marks = mark_by_class(&mesh, class_dim, class_dim, class_id);
+    if (ent_dim == class_dim) return eq_marks;
+    return mark_down(&mesh, class_dim, ent_dim, eq_marks);
+  };
+  for (Int class_dim = 0; class_dim <= 3; ++class_dim) {
+    for (Int ent_dim = 0; ent_dim <= class_dim; ++ent_dim) {
+      for (ClassId class_id = 0; class_id < 27; ++class_id) {
+        OMEGA_H_CHECK(mark_class_closure(&mesh, ent_dim, class_dim, class_id) ==
+                      brute_force(ent_dim, class_dim, class_id));
+      }
+    }
+  }
+  auto x_minus = ents_on_closure(&mesh, {"x-"}, VERT);
+  OMEGA_H_CHECK(x_minus == collect_marked(brute_force(VERT, FACE, 12)));
+  auto marks = mark_class_closures(&mesh, VERT, {{2, 12}, {2, 14}});
+  OMEGA_H_CHECK(marks == lor_each(brute_force(VERT, FACE, 12),
+                             brute_force(VERT, FACE, 14)));
+  /* changing the classification invalidates the index */
+  auto face_ids = deep_copy(mesh.get_array<ClassId>(FACE, "class_id"));
+  auto old_x_minus = brute_force(EDGE, FACE, 12);
+  auto relabel = OMEGA_H_LAMBDA(LO f) {
+    if (face_ids[f] == 12) face_ids[f] = 100;
+  };
+  parallel_for(mesh.nfaces(), relabel);
+  mesh.set_tag(FACE, "class_id", read(face_ids));
+  OMEGA_H_CHECK(get_max(mark_class_closure(&mesh, EDGE, FACE, 12)) == 0);
+  OMEGA_H_CHECK(mark_class_closure(&mesh, EDGE, FACE, 100) == old_x_minus);
+}
+
 static void test_compare_meshes(Library* lib) {
   auto a = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 0., 4, 4, 0);
   OMEGA_H_CHECK(a == a);
@@ -588,6 +667,120 @@ static void test_1d_box(Library* lib) {
   auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1, 0, 0, 4, 0, 0);
 }
 
+static void test_box_distributed(Library* lib) {
+  for (auto family : {OMEGA_H_SIMPLEX, OMEGA_H_HYPERCUBE}) {
+    for (Int dim = 1; dim <= 3; ++dim) {
+      LO ny = (dim > 1) ? 3 : 0;
+      LO nz = (dim > 2) ? 2 : 0;
+      auto a = build_box(lib->world(), family, 1., 2., 3., 4, ny, nz);
+      auto b =
+          build_box_distributed(lib->world(), family, 1., 2., 3., 4, ny, nz);
+      OMEGA_H_CHECK(b.dim() == dim);
+      for (Int ent_dim = 0; ent_dim <= dim; ++ent_dim) {
+        OMEGA_H_CHECK(a.nents(ent_dim) == b.nents(ent_dim));
+        OMEGA_H_CHECK(get_sum(a.get_array<ClassId>(ent_dim, "class_id")) ==
+                      get_sum(b.get_array<ClassId>(ent_dim, "class_id")));
+        OMEGA_H_CHECK(get_sum(a.get_array<Byte>(ent_dim, "class_dim")) ==
+                      get_sum(b.get_array<Byte>(ent_dim, "class_dim")));
+      }
+      if (family == OMEGA_H_SIMPLEX) {
+        OMEGA_H_CHECK(
+            are_close(get_sum(a.ask_sizes()), get_sum(b.ask_sizes())));
+      }
+      for (Int ent_dim = 0; ent_dim <= dim; ++ent_dim) {
+        OMEGA_H_CHECK(b.globals(ent_dim) == GOs(b.nents(ent_dim), 0, 1));
+      }
+      /* the computed alignment codes agree with matching */
+      for (Int ent_dim = 2; ent_dim <= dim; ++ent_dim) {
+        auto down = b.ask_down(ent_dim, ent_dim - 1);
+        auto matched = reflect_down(b.ask_verts_of(ent_dim),
+            b.ask_verts_of(ent_dim - 1), b.ask_up(VERT, ent_dim - 1), family,
+            ent_dim, ent_dim - 1);
+        OMEGA_H_CHECK(down.ab2b == matched.ab2b);
+        OMEGA_H_CHECK(down.codes == matched.codes);
+      }
+      Few<LO, 3> nel({4, ny, nz});
+      LOs ev2v;
+      Reals coords;
+      GOs vert_globals;
+      GOs cell_globals;
+      make_box_block(dim, Vector<3>({1., 2., 3.}), nel, Few<LO, 3>({0, 0, 0}),
+          nel, &ev2v, &coords, &vert_globals, &cell_globals);
+      if (family == OMEGA_H_SIMPLEX && dim == 2) ev2v = tris_from_quads(ev2v);
+      if (family == OMEGA_H_SIMPLEX && dim == 3) ev2v = tets_from_hexes(ev2v);
+      OMEGA_H_CHECK(b.ask_elem_verts() == ev2v);
+    }
+  }
+  auto parts = suggest_box_parts(12, 3, Few<LO, 3>({10, 10, 40}));
+  OMEGA_H_CHECK(parts[0] * parts[1] * parts[2] == 12);
+  OMEGA_H_CHECK(parts[2] >= parts[0] && parts[2] >= parts[1]);
+}
+
+static void test_field_stats(Library* lib) {
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 0., 4, 4, 0);
+  auto xs = get_component(mesh.coords(), 2, 0);
+  auto stats = get_field_stats(&mesh,
+      {{VERT, xs, {0.3, 0.8}, 4, 0.0, 1.0, STATS_VALUES},
+          {FACE, mesh.ask_sizes(), {0.0, 1.0}, 0, 0.0, 0.0, STATS_VALUES}});
+  OMEGA_H_CHECK(stats.size() == 2);
+  auto& s = stats[0];
+  OMEGA_H_CHECK(s.ntotal == 25);
+  OMEGA_H_CHECK(s.nlow == 10);
+  OMEGA_H_CHECK(s.nhigh == 5);
+  OMEGA_H_CHECK(s.nunder == 0 && s.nover == 0);
+  OMEGA_H_CHECK(are_close(s.actual.min, 0.0));
+  OMEGA_H_CHECK(are_close(s.actual.max, 1.0));
+  OMEGA_H_CHECK(are_close(s.mean, 0.5));
+  OMEGA_H_CHECK(s.histogram.bins == std::vector<GO>({5, 5, 5, 10}));
+  auto median = get_quantile(s, 0.5);
+  OMEGA_H_CHECK(0.5 <= median && median <= 0.75);
+  OMEGA_H_CHECK(are_close(get_quantile(s, 0.0), 0.0));
+  OMEGA_H_CHECK(are_close(get_quantile(s, 1.0), 1.0));
+  auto sizes = get_minmax(mesh.comm(), mesh.ask_sizes());
+  OMEGA_H_CHECK(stats[1].ntotal == mesh.nglobal_ents(FACE));
+  OMEGA_H_CHECK(are_close(stats[1].actual.min, sizes.min));
+  OMEGA_H_CHECK(are_close(stats[1].actual.max, sizes.max));
+  OMEGA_H_CHECK(are_close(stats[1].mean, 1.0 / 32.0));
+  OMEGA_H_CHECK(stats[1].histogram.bins.empty());
+  auto h = get_histogram(&mesh, VERT, 4, 0.0, 1.0, xs);
+  OMEGA_H_CHECK(h.bins == s.histogram.bins);
+  auto wide = get_histogram(&mesh, VERT, 100, 0.0, 1.0, xs);
+  std::vector<GO> wide_bins(100, 0);
+  for (auto b : {0, 25, 50, 75, 99}) wide_bins[std::size_t(b)] = 5;
+  OMEGA_H_CHECK(wide.bins == wide_bins);
+  mesh.add_tag(VERT, "metric", 1, Reals(mesh.nverts(), 4.0));
+  auto measured = get_field_stats(&mesh,
+      {{FACE, Reals(), {0.5, 1.0}, 0, 0.0, 0.0, STATS_QUALITY},
+          {EDGE, Reals(), {0.0, 1.0}, 0, 0.0, 0.0, STATS_LENGTH}});
+  OMEGA_H_CHECK(!mesh.has_tag(FACE, "quality"));
+  OMEGA_H_CHECK(!mesh.has_tag(EDGE, "length"));
+  auto quals = get_minmax(mesh.comm(), measure_qualities(&mesh));
+  auto lens = get_minmax(mesh.comm(), measure_edges_metric(&mesh));
+  OMEGA_H_CHECK(are_close(measured[0].actual.min, quals.min));
+  OMEGA_H_CHECK(are_close(measured[0].actual.max, quals.max));
+  OMEGA_H_CHECK(are_close(measured[1].actual.min, lens.min));
+  OMEGA_H_CHECK(are_close(measured[1].actual.max, lens.max));
+  OMEGA_H_CHECK(measured[1].ntotal == mesh.nglobal_ents(EDGE));
+  OMEGA_H_CHECK(measured[1].nhigh == 0);
+}
+
+static void test_surface_cache(Library* lib) {
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 4, 4, 4);
+  auto const* first = &mesh.ask_surface_info();
+  OMEGA_H_CHECK(first == &mesh.ask_surface_info());
+  auto fresh = get_surface_info(&mesh);
+  OMEGA_H_CHECK(first->surf_vert_normals == fresh.surf_vert_normals);
+  OMEGA_H_CHECK(first->curv_vert_tangents == fresh.curv_vert_tangents);
+  mesh.set_coords(multiply_each_by(mesh.coords(), 2.0));
+  auto const& scaled = mesh.ask_surface_info();
+  auto curvatures = get_vert_curvatures(&mesh, scaled);
+  OMEGA_H_CHECK(are_close(
+      curvatures, multiply_each_by(get_vert_curvatures(&mesh, fresh), 0.5)));
+  OMEGA_H_CHECK(scaled.surf_vert_normals == fresh.surf_vert_normals);
+  OMEGA_H_CHECK(are_close(scaled.curv_vert_curvatures,
+      multiply_each_by(fresh.curv_vert_curvatures, 0.5)));
+}
+
 static bool compare_hst(Int pd, Int cd, Int wc, Int wcv, SplitVertex truth) {
   auto split_vtx = hypercube_split_template(pd, cd, wc, wcv);
   if (split_vtx.dim != truth.dim) return false;
@@ -756,9 +949,13 @@ int main(int argc, char** argv) {
   test_dual(&lib);
   test_quality();
   test_inertial_bisect(&lib);
+#ifndef _MSC_VER
+  test_random_indset_and_coloring(&lib);
+#endif
   test_average_field(&lib);
   test_refine_qualities(&lib);
   test_mark_up_down(&lib);
+  test_class_closures(&lib);
   test_compare_meshes(&lib);
   test_swap2d_topology(&lib);
   test_swap3d_loop(&lib);
@@ -767,5 +964,8 @@ int main(int argc, char** argv) {
   test_sf_scale(&lib);
   test_proximity(&lib);
   test_1d_box(&lib);
+  test_box_distributed(&lib);
+  test_field_stats(&lib);
+  test_surface_cache(&lib);
   test_hypercube_split_template();
 }
@@ -229,6 +229,32 @@ static void test_yaml_reader() {
   test_yaml_reader("---\npressure: -1.9e-6\nvolume: 0.7e+10\n...\n");
 }
 
+static std::string get_reader_error(
+    ReaderTablesPtr tables, std::string const& str) {
+  auto reader = Reader(tables);
+  try {
+    reader.read_string(str, "test_reader_errors");
+  } catch (ParserFail const& e) {
+    return e.what();
+  }
+  return "";
+}
+
+static void test_reader_errors() {
+  auto yaml_tables = yaml::ask_reader_tables();
+  auto msg = get_reader_error(yaml_tables, "---\nfoo: bar\n  baz: [1, 2\n...\n");
+  OMEGA_H_CHECK(msg.find("line 3") != std::string::npos);
+  msg = get_reader_error(yaml_tables, "---\nfoo: bar\n\x01\n...\n");
+  OMEGA_H_CHECK(
+      msg.find("Unexpected character code 1 at line 3 column 1") !=
+      std::string::npos);
+  /* one long line, which used to be copied at every lexer accept */
+  std::string long_value(1 << 18, 'a');
+  auto reader = Reader(xml::ask_reader_tables());
+  std::istringstream stream("<P name=\"" + long_value + "\"/>");
+  reader.read_stream(stream, "test_reader_errors");
+}
+
 static void test_hydro() {
   auto str = "vector((x > 0.5) ? 0.01 : 0.0)";
   ExprOpsReader reader;
@@ -254,5 +280,6 @@ int main(int argc, char** argv) {
   test_xml_reader();
   test_yaml_language();
   test_yaml_reader();
+  test_reader_errors();
   test_hydro();
 }